@@ -20,6 +20,7 @@ using SteamNetworkingConfigValue_t = SteamNetworkingConfigValue_t;
 using ISteamNetworkingMessage = ISteamNetworkingMessage;
 using SteamDatagramErrMsg = SteamDatagramErrMsg;
 using SteamNetworkingMicroseconds = SteamNetworkingMicroseconds;
+using SteamNetConnectionRealTimeStatus_t = SteamNetConnectionRealTimeStatus_t;
 using ESteamNetworkingSocketsDebugOutputType = ESteamNetworkingSocketsDebugOutputType;
 
 constexpr auto GameNetworkingSockets = SteamNetworkingSockets;
@@ -1,5 +1,6 @@
 module;
 
+#include <chrono>
 #include <memory>
 #include <functional>
 #include <optional>
@@ -15,6 +16,7 @@ export namespace Httplib
 struct Response
 {
     int status;
+    std::string body;
 };
 
 struct Header
@@ -81,8 +83,16 @@ public:
 
     void set_keep_alive(bool on);
 
+    void set_connection_timeout(std::chrono::milliseconds timeout);
+
+    void set_read_timeout(std::chrono::milliseconds timeout);
+
+    void set_write_timeout(std::chrono::milliseconds timeout);
+
     std::string host() const;
 
+    Result Get(const std::string& path);
+
     Result Post(const std::string& path, const std::string& body, const std::string& content_type);
 
 private:
@@ -105,12 +115,23 @@ public:
 
     ~Server();
 
+    void Get(const std::string& path, Handler handler);
+
     void Post(const std::string& path, Handler handler);
 
     void Options(const std::string& path, Handler handler);
 
     bool Listen(const std::string& host, int port);
 
+    // Returns the bound port or -1 on failure
+    int BindToAnyPort(const std::string& host);
+
+    bool BindToPort(const std::string& host, int port);
+
+    bool ListenAfterBind();
+
+    void WaitUntilReady() const;
+
     void Stop();
 
 private:
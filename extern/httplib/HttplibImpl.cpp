@@ -1,5 +1,6 @@
 module;
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <utility>
@@ -50,16 +51,41 @@ void Client::set_keep_alive(bool on)
     implementation_->client.set_keep_alive(on);
 }
 
+void Client::set_connection_timeout(std::chrono::milliseconds timeout)
+{
+    implementation_->client.set_connection_timeout(timeout);
+}
+
+void Client::set_read_timeout(std::chrono::milliseconds timeout)
+{
+    implementation_->client.set_read_timeout(timeout);
+}
+
+void Client::set_write_timeout(std::chrono::milliseconds timeout)
+{
+    implementation_->client.set_write_timeout(timeout);
+}
+
 std::string Client::host() const
 {
     return implementation_->client.host();
 }
 
+Result Client::Get(const std::string& path)
+{
+    auto response = implementation_->client.Get(path);
+    if (response) {
+        return Result{ Response{ .status = response->status, .body = response->body } };
+    }
+
+    return Result{ static_cast<int>(response.error()), httplib::to_string(response.error()) };
+}
+
 Result Client::Post(const std::string& path, const std::string& body, const std::string& content_type)
 {
     auto response = implementation_->client.Post(path, body, content_type);
     if (response) {
-        return Result{ Response{ response->status } };
+        return Result{ Response{ .status = response->status, .body = response->body } };
     }
 
     return Result{ static_cast<int>(response.error()), httplib::to_string(response.error()) };
@@ -81,6 +107,20 @@ Server& Server::operator=(Server&&) noexcept = default;
 
 Server::~Server() = default;
 
+void Server::Get(const std::string& path, Handler handler)
+{
+    implementation_->server.Get(
+      path, [handler = std::move(handler)](const httplib::Request& request,
+                                           httplib::Response& response) {
+          const auto server_response = handler(ServerRequest{ .body = request.body });
+          response.status = server_response.status;
+          for (const auto& header : server_response.headers) {
+              response.set_header(header.name, header.value);
+          }
+          response.set_content(server_response.body, server_response.content_type);
+      });
+}
+
 void Server::Post(const std::string& path, Handler handler)
 {
     implementation_->server.Post(
@@ -114,6 +154,26 @@ bool Server::Listen(const std::string& host, int port)
     return implementation_->server.listen(host, port);
 }
 
+int Server::BindToAnyPort(const std::string& host)
+{
+    return implementation_->server.bind_to_any_port(host);
+}
+
+bool Server::BindToPort(const std::string& host, int port)
+{
+    return implementation_->server.bind_to_port(host, port);
+}
+
+bool Server::ListenAfterBind()
+{
+    return implementation_->server.listen_after_bind();
+}
+
+void Server::WaitUntilReady() const
+{
+    implementation_->server.wait_until_ready();
+}
+
 void Server::Stop()
 {
     implementation_->server.stop();
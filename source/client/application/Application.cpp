@@ -31,6 +31,7 @@ import Gameplay.PlayerController;
 import Editor.EditorSession;
 import Scene;
 import RenderPipeline;
+import RenderSnapshot;
 import MapEditor;
 import MapEditorState;
 import ClientState;
@@ -57,6 +58,8 @@ import Shared.Core.Entities.Bullet;
 import Shared.Core.Entities.Soldier;
 import Shared.Core.Map.PMSStructs;
 import Shared.Core.Entities.Item;
+import Shared.Core.Utility.FrameProfiler;
+import Shared.Core.Utility.TripleBuffer;
 
 import Shared.Networking.NetworkPackets;
 import Shared.Networking.NetworkEventDispatcher;
@@ -90,6 +93,10 @@ private:
     std::unique_ptr<EditorSession> editor_session_;
     std::unique_ptr<NetworkClientSession> network_client_session_;
     std::unique_ptr<RenderPipeline> render_pipeline_;
+    // Snapshots of the last two ticks, captured by the simulation after every tick
+    RenderSnapshotHistory render_snapshot_history_;
+    // Published by the simulation after every tick, taken by rendering
+    TripleBuffer<RenderSnapshotHistory> render_snapshots_;
     std::unique_ptr<ApplicationInputController> input_controller_;
     std::unique_ptr<PlayerController> player_controller_;
 
@@ -320,6 +327,7 @@ void Application::Run()
 
     world_->SetShouldStopGameLoopCallback([&]() { return window_->ShouldClose(); });
     world_->SetPreGameLoopIterationCallback([&]() {
+        ScopedProfilerZone input_zone(GetFrameProfiler(), "Input");
         input_controller_->UpdateContext();
         input_controller_->Route();
 
@@ -354,14 +362,19 @@ void Application::Run()
         client_state_->debug_render.colliding_polygon_ids.clear();
 
         if (application_mode_ == ApplicationMode::Online) {
+            ScopedProfilerZone network_zone(GetFrameProfiler(), "Network");
             network_client_session_->UpdateBeforeWorldTick();
         }
 
         if (client_state_->client_soldier_id.has_value()) {
             std::uint8_t client_soldier_id = *client_state_->client_soldier_id;
-            player_controller_->Update(client_soldier_id);
+            {
+                ScopedProfilerZone input_zone(GetFrameProfiler(), "Input");
+                player_controller_->Update(client_soldier_id);
+            }
 
             if (application_mode_ == ApplicationMode::Online) {
+                ScopedProfilerZone network_zone(GetFrameProfiler(), "Network");
                 glm::vec2 mouse_map_position = input_controller_->GetMouseMapPosition();
                 network_client_session_->SendSoldierInput(client_soldier_id, mouse_map_position);
 
@@ -379,26 +392,43 @@ void Application::Run()
             client_state_->camera.position = { 0.0F, 0.0F };
         }
     });
-    world_->SetPostWorldUpdateCallback([&](const StateManager& /*state_manager*/) {
+    world_->SetPostWorldUpdateCallback([&](const StateManager& state_manager) {
         if (application_mode_ == ApplicationMode::Online &&
             client_state_->client_soldier_id.has_value()) {
+            ScopedProfilerZone network_zone(GetFrameProfiler(), "Network");
             network_client_session_->StorePredictedSoldierSnapshot(
               *client_state_->client_soldier_id);
         }
+        if (client_state_->world_render_options.render_from_snapshots) {
+            ScopedProfilerZone snapshot_zone(GetFrameProfiler(), "Render snapshot");
+            CaptureRenderSnapshot(state_manager, render_snapshot_history_.PushNew());
+            render_snapshots_.GetWriteBuffer() = render_snapshot_history_;
+            render_snapshots_.Publish();
+        }
     });
     world_->SetPostGameLoopIterationCallback(
       [&](const StateManager& state_manager, double frame_percent, int last_fps) {
           if (!client_state_->network.objects_interpolation) {
               frame_percent = 1.0F;
           }
-          render_pipeline_->Render(state_manager,
-                                   *client_state_,
-                                   client_runtime_.GetClientMode(),
-                                   client_runtime_.GetEditorMode(),
-                                   frame_percent,
-                                   last_fps);
-
-          window_->SwapBuffers();
+          {
+              ScopedProfilerZone render_zone(GetFrameProfiler(), "Render");
+              render_snapshots_.Update();
+              render_pipeline_->Render(state_manager,
+                                       render_snapshots_.GetReadBuffer(),
+                                       *client_state_,
+                                       client_runtime_.GetClientMode(),
+                                       client_runtime_.GetEditorMode(),
+                                       frame_percent,
+                                       last_fps);
+          }
+
+          {
+              // Includes waiting for vertical sync
+              ScopedProfilerZone swap_zone(GetFrameProfiler(), "Swap buffers");
+              window_->SwapBuffers();
+          }
+          ScopedProfilerZone input_zone(GetFrameProfiler(), "Input");
           window_->GetPlatformInput().ResetFrame();
           window_->PollInput();
       });
@@ -1,5 +1,7 @@
 module;
 
+#include <array>
+#include <cstddef>
 #include <string>
 #include <cassert>
 #include <cstdint>
@@ -38,28 +40,34 @@ public:
       const std::shared_ptr<NetworkEventDispatcher>& network_event_dispatcher) final
     {
         while (true) {
-            GNS::ISteamNetworkingMessage* p_incoming_msg = nullptr;
-            int num_msgs =
-              interface_->ReceiveMessagesOnConnection(connection_handle_, &p_incoming_msg, 1);
-            if (num_msgs == 0) {
+            int messages_count = interface_->ReceiveMessagesOnConnection(
+              connection_handle_, incoming_messages_.data(), RECEIVE_MESSAGES_BATCH_SIZE);
+            if (messages_count == 0) {
                 return;
             }
-            if (num_msgs < 0) {
+            if (messages_count < 0) {
                 Spdlog::error("Error checking for messages");
                 return;
             }
 
-            std::span<const char> received_bytes{ static_cast<char*>(p_incoming_msg->m_pData),
-                                                  static_cast<unsigned int>(
-                                                    p_incoming_msg->m_cbSize) };
-
-            NetworkMessage received_message(received_bytes);
-            ConnectionMetadata connection_metadata{ .connection_id = p_incoming_msg->m_conn,
-                                                    .send_message_to_connection =
-                                                      [](const NetworkMessage& /*message*/) {} };
-            // We don't need this anymore.
-            p_incoming_msg->Release();
-            network_event_dispatcher->ProcessNetworkMessage(connection_metadata, received_message);
+            // Messages are dispatched straight from the GNS buffers and released together after
+            // the whole batch is handled
+            std::span received_messages{ incoming_messages_.data(),
+                                         static_cast<std::size_t>(messages_count) };
+            for (auto* incoming_message : received_messages) {
+                connection_metadata_.connection_id = incoming_message->m_conn;
+                network_event_dispatcher->ProcessNetworkMessage(
+                  connection_metadata_,
+                  NetworkMessageView{ { static_cast<const char*>(incoming_message->m_pData),
+                                        static_cast<std::size_t>(incoming_message->m_cbSize) } });
+            }
+            for (auto* incoming_message : received_messages) {
+                incoming_message->Release();
+            }
+
+            if (messages_count < RECEIVE_MESSAGES_BATCH_SIZE) {
+                return;
+            }
         }
     }
 
@@ -86,6 +94,8 @@ public:
     }
 
 private:
+    static constexpr int RECEIVE_MESSAGES_BATCH_SIZE = 64;
+
     static int ToSendFlag(DeliveryMode delivery_mode)
     {
         return delivery_mode == DeliveryMode::Reliable ? GNS::nSteamNetworkingSend::Reliable
@@ -94,5 +104,11 @@ private:
 
     GNS::ISteamNetworkingSockets* interface_;
     GNS::HSteamNetConnection connection_handle_;
+
+    std::array<GNS::ISteamNetworkingMessage*, RECEIVE_MESSAGES_BATCH_SIZE> incoming_messages_{};
+    ConnectionMetadata connection_metadata_{
+        .connection_id = 0,
+        .send_message_to_connection = [](const NetworkMessage& /*message*/) {}
+    };
 };
 } // namespace Soldank
@@ -1,9 +1,14 @@
 module;
 
 #include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <memory>
 #include <optional>
+#include <span>
+#include <vector>
 
 export module Networking.NetworkClientSession;
 
@@ -12,8 +17,10 @@ import Extern.Glm;
 import ClientState;
 import Networking.INetworkingClient;
 import Networking.InputApplicationTimeline;
+import Networking.SoldierStateApplication;
 
 import Shared.Core.IWorld;
+import Shared.Core.Config.Config;
 import Shared.Core.State.StateManager;
 import Shared.Core.Entities.Soldier;
 
@@ -21,6 +28,7 @@ import Shared.Networking.NetworkEventDispatcher;
 import Shared.Networking.NetworkEvent;
 import Shared.Networking.NetworkPackets;
 import Shared.Networking.DeliveryMode;
+import Shared.Networking.SoldierInputCodec;
 
 import Extern.Spdlog;
 
@@ -45,6 +53,7 @@ public:
         networking_client_.SetLag(client_state_.network.network_lag);
         networking_client_.Update(network_event_dispatcher_);
         UpdateTargetInputDelay();
+        UpdateRemoteSoldiers();
 
         if ((world_.GetStateManager()->GetGameTick() % 60 == 0)) {
             SendPingCheck();
@@ -78,6 +87,7 @@ public:
             .input_sequence_id = input_sequence_id_,
             .client_tick = client_tick,
             .apply_server_tick = *apply_server_tick,
+            .view_server_tick = GetViewServerTick(*apply_server_tick),
             .position_x = world_.GetSoldier(soldier_id).particle.position.x,
             .position_y = world_.GetSoldier(soldier_id).particle.position.y,
             .mouse_map_position_x = mouse_map_position.x,
@@ -93,7 +103,8 @@ public:
             client_state_.network.prediction_inputs.push_back(update_soldier_state_packet);
         }
         networking_client_.SendNetworkMessage(
-          { NetworkEvent::SoldierInput, update_soldier_state_packet }, DeliveryMode::Unreliable);
+          SoldierInputCodec::Encode(GetInputsToSend(update_soldier_state_packet)),
+          DeliveryMode::Unreliable);
     }
 
     void StorePredictedSoldierSnapshot(std::uint8_t soldier_id)
@@ -120,6 +131,80 @@ public:
     }
 
 private:
+    // The newest inputs not acknowledged by the server are sent along with the current one, so
+    // a single lost datagram does not make the server miss an input. Acknowledgements are only
+    // tracked with server reconciliation enabled, otherwise just the current input is sent.
+    std::span<const SoldierInputPacket> GetInputsToSend(const SoldierInputPacket& current_input)
+    {
+        const auto& pending_inputs = client_state_.network.pending_inputs;
+        if (!client_state_.network.server_reconciliation || pending_inputs.empty()) {
+            inputs_to_send_.assign(1, current_input);
+            return inputs_to_send_;
+        }
+
+        const auto inputs_to_send_count =
+          std::min(pending_inputs.size(), MAX_SOLDIER_INPUTS_PER_MESSAGE);
+        inputs_to_send_.assign(
+          std::prev(pending_inputs.end(), static_cast<std::ptrdiff_t>(inputs_to_send_count)),
+          pending_inputs.end());
+        return inputs_to_send_;
+    }
+
+    // Remote soldiers played back from the interpolation buffer are drawn as they were at the
+    // playback tick. Without the buffer they are drawn as soon as their states arrive and only a
+    // late input gets rewound.
+    std::uint32_t GetViewServerTick(std::uint32_t apply_server_tick) const
+    {
+        if (!client_state_.network.remote_soldiers_interpolation) {
+            return apply_server_tick;
+        }
+
+        return client_state_.network.remote_soldier_snapshots.GetPlaybackTick().value_or(
+          apply_server_tick);
+    }
+
+    void UpdateRemoteSoldiers()
+    {
+        if (!client_state_.network.remote_soldiers_interpolation) {
+            return;
+        }
+
+        auto& remote_soldier_snapshots = client_state_.network.remote_soldier_snapshots;
+        const auto playback_tick = remote_soldier_snapshots.AdvancePlaybackTick();
+        if (!playback_tick.has_value()) {
+            return;
+        }
+
+        for (std::uint8_t soldier_id = 0; soldier_id < Config::MAX_PLAYERS; ++soldier_id) {
+            if (client_state_.client_soldier_id == soldier_id) {
+                continue;
+            }
+            const Soldier& soldier = world_.GetSoldier(soldier_id);
+            auto& applied_server_tick = applied_remote_soldier_server_ticks_.at(soldier_id);
+            if (!soldier.active) {
+                remote_soldier_snapshots.Clear(soldier_id);
+                applied_server_tick.reset();
+                continue;
+            }
+
+            auto soldier_state = remote_soldier_snapshots.Sample(soldier_id, *playback_tick);
+            if (!soldier_state.has_value()) {
+                continue;
+            }
+            // The renderer blends from the previously played back position
+            soldier_state->old_position_x = soldier.particle.position.x;
+            soldier_state->old_position_y = soldier.particle.position.y;
+            // The full state is applied once per received state, until the playback reaches the
+            // next one only what is drawn moves
+            if (applied_server_tick != soldier_state->server_tick) {
+                ApplySoldierState(world_, *soldier_state);
+                applied_server_tick = soldier_state->server_tick;
+            } else {
+                ApplySoldierPose(world_, *soldier_state);
+            }
+        }
+    }
+
     void UpdateTargetInputDelay()
     {
         const auto completed_round_trip_time =
@@ -158,5 +243,9 @@ private:
     std::optional<std::uint32_t> last_sent_input_sequence_id_;
     std::optional<std::uint32_t> last_sent_input_client_tick_;
     std::optional<std::uint32_t> last_sent_input_apply_server_tick_;
+    std::vector<SoldierInputPacket> inputs_to_send_;
+    // Server tick of the received state each remote soldier's full state was last applied from
+    std::array<std::optional<std::uint32_t>, Config::MAX_PLAYERS>
+      applied_remote_soldier_server_ticks_;
 };
 } // namespace Soldank
@@ -0,0 +1,266 @@
+module;
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+export module Networking.SoldierSnapshotInterpolation;
+
+import Shared.Core.Config.Config;
+import Shared.Networking.NetworkPackets;
+import Shared.Core.Utility.SerialNumber;
+
+export namespace Soldank
+{
+// Ring of the newest states received for one soldier, ordered by server tick
+class SoldierSnapshotBuffer
+{
+public:
+    static constexpr std::size_t CAPACITY = 32;
+
+    // States that are not newer than the newest stored state are ignored
+    bool Push(const SoldierStatePacket& soldier_state)
+    {
+        if (count_ > 0 &&
+            !IsSerialNumberNewer(soldier_state.server_tick, GetNewest().server_tick)) {
+            return false;
+        }
+
+        snapshots_.at((first_ + count_) % CAPACITY) = soldier_state;
+        if (count_ < CAPACITY) {
+            ++count_;
+        } else {
+            first_ = (first_ + 1) % CAPACITY;
+        }
+        return true;
+    }
+
+    // Returns the state at the given server tick. Continuous values (positions, velocity, aim) and
+    // the frames of animations that keep playing are interpolated between the states received
+    // around it, discrete values (animation types, stance, weapon) are taken from the older one,
+    // and so is server_tick, so a new older state can be told apart from the previous one. The
+    // newest state is held when the tick is past it.
+    std::optional<SoldierStatePacket> Sample(std::uint32_t server_tick) const
+    {
+        std::optional<std::size_t> from_index;
+        for (std::size_t i = count_; i > 0; --i) {
+            if (!IsSerialNumberNewer(GetAt(i - 1).server_tick, server_tick)) {
+                from_index = i - 1;
+                break;
+            }
+        }
+        if (!from_index.has_value()) {
+            return std::nullopt;
+        }
+
+        const SoldierStatePacket& from = GetAt(*from_index);
+        if (*from_index + 1 == count_ || from.server_tick == server_tick) {
+            return from;
+        }
+
+        const SoldierStatePacket& to = GetAt(*from_index + 1);
+        const float dx = to.position_x - from.position_x;
+        const float dy = to.position_y - from.position_y;
+        if (dx * dx + dy * dy > MAX_INTERPOLATION_DISTANCE * MAX_INTERPOLATION_DISTANCE) {
+            // Respawns and teleports are not smoothed out
+            return from;
+        }
+
+        const float alpha = static_cast<float>(SerialNumberForwardDistance(from.server_tick,
+                                                                           server_tick)) /
+                            static_cast<float>(SerialNumberForwardDistance(from.server_tick,
+                                                                           to.server_tick));
+        const auto lerp = [alpha](float a, float b) { return std::lerp(a, b, alpha); };
+
+        SoldierStatePacket sampled = from;
+        sampled.position_x = lerp(from.position_x, to.position_x);
+        sampled.position_y = lerp(from.position_y, to.position_y);
+        sampled.old_position_x = lerp(from.old_position_x, to.old_position_x);
+        sampled.old_position_y = lerp(from.old_position_y, to.old_position_y);
+        sampled.velocity_x = lerp(from.velocity_x, to.velocity_x);
+        sampled.velocity_y = lerp(from.velocity_y, to.velocity_y);
+        sampled.mouse_map_position_x = lerp(from.mouse_map_position_x, to.mouse_map_position_x);
+        sampled.mouse_map_position_y = lerp(from.mouse_map_position_y, to.mouse_map_position_y);
+        if (to.body_animation_type == from.body_animation_type &&
+            to.body_animation_frame >= from.body_animation_frame) {
+            sampled.body_animation_frame = LerpFrame(from.body_animation_frame,
+                                                     to.body_animation_frame,
+                                                     alpha);
+        }
+        if (to.legs_animation_type == from.legs_animation_type &&
+            to.legs_animation_frame >= from.legs_animation_frame) {
+            sampled.legs_animation_frame = LerpFrame(from.legs_animation_frame,
+                                                     to.legs_animation_frame,
+                                                     alpha);
+        }
+        return sampled;
+    }
+
+    std::optional<std::uint32_t> GetNewestServerTick() const
+    {
+        if (count_ == 0) {
+            return std::nullopt;
+        }
+        return GetNewest().server_tick;
+    }
+
+    std::size_t GetSize() const { return count_; }
+
+    void Clear()
+    {
+        first_ = 0;
+        count_ = 0;
+    }
+
+private:
+    static constexpr float MAX_INTERPOLATION_DISTANCE = 100.0F;
+
+    static std::uint32_t LerpFrame(std::uint32_t from, std::uint32_t to, float alpha)
+    {
+        return from + static_cast<std::uint32_t>(
+                        std::floor(static_cast<float>(to - from) * alpha));
+    }
+
+    const SoldierStatePacket& GetAt(std::size_t index) const
+    {
+        return snapshots_.at((first_ + index) % CAPACITY);
+    }
+
+    const SoldierStatePacket& GetNewest() const { return GetAt(count_ - 1); }
+
+    std::array<SoldierStatePacket, CAPACITY> snapshots_{};
+    std::size_t first_ = 0;
+    std::size_t count_ = 0;
+};
+
+// Jitter buffer for the soldiers that are not controlled by this client. Their states are played
+// back behind the newest received server tick, so a state that arrives a bit late is still in the
+// buffer when it is needed and the soldier does not have to be simulated locally in the meantime.
+// The delay covers the longest gap seen lately between newer states arriving, and at least the
+// snapshot interval the server announces, plus a margin. So it follows both the rate the server
+// sends states at, before the longer gaps are even seen, and the jitter of the link.
+class SoldierSnapshotInterpolation
+{
+public:
+    void Push(const SoldierStatePacket& soldier_state)
+    {
+        if (soldier_state.player_id >= Config::MAX_PLAYERS) {
+            return;
+        }
+        if (!buffers_.at(soldier_state.player_id).Push(soldier_state)) {
+            return;
+        }
+        if (!newest_server_tick_.has_value()) {
+            newest_server_tick_ = soldier_state.server_tick;
+            snapshot_interval_ticks_ = soldier_state.snapshot_interval_ticks;
+            ticks_since_newest_state_ = 0;
+        } else if (IsSerialNumberNewer(soldier_state.server_tick, *newest_server_tick_)) {
+            newest_server_tick_ = soldier_state.server_tick;
+            snapshot_interval_ticks_ = soldier_state.snapshot_interval_ticks;
+            arrival_gaps_.at(next_arrival_gap_) = ticks_since_newest_state_;
+            next_arrival_gap_ = (next_arrival_gap_ + 1) % ARRIVAL_GAPS_COUNT;
+            arrival_gaps_count_ = std::min(arrival_gaps_count_ + 1, ARRIVAL_GAPS_COUNT);
+            ticks_since_newest_state_ = 0;
+        }
+    }
+
+    // Called once per client tick. The playback advances by one tick and is only resynchronized
+    // when it drifted too far from the delayed newest server tick, so small jitter in the arrival
+    // times does not make the remote soldiers stutter. The delay follows the measured one a tick at
+    // a time, the playback holds still for a tick to lengthen it and skips a tick to shorten it.
+    std::optional<std::uint32_t> AdvancePlaybackTick()
+    {
+        ++ticks_since_newest_state_;
+        if (!newest_server_tick_.has_value()) {
+            return std::nullopt;
+        }
+
+        const std::uint32_t measured_delay_ticks = GetMeasuredDelayTicks();
+        if (!playback_tick_.has_value()) {
+            delay_ticks_ = measured_delay_ticks;
+            playback_tick_ = *newest_server_tick_ - delay_ticks_;
+            return playback_tick_;
+        }
+
+        if (delay_ticks_ < measured_delay_ticks) {
+            ++delay_ticks_;
+        } else {
+            if (delay_ticks_ > measured_delay_ticks) {
+                --delay_ticks_;
+                ++*playback_tick_;
+            }
+            ++*playback_tick_;
+        }
+
+        const std::uint32_t target_tick = *newest_server_tick_ - delay_ticks_;
+        const std::int64_t drift = SerialNumberSignedDistance(target_tick, *playback_tick_);
+        if (drift > static_cast<std::int64_t>(delay_ticks_) ||
+            -drift > static_cast<std::int64_t>(delay_ticks_ + MAX_PLAYBACK_LAG_TICKS)) {
+            playback_tick_ = target_tick;
+            ++resynchronization_count_;
+        }
+        return playback_tick_;
+    }
+
+    std::optional<SoldierStatePacket> Sample(std::uint8_t soldier_id,
+                                             std::uint32_t server_tick) const
+    {
+        if (soldier_id >= Config::MAX_PLAYERS) {
+            return std::nullopt;
+        }
+        return buffers_.at(soldier_id).Sample(server_tick);
+    }
+
+    void Clear(std::uint8_t soldier_id)
+    {
+        if (soldier_id < Config::MAX_PLAYERS) {
+            buffers_.at(soldier_id).Clear();
+        }
+    }
+
+    std::optional<std::uint32_t> GetPlaybackTick() const { return playback_tick_; }
+    std::uint32_t GetDelayTicks() const { return delay_ticks_; }
+    unsigned int GetResynchronizationCount() const { return resynchronization_count_; }
+
+private:
+    static constexpr std::uint32_t MAX_PLAYBACK_LAG_TICKS = 8;
+    // Used until the gaps between states arriving were measured
+    static constexpr std::uint32_t DEFAULT_DELAY_TICKS = 3;
+    static constexpr std::uint32_t MIN_DELAY_TICKS = 2;
+    static constexpr std::uint32_t MAX_DELAY_TICKS = 12;
+    static constexpr std::uint32_t JITTER_MARGIN_TICKS = 1;
+    static constexpr std::size_t ARRIVAL_GAPS_COUNT = 32;
+
+    std::uint32_t GetMeasuredDelayTicks() const
+    {
+        if (arrival_gaps_count_ == 0) {
+            return std::max(DEFAULT_DELAY_TICKS, snapshot_interval_ticks_ + JITTER_MARGIN_TICKS);
+        }
+
+        const std::uint32_t longest_arrival_gap = *std::max_element(
+          arrival_gaps_.begin(),
+          arrival_gaps_.begin() + static_cast<std::ptrdiff_t>(arrival_gaps_count_));
+        return std::clamp(std::max(longest_arrival_gap, snapshot_interval_ticks_) +
+                            JITTER_MARGIN_TICKS,
+                          MIN_DELAY_TICKS,
+                          MAX_DELAY_TICKS);
+    }
+
+    std::array<SoldierSnapshotBuffer, Config::MAX_PLAYERS> buffers_;
+    std::optional<std::uint32_t> newest_server_tick_;
+    std::optional<std::uint32_t> playback_tick_;
+    std::uint32_t delay_ticks_ = DEFAULT_DELAY_TICKS;
+    // Announced with the newest state
+    std::uint32_t snapshot_interval_ticks_ = 0;
+    unsigned int resynchronization_count_ = 0;
+
+    // Client ticks between newer states arriving, the latest ARRIVAL_GAPS_COUNT of them
+    std::array<std::uint32_t, ARRIVAL_GAPS_COUNT> arrival_gaps_{};
+    std::size_t next_arrival_gap_ = 0;
+    std::size_t arrival_gaps_count_ = 0;
+    std::uint32_t ticks_since_newest_state_ = 0;
+};
+} // namespace Soldank
@@ -0,0 +1,133 @@
+module;
+
+#include <cstdint>
+
+export module Networking.SoldierStateApplication;
+
+import Extern.Glm;
+
+import Shared.Core.IWorld;
+import Shared.Core.Animations;
+import Shared.Core.Entities.Soldier;
+import Shared.Core.Physics.SoldierSkeletonPhysics;
+import Shared.Networking.NetworkPackets;
+
+export namespace Soldank
+{
+// Overwrites the soldier's replicated state with the received (or interpolated) server state
+void ApplySoldierState(IWorld& world, const SoldierStatePacket& soldier_state)
+{
+    const std::uint8_t soldier_id = soldier_state.player_id;
+    const glm::vec2 soldier_force = { soldier_state.force_x, soldier_state.force_y };
+
+    world.GetStateManager()->TransformSoldier(soldier_id, [&](auto& soldier) {
+        soldier.particle.old_position = { soldier_state.old_position_x,
+                                          soldier_state.old_position_y };
+        soldier.particle.position = { soldier_state.position_x, soldier_state.position_y };
+        soldier.particle.SetVelocity({ soldier_state.velocity_x, soldier_state.velocity_y });
+        soldier.particle.SetForce(soldier_force);
+
+        soldier.on_ground = soldier_state.on_ground;
+        soldier.on_ground_for_law = soldier_state.on_ground_for_law;
+        soldier.on_ground_last_frame = soldier_state.on_ground_last_frame;
+        soldier.on_ground_permanent = soldier_state.on_ground_permanent;
+        soldier.old_direction = soldier_state.old_direction;
+
+        soldier.stance = soldier_state.stance;
+
+        // TODO: make mouse position not game width and game height dependent
+        soldier.game_width = 640.0;
+        soldier.game_height = 480.0;
+        world.GetStateManager()->ChangeSoldierMouseMapPosition(
+          soldier_id, { soldier_state.mouse_map_position_x, soldier_state.mouse_map_position_y });
+
+        if ((float)soldier.control.mouse_aim_x >= soldier.particle.position.x) {
+            soldier.direction = 1;
+        } else {
+            soldier.direction = -1;
+        }
+
+        // TODO: there is a visual bug with feet when another soldier is using jets and going
+        // backwards
+        soldier.control.jets = soldier_state.using_jets;
+        soldier.jets_count = soldier_state.jets_count;
+
+        soldier.active_weapon = soldier_state.active_weapon;
+
+        if (soldier.body_animation->GetType() != soldier_state.body_animation_type) {
+            AnimationState::ExitParams body_exit_params{ false };
+            soldier.body_animation->Exit(body_exit_params);
+            if (body_exit_params.should_throw_active_weapon) {
+                world.GetPhysicsEvents().soldier_throws_active_weapon.Notify(soldier);
+            }
+            soldier.body_animation = world.GetBodyAnimationState(soldier_state.body_animation_type);
+            AnimationState::EnterParams body_enter_params{
+                soldier.on_ground,         soldier.direction, soldier.particle.GetForce(),
+                soldier.grenade_can_throw, soldier.weapons,   soldier.active_weapon
+            };
+            soldier.body_animation->Enter(body_enter_params);
+            soldier.grenade_can_throw = body_enter_params.grenade_can_throw;
+        }
+        soldier.body_animation->SetFrame(soldier_state.body_animation_frame);
+        soldier.body_animation->SetSpeed(soldier_state.body_animation_speed);
+        soldier.body_animation->SetCount(soldier_state.body_animation_count);
+
+        if (soldier.legs_animation->GetType() != soldier_state.legs_animation_type) {
+            AnimationState::ExitParams legs_exit_params{ false };
+            soldier.legs_animation->Exit(legs_exit_params);
+            if (legs_exit_params.should_throw_active_weapon) {
+                world.GetPhysicsEvents().soldier_throws_active_weapon.Notify(soldier);
+            }
+            soldier.legs_animation = world.GetLegsAnimationState(soldier_state.legs_animation_type);
+            AnimationState::EnterParams legs_enter_params{
+                soldier.on_ground,         soldier.direction, soldier.particle.GetForce(),
+                soldier.grenade_can_throw, soldier.weapons,   soldier.active_weapon
+            };
+            soldier.legs_animation->Enter(legs_enter_params);
+            soldier.grenade_can_throw = legs_enter_params.grenade_can_throw;
+        }
+        soldier.legs_animation->SetFrame(soldier_state.legs_animation_frame);
+        soldier.legs_animation->SetSpeed(soldier_state.legs_animation_speed);
+        soldier.legs_animation->SetCount(soldier_state.legs_animation_count);
+
+        // The snapshot's force is authoritative. Animation entry may calculate a temporary
+        // transition force, but it must not overwrite the replicated simulation state.
+        soldier.particle.SetForce(soldier_force);
+
+        RepositionSoldierSkeletonParts(soldier);
+
+        // TODO: Figure out if the below section is needed, I have a hunch that it is not
+        if (soldier.dead_meat) {
+            soldier.skeleton->DoVerletTimestep();
+            soldier.particle.position = soldier.skeleton->GetPos(12);
+            // CheckSkeletonOutOfBounds;
+        }
+    });
+}
+
+// Moves a soldier whose full state was already applied from the same received state: only what is
+// drawn changes, which is the position, the aim and the animation frames
+void ApplySoldierPose(IWorld& world, const SoldierStatePacket& soldier_state)
+{
+    const std::uint8_t soldier_id = soldier_state.player_id;
+
+    world.GetStateManager()->TransformSoldier(soldier_id, [&](auto& soldier) {
+        soldier.particle.old_position = { soldier_state.old_position_x,
+                                          soldier_state.old_position_y };
+        soldier.particle.position = { soldier_state.position_x, soldier_state.position_y };
+
+        world.GetStateManager()->ChangeSoldierMouseMapPosition(
+          soldier_id, { soldier_state.mouse_map_position_x, soldier_state.mouse_map_position_y });
+        if ((float)soldier.control.mouse_aim_x >= soldier.particle.position.x) {
+            soldier.direction = 1;
+        } else {
+            soldier.direction = -1;
+        }
+
+        soldier.body_animation->SetFrame(soldier_state.body_animation_frame);
+        soldier.legs_animation->SetFrame(soldier_state.legs_animation_frame);
+
+        RepositionSoldierSkeletonParts(soldier);
+    });
+}
+} // namespace Soldank
@@ -4,6 +4,7 @@ module;
 #include <list>
 #include <chrono>
 #include <cstdint>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -13,6 +14,7 @@ import Extern.Glm;
 
 import Camera;
 import MapEditorState;
+import Networking.SoldierSnapshotInterpolation;
 
 import Shared.Networking.PingTimer;
 import Shared.Networking.NetworkPackets;
@@ -60,6 +62,10 @@ struct ClientNetworkState
     bool server_reconciliation = true;
     bool client_side_prediction = true;
     bool objects_interpolation = true;
+    // Soldiers of other players are played back from the received states with a delay measured
+    // from their arrival instead of being overwritten by every state as it arrives
+    bool remote_soldiers_interpolation = true;
+    SoldierSnapshotInterpolation remote_soldier_snapshots;
     bool draw_server_pov_client_pos;
 
     std::optional<std::int64_t> server_tick_offset;
@@ -70,15 +76,23 @@ struct ClientNetworkState
 
     int network_lag;
 
-#ifndef NDEBUG
     float last_local_correction_distance = 0.0F;
     float maximum_local_correction_distance = 0.0F;
     unsigned int local_correction_count = 0;
-#endif
 
     PingTimer ping_timer;
 };
 
+// Frame profiler window state kept between frames
+struct FrameProfilerWindowState
+{
+    std::string export_status;
+    // Reused by the frame durations graph every frame
+    std::vector<float> frame_durations_ms;
+    // The newest frame is shown unless a frame was picked
+    std::optional<std::uint64_t> picked_frame_number;
+};
+
 struct ClientDebugRenderState
 {
     bool draw_colliding_polygons = false;
@@ -90,6 +104,7 @@ struct ClientDebugRenderState
     std::vector<unsigned int> colliding_polygon_ids;
 
     bool is_game_debug_interface_enabled = false;
+    FrameProfilerWindowState frame_profiler_window;
 };
 
 struct ClientWorldRenderOptions
@@ -97,6 +112,9 @@ struct ClientWorldRenderOptions
     bool draw_background = true;
     bool draw_polygons = true;
     bool draw_sceneries = true;
+    // Draw soldiers, items and bullets between the snapshots published after the last two ticks
+    // instead of from the live simulation state. Drawing still runs on the simulation's thread.
+    bool render_from_snapshots = false;
 
     glm::vec2 current_polygon_texture_dimensions;
 };
@@ -6,6 +6,7 @@ export module RenderPipeline;
 
 import Application.ClientModes;
 import ClientState;
+import RenderSnapshot;
 import Scene;
 
 import Shared.Core.State.StateManager;
@@ -22,6 +23,7 @@ public:
     ~RenderPipeline();
 
     void Render(const StateManager& game_state_manager,
+                const RenderSnapshotHistory& render_snapshots,
                 ClientState& client_state,
                 ClientMode client_mode,
                 EditorMode editor_mode,
@@ -30,14 +32,16 @@ public:
     {
         if (client_mode == ClientMode::MapEditor) {
             if (editor_mode == EditorMode::PlayTest) {
-                scene_.RenderPlayTest(game_state_manager, client_state, frame_percent, fps);
+                scene_.RenderPlayTest(
+                  game_state_manager, render_snapshots, client_state, frame_percent, fps);
             } else {
-                scene_.RenderEditor(game_state_manager, client_state, frame_percent, fps);
+                scene_.RenderEditor(
+                  game_state_manager, render_snapshots, client_state, frame_percent, fps);
             }
             return;
         }
 
-        scene_.RenderGame(game_state_manager, client_state, frame_percent, fps);
+        scene_.RenderGame(game_state_manager, render_snapshots, client_state, frame_percent, fps);
     }
 
 private:
@@ -0,0 +1,301 @@
+module;
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+export module RenderSnapshot;
+
+import Extern.Glm;
+
+import SoldierSkinning;
+
+import Shared.Core.Animations;
+import Shared.Core.Entities.Bullet;
+import Shared.Core.Entities.Item;
+import Shared.Core.Entities.Soldier;
+import Shared.Core.Math.Calc;
+import Shared.Core.State.StateManager;
+import Shared.Core.Types.BulletType;
+import Shared.Core.Types.ItemType;
+import Shared.Core.Types.WeaponType;
+
+export namespace Soldank
+{
+constexpr std::size_t ITEM_RENDER_POSITIONS_COUNT = 4;
+
+// Entities that move further than this in a tick were placed somewhere else (respawned, picked up
+// a flag...), they are drawn where they are now instead of sliding across the map
+constexpr float MAX_RENDER_INTERPOLATION_DISTANCE = 100.0F;
+
+// What drawing a soldier needs of it, see SoldierRenderer
+struct SoldierRenderState
+{
+    std::uint8_t id;
+    std::array<glm::vec2, SOLDIER_SKELETON_POSITIONS_COUNT> skeleton_positions;
+    std::int8_t direction;
+    AnimationType body_animation_type;
+    unsigned int body_animation_frame;
+    AnimationType legs_animation_type;
+    unsigned int legs_animation_frame;
+    bool dead_meat;
+    bool using_jets;
+    bool has_vest;
+    bool has_cigar;
+    std::uint8_t fired;
+    std::uint8_t alpha;
+    std::uint8_t visible;
+    float health;
+    WeaponType primary_weapon_type;
+    std::uint8_t primary_weapon_ammo_count;
+    std::uint16_t primary_weapon_reload_time_count;
+    std::uint16_t primary_weapon_clip_in_time;
+    std::uint16_t primary_weapon_clip_out_time;
+    WeaponType secondary_weapon_type;
+    WeaponType tertiary_weapon_type;
+    std::uint8_t tertiary_weapon_ammo_count;
+};
+
+// What drawing an item needs of it, see ItemRenderer
+struct ItemRenderState
+{
+    std::uint8_t id;
+    ItemType style;
+    std::int32_t time_out;
+    bool flipped;
+    bool in_base;
+    // Skeleton positions, the first one is the skeleton's particle 1
+    std::array<glm::vec2, ITEM_RENDER_POSITIONS_COUNT> positions;
+};
+
+// What drawing a bullet needs of it, see BulletRenderer
+struct BulletRenderState
+{
+    // Slot of the bullet in the state, a slot is reused once its bullet is gone
+    std::uint16_t id;
+    BulletType style;
+    WeaponType weapon;
+    glm::vec2 position;
+    glm::vec2 velocity;
+    glm::vec2 initial_position;
+    float timeout;
+    float hit_multiply;
+};
+
+// Skeleton positions are left out, the live state and the snapshots interpolate them differently
+SoldierRenderState CaptureSoldierRenderState(const Soldier& soldier)
+{
+    const auto& primary_weapon = soldier.weapons[soldier.active_weapon];
+    const auto& secondary_weapon = soldier.weapons[(soldier.active_weapon + 1) % 2];
+    const auto& tertiary_weapon = soldier.weapons[2];
+    return {
+        .id = soldier.id,
+        .skeleton_positions = {},
+        .direction = soldier.direction,
+        .body_animation_type = soldier.body_animation->GetType(),
+        .body_animation_frame = soldier.body_animation->GetFrame(),
+        .legs_animation_type = soldier.legs_animation->GetType(),
+        .legs_animation_frame = soldier.legs_animation->GetFrame(),
+        .dead_meat = soldier.dead_meat,
+        .using_jets = soldier.control.jets && soldier.jets_count > 0,
+        .has_vest = soldier.vest > 0.0F,
+        .has_cigar = soldier.has_cigar != 0,
+        .fired = soldier.fired,
+        .alpha = soldier.alpha,
+        .visible = soldier.visible,
+        .health = soldier.health,
+        .primary_weapon_type = primary_weapon.GetWeaponParameters().kind,
+        .primary_weapon_ammo_count = primary_weapon.GetAmmoCount(),
+        .primary_weapon_reload_time_count = primary_weapon.GetReloadTimeCount(),
+        .primary_weapon_clip_in_time = primary_weapon.GetClipInTime(),
+        .primary_weapon_clip_out_time = primary_weapon.GetClipOutTime(),
+        .secondary_weapon_type = secondary_weapon.GetWeaponParameters().kind,
+        .tertiary_weapon_type = tertiary_weapon.GetWeaponParameters().kind,
+        .tertiary_weapon_ammo_count = tertiary_weapon.GetAmmoCount(),
+    };
+}
+
+// Positions are left out, the live state and the snapshots interpolate them differently
+ItemRenderState CaptureItemRenderState(const Item& item)
+{
+    return { .id = item.id,
+             .style = item.style,
+             .time_out = item.time_out,
+             .flipped = item.flipped,
+             .in_base = item.in_base,
+             .positions = {} };
+}
+
+// Values after the tick, the live state interpolates them from the ones before it instead
+BulletRenderState CaptureBulletRenderState(std::uint16_t slot, const Bullet& bullet)
+{
+    return { .id = slot,
+             .style = bullet.style,
+             .weapon = bullet.weapon,
+             .position = bullet.particle.position,
+             .velocity = bullet.particle.velocity_,
+             .initial_position = bullet.initial_position,
+             .timeout = (float)bullet.timeout,
+             .hit_multiply = bullet.hit_multiply };
+}
+
+SoldierRenderState InterpolateRenderState(const SoldierRenderState& previous,
+                                          const SoldierRenderState& current,
+                                          float frame_percent)
+{
+    if (Calc::Vec2Length(current.skeleton_positions[0] - previous.skeleton_positions[0]) >
+        MAX_RENDER_INTERPOLATION_DISTANCE) {
+        return current;
+    }
+
+    SoldierRenderState interpolated = current;
+    for (std::size_t i = 0; i < SOLDIER_SKELETON_POSITIONS_COUNT; ++i) {
+        interpolated.skeleton_positions[i] = Calc::Lerp(
+          previous.skeleton_positions[i], current.skeleton_positions[i], frame_percent);
+    }
+    return interpolated;
+}
+
+ItemRenderState InterpolateRenderState(const ItemRenderState& previous,
+                                       const ItemRenderState& current,
+                                       float frame_percent)
+{
+    if (previous.style != current.style ||
+        Calc::Vec2Length(current.positions[0] - previous.positions[0]) >
+          MAX_RENDER_INTERPOLATION_DISTANCE) {
+        return current;
+    }
+
+    ItemRenderState interpolated = current;
+    for (std::size_t i = 0; i < ITEM_RENDER_POSITIONS_COUNT; ++i) {
+        interpolated.positions[i] =
+          Calc::Lerp(previous.positions[i], current.positions[i], frame_percent);
+    }
+    return interpolated;
+}
+
+BulletRenderState InterpolateRenderState(const BulletRenderState& previous,
+                                         const BulletRenderState& current,
+                                         float frame_percent)
+{
+    // A bullet that took over the slot is drawn where it was fired from
+    if (previous.initial_position != current.initial_position || previous.style != current.style) {
+        return current;
+    }
+
+    BulletRenderState interpolated = current;
+    interpolated.position = Calc::Lerp(previous.position, current.position, frame_percent);
+    interpolated.timeout = Calc::Lerp(previous.timeout, current.timeout, frame_percent);
+    interpolated.hit_multiply =
+      Calc::Lerp(previous.hit_multiply, current.hit_multiply, frame_percent);
+    return interpolated;
+}
+
+// What the world looks like after a tick, copied out of the simulation in the compact form the
+// renderers draw from. Every list is sorted by id.
+struct RenderSnapshot
+{
+    unsigned int game_tick = 0;
+    std::vector<SoldierRenderState> soldiers;
+    std::vector<ItemRenderState> items;
+    std::vector<BulletRenderState> bullets;
+};
+
+// Reuses the snapshot's containers, so capturing doesn't allocate once they are large enough
+void CaptureRenderSnapshot(const StateManager& state_manager, RenderSnapshot& render_snapshot)
+{
+    render_snapshot.game_tick = state_manager.GetGameTick();
+
+    render_snapshot.soldiers.clear();
+    state_manager.ForEachSoldier([&](const Soldier& soldier) {
+        auto& soldier_render_state =
+          render_snapshot.soldiers.emplace_back(CaptureSoldierRenderState(soldier));
+        const auto& particles = soldier.skeleton->GetParticles();
+        for (std::size_t i = 0; i < SOLDIER_SKELETON_POSITIONS_COUNT && i < particles.size();
+             ++i) {
+            soldier_render_state.skeleton_positions[i] = particles[i].position;
+        }
+    });
+    std::ranges::sort(render_snapshot.soldiers, {}, &SoldierRenderState::id);
+
+    render_snapshot.items.clear();
+    state_manager.ForEachItem([&](const Item& item) {
+        auto& item_render_state = render_snapshot.items.emplace_back(CaptureItemRenderState(item));
+        const auto& particles = item.skeleton->GetParticles();
+        for (std::size_t i = 0; i < ITEM_RENDER_POSITIONS_COUNT && i < particles.size(); ++i) {
+            item_render_state.positions[i] = particles[i].position;
+        }
+    });
+    std::ranges::sort(render_snapshot.items, {}, &ItemRenderState::id);
+
+    render_snapshot.bullets.clear();
+    for (std::size_t slot = 0; slot < state_manager.GetBulletSlotsCount(); ++slot) {
+        const Bullet& bullet = state_manager.GetBulletSlot(slot);
+        if (bullet.active) {
+            render_snapshot.bullets.push_back(
+              CaptureBulletRenderState((std::uint16_t)slot, bullet));
+        }
+    }
+}
+
+// The two latest snapshots, a frame is drawn between them like the live state is drawn between
+// the positions before and after the last tick
+class RenderSnapshotHistory
+{
+public:
+    // The current snapshot becomes the previous one, the returned one is to be captured into.
+    // It is the snapshot from before the previous one, so its containers are reused.
+    RenderSnapshot& PushNew()
+    {
+        std::swap(previous_, current_);
+        return current_;
+    }
+
+    const RenderSnapshot& GetCurrent() const { return current_; }
+
+    // Entities without a previous state are drawn as they are in the current snapshot
+    template<typename TFunction>
+    void ForEachSoldier(float frame_percent, TFunction&& function) const
+    {
+        ForEachInterpolated(previous_.soldiers, current_.soldiers, frame_percent, function);
+    }
+
+    template<typename TFunction>
+    void ForEachItem(float frame_percent, TFunction&& function) const
+    {
+        ForEachInterpolated(previous_.items, current_.items, frame_percent, function);
+    }
+
+    template<typename TFunction>
+    void ForEachBullet(float frame_percent, TFunction&& function) const
+    {
+        ForEachInterpolated(previous_.bullets, current_.bullets, frame_percent, function);
+    }
+
+private:
+    template<typename TRenderState, typename TFunction>
+    static void ForEachInterpolated(const std::vector<TRenderState>& previous,
+                                    const std::vector<TRenderState>& current,
+                                    float frame_percent,
+                                    TFunction& function)
+    {
+        auto previous_it = previous.begin();
+        for (const auto& render_state : current) {
+            while (previous_it != previous.end() && previous_it->id < render_state.id) {
+                ++previous_it;
+            }
+            if (previous_it != previous.end() && previous_it->id == render_state.id) {
+                function(InterpolateRenderState(*previous_it, render_state, frame_percent));
+            } else {
+                function(render_state);
+            }
+        }
+    }
+
+    RenderSnapshot previous_;
+    RenderSnapshot current_;
+};
+} // namespace Soldank
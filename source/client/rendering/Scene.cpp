@@ -5,15 +5,19 @@ module;
 
 #include <array>
 #include <string>
+#include <string_view>
 #include <algorithm>
 #include <vector>
 #include <memory>
+#include <optional>
+#include <utility>
 
 export module Scene;
 
 import Extern.Glm;
 
 import Camera;
+import MapSpatialIndex;
 import ItemRenderer;
 import PolygonsRenderer;
 import DebugUI;
@@ -33,6 +37,10 @@ import LineRenderer;
 import CircleRenderer;
 import MapEditorScene;
 import MapEditorUI;
+import Renderer;
+import RenderQueue;
+import RenderSnapshot;
+import Rendering.Gpu.GpuTimer;
 
 import Shared.Core.State.StateManager;
 import Shared.Core.Entities.Item;
@@ -40,6 +48,8 @@ import Shared.Core.Types.ItemType;
 import Shared.Core.Entities.Soldier;
 import Shared.Core.Entities.Bullet;
 import Shared.Core.Math.Calc;
+import Shared.Core.Utility.Counters;
+import Shared.Core.Utility.FrameProfiler;
 
 export namespace Soldank
 {
@@ -50,18 +60,22 @@ public:
     ~Scene();
 
     void Render(const StateManager& game_state_manager,
+                const RenderSnapshotHistory& render_snapshots,
                 ClientState& client_state,
                 double frame_percent,
                 int fps);
     void RenderGame(const StateManager& game_state_manager,
+                    const RenderSnapshotHistory& render_snapshots,
                     ClientState& client_state,
                     double frame_percent,
                     int fps);
     void RenderEditor(const StateManager& game_state_manager,
+                      const RenderSnapshotHistory& render_snapshots,
                       ClientState& client_state,
                       double frame_percent,
                       int fps);
     void RenderPlayTest(const StateManager& game_state_manager,
+                        const RenderSnapshotHistory& render_snapshots,
                         ClientState& client_state,
                         double frame_percent,
                         int fps);
@@ -69,6 +83,9 @@ public:
     void RenderSoldiers(const StateManager& game_state_manager,
                         const ClientState& client_state,
                         double frame_percent);
+    void RenderSoldiers(const RenderSnapshotHistory& render_snapshots,
+                        const ClientState& client_state,
+                        double frame_percent);
 
     glm::vec2 GetTextureDimensions() const { return polygons_renderer_->GetTextureDimensions(); }
 
@@ -76,6 +93,7 @@ public:
 
 private:
     void RenderWorld(const StateManager& game_state_manager,
+                     const RenderSnapshotHistory& render_snapshots,
                      ClientState& client_state,
                      double frame_percent);
     void RenderDebugOverlay(const StateManager& game_state_manager,
@@ -91,6 +109,8 @@ private:
     std::unique_ptr<PolygonsRenderer> polygons_renderer_;
     PolygonOutlinesRenderer polygon_outlines_renderer_;
     SceneriesRenderer sceneries_renderer_;
+    MapSpatialIndex map_spatial_index_;
+    VisibleMapObjects visible_map_objects_;
     SoldierRenderer soldier_renderer_;
     CursorRenderer cursor_renderer_;
     GameHudRenderer game_hud_renderer_;
@@ -100,6 +120,9 @@ private:
     CircleRenderer circle_renderer_;
     ItemRenderer item_renderer_;
     MapEditorScene map_editor_scene_;
+    RenderQueue render_queue_;
+    RenderStateBinder render_state_binder_;
+    GpuTimer gpu_timer_;
 };
 } // namespace Soldank
 
@@ -112,11 +135,28 @@ Scene::Scene(const std::shared_ptr<StateManager>& game_state, ClientState& clien
                                            std::string(game_state->GetMap().GetTextureName())))
     , polygon_outlines_renderer_(game_state->GetMap(), { 1.0F, 1.0F, 1.0F, 1.0F })
     , sceneries_renderer_(game_state->GetMap())
+    , map_spatial_index_(game_state->GetMap())
     , soldier_renderer_(sprite_manager_)
     , cursor_renderer_(client_state)
     , bullet_renderer_(sprite_manager_)
     , item_renderer_(sprite_manager_)
     , map_editor_scene_(client_state, *game_state)
+    , render_state_binder_{
+        .use_shader = [](unsigned int shader_id) { glUseProgram(shader_id); },
+        .bind_texture = [](unsigned int texture_id) { Renderer::BindTexture(texture_id); },
+        // Every layer is a render pass of its own for the profiler
+        .begin_layer =
+          [this](RenderLayer layer) {
+              std::string_view layer_name = RENDER_LAYER_NAMES.at(std::to_underlying(layer));
+              GetFrameProfiler().BeginZone(layer_name);
+              gpu_timer_.Begin(GetFrameProfiler(), layer_name);
+          },
+        .end_layer =
+          [this](RenderLayer /*layer*/) {
+              gpu_timer_.End();
+              GetFrameProfiler().EndZone();
+          },
+    }
 {
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -127,46 +167,56 @@ Scene::Scene(const std::shared_ptr<StateManager>& game_state, ClientState& clien
 Scene::~Scene() {}
 
 void Scene::Render(const StateManager& game_state_manager,
+                   const RenderSnapshotHistory& render_snapshots,
                    ClientState& client_state,
                    double frame_percent,
                    int fps)
 {
-    RenderGame(game_state_manager, client_state, frame_percent, fps);
+    RenderGame(game_state_manager, render_snapshots, client_state, frame_percent, fps);
 }
 
 void Scene::RenderGame(const StateManager& game_state_manager,
+                       const RenderSnapshotHistory& render_snapshots,
                        ClientState& client_state,
                        double frame_percent,
                        int fps)
 {
-    RenderWorld(game_state_manager, client_state, frame_percent);
+    RenderWorld(game_state_manager, render_snapshots, client_state, frame_percent);
     RenderDebugOverlay(game_state_manager, client_state, frame_percent, fps);
-    game_hud_renderer_.Render(game_state_manager, client_state);
+    {
+        ScopedProfilerZone hud_zone(GetFrameProfiler(), "HUD");
+        game_hud_renderer_.Render(game_state_manager, client_state);
+    }
     RenderDebugMouseAim(game_state_manager, client_state);
 }
 
 void Scene::RenderEditor(const StateManager& game_state_manager,
+                         const RenderSnapshotHistory& render_snapshots,
                          ClientState& client_state,
                          double frame_percent,
                          int /*fps*/)
 {
-    RenderWorld(game_state_manager, client_state, frame_percent);
+    RenderWorld(game_state_manager, render_snapshots, client_state, frame_percent);
     RenderEditorOverlay(game_state_manager, client_state);
     RenderDebugMouseAim(game_state_manager, client_state);
 }
 
 void Scene::RenderPlayTest(const StateManager& game_state_manager,
+                           const RenderSnapshotHistory& render_snapshots,
                            ClientState& client_state,
                            double frame_percent,
                            int fps)
 {
-    RenderGame(game_state_manager, client_state, frame_percent, fps);
+    RenderGame(game_state_manager, render_snapshots, client_state, frame_percent, fps);
 }
 
 void Scene::RenderWorld(const StateManager& game_state_manager,
+                        const RenderSnapshotHistory& render_snapshots,
                         ClientState& client_state,
                         double frame_percent)
 {
+    gpu_timer_.Collect(GetFrameProfiler());
+
     // TODO: handle it better, this is not a good place for this to be
     client_state.world_render_options.current_polygon_texture_dimensions =
       polygons_renderer_->GetTextureDimensions();
@@ -175,148 +225,196 @@ void Scene::RenderWorld(const StateManager& game_state_manager,
       client_state.camera.previous_position, client_state.camera.position, (float)frame_percent);
     Camera& camera = client_state.camera.view;
     camera.Move(new_camera_position.x, new_camera_position.y);
+    {
+        ScopedProfilerZone culling_zone(GetFrameProfiler(), "Culling");
+        map_spatial_index_.Cull(GetCameraViewBounds(camera), visible_map_objects_);
+    }
 
     glViewport(0, 0, (int)client_state.input.window_width, (int)client_state.input.window_height);
     glClearColor(168.0F / 255.0F, 163.0F / 255.0F, 148.0F / 255.0F, 0.0);
     glClear(GL_COLOR_BUFFER_BIT);
 
+    const auto& scenery_instances = game_state_manager.GetConstMap().GetSceneryInstances();
+    const auto submit_sceneries = [&](RenderLayer layer, unsigned int level) {
+        render_queue_.Submit(layer, [&, level]() {
+            sceneries_renderer_.Render(camera.GetView(),
+                                       visible_map_objects_.scenery_ids_per_level.at(level),
+                                       scenery_instances);
+        });
+    };
+
     if (client_state.world_render_options.draw_background) {
-        background_renderer_.Render(camera.GetView());
+        render_queue_.Submit(RenderLayer::Background,
+                             [&]() { background_renderer_.Render(camera.GetView()); });
     }
 
     if (client_state.world_render_options.draw_sceneries) {
-        sceneries_renderer_.Render(
-          camera.GetView(), 0, game_state_manager.GetConstMap().GetSceneryInstances());
+        submit_sceneries(RenderLayer::BackSceneries, 0);
     }
 
     if (client_state.network.draw_server_pov_client_pos) {
-        rectangle_renderer_.Render(camera.GetView(),
-                                   client_state.network.soldier_position_server_pov,
-                                   { 1.0F, 0.0F, 0.0F, 1.0F });
+        render_queue_.Submit(RenderLayer::BackDebugOverlay, [&]() {
+            rectangle_renderer_.Render(camera.GetView(),
+                                       client_state.network.soldier_position_server_pov,
+                                       { 1.0F, 0.0F, 0.0F, 1.0F });
+        });
+    }
+    if (client_state.world_render_options.render_from_snapshots) {
+        render_snapshots.ForEachBullet((float)frame_percent, [&](const auto& bullet) {
+            bullet_renderer_.Submit(render_queue_, RenderLayer::Bullets, camera.GetView(), bullet);
+        });
+        render_queue_.Submit(RenderLayer::Soldiers, [&]() {
+            RenderSoldiers(render_snapshots, client_state, frame_percent);
+        });
+        render_queue_.Submit(RenderLayer::Items, [&]() {
+            render_snapshots.ForEachItem((float)frame_percent, [&](const auto& item) {
+                item_renderer_.Render(
+                  camera.GetView(), item, render_snapshots.GetCurrent().game_tick);
+            });
+        });
+    } else {
+        game_state_manager.ForEachBullet([&](const auto& bullet) {
+            bullet_renderer_.Submit(
+              render_queue_, RenderLayer::Bullets, camera.GetView(), bullet, frame_percent);
+        });
+        render_queue_.Submit(RenderLayer::Soldiers, [&]() {
+            RenderSoldiers(game_state_manager, client_state, frame_percent);
+        });
+        render_queue_.Submit(RenderLayer::Items, [&]() {
+            game_state_manager.ForEachItem([&](const auto& item) {
+                item_renderer_.Render(
+                  camera.GetView(), item, frame_percent, game_state_manager.GetGameTick());
+            });
+        });
     }
-    game_state_manager.ForEachBullet([&](const auto& bullet) {
-        bullet_renderer_.Render(camera.GetView(), bullet, frame_percent);
-    });
-    RenderSoldiers(game_state_manager, client_state, frame_percent);
-    game_state_manager.ForEachItem([&](const auto& item) {
-        item_renderer_.Render(
-          camera.GetView(), item, frame_percent, game_state_manager.GetGameTick());
-    });
     if (client_state.world_render_options.draw_sceneries) {
-        sceneries_renderer_.Render(
-          camera.GetView(), 1, game_state_manager.GetConstMap().GetSceneryInstances());
+        submit_sceneries(RenderLayer::MiddleSceneries, 1);
     }
     if (client_state.world_render_options.draw_polygons) {
-        polygons_renderer_->Render(camera.GetView());
+        render_queue_.Submit(RenderLayer::Polygons, [&]() {
+            polygons_renderer_->Render(camera.GetView(), visible_map_objects_.polygon_ids);
+        });
     }
     if (client_state.debug_render.draw_colliding_polygons) {
-        for (unsigned int polygon_id : client_state.debug_render.colliding_polygon_ids) {
-            polygon_outlines_renderer_.Render(camera.GetView(), polygon_id);
-        }
+        render_queue_.Submit(RenderLayer::Polygons, [&]() {
+            for (unsigned int polygon_id : client_state.debug_render.colliding_polygon_ids) {
+                polygon_outlines_renderer_.Render(camera.GetView(), polygon_id);
+            }
+        });
     }
     if (client_state.world_render_options.draw_sceneries) {
-        sceneries_renderer_.Render(
-          camera.GetView(), 2, game_state_manager.GetConstMap().GetSceneryInstances());
+        submit_sceneries(RenderLayer::FrontSceneries, 2);
     }
 
-    if (client_state.debug_render.draw_soldier_hitboxes) {
-        const auto bullet_colliding_body_parts = std::array{ 12, 11, 10, 6, 5, 4, 3 };
-        game_state_manager.ForEachSoldier([&](const auto& soldier) {
-            glm::vec2 soldier_pos = soldier.particle.position;
-            for (auto body_part_id : bullet_colliding_body_parts) {
-                auto body_part_offset =
-                  soldier.skeleton->GetPos(body_part_id) - soldier.particle.position;
-                auto body_part_center_position = soldier_pos + body_part_offset;
-                float radius = 7.0F;
-                circle_renderer_.Render(camera.GetView(),
-                                        body_part_center_position,
-                                        { 1.0F, 0.0F, 0.0F, 1.0F },
-                                        radius,
-                                        radius - 0.5F);
-            }
-        });
-    }
+    auto render_queue_stats = render_queue_.Execute(render_state_binder_);
+    GetCounterRegistry().Set(Gauge::RenderCommandsPerFrame, render_queue_stats.commands_count);
+    GetCounterRegistry().Set(Gauge::RenderStateChangesPerFrame,
+                             render_queue_stats.GetStateChangesCount());
+
+    {
+        ScopedProfilerZone debug_shapes_zone(GetFrameProfiler(), "Debug shapes");
+
+        if (client_state.debug_render.draw_soldier_hitboxes) {
+            const auto bullet_colliding_body_parts = std::array{ 12, 11, 10, 6, 5, 4, 3 };
+            game_state_manager.ForEachSoldier([&](const auto& soldier) {
+                glm::vec2 soldier_pos = soldier.particle.position;
+                for (auto body_part_id : bullet_colliding_body_parts) {
+                    auto body_part_offset =
+                      soldier.skeleton->GetPos(body_part_id) - soldier.particle.position;
+                    auto body_part_center_position = soldier_pos + body_part_offset;
+                    float radius = 7.0F;
+                    circle_renderer_.Render(camera.GetView(),
+                                            body_part_center_position,
+                                            { 1.0F, 0.0F, 0.0F, 1.0F },
+                                            radius,
+                                            radius - 0.5F);
+                }
+            });
+        }
 
-    if (client_state.debug_render.draw_item_hitboxes) {
-        game_state_manager.ForEachItem([&](const auto& item) {
-            if (IsItemTypeWeapon(item.style)) {
-                glm::vec2 start_pos = item.skeleton->GetPos(1);
-                glm::vec2 end_pos = item.skeleton->GetPos(2);
-                float radius = 1.0F;
-                circle_renderer_.Render(
-                  camera.GetView(), start_pos, { 1.0F, 0.0F, 0.0F, 1.0F }, radius);
-                circle_renderer_.Render(
-                  camera.GetView(), end_pos, { 1.0F, 0.0F, 0.0F, 1.0F }, radius);
-                line_renderer_.Render(
-                  camera.GetView(), start_pos, end_pos, { 1.0F, 0.0F, 0.0F, 1.0F }, 0.5F);
-            } else {
-                for (unsigned int i = 1; i <= 4; ++i) {
-                    glm::vec2 start_pos = item.skeleton->GetPos(i);
-                    glm::vec2 end_pos = item.skeleton->GetPos((i % 4) + 1);
+        if (client_state.debug_render.draw_item_hitboxes) {
+            game_state_manager.ForEachItem([&](const auto& item) {
+                if (IsItemTypeWeapon(item.style)) {
+                    glm::vec2 start_pos = item.skeleton->GetPos(1);
+                    glm::vec2 end_pos = item.skeleton->GetPos(2);
                     float radius = 1.0F;
                     circle_renderer_.Render(
                       camera.GetView(), start_pos, { 1.0F, 0.0F, 0.0F, 1.0F }, radius);
+                    circle_renderer_.Render(
+                      camera.GetView(), end_pos, { 1.0F, 0.0F, 0.0F, 1.0F }, radius);
                     line_renderer_.Render(
                       camera.GetView(), start_pos, end_pos, { 1.0F, 0.0F, 0.0F, 1.0F }, 0.5F);
+                } else {
+                    for (unsigned int i = 1; i <= 4; ++i) {
+                        glm::vec2 start_pos = item.skeleton->GetPos(i);
+                        glm::vec2 end_pos = item.skeleton->GetPos((i % 4) + 1);
+                        float radius = 1.0F;
+                        circle_renderer_.Render(
+                          camera.GetView(), start_pos, { 1.0F, 0.0F, 0.0F, 1.0F }, radius);
+                        line_renderer_.Render(
+                          camera.GetView(), start_pos, end_pos, { 1.0F, 0.0F, 0.0F, 1.0F }, 0.5F);
+                    }
                 }
-            }
-        });
-    }
+            });
+        }
 
-    if (client_state.debug_render.draw_bullet_hitboxes) {
-        game_state_manager.ForEachBullet([&](const auto& bullet) {
-            auto start_point = bullet.particle.position;
-            auto end_point = bullet.particle.position + bullet.particle.GetVelocity();
+        if (client_state.debug_render.draw_bullet_hitboxes) {
+            game_state_manager.ForEachBullet([&](const auto& bullet) {
+                auto start_point = bullet.particle.position;
+                auto end_point = bullet.particle.position + bullet.particle.GetVelocity();
 
-            line_renderer_.Render(
-              camera.GetView(), start_point, end_point, { 1.0F, 0.0F, 0.0F, 1.0F }, 0.5F);
-        });
-    }
+                line_renderer_.Render(
+                  camera.GetView(), start_point, end_point, { 1.0F, 0.0F, 0.0F, 1.0F }, 0.5F);
+            });
+        }
 
-    if (client_state.debug_render.draw_sectors) {
-        int sectors_count = 2 * game_state_manager.GetConstMap().GetSectorsCount() + 1;
-        for (int x = 0; x < sectors_count; ++x) {
-            for (int y = 0; y < sectors_count; ++y) {
-                const auto& boundaries =
-                  game_state_manager.GetConstMap().GetSector(x, y).boundaries;
+        if (client_state.debug_render.draw_sectors) {
+            int sectors_count = 2 * game_state_manager.GetConstMap().GetSectorsCount() + 1;
+            for (int x = 0; x < sectors_count; ++x) {
+                for (int y = 0; y < sectors_count; ++y) {
+                    const auto& boundaries =
+                      game_state_manager.GetConstMap().GetSector(x, y).boundaries;
 
-                float top = boundaries[0];
-                float bottom = boundaries[1];
-                float left = boundaries[2];
-                float right = boundaries[3];
+                    float top = boundaries[0];
+                    float bottom = boundaries[1];
+                    float left = boundaries[2];
+                    float right = boundaries[3];
 
-                glm::vec4 color = { 0.7F, 0.1F, 0.0F, 1.0F };
-                float thickness = camera.GetZoom();
+                    glm::vec4 color = { 0.7F, 0.1F, 0.0F, 1.0F };
+                    float thickness = camera.GetZoom();
 
-                line_renderer_.Render(
-                  camera.GetView(), { left, top }, { right, top }, color, thickness);
-                line_renderer_.Render(
-                  camera.GetView(), { right, top }, { right, bottom }, color, thickness);
-                line_renderer_.Render(
-                  camera.GetView(), { left, bottom }, { right, bottom }, color, thickness);
-                line_renderer_.Render(
-                  camera.GetView(), { left, bottom }, { left, top }, color, thickness);
+                    line_renderer_.Render(
+                      camera.GetView(), { left, top }, { right, top }, color, thickness);
+                    line_renderer_.Render(
+                      camera.GetView(), { right, top }, { right, bottom }, color, thickness);
+                    line_renderer_.Render(
+                      camera.GetView(), { left, bottom }, { right, bottom }, color, thickness);
+                    line_renderer_.Render(
+                      camera.GetView(), { left, bottom }, { left, top }, color, thickness);
+                }
             }
         }
-    }
 
-    if (client_state.debug_render.draw_map_boundaries) {
-        auto boundaries = game_state_manager.GetConstMap().GetBoundaries();
+        if (client_state.debug_render.draw_map_boundaries) {
+            auto boundaries = game_state_manager.GetConstMap().GetBoundaries();
 
-        float top = boundaries[0];
-        float bottom = boundaries[1];
-        float left = boundaries[2];
-        float right = boundaries[3];
+            float top = boundaries[0];
+            float bottom = boundaries[1];
+            float left = boundaries[2];
+            float right = boundaries[3];
 
-        glm::vec4 color = { 0.5F, 0.0F, 0.0F, 1.0F };
-        float thickness = camera.GetZoom();
+            glm::vec4 color = { 0.5F, 0.0F, 0.0F, 1.0F };
+            float thickness = camera.GetZoom();
 
-        line_renderer_.Render(camera.GetView(), { left, top }, { right, top }, color, thickness);
-        line_renderer_.Render(
-          camera.GetView(), { right, top }, { right, bottom }, color, thickness);
-        line_renderer_.Render(
-          camera.GetView(), { left, bottom }, { right, bottom }, color, thickness);
-        line_renderer_.Render(camera.GetView(), { left, bottom }, { left, top }, color, thickness);
+            line_renderer_.Render(
+              camera.GetView(), { left, top }, { right, top }, color, thickness);
+            line_renderer_.Render(
+              camera.GetView(), { right, top }, { right, bottom }, color, thickness);
+            line_renderer_.Render(
+              camera.GetView(), { left, bottom }, { right, bottom }, color, thickness);
+            line_renderer_.Render(
+              camera.GetView(), { left, bottom }, { left, top }, color, thickness);
+        }
     }
 }
 
@@ -325,7 +423,12 @@ void Scene::RenderDebugOverlay(const StateManager& game_state_manager,
                                double frame_percent,
                                int fps)
 {
-    DebugUI::Render(game_state_manager, client_state, frame_percent, fps);
+    {
+        ScopedProfilerZone imgui_zone(GetFrameProfiler(), "ImGui");
+        gpu_timer_.Begin(GetFrameProfiler(), "ImGui");
+        DebugUI::Render(game_state_manager, client_state, frame_percent, fps);
+        gpu_timer_.End();
+    }
     if (!DebugUI::GetWantCaptureMouse()) {
         cursor_renderer_.Render(
           { client_state.input.mouse_screen_position.x,
@@ -336,6 +439,7 @@ void Scene::RenderDebugOverlay(const StateManager& game_state_manager,
 
 void Scene::RenderEditorOverlay(const StateManager& game_state_manager, ClientState& client_state)
 {
+    ScopedProfilerZone editor_zone(GetFrameProfiler(), "Map editor");
     map_editor_scene_.Render(game_state_manager, client_state, *polygons_renderer_);
 }
 
@@ -379,7 +483,7 @@ void Scene::RenderSoldiers(const StateManager& game_state_manager,
             return;
         }
 
-        soldier_renderer_.Render(camera.GetView(), sprite_manager_, soldier, frame_percent);
+        soldier_renderer_.AddSoldier(sprite_manager_, soldier, frame_percent);
     });
 
     // Render player's soldier last because it's the most important for the player to see their
@@ -388,9 +492,35 @@ void Scene::RenderSoldiers(const StateManager& game_state_manager,
         unsigned int client_soldier_id = *client_state.client_soldier_id;
         game_state_manager.ForSoldier(client_soldier_id, [&](const auto& soldier) {
             if (soldier.active) {
-                soldier_renderer_.Render(camera.GetView(), sprite_manager_, soldier, frame_percent);
+                soldier_renderer_.AddSoldier(sprite_manager_, soldier, frame_percent);
             }
         });
     }
+
+    soldier_renderer_.Render(camera.GetView());
+}
+
+void Scene::RenderSoldiers(const RenderSnapshotHistory& render_snapshots,
+                           const ClientState& client_state,
+                           double frame_percent)
+{
+    const Camera& camera = client_state.camera.view;
+
+    // Player's soldier goes last like when drawing from the live state
+    std::optional<SoldierRenderState> client_soldier;
+    render_snapshots.ForEachSoldier((float)frame_percent, [&](const SoldierRenderState& soldier) {
+        if (client_state.client_soldier_id.has_value() &&
+            *client_state.client_soldier_id == soldier.id) {
+            client_soldier = soldier;
+            return;
+        }
+
+        soldier_renderer_.AddSoldier(sprite_manager_, soldier);
+    });
+    if (client_soldier.has_value()) {
+        soldier_renderer_.AddSoldier(sprite_manager_, *client_soldier);
+    }
+
+    soldier_renderer_.Render(camera.GetView());
 }
 } // namespace Soldank
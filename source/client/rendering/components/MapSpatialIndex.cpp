@@ -0,0 +1,344 @@
+module;
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+export module MapSpatialIndex;
+
+import Extern.Glm;
+
+import Camera;
+
+import Shared.Core.Map.Map;
+import Shared.Core.Map.PMSStructs;
+
+export namespace Soldank
+{
+// Axis aligned rectangle in render coordinates, that is with the map's y axis flipped like the
+// renderers do it
+struct BoundingRectangle
+{
+    glm::vec2 min;
+    glm::vec2 max;
+
+    static BoundingRectangle CreateEmpty()
+    {
+        return { .min = glm::vec2{ std::numeric_limits<float>::max() },
+                 .max = glm::vec2{ std::numeric_limits<float>::lowest() } };
+    }
+
+    void Extend(const glm::vec2& point)
+    {
+        min = { std::min(min.x, point.x), std::min(min.y, point.y) };
+        max = { std::max(max.x, point.x), std::max(max.y, point.y) };
+    }
+
+    bool Intersects(const BoundingRectangle& other) const
+    {
+        return min.x <= other.max.x && max.x >= other.min.x && min.y <= other.max.y &&
+               max.y >= other.min.y;
+    }
+};
+
+BoundingRectangle GetCameraViewBounds(const Camera& camera)
+{
+    glm::vec2 half_dimensions{ camera.GetWidth() / 2.0F, camera.GetHeight() / 2.0F };
+    glm::vec2 camera_position{ camera.GetX(), camera.GetY() };
+    return { .min = camera_position - half_dimensions, .max = camera_position + half_dimensions };
+}
+
+// Uniform grid over the bounds of a set of objects. Every object is listed in all the cells it
+// overlaps, the cells are stored one after another in a single vector.
+class BoundsGrid
+{
+public:
+    static constexpr float MIN_CELL_SIZE = 512.0F;
+    static constexpr unsigned int MAX_CELLS_PER_AXIS = 256;
+
+    void Rebuild(std::vector<BoundingRectangle> bounds)
+    {
+        bounds_ = std::move(bounds);
+        query_stamps_.assign(bounds_.size(), 0);
+        query_stamp_ = 0;
+        cell_starts_.clear();
+        cell_ids_.clear();
+        columns_count_ = 0;
+        rows_count_ = 0;
+
+        if (bounds_.empty()) {
+            return;
+        }
+
+        BoundingRectangle grid_bounds = bounds_.front();
+        for (const auto& object_bounds : bounds_) {
+            grid_bounds.Extend(object_bounds.min);
+            grid_bounds.Extend(object_bounds.max);
+        }
+        grid_min_ = grid_bounds.min;
+
+        glm::vec2 grid_dimensions = grid_bounds.max - grid_bounds.min;
+        cell_size_ = { std::max(MIN_CELL_SIZE, grid_dimensions.x / MAX_CELLS_PER_AXIS),
+                       std::max(MIN_CELL_SIZE, grid_dimensions.y / MAX_CELLS_PER_AXIS) };
+        columns_count_ = std::min(
+          static_cast<unsigned int>(grid_dimensions.x / cell_size_.x) + 1, MAX_CELLS_PER_AXIS);
+        rows_count_ = std::min(static_cast<unsigned int>(grid_dimensions.y / cell_size_.y) + 1,
+                               MAX_CELLS_PER_AXIS);
+
+        // Counting sort of the objects into the cells, first the sizes then the ids
+        cell_starts_.assign(static_cast<std::size_t>(columns_count_) * rows_count_ + 1, 0);
+        for (const auto& object_bounds : bounds_) {
+            ForEachCell(object_bounds, [&](std::size_t cell_index) { ++cell_starts_[cell_index]; });
+        }
+        unsigned int cell_start = 0;
+        for (auto& cell_size : cell_starts_) {
+            cell_start += std::exchange(cell_size, cell_start);
+        }
+        cell_ids_.resize(cell_start);
+        std::vector<unsigned int> cell_fill = cell_starts_;
+        for (unsigned int id = 0; id < bounds_.size(); ++id) {
+            ForEachCell(bounds_[id], [&](std::size_t cell_index) {
+                cell_ids_[cell_fill[cell_index]++] = id;
+            });
+        }
+    }
+
+    // Writes the ids of the objects intersecting area to destination_ids in increasing order
+    void Query(const BoundingRectangle& area, std::vector<unsigned int>& destination_ids)
+    {
+        destination_ids.clear();
+        if (bounds_.empty()) {
+            return;
+        }
+
+        // Objects spanning several cells are only tested once per query
+        ++query_stamp_;
+        if (query_stamp_ == 0) {
+            std::ranges::fill(query_stamps_, 0);
+            query_stamp_ = 1;
+        }
+
+        ForEachCell(area, [&](std::size_t cell_index) {
+            for (unsigned int i = cell_starts_[cell_index]; i < cell_starts_[cell_index + 1]; ++i) {
+                unsigned int id = cell_ids_[i];
+                if (query_stamps_[id] == query_stamp_) {
+                    continue;
+                }
+                query_stamps_[id] = query_stamp_;
+                if (bounds_[id].Intersects(area)) {
+                    destination_ids.push_back(id);
+                }
+            }
+        });
+
+        std::ranges::sort(destination_ids);
+    }
+
+    std::size_t GetObjectsCount() const { return bounds_.size(); }
+    unsigned int GetColumnsCount() const { return columns_count_; }
+    unsigned int GetRowsCount() const { return rows_count_; }
+
+private:
+    template<typename OnCell>
+    void ForEachCell(const BoundingRectangle& area, OnCell on_cell) const
+    {
+        if (columns_count_ == 0 || rows_count_ == 0) {
+            return;
+        }
+
+        glm::vec2 first_cell = (area.min - grid_min_) / cell_size_;
+        glm::vec2 last_cell = (area.max - grid_min_) / cell_size_;
+        first_cell = { std::floor(first_cell.x), std::floor(first_cell.y) };
+        last_cell = { std::floor(last_cell.x), std::floor(last_cell.y) };
+        if (last_cell.x < 0.0F || last_cell.y < 0.0F ||
+            first_cell.x >= static_cast<float>(columns_count_) ||
+            first_cell.y >= static_cast<float>(rows_count_)) {
+            return;
+        }
+
+        auto first_column = static_cast<unsigned int>(std::max(first_cell.x, 0.0F));
+        auto first_row = static_cast<unsigned int>(std::max(first_cell.y, 0.0F));
+        auto last_column = static_cast<unsigned int>(
+          std::min(last_cell.x, static_cast<float>(columns_count_ - 1)));
+        auto last_row =
+          static_cast<unsigned int>(std::min(last_cell.y, static_cast<float>(rows_count_ - 1)));
+        for (unsigned int row = first_row; row <= last_row; ++row) {
+            for (unsigned int column = first_column; column <= last_column; ++column) {
+                on_cell(static_cast<std::size_t>(row) * columns_count_ + column);
+            }
+        }
+    }
+
+    std::vector<BoundingRectangle> bounds_;
+    glm::vec2 grid_min_{ 0.0F };
+    glm::vec2 cell_size_{ MIN_CELL_SIZE };
+    unsigned int columns_count_ = 0;
+    unsigned int rows_count_ = 0;
+    std::vector<unsigned int> cell_starts_;
+    std::vector<unsigned int> cell_ids_;
+
+    std::vector<std::uint32_t> query_stamps_;
+    std::uint32_t query_stamp_ = 0;
+};
+
+constexpr std::size_t SCENERY_LEVELS_COUNT = 3;
+
+// Ids are indexes into the map's scenery instances and polygons, in the order they are drawn in
+struct VisibleMapObjects
+{
+    std::array<std::vector<unsigned int>, SCENERY_LEVELS_COUNT> scenery_ids_per_level;
+    std::vector<unsigned int> polygon_ids;
+};
+
+// Spatial index of the map's sceneries and polygons, so a frame only draws what is in the view.
+// It is built when the map is loaded and rebuilt from the map change events when the map is
+// edited.
+class MapSpatialIndex
+{
+public:
+    MapSpatialIndex() = default;
+    MapSpatialIndex(Map& map);
+
+    // it's not safe to be able to copy/move this because the map change observers keep a pointer
+    // to it
+    MapSpatialIndex(const MapSpatialIndex&) = delete;
+    MapSpatialIndex& operator=(const MapSpatialIndex& other) = delete;
+    MapSpatialIndex(MapSpatialIndex&&) = delete;
+    MapSpatialIndex& operator=(MapSpatialIndex&& other) = delete;
+
+    void RebuildSceneries(const std::vector<PMSScenery>& sceneries);
+    void RebuildPolygons(const std::vector<PMSPolygon>& polygons);
+
+    void Cull(const BoundingRectangle& view_bounds, VisibleMapObjects& visible_map_objects);
+
+    static BoundingRectangle GetSceneryBounds(const PMSScenery& scenery);
+    static BoundingRectangle GetPolygonBounds(const PMSPolygon& polygon);
+
+private:
+    BoundsGrid sceneries_grid_;
+    std::vector<int> scenery_levels_;
+    BoundsGrid polygons_grid_;
+
+    std::vector<unsigned int> visible_scenery_ids_;
+};
+} // namespace Soldank
+
+namespace Soldank
+{
+MapSpatialIndex::MapSpatialIndex(Map& map)
+{
+    RebuildSceneries(map.GetSceneryInstances());
+    RebuildPolygons(map.GetPolygons());
+
+    // The map's vectors are already changed when the events are sent
+    auto rebuild_sceneries = [this, &map]() { RebuildSceneries(map.GetSceneryInstances()); };
+    auto rebuild_polygons = [this, &map]() { RebuildPolygons(map.GetPolygons()); };
+
+    map.GetMapChangeEvents().added_new_scenery.AddObserver(
+      [rebuild_sceneries](const PMSScenery& /*new_scenery*/, unsigned int /*new_scenery_id*/) {
+          rebuild_sceneries();
+      });
+    map.GetMapChangeEvents().removed_scenery.AddObserver(
+      [rebuild_sceneries](const PMSScenery& /*removed_scenery*/,
+                          unsigned int /*removed_scenery_id*/,
+                          const std::vector<PMSScenery>& /*sceneries_after_removal*/) {
+          rebuild_sceneries();
+      });
+    map.GetMapChangeEvents().added_sceneries.AddObserver(
+      [rebuild_sceneries](const std::vector<PMSScenery>& /*sceneries_after_adding*/) {
+          rebuild_sceneries();
+      });
+    map.GetMapChangeEvents().removed_sceneries.AddObserver(
+      [rebuild_sceneries](const std::vector<PMSScenery>& /*sceneries_after_removal*/) {
+          rebuild_sceneries();
+      });
+    map.GetMapChangeEvents().modified_sceneries.AddObserver(
+      [rebuild_sceneries](const std::vector<PMSScenery>& /*sceneries_after_modify*/) {
+          rebuild_sceneries();
+      });
+
+    map.GetMapChangeEvents().added_new_polygon.AddObserver(
+      [rebuild_polygons](const PMSPolygon& /*new_polygon*/) { rebuild_polygons(); });
+    map.GetMapChangeEvents().removed_polygon.AddObserver(
+      [rebuild_polygons](const PMSPolygon& /*removed_polygon*/,
+                         const std::vector<PMSPolygon>& /*polygons_after_removal*/) {
+          rebuild_polygons();
+      });
+    map.GetMapChangeEvents().added_new_polygons.AddObserver(
+      [rebuild_polygons](const std::vector<PMSPolygon>& /*created_polygons*/,
+                         const std::vector<PMSPolygon>& /*polygons_after_adding*/) {
+          rebuild_polygons();
+      });
+    map.GetMapChangeEvents().removed_polygons.AddObserver(
+      [rebuild_polygons](const std::vector<PMSPolygon>& /*removed_polygons*/,
+                         const std::vector<PMSPolygon>& /*polygons_after_removal*/) {
+          rebuild_polygons();
+      });
+    map.GetMapChangeEvents().modified_polygons.AddObserver(
+      [rebuild_polygons](const std::vector<PMSPolygon>& /*polygons_after_modify*/) {
+          rebuild_polygons();
+      });
+}
+
+void MapSpatialIndex::RebuildSceneries(const std::vector<PMSScenery>& sceneries)
+{
+    std::vector<BoundingRectangle> bounds;
+    bounds.reserve(sceneries.size());
+    scenery_levels_.clear();
+    for (const auto& scenery : sceneries) {
+        bounds.push_back(GetSceneryBounds(scenery));
+        scenery_levels_.push_back(scenery.level);
+    }
+    sceneries_grid_.Rebuild(std::move(bounds));
+}
+
+void MapSpatialIndex::RebuildPolygons(const std::vector<PMSPolygon>& polygons)
+{
+    std::vector<BoundingRectangle> bounds;
+    bounds.reserve(polygons.size());
+    for (const auto& polygon : polygons) {
+        bounds.push_back(GetPolygonBounds(polygon));
+    }
+    polygons_grid_.Rebuild(std::move(bounds));
+}
+
+void MapSpatialIndex::Cull(const BoundingRectangle& view_bounds,
+                           VisibleMapObjects& visible_map_objects)
+{
+    sceneries_grid_.Query(view_bounds, visible_scenery_ids_);
+    for (auto& scenery_ids : visible_map_objects.scenery_ids_per_level) {
+        scenery_ids.clear();
+    }
+    for (unsigned int scenery_id : visible_scenery_ids_) {
+        int level = scenery_levels_[scenery_id];
+        if (level >= 0 && level < static_cast<int>(SCENERY_LEVELS_COUNT)) {
+            visible_map_objects.scenery_ids_per_level.at(level).push_back(scenery_id);
+        }
+    }
+
+    polygons_grid_.Query(view_bounds, visible_map_objects.polygon_ids);
+}
+
+BoundingRectangle MapSpatialIndex::GetSceneryBounds(const PMSScenery& scenery)
+{
+    auto bounds = BoundingRectangle::CreateEmpty();
+    for (const auto& vertex_position : Map::GetSceneryVertexPositions(scenery)) {
+        bounds.Extend({ vertex_position.x, -vertex_position.y });
+    }
+    return bounds;
+}
+
+BoundingRectangle MapSpatialIndex::GetPolygonBounds(const PMSPolygon& polygon)
+{
+    auto bounds = BoundingRectangle::CreateEmpty();
+    for (const auto& vertex : polygon.vertices) {
+        bounds.Extend({ vertex.x, -vertex.y });
+    }
+    return bounds;
+}
+} // namespace Soldank
@@ -5,8 +5,10 @@ module;
 
 #include <stb_image.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <span>
+#include <string_view>
 #include <fstream>
 #include <limits>
 #include <utility>
@@ -18,6 +20,8 @@ module;
 
 export module Texture;
 
+import Extern.Glm;
+
 export namespace Soldank::Texture
 {
 struct TextureData
@@ -27,21 +31,27 @@ struct TextureData
     int height;
 };
 
+// All frames of a GIF live in one texture, laid out in a grid of columns x rows frames going
+// left to right, then row by row. Frame i is shown for GetDelay(i) milliseconds.
 class TextureGIFData
 {
 public:
-    TextureGIFData(int width, int height)
-        : width_(width)
+    TextureGIFData(unsigned int opengl_id,
+                   int width,
+                   int height,
+                   int columns,
+                   int rows,
+                   std::vector<int> delays)
+        : opengl_id_(opengl_id)
+        , delays_(std::move(delays))
+        , width_(width)
         , height_(height)
+        , columns_(columns)
+        , rows_(rows)
     {
     }
 
-    ~TextureGIFData()
-    {
-        for (unsigned int texture_id : opengl_ids_) {
-            glDeleteTextures(1, &texture_id);
-        }
-    }
+    ~TextureGIFData() { glDeleteTextures(1, &opengl_id_); }
 
     // it's not safe to be able to copy/move this because we would also need to take care of the
     // created OpenGL buffers and textures
@@ -50,36 +60,68 @@ public:
     TextureGIFData(TextureGIFData&&) = delete;
     TextureGIFData& operator=(TextureGIFData&& other) = delete;
 
-    void AddFrame(unsigned int opengl_id, int delay)
-    {
-        opengl_ids_.push_back(opengl_id);
-        delays_.push_back(delay);
-    }
-    std::pair<unsigned int, int> GetFrame(unsigned int frame_id) const
-    {
-        return { opengl_ids_.at(frame_id), delays_.at(frame_id) };
-    }
+    unsigned int GetOpenGLId() const { return opengl_id_; }
+    int GetDelay(unsigned int frame_id) const { return delays_.at(frame_id); }
 
-    unsigned int Size() const { return opengl_ids_.size(); }
+    unsigned int Size() const { return delays_.size(); }
 
+    // Size of a single frame
     int GetWidth() const { return width_; };
     int GetHeight() const { return height_; };
 
+    int GetColumns() const { return columns_; };
+    int GetRows() const { return rows_; };
+
 private:
-    std::vector<unsigned int> opengl_ids_;
+    unsigned int opengl_id_;
     std::vector<int> delays_;
     int width_;
     int height_;
+    int columns_;
+    int rows_;
 };
 
 enum class LoadError
 {
-    TextureNotFound = 0
+    TextureNotFound = 0,
+    TextureTooLarge
 };
 
-std::expected<TextureData, LoadError> Load(const char* texture_path)
+std::string_view GetLoadErrorMessage(LoadError load_error)
+{
+    switch (load_error) {
+        case LoadError::TextureNotFound:
+            return "Texture file not found";
+        case LoadError::TextureTooLarge:
+            return "Texture too large for the GPU";
+    }
+    return "Texture could not be loaded";
+}
+
+// RGBA pixels of an image, rows going from the bottom of the image up
+struct ImageData
+{
+    int width;
+    int height;
+    std::vector<unsigned char> pixels;
+};
+
+// Part of a texture in texture coordinates
+struct TextureRegion
+{
+    glm::vec2 texture_min;
+    glm::vec2 texture_max;
+};
+
+struct AtlasLayout
+{
+    // Bottom left corner of every image in pixels
+    std::vector<glm::ivec2> positions;
+    glm::ivec2 size;
+};
+
+std::expected<ImageData, LoadError> LoadImageData(const char* texture_path)
 {
-    unsigned int texture_id = 0;
     int texture_width = 0;
     int texture_height = 0;
 
@@ -87,42 +129,150 @@ std::expected<TextureData, LoadError> Load(const char* texture_path)
     stbi_set_flip_vertically_on_load(1);
     unsigned char* data = stbi_load(
       texture_path, &texture_width, &texture_height, &texture_nr_channels, STBI_rgb_alpha);
-    if (data != nullptr) {
-        std::span pixels{ data, static_cast<size_t>(texture_height * texture_width * 4) };
+    if (data == nullptr) {
+        return std::unexpected(LoadError::TextureNotFound);
+    }
 
-        // Changing fully green pixels to be transparent
-        for (int y = 0; y < texture_height; y++) {
-            for (int x = 0; x < texture_width; x++) {
-                if (pixels[(x + y * texture_width) * 4 + 0] == 0 &&
-                    pixels[(x + y * texture_width) * 4 + 1] == 255 &&
-                    pixels[(x + y * texture_width) * 4 + 2] == 0) {
-                    pixels[(x + y * texture_width) * 4 + 3] = 0;
-                }
+    std::span pixels{ data, static_cast<size_t>(texture_height * texture_width * 4) };
+
+    // Changing fully green pixels to be transparent
+    for (int y = 0; y < texture_height; y++) {
+        for (int x = 0; x < texture_width; x++) {
+            if (pixels[(x + y * texture_width) * 4 + 0] == 0 &&
+                pixels[(x + y * texture_width) * 4 + 1] == 255 &&
+                pixels[(x + y * texture_width) * 4 + 2] == 0) {
+                pixels[(x + y * texture_width) * 4 + 3] = 0;
             }
         }
-
-        glGenTextures(1, &texture_id);
-        glBindTexture(GL_TEXTURE_2D, texture_id);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-        glTexImage2D(GL_TEXTURE_2D,
-                     0,
-                     GL_RGBA,
-                     texture_width,
-                     texture_height,
-                     0,
-                     GL_RGBA,
-                     GL_UNSIGNED_BYTE,
-                     pixels.data());
-    } else {
-        return std::unexpected(LoadError::TextureNotFound);
     }
+
+    ImageData image_data{ .width = texture_width,
+                          .height = texture_height,
+                          .pixels = std::vector<unsigned char>(pixels.begin(), pixels.end()) };
     stbi_image_free(data);
 
-    return TextureData{ .opengl_id = texture_id, .width = texture_width, .height = texture_height };
+    return image_data;
+}
+
+TextureData CreateFromImageData(const ImageData& image_data)
+{
+    unsigned int texture_id = 0;
+
+    glGenTextures(1, &texture_id);
+    glBindTexture(GL_TEXTURE_2D, texture_id);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glTexImage2D(GL_TEXTURE_2D,
+                 0,
+                 GL_RGBA,
+                 image_data.width,
+                 image_data.height,
+                 0,
+                 GL_RGBA,
+                 GL_UNSIGNED_BYTE,
+                 image_data.pixels.data());
+
+    return TextureData{ .opengl_id = texture_id,
+                        .width = image_data.width,
+                        .height = image_data.height };
+}
+
+std::expected<TextureData, LoadError> Load(const char* texture_path)
+{
+    auto image_data = LoadImageData(texture_path);
+    if (!image_data.has_value()) {
+        return std::unexpected(image_data.error());
+    }
+
+    return CreateFromImageData(*image_data);
+}
+
+// Places the images in rows going up, in the order they are given, with padding pixels around
+// every image. Rows are atlas_width pixels wide unless an image is wider, the height is rounded
+// up to a power of two.
+AtlasLayout PackAtlas(std::span<const glm::ivec2> image_sizes, int atlas_width, int padding)
+{
+    AtlasLayout atlas_layout{ .positions = {}, .size = { atlas_width, 1 } };
+    for (glm::ivec2 image_size : image_sizes) {
+        atlas_layout.size.x = std::max(atlas_layout.size.x, image_size.x + 2 * padding);
+    }
+
+    glm::ivec2 next_position{ padding };
+    int row_height = 0;
+    for (glm::ivec2 image_size : image_sizes) {
+        if (next_position.x + image_size.x + padding > atlas_layout.size.x) {
+            next_position = { padding, next_position.y + row_height + padding };
+            row_height = 0;
+        }
+
+        atlas_layout.positions.push_back(next_position);
+        row_height = std::max(row_height, image_size.y);
+        next_position.x += image_size.x + padding;
+    }
+
+    while (atlas_layout.size.y < next_position.y + row_height + padding) {
+        atlas_layout.size.y *= 2;
+    }
+
+    return atlas_layout;
+}
+
+struct TextureAtlasData
+{
+    TextureData texture;
+    // Where every image ended up, in the order of the images
+    std::vector<TextureRegion> regions;
+};
+
+std::expected<TextureAtlasData, LoadError> CreateAtlas(std::span<const ImageData* const> images,
+                                                       int atlas_width)
+{
+    constexpr int ATLAS_IMAGE_PADDING = 1;
+
+    std::vector<glm::ivec2> image_sizes;
+    image_sizes.reserve(images.size());
+    for (const ImageData* image : images) {
+        image_sizes.emplace_back(image->width, image->height);
+    }
+    AtlasLayout atlas_layout = PackAtlas(image_sizes, atlas_width, ATLAS_IMAGE_PADDING);
+
+    int max_texture_size = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture_size);
+    if (atlas_layout.size.x > max_texture_size || atlas_layout.size.y > max_texture_size) {
+        return std::unexpected(LoadError::TextureTooLarge);
+    }
+
+    ImageData atlas{ .width = atlas_layout.size.x,
+                     .height = atlas_layout.size.y,
+                     .pixels = std::vector<unsigned char>(
+                       static_cast<size_t>(atlas_layout.size.x) * atlas_layout.size.y * 4, 0) };
+    TextureAtlasData texture_atlas_data;
+    glm::vec2 atlas_dimensions(atlas_layout.size);
+    for (unsigned int i = 0; i < images.size(); ++i) {
+        const ImageData& image = *images[i];
+        glm::ivec2 position = atlas_layout.positions[i];
+        int image_row_size = image.width * 4;
+        for (int y = 0; y < image.height; y++) {
+            std::ranges::copy_n(image.pixels.begin() + (std::ptrdiff_t)y * image_row_size,
+                                image_row_size,
+                                atlas.pixels.begin() +
+                                  ((std::ptrdiff_t)(position.y + y) * atlas.width + position.x) *
+                                    4);
+        }
+
+        texture_atlas_data.regions.push_back(
+          { .texture_min = glm::vec2(position) / atlas_dimensions,
+            .texture_max = glm::vec2(position + glm::ivec2(image.width, image.height)) /
+                           atlas_dimensions });
+    }
+
+    texture_atlas_data.texture = CreateFromImageData(atlas);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    return texture_atlas_data;
 }
 
 TextureData CreateSinglePixel(unsigned char red,
@@ -189,50 +339,71 @@ std::expected<std::shared_ptr<TextureGIFData>, LoadError> LoadGIF(const char* te
         return std::unexpected(LoadError::TextureNotFound);
     }
 
-    std::shared_ptr<TextureGIFData> texture_gif_data =
-      std::make_shared<TextureGIFData>(texture_width, texture_height);
+    int max_texture_size = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture_size);
+    int columns = std::clamp(max_texture_size / std::max(texture_width, 1), 1, frame_count);
+    int rows = (frame_count + columns - 1) / columns;
+    if (texture_width > max_texture_size || rows * texture_height > max_texture_size) {
+        stbi_image_free(delays_data);
+        stbi_image_free(data);
+        return std::unexpected(LoadError::TextureTooLarge);
+    }
 
     std::span delays = std::span{ delays_data, static_cast<size_t>(frame_count) };
 
     int frame_size = texture_height * texture_width * 4;
     int data_size = frame_size * frame_count;
     std::span all_pixels{ data, static_cast<size_t>(data_size) };
-    for (int frame_id = 0; frame_id < frame_count; ++frame_id) {
-        int offset = (texture_height * texture_width * 4) * frame_id;
-        std::span pixels = all_pixels.subspan(offset, frame_size);
 
-        // Changing fully green pixels to be transparent
+    // Changing fully green pixels to be transparent
+    for (int pixel_offset = 0; pixel_offset < data_size; pixel_offset += 4) {
+        if (all_pixels[pixel_offset + 0] == 0 && all_pixels[pixel_offset + 1] == 255 &&
+            all_pixels[pixel_offset + 2] == 0) {
+            all_pixels[pixel_offset + 3] = 0;
+        }
+    }
+
+    int grid_width = columns * texture_width;
+    int grid_height = rows * texture_height;
+    std::vector<unsigned char> grid_pixels(static_cast<size_t>(grid_width) * grid_height * 4, 0);
+    int frame_row_size = texture_width * 4;
+    for (int frame_id = 0; frame_id < frame_count; ++frame_id) {
+        int grid_x = (frame_id % columns) * texture_width;
+        int grid_y = (frame_id / columns) * texture_height;
         for (int y = 0; y < texture_height; y++) {
-            for (int x = 0; x < texture_width; x++) {
-                if (pixels[(x + y * texture_width) * 4 + 0] == 0 &&
-                    pixels[(x + y * texture_width) * 4 + 1] == 255 &&
-                    pixels[(x + y * texture_width) * 4 + 2] == 0) {
-                    pixels[(x + y * texture_width) * 4 + 3] = 0;
-                }
-            }
+            auto frame_row = all_pixels.subspan(frame_id * frame_size + y * frame_row_size,
+                                                frame_row_size);
+            std::ranges::copy(frame_row,
+                              grid_pixels.begin() + ((grid_y + y) * grid_width + grid_x) * 4);
         }
-        unsigned int texture_id = 0;
-
-        glGenTextures(1, &texture_id);
-        glBindTexture(GL_TEXTURE_2D, texture_id);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-        glTexImage2D(GL_TEXTURE_2D,
-                     0,
-                     GL_RGBA,
-                     texture_width,
-                     texture_height,
-                     0,
-                     GL_RGBA,
-                     GL_UNSIGNED_BYTE,
-                     pixels.data());
-
-        texture_gif_data->AddFrame(texture_id, delays[frame_id]);
     }
 
+    unsigned int texture_id = 0;
+    glGenTextures(1, &texture_id);
+    glBindTexture(GL_TEXTURE_2D, texture_id);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glTexImage2D(GL_TEXTURE_2D,
+                 0,
+                 GL_RGBA,
+                 grid_width,
+                 grid_height,
+                 0,
+                 GL_RGBA,
+                 GL_UNSIGNED_BYTE,
+                 grid_pixels.data());
+
+    std::shared_ptr<TextureGIFData> texture_gif_data =
+      std::make_shared<TextureGIFData>(texture_id,
+                                       texture_width,
+                                       texture_height,
+                                       columns,
+                                       rows,
+                                       std::vector<int>(delays.begin(), delays.end()));
+
     stbi_image_free(delays_data);
     stbi_image_free(data);
 
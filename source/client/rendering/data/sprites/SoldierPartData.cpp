@@ -75,6 +75,16 @@ public:
     int GetTextureFlippedWidth() const { return texture_flipped_width_; }
     int GetTextureFlippedHeight() const { return texture_flipped_height_; }
 
+    // Where the textures are in the soldier parts atlas, known only once all the parts are added
+    void SetAtlasRegions(Texture::TextureRegion region, Texture::TextureRegion flipped_region)
+    {
+        atlas_region_ = region;
+        atlas_flipped_region_ = flipped_region;
+    }
+
+    Texture::TextureRegion GetAtlasRegion() const { return atlas_region_; }
+    Texture::TextureRegion GetAtlasFlippedRegion() const { return atlas_flipped_region_; }
+
 private:
     glm::uvec2 point_;
     glm::vec2 center_;
@@ -90,5 +100,9 @@ private:
     int texture_height_;
     int texture_flipped_width_;
     int texture_flipped_height_;
+    Texture::TextureRegion atlas_region_{ .texture_min = { 0.0F, 0.0F },
+                                          .texture_max = { 1.0F, 1.0F } };
+    Texture::TextureRegion atlas_flipped_region_{ .texture_min = { 0.0F, 0.0F },
+                                                  .texture_max = { 1.0F, 1.0F } };
 };
 } // namespace Soldank::Sprites
@@ -296,23 +296,32 @@ public:
             { ObjectSpriteType::Para2, "gostek-gfx/para2.png" },
         };
 
+        // Kept until the soldier parts atlas is created from them
+        std::unordered_map<TSpriteKey, Texture::ImageData> sprite_images;
         std::ranges::for_each(
           std::as_const(all_sprite_file_paths), [&](const auto& type_and_file_path) {
-              auto texture_data_or_error = Texture::Load(type_and_file_path.second.c_str());
-              auto texture_data =
-                Texture::TextureData{ .opengl_id = 0, .width = 0, .height = 0 };
-              if (texture_data_or_error.has_value()) {
-                  texture_data = *texture_data_or_error;
+              auto image_data_or_error =
+                Texture::LoadImageData(type_and_file_path.second.c_str());
+              auto image_data =
+                Texture::ImageData{ .width = 1, .height = 1, .pixels = { 0, 0, 0, 0 } };
+              if (image_data_or_error.has_value()) {
+                  image_data = std::move(*image_data_or_error);
               } else {
-                  switch (texture_data_or_error.error()) {
+                  switch (image_data_or_error.error()) {
                       case Texture::LoadError::TextureNotFound: {
                           Spdlog::critical("Sprite file not found: {}", type_and_file_path.second);
-                          texture_data = Texture::CreateSinglePixel(0, 0, 0, 0);
+                          break;
+                      }
+                      case Texture::LoadError::TextureTooLarge: {
+                          Spdlog::critical("Sprite file too large: {}", type_and_file_path.second);
+                          break;
                       }
                   }
               }
 
-              all_sprites_.insert({ type_and_file_path.first, texture_data });
+              all_sprites_.insert(
+                { type_and_file_path.first, Texture::CreateFromImageData(image_data) });
+              sprite_images.insert({ type_and_file_path.first, std::move(image_data) });
           });
 
         // clang-format off
@@ -449,6 +458,8 @@ public:
     AddSprite(SoldierPartSpriteType::Dlon, SoldierPartSpriteType::Dlon, SoldierPartSpriteType::Dlon2, {16, 20}, {0.000, 0.500}, true, true, 0.0, SoldierSpriteColor::Skin, SoldierSpriteAlpha::Base);
         // clang-format on
         Spdlog::info("Loaded {} soldier part sprites", soldier_part_type_to_data_.size());
+
+        CreateSoldierPartsAtlas(sprite_images);
     }
 
     ~SpriteManager()
@@ -456,6 +467,7 @@ public:
         std::ranges::for_each(std::as_const(all_sprites_), [&](const auto& type_and_texture_data) {
             Texture::Delete(type_and_texture_data.second.opengl_id);
         });
+        Texture::Delete(soldier_parts_atlas_.opengl_id);
     }
 
     // it's not safe to be able to copy/move this because we would also need to take care of the
@@ -481,6 +493,9 @@ public:
 
     unsigned int GetSoldierPartCount() const { return soldier_part_type_to_data_.size(); }
 
+    // All textures of the soldier parts in one texture, see SoldierPartData::GetAtlasRegion
+    Texture::TextureData GetSoldierPartsAtlas() const { return soldier_parts_atlas_; }
+
     Texture::TextureData GetBulletTexture(WeaponSpriteType weapon_sprite_type) const
     {
         return all_sprites_.at(weapon_sprite_type);
@@ -730,8 +745,67 @@ private:
                                             alpha));
     }
 
+    void CreateSoldierPartsAtlas(
+      const std::unordered_map<TSpriteKey, Texture::ImageData>& sprite_images)
+    {
+        constexpr int SOLDIER_PARTS_ATLAS_WIDTH = 1024;
+
+        std::unordered_map<unsigned int, const Texture::ImageData*> texture_to_image;
+        for (const auto& [sprite_key, texture_data] : all_sprites_) {
+            texture_to_image.insert({ texture_data.opengl_id, &sprite_images.at(sprite_key) });
+        }
+
+        std::vector<unsigned int> atlas_textures;
+        for (const auto& [part_type, part_data] : soldier_part_type_to_data_) {
+            if (part_data == nullptr) {
+                continue;
+            }
+            atlas_textures.push_back(part_data->GetTexture());
+            if (part_data->IsFlippable()) {
+                atlas_textures.push_back(part_data->GetTextureFlipped());
+            }
+        }
+        std::ranges::sort(atlas_textures);
+        const auto [duplicates_begin, duplicates_end] = std::ranges::unique(atlas_textures);
+        atlas_textures.erase(duplicates_begin, duplicates_end);
+
+        std::vector<const Texture::ImageData*> atlas_images;
+        atlas_images.reserve(atlas_textures.size());
+        for (unsigned int texture : atlas_textures) {
+            atlas_images.push_back(texture_to_image.at(texture));
+        }
+
+        auto atlas_or_error = Texture::CreateAtlas(atlas_images, SOLDIER_PARTS_ATLAS_WIDTH);
+        if (!atlas_or_error.has_value()) {
+            Spdlog::critical("Soldier part sprites don't fit in a single texture");
+            soldier_parts_atlas_ = Texture::CreateSinglePixel(0, 0, 0, 0);
+            return;
+        }
+        soldier_parts_atlas_ = atlas_or_error->texture;
+
+        const auto get_region = [&](unsigned int texture) {
+            auto it = std::ranges::lower_bound(atlas_textures, texture);
+            return atlas_or_error->regions.at(it - atlas_textures.begin());
+        };
+        for (const auto& [part_type, part_data] : soldier_part_type_to_data_) {
+            if (part_data == nullptr) {
+                continue;
+            }
+            auto region = get_region(part_data->GetTexture());
+            part_data->SetAtlasRegions(
+              region,
+              part_data->IsFlippable() ? get_region(part_data->GetTextureFlipped()) : region);
+        }
+        Spdlog::info("Packed {} soldier part textures into a {}x{} atlas",
+                     atlas_textures.size(),
+                     soldier_parts_atlas_.width,
+                     soldier_parts_atlas_.height);
+    }
+
     TSoldierPartList soldier_part_type_to_data_;
 
     std::unordered_map<TSpriteKey, Texture::TextureData> all_sprites_;
+
+    Texture::TextureData soldier_parts_atlas_{ .opengl_id = 0, .width = 0, .height = 0 };
 };
 } // namespace Soldank::Sprites
@@ -2,6 +2,8 @@ module;
 
 #include <glad/glad.h>
 
+#include <algorithm>
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -71,6 +73,14 @@ public:
                offset);
     }
 
+    // Gives the buffer new storage instead of writing into the old one, so the driver doesn't
+    // have to wait for the draws still reading it
+    void Replace(const void* data, long long size, GLenum usage) const
+    {
+        glBindBuffer(GetGlTarget(), id_);
+        glBufferData(GetGlTarget(), size, data, usage);
+    }
+
 private:
     GLenum GetGlTarget() const
     {
@@ -88,4 +98,46 @@ private:
     unsigned int id_ = 0;
     GpuBufferTarget target_ = GpuBufferTarget::Array;
 };
+
+// Vertices written every frame, sub-allocated one after another from a single buffer used as a
+// ring. Every part of the ring is written once until the ring is full, then the buffer gets new
+// storage, so writing never waits for the draws that still read the older vertices.
+class StreamingGpuBuffer
+{
+public:
+    static constexpr long long DEFAULT_CAPACITY = 64LL * 1024;
+
+    StreamingGpuBuffer() = default;
+
+    explicit StreamingGpuBuffer(long long capacity)
+        : buffer_(GpuBufferTarget::Array, nullptr, capacity, GL_STREAM_DRAW)
+        , capacity_(capacity)
+    {
+    }
+
+    unsigned int GetId() const { return buffer_.GetId(); }
+
+    // Returns the index of the first written vertex, for the draw call's first vertex. Vertices
+    // are floats_per_vertex floats each.
+    int WriteVertices(std::span<const float> vertices, int floats_per_vertex)
+    {
+        const long long vertex_size = floats_per_vertex * (long long)sizeof(float);
+        const auto size = (long long)vertices.size_bytes();
+        long long offset = (write_offset_ + vertex_size - 1) / vertex_size * vertex_size;
+        if (offset + size > capacity_) {
+            capacity_ = std::max(capacity_, size);
+            buffer_.Replace(nullptr, capacity_, GL_STREAM_DRAW);
+            offset = 0;
+        }
+
+        buffer_.Update(vertices.data(), size, offset);
+        write_offset_ = offset + size;
+        return (int)(offset / vertex_size);
+    }
+
+private:
+    GpuBuffer buffer_;
+    long long capacity_ = 0;
+    long long write_offset_ = 0;
+};
 } // namespace Soldank
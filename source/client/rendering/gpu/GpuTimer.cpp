@@ -0,0 +1,175 @@
+module;
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+export module Rendering.Gpu.GpuTimer;
+
+import Shared.Core.Utility.FrameProfiler;
+
+export namespace Soldank
+{
+// Measures how long the GPU takes to run the draws between Begin and End with timer queries and
+// adds the timings to the frame profiler once the GPU has them, usually a few frames later.
+// Timer queries need GL_ARB_timer_query or GL_EXT_timer_query on desktop and
+// EXT_disjoint_timer_query_webgl2 in browsers, without them nothing is measured.
+class GpuTimer
+{
+public:
+    GpuTimer();
+    ~GpuTimer();
+
+    // it's not safe to be able to copy/move this because we would also need to take care of the
+    // created OpenGL queries
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(GpuTimer other) = delete;
+    GpuTimer(GpuTimer&&) = delete;
+    GpuTimer& operator=(GpuTimer&& other) = delete;
+
+    bool IsAvailable() const { return available_; }
+
+    // Only one pass is measured at a time, passes begun while another one is measured are skipped
+    void Begin(const FrameProfiler& frame_profiler, std::string_view name);
+    void End();
+
+    // Adds the timings the GPU has finished to the profiler, in the order the passes were begun
+    void Collect(FrameProfiler& frame_profiler);
+
+private:
+    static constexpr std::size_t MAX_PENDING_QUERIES_COUNT = 64;
+
+    struct PendingQuery
+    {
+        std::string_view name;
+        std::uint64_t frame_number;
+        // CPU time of Begin, the GPU timing has no start of its own
+        std::int64_t start_ns;
+    };
+
+    std::array<GLuint, MAX_PENDING_QUERIES_COUNT> query_ids_{};
+    std::array<PendingQuery, MAX_PENDING_QUERIES_COUNT> pending_queries_{};
+    std::size_t first_pending_query_ = 0;
+    std::size_t pending_queries_count_ = 0;
+    bool available_ = false;
+    bool measuring_ = false;
+};
+} // namespace Soldank
+
+namespace Soldank
+{
+namespace
+{
+// The glad and GLES 3.0 headers we use don't define the timer query enums
+constexpr GLenum TIME_ELAPSED_QUERY = 0x88BF;
+#ifdef __EMSCRIPTEN__
+constexpr GLenum GPU_DISJOINT = 0x8FBB;
+#endif
+
+bool AreTimerQueriesSupported()
+{
+#ifdef __EMSCRIPTEN__
+    GLint extensions_count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensions_count);
+    for (GLint i = 0; i < extensions_count; ++i) {
+        const auto* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+        // Browsers may or may not prefix the names with GL_
+        if (extension != nullptr && std::string_view(extension).find(
+                                      "EXT_disjoint_timer_query") != std::string_view::npos) {
+            return true;
+        }
+    }
+    return false;
+#else
+    const auto* extensions = (const char*)glGetString(GL_EXTENSIONS);
+    if (extensions == nullptr) {
+        return false;
+    }
+    std::string_view extensions_view(extensions);
+    return extensions_view.find("GL_ARB_timer_query") != std::string_view::npos ||
+           extensions_view.find("GL_EXT_timer_query") != std::string_view::npos;
+#endif
+}
+} // namespace
+
+GpuTimer::GpuTimer()
+    : available_(AreTimerQueriesSupported())
+{
+    if (available_) {
+        glGenQueries((GLsizei)MAX_PENDING_QUERIES_COUNT, query_ids_.data());
+    }
+}
+
+GpuTimer::~GpuTimer()
+{
+    if (available_) {
+        glDeleteQueries((GLsizei)MAX_PENDING_QUERIES_COUNT, query_ids_.data());
+    }
+}
+
+void GpuTimer::Begin(const FrameProfiler& frame_profiler, std::string_view name)
+{
+    if (!available_ || measuring_ || !frame_profiler.IsFrameInProgress() ||
+        pending_queries_count_ == MAX_PENDING_QUERIES_COUNT) {
+        return;
+    }
+
+    std::size_t query_index =
+      (first_pending_query_ + pending_queries_count_) % MAX_PENDING_QUERIES_COUNT;
+    pending_queries_.at(query_index) = { .name = name,
+                                         .frame_number = frame_profiler.GetCurrentFrameNumber(),
+                                         .start_ns = frame_profiler.Now() };
+    glBeginQuery(TIME_ELAPSED_QUERY, query_ids_.at(query_index));
+    measuring_ = true;
+}
+
+void GpuTimer::End()
+{
+    if (!measuring_) {
+        return;
+    }
+
+    glEndQuery(TIME_ELAPSED_QUERY);
+    ++pending_queries_count_;
+    measuring_ = false;
+}
+
+void GpuTimer::Collect(FrameProfiler& frame_profiler)
+{
+    if (!available_) {
+        return;
+    }
+
+    // Timings are meaningless when the GPU was interrupted, e.g. by a clock change
+    bool disjoint = false;
+#ifdef __EMSCRIPTEN__
+    GLint gpu_disjoint = 0;
+    glGetIntegerv(GPU_DISJOINT, &gpu_disjoint);
+    disjoint = gpu_disjoint != 0;
+#endif
+
+    while (pending_queries_count_ > 0) {
+        GLuint query_id = query_ids_.at(first_pending_query_);
+        GLuint result_available = 0;
+        glGetQueryObjectuiv(query_id, GL_QUERY_RESULT_AVAILABLE, &result_available);
+        if (result_available == 0) {
+            break;
+        }
+
+        // Nanoseconds, 32 bits are enough for a single pass
+        GLuint elapsed_ns = 0;
+        glGetQueryObjectuiv(query_id, GL_QUERY_RESULT, &elapsed_ns);
+        if (!disjoint) {
+            const PendingQuery& pending_query = pending_queries_.at(first_pending_query_);
+            frame_profiler.AddGpuZone(
+              pending_query.frame_number, pending_query.name, pending_query.start_ns, elapsed_ns);
+        }
+
+        first_pending_query_ = (first_pending_query_ + 1) % MAX_PENDING_QUERIES_COUNT;
+        --pending_queries_count_;
+    }
+}
+} // namespace Soldank
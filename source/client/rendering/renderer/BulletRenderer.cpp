@@ -16,6 +16,8 @@ export module BulletRenderer;
 import Extern.Glm;
 
 import Renderer;
+import RenderQueue;
+import RenderSnapshot;
 import Shader;
 import Texture;
 import SpritesManager;
@@ -40,7 +42,17 @@ public:
     BulletRenderer(BulletRenderer&&) = delete;
     BulletRenderer& operator=(BulletRenderer&& other) = delete;
 
-    void Render(glm::mat4 transform, const Bullet& bullet, double frame_percent);
+    // The bullet is drawn when the queue is executed. The queue sets the shader and the texture,
+    // so bullets sharing them don't set them again.
+    void Submit(RenderQueue& render_queue,
+                RenderLayer layer,
+                glm::mat4 transform,
+                const BulletRenderState& bullet);
+    void Submit(RenderQueue& render_queue,
+                RenderLayer layer,
+                glm::mat4 transform,
+                const Bullet& bullet,
+                double frame_percent);
 
 private:
     struct BulletSpriteData
@@ -114,14 +126,32 @@ void BulletRenderer::LoadSpriteData(const Sprites::SpriteManager& sprite_manager
     weapon_sprite_type_to_gl_data_[weapon_sprite_type] = { vbo, ebo, texture_data };
 }
 
-void BulletRenderer::Render(glm::mat4 transform, const Bullet& bullet, double frame_percent)
+void BulletRenderer::Submit(RenderQueue& render_queue,
+                            RenderLayer layer,
+                            glm::mat4 transform,
+                            const Bullet& bullet,
+                            double frame_percent)
 {
     if (!bullet.active) {
         return;
     }
 
-    auto pos =
+    auto bullet_render_state = CaptureBulletRenderState(0, bullet);
+    bullet_render_state.position =
       Calc::Lerp(bullet.particle.old_position, bullet.particle.position, (float)frame_percent);
+    bullet_render_state.timeout =
+      Calc::Lerp(bullet.timeout_prev, bullet.timeout, (float)frame_percent);
+    bullet_render_state.hit_multiply =
+      Calc::Lerp(bullet.hit_multiply_prev, bullet.hit_multiply, (float)frame_percent);
+    Submit(render_queue, layer, transform, bullet_render_state);
+}
+
+void BulletRenderer::Submit(RenderQueue& render_queue,
+                            RenderLayer layer,
+                            glm::mat4 transform,
+                            const BulletRenderState& bullet)
+{
+    auto pos = bullet.position;
 
     float rot = 0.0F;
     glm::vec2 scale;
@@ -130,11 +160,11 @@ void BulletRenderer::Render(glm::mat4 transform, const Bullet& bullet, double fr
 
     switch (bullet.style) {
         case BulletType::ThrownKnife: {
-            auto t = Calc::Lerp(bullet.timeout_prev, bullet.timeout, (float)frame_percent);
+            auto t = bullet.timeout;
             rot = 0.0F;
             scale = { 1.0F, 1.0F };
 
-            if (bullet.particle.velocity_.x >= 0.0F) {
+            if (bullet.velocity.x >= 0.0F) {
                 rot = t / std::numbers::pi;
                 bullet_sprite_data =
                   weapon_sprite_type_to_gl_data_.at(Sprites::WeaponSpriteType::Knife);
@@ -152,24 +182,23 @@ void BulletRenderer::Render(glm::mat4 transform, const Bullet& bullet, double fr
 
             scale = { 1.0F, 1.0F };
             alpha = 252.0F;
-            rot = Calc::Vec2Angle(-bullet.particle.velocity_);
+            rot = Calc::Vec2Angle(-bullet.velocity);
             break;
         }
         case BulletType::LAWMissile: {
             bullet_sprite_data =
               weapon_sprite_type_to_gl_data_.at(Sprites::WeaponSpriteType::Missile);
             scale = { 1.0F, 1.0F };
-            rot = Calc::Vec2Angle(-bullet.particle.velocity_);
+            rot = Calc::Vec2Angle(-bullet.velocity);
             break;
         }
         default: {
-            auto hit =
-              Calc::Lerp(bullet.hit_multiply_prev, bullet.hit_multiply, (float)frame_percent);
+            auto hit = bullet.hit_multiply;
 
             bullet_sprite_data =
               weapon_sprite_type_to_gl_data_.at(Sprites::WeaponSpriteType::Bullet);
 
-            scale = { Calc::Vec2Length(bullet.particle.velocity_) / 13.0F, 1.0F };
+            scale = { Calc::Vec2Length(bullet.velocity) / 13.0F, 1.0F };
             auto dist = Calc::Vec2Length(pos - bullet.initial_position);
 
             if (dist < scale.x * (float)bullet_sprite_data.texture_data.width) {
@@ -177,7 +206,7 @@ void BulletRenderer::Render(glm::mat4 transform, const Bullet& bullet, double fr
             }
             alpha = std::max(50.0F, std::min(230.0F, 255.0F * hit * (scale.x * scale.x) / 4.63F));
 
-            rot = Calc::Vec2Angle(-bullet.particle.velocity_);
+            rot = Calc::Vec2Angle(-bullet.velocity);
             break;
         }
     }
@@ -221,9 +250,6 @@ void BulletRenderer::Render(glm::mat4 transform, const Bullet& bullet, double fr
         }
     }
 
-    shader_.Use();
-    Renderer::SetupVertexArray(bullet_sprite_data.vbo, bullet_sprite_data.ebo, false, true);
-
     // TODO: magic number, this is in mod.ini
     scale /= 4.5F;
 
@@ -236,10 +262,15 @@ void BulletRenderer::Render(glm::mat4 transform, const Bullet& bullet, double fr
     current_scenery_transform =
       glm::scale(current_scenery_transform, glm::vec3(scale.x, scale.y, 0.0));
 
-    shader_.SetMatrix4("transform", current_scenery_transform);
-    shader_.SetVec4("color", glm::vec4(1.0F, 1.0F, 1.0F, alpha / 255.0F));
-
-    Renderer::BindTexture(bullet_sprite_data.texture_data.opengl_id);
-    Renderer::DrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    render_queue.Submit(
+      layer,
+      shader_.GetId(),
+      bullet_sprite_data.texture_data.opengl_id,
+      [this, bullet_sprite_data, current_scenery_transform, alpha]() {
+          Renderer::SetupVertexArray(bullet_sprite_data.vbo, bullet_sprite_data.ebo, false, true);
+          shader_.SetMatrix4("transform", current_scenery_transform);
+          shader_.SetVec4("color", glm::vec4(1.0F, 1.0F, 1.0F, alpha / 255.0F));
+          Renderer::DrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+      });
 }
 } // namespace Soldank
@@ -4,8 +4,8 @@ module;
 
 #include <glad/glad.h>
 
+#include <array>
 #include <optional>
-#include <vector>
 
 export module CircleRenderer;
 
@@ -39,7 +39,7 @@ public:
 private:
     Shader shader_;
 
-    GpuBuffer vbo_;
+    StreamingGpuBuffer vbo_;
 };
 } // namespace Soldank
 
@@ -48,10 +48,8 @@ namespace Soldank
 CircleRenderer::CircleRenderer()
     : shader_(ShaderSources::CIRCLE_VERTEX_SHADER_SOURCE,
               ShaderSources::CIRCLE_FRAGMENT_SHADER_SOURCE)
+    , vbo_(StreamingGpuBuffer::DEFAULT_CAPACITY)
 {
-    std::vector<float> vertices(18, 0.0F);
-
-    vbo_ = GpuBuffer::CreateArrayBuffer(vertices, GL_DYNAMIC_DRAW);
 }
 
 CircleRenderer::~CircleRenderer() {}
@@ -67,11 +65,8 @@ void CircleRenderer::Render(glm::mat4 transform,
     float right = outer_radius;
     float top = outer_radius;
 
-    shader_.Use();
-    Renderer::SetupVertexArray(vbo_.GetId(), std::nullopt, false, false);
-
     // clang-format off
-    std::vector<float> vertices{
+    std::array<float, 18> vertices{
         // position
         left,  bottom,  1.0,
         right, bottom,  1.0,
@@ -82,13 +77,16 @@ void CircleRenderer::Render(glm::mat4 transform,
     };
     // clang-format on
 
-    vbo_.UpdateVertices(vertices);
+    int first_vertex = vbo_.WriteVertices(vertices, 3);
+
+    shader_.Use();
+    Renderer::SetupVertexArray(vbo_.GetId(), std::nullopt, false, false);
 
     transform = glm::translate(transform, glm::vec3(position.x, -position.y, 0.0));
     shader_.SetMatrix4("transform", transform);
     shader_.SetFloat("outerRadius", outer_radius);
     shader_.SetFloat("innerRadius", inner_radius);
     shader_.SetVec4("color", color);
-    Renderer::DrawArrays(GL_TRIANGLES, 0, 6);
+    Renderer::DrawArrays(GL_TRIANGLES, first_vertex, 6);
 }
 } // namespace Soldank
@@ -5,11 +5,14 @@ module;
 
 #include <glad/glad.h>
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <numbers>
 #include <cmath>
 #include <map>
+#include <optional>
 #include <unordered_map>
-#include <vector>
 
 export module ItemRenderer;
 
@@ -17,6 +20,8 @@ import Extern.Glm;
 
 import Texture;
 import Renderer;
+import RenderSnapshot;
+import Rendering.Gpu.GpuBuffer;
 import Shader;
 import SpritesManager;
 
@@ -39,6 +44,7 @@ public:
     ItemRenderer(ItemRenderer&&) = delete;
     ItemRenderer& operator=(ItemRenderer&& other) = delete;
 
+    void Render(glm::mat4 transform, const ItemRenderState& item, unsigned int game_tick);
     void Render(glm::mat4 transform,
                 const Item& item,
                 double frame_percent,
@@ -52,17 +58,23 @@ private:
         Texture::TextureData texture_data;
     };
 
+    struct QuadCorner
+    {
+        glm::vec2 position;
+        glm::vec4 color;
+        glm::vec2 texture_position;
+    };
+
     void LoadSpriteData(const Sprites::SpriteManager& sprite_manager, ItemType item_type);
     void LoadObjectSpriteData(const Sprites::SpriteManager& sprite_manager,
                               Sprites::ObjectSpriteType object_sprite_type);
 
-    void RenderQuad(glm::mat4 transform, const Item& item, double frame_percent);
-    void RenderWeapon(glm::mat4 transform, const Item& item, double frame_percent);
+    void RenderQuad(glm::mat4 transform, const ItemRenderState& item);
+    void RenderWeapon(glm::mat4 transform, const ItemRenderState& item);
     void RenderFlagSprites(glm::mat4 transform,
-                           const Item& item,
-                           double frame_percent,
+                           const ItemRenderState& item,
                            unsigned int game_tick);
-    void RenderParachute(glm::mat4 transform, const Item& item, double frame_percent);
+    void RenderParachute(glm::mat4 transform, const ItemRenderState& item);
     void RenderSprite(glm::mat4 transform,
                       const Texture::TextureData& item_sprite_data,
                       glm::vec2 position,
@@ -70,6 +82,10 @@ private:
                       glm::vec2 scale,
                       glm::vec4 color = { 1.0F, 1.0F, 1.0F, 1.0F },
                       glm::vec2 pivot = { 0.0F, 0.0F });
+    // Corners go around the quad, the quad is drawn as two triangles
+    void DrawQuad(glm::mat4 transform,
+                  const std::array<QuadCorner, 4>& corners,
+                  unsigned int texture_id);
 
     static glm::vec4 GetQuadMainColor(ItemType item_type);
     static glm::vec4 GetQuadTopColor(ItemType item_type);
@@ -82,8 +98,7 @@ private:
     std::unordered_map<Sprites::ObjectSpriteType, Texture::TextureData>
       object_sprite_type_to_gl_data_;
 
-    unsigned vbo_;
-    unsigned ebo_;
+    StreamingGpuBuffer vbo_;
 };
 } // namespace Soldank
 
@@ -91,6 +106,7 @@ namespace Soldank
 {
 ItemRenderer::ItemRenderer(const Sprites::SpriteManager& sprite_manager)
     : shader_(ShaderSources::VERTEX_SHADER_SOURCE, ShaderSources::FRAGMENT_SHADER_SOURCE)
+    , vbo_(StreamingGpuBuffer::DEFAULT_CAPACITY)
 {
     // Flags
     LoadSpriteData(sprite_manager, ItemType::AlphaFlag);
@@ -129,28 +145,9 @@ ItemRenderer::ItemRenderer(const Sprites::SpriteManager& sprite_manager)
     LoadObjectSpriteData(sprite_manager, Sprites::ObjectSpriteType::ParaRope);
     LoadObjectSpriteData(sprite_manager, Sprites::ObjectSpriteType::Para);
     LoadObjectSpriteData(sprite_manager, Sprites::ObjectSpriteType::Para2);
-
-    // generate vertices
-    // clang-format off
-    std::vector<float> vertices{
-      // position         // color                  // texture
-      0.0F, 0.0F, 1.0F,   1.0F, 1.0F, 1.0F, 1.0F,   0.0F, 0.0F,
-      0.0F, 0.0F, 1.0F,   1.0F, 1.0F, 1.0F, 1.0F,   1.0F, 0.0F,
-      0.0F, 0.0F, 1.0F,   1.0F, 1.0F, 1.0F, 1.0F,   1.0F, 1.0F,
-      0.0F, 0.0F, 1.0F,   1.0F, 1.0F, 1.0F, 1.0F,   0.0F, 1.0F
-    };
-    // clang-format on
-
-    vbo_ = Renderer::CreateVBO(vertices, GL_DYNAMIC_DRAW);
-    std::vector<unsigned int> indices{ 0, 1, 3, 1, 2, 3 };
-    ebo_ = Renderer::CreateEBO(indices, GL_STATIC_DRAW);
 }
 
-ItemRenderer::~ItemRenderer()
-{
-    Renderer::FreeVBO(vbo_);
-    Renderer::FreeEBO(ebo_);
-}
+ItemRenderer::~ItemRenderer() {}
 
 void ItemRenderer::LoadSpriteData(const Sprites::SpriteManager& sprite_manager, ItemType item_type)
 {
@@ -176,6 +173,17 @@ void ItemRenderer::Render(glm::mat4 transform,
         return;
     }
 
+    auto item_render_state = CaptureItemRenderState(item);
+    const auto& particles = item.skeleton->GetParticles();
+    for (std::size_t i = 0; i < ITEM_RENDER_POSITIONS_COUNT && i < particles.size(); ++i) {
+        item_render_state.positions.at(i) = Calc::Lerp(
+          particles[i].old_position, particles[i].position, (float)frame_percent);
+    }
+    Render(transform, item_render_state, game_tick);
+}
+
+void ItemRenderer::Render(glm::mat4 transform, const ItemRenderState& item, unsigned int game_tick)
+{
     if (IsItemTypeFlag(item.style)) {
         // fade out (sort of)
         if (item.time_out < 300) {
@@ -183,39 +191,36 @@ void ItemRenderer::Render(glm::mat4 transform,
                 return;
             }
         }
-        RenderFlagSprites(transform, item, frame_percent, game_tick);
-        RenderQuad(transform, item, frame_percent);
+        RenderFlagSprites(transform, item, game_tick);
+        RenderQuad(transform, item);
     }
 
     if (IsItemTypeWeapon(item.style)) {
-        RenderWeapon(transform, item, frame_percent);
+        RenderWeapon(transform, item);
     }
 
     if (IsItemTypeKit(item.style)) {
-        RenderQuad(transform, item, frame_percent);
+        RenderQuad(transform, item);
     }
 
     if (item.style == ItemType::Parachute) {
-        RenderParachute(transform, item, frame_percent);
+        RenderParachute(transform, item);
     }
 }
 
-void ItemRenderer::RenderQuad(glm::mat4 transform, const Item& item, double frame_percent)
+void ItemRenderer::RenderQuad(glm::mat4 transform, const ItemRenderState& item)
 {
     const auto& item_sprite_data = item_sprite_type_to_gl_data_.at(item.style);
-    glm::vec2 pos =
-      Calc::Lerp(item.skeleton->GetOldPos(1), item.skeleton->GetPos(1), (float)frame_percent);
+    glm::vec2 pos = item.positions[0];
     auto main_color = GetQuadMainColor(item.style);
     auto top_color = GetQuadTopColor(item.style);
     auto low_color = GetQuadLowColor(item.style);
 
-    shader_.Use();
-
     // Set corners of the item on a (0,0) anchor from 1st corner
-    glm::vec2 pos1 = item.skeleton->GetPos(1) - item.skeleton->GetPos(1);
-    glm::vec2 pos2 = item.skeleton->GetPos(2) - item.skeleton->GetPos(1);
-    glm::vec2 pos3 = item.skeleton->GetPos(3) - item.skeleton->GetPos(1);
-    glm::vec2 pos4 = item.skeleton->GetPos(4) - item.skeleton->GetPos(1);
+    glm::vec2 pos1 = item.positions[0] - item.positions[0];
+    glm::vec2 pos2 = item.positions[1] - item.positions[0];
+    glm::vec2 pos3 = item.positions[2] - item.positions[0];
+    glm::vec2 pos4 = item.positions[3] - item.positions[0];
 
     if (IsItemTypeFlag(item.style)) {
         // Move up the position at the handle to halfway between it and the flag tip
@@ -230,15 +235,9 @@ void ItemRenderer::RenderQuad(glm::mat4 transform, const Item& item, double fram
     pos3.y = -pos3.y;
     pos4.y = -pos4.y;
 
-    // clang-format off
-    std::vector<float> vertices{
-      // position             // color                                          // texture
-      pos1.x, pos1.y, 1.0F,   main_color.x, main_color.y, main_color.z, 1.0F,   0.0F, 0.0F,
-      pos2.x, pos2.y, 1.0F,   low_color.x, low_color.y, low_color.z, 1.0F,   1.0F, 0.0F,
-      pos3.x, pos3.y, 1.0F,   main_color.x, main_color.y, main_color.z, 1.0F,   1.0F, 1.0F,
-      pos4.x, pos4.y, 1.0F,   top_color.x, top_color.y, top_color.z, 1.0F,   0.0F, 1.0F
-    };
-    // clang-format on
+    main_color.w = 1.0F;
+    top_color.w = 1.0F;
+    low_color.w = 1.0F;
 
     glm::mat4 current_scenery_transform = transform;
 
@@ -246,20 +245,18 @@ void ItemRenderer::RenderQuad(glm::mat4 transform, const Item& item, double fram
     current_scenery_transform =
       glm::translate(current_scenery_transform, glm::vec3(pos.x, -pos.y, 0.0));
 
-    shader_.SetMatrix4("transform", current_scenery_transform);
-
-    Renderer::ModifyVBOVertices(vbo_, vertices);
-    Renderer::SetupVertexArray(vbo_, ebo_, true, true);
-    Renderer::BindTexture(item_sprite_data.opengl_id);
-    Renderer::DrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    DrawQuad(current_scenery_transform,
+             { { { pos1, main_color, { 0.0F, 0.0F } },
+                 { pos2, low_color, { 1.0F, 0.0F } },
+                 { pos3, main_color, { 1.0F, 1.0F } },
+                 { pos4, top_color, { 0.0F, 1.0F } } } },
+             item_sprite_data.opengl_id);
 }
 
-void ItemRenderer::RenderWeapon(glm::mat4 transform, const Item& item, double frame_percent)
+void ItemRenderer::RenderWeapon(glm::mat4 transform, const ItemRenderState& item)
 {
-    glm::vec2 position =
-      Calc::Lerp(item.skeleton->GetOldPos(1), item.skeleton->GetPos(1), (float)frame_percent);
-    glm::vec2 position2 =
-      Calc::Lerp(item.skeleton->GetOldPos(2), item.skeleton->GetPos(2), (float)frame_percent);
+    glm::vec2 position = item.positions[0];
+    glm::vec2 position2 = item.positions[1];
     float rotation = Calc::Vec2Angle(position2 - position);
     glm::vec2 scale = { 1.0F, 1.0F };
     scale /= 4.5F;
@@ -288,14 +285,11 @@ void ItemRenderer::RenderWeapon(glm::mat4 transform, const Item& item, double fr
 }
 
 void ItemRenderer::RenderFlagSprites(glm::mat4 transform,
-                                     const Item& item,
-                                     double frame_percent,
+                                     const ItemRenderState& item,
                                      unsigned int game_tick)
 {
-    glm::vec2 skeleton_position_1 =
-      Calc::Lerp(item.skeleton->GetOldPos(1), item.skeleton->GetPos(1), (float)frame_percent);
-    glm::vec2 skeleton_position_2 =
-      Calc::Lerp(item.skeleton->GetOldPos(2), item.skeleton->GetPos(2), (float)frame_percent);
+    glm::vec2 skeleton_position_1 = item.positions[0];
+    glm::vec2 skeleton_position_2 = item.positions[1];
     float rotation = Calc::Vec2Angle(skeleton_position_2 - skeleton_position_1);
     glm::vec2 scale = { 1.0F, 1.0F };
     scale /= 4.5F;
@@ -329,7 +323,7 @@ void ItemRenderer::RenderFlagSprites(glm::mat4 transform,
     }
 }
 
-void ItemRenderer::RenderParachute(glm::mat4 transform, const Item& item, double frame_percent)
+void ItemRenderer::RenderParachute(glm::mat4 transform, const ItemRenderState& item)
 {
     const Texture::TextureData& parachute1_texture =
       object_sprite_type_to_gl_data_.at(Sprites::ObjectSpriteType::Para);
@@ -338,14 +332,10 @@ void ItemRenderer::RenderParachute(glm::mat4 transform, const Item& item, double
     const Texture::TextureData& parachute_rope_texture =
       object_sprite_type_to_gl_data_.at(Sprites::ObjectSpriteType::ParaRope);
 
-    glm::vec2 skeleton_position_1 =
-      Calc::Lerp(item.skeleton->GetOldPos(1), item.skeleton->GetPos(1), (float)frame_percent);
-    glm::vec2 skeleton_position_2 =
-      Calc::Lerp(item.skeleton->GetOldPos(2), item.skeleton->GetPos(2), (float)frame_percent);
-    glm::vec2 skeleton_position_3 =
-      Calc::Lerp(item.skeleton->GetOldPos(3), item.skeleton->GetPos(3), (float)frame_percent);
-    glm::vec2 skeleton_position_4 =
-      Calc::Lerp(item.skeleton->GetOldPos(4), item.skeleton->GetPos(4), (float)frame_percent);
+    glm::vec2 skeleton_position_1 = item.positions[0];
+    glm::vec2 skeleton_position_2 = item.positions[1];
+    glm::vec2 skeleton_position_3 = item.positions[2];
+    glm::vec2 skeleton_position_4 = item.positions[3];
 
     glm::vec2 scale = { 1.0F, 1.0F };
     scale /= 4.5F;
@@ -406,7 +396,6 @@ void ItemRenderer::RenderSprite(glm::mat4 transform,
                                 glm::vec4 color,
                                 glm::vec2 pivot)
 {
-    shader_.Use();
     pivot.x *= (float)item_sprite_data.width;
     pivot.y *= (float)item_sprite_data.height;
     float w0 = 0.0F - pivot.x;
@@ -418,16 +407,6 @@ void ItemRenderer::RenderSprite(glm::mat4 transform,
     glm::vec2 pos3 = { w1, h1 };
     glm::vec2 pos4 = { w0, h1 };
 
-    // clang-format off
-    std::vector<float> vertices{
-      // position             // color                              // texture
-      pos1.x, pos1.y, 1.0F,   color.x, color.y, color.z, color.w,   0.0F, 0.0F,
-      pos2.x, pos2.y, 1.0F,   color.x, color.y, color.z, color.w,   1.0F, 0.0F,
-      pos3.x, pos3.y, 1.0F,   color.x, color.y, color.z, color.w,   1.0F, 1.0F,
-      pos4.x, pos4.y, 1.0F,   color.x, color.y, color.z, color.w,   0.0F, 1.0F
-    };
-    // clang-format on
-
     glm::mat4 current_scenery_transform = transform;
 
     // We need to move the corners from (0,0) anchor to the position on the map
@@ -438,12 +417,44 @@ void ItemRenderer::RenderSprite(glm::mat4 transform,
     current_scenery_transform =
       glm::scale(current_scenery_transform, glm::vec3(scale.x, scale.y, 0.0));
 
-    shader_.SetMatrix4("transform", current_scenery_transform);
+    DrawQuad(current_scenery_transform,
+             { { { pos1, color, { 0.0F, 0.0F } },
+                 { pos2, color, { 1.0F, 0.0F } },
+                 { pos3, color, { 1.0F, 1.0F } },
+                 { pos4, color, { 0.0F, 1.0F } } } },
+             item_sprite_data.opengl_id);
+}
+
+void ItemRenderer::DrawQuad(glm::mat4 transform,
+                            const std::array<QuadCorner, 4>& corners,
+                            unsigned int texture_id)
+{
+    constexpr std::array<unsigned int, 6> QUAD_CORNER_INDICES{ 0, 1, 3, 1, 2, 3 };
+    constexpr int FLOATS_PER_VERTEX = 9;
+
+    std::array<float, QUAD_CORNER_INDICES.size() * FLOATS_PER_VERTEX> vertices{};
+    auto vertex = vertices.begin();
+    for (unsigned int corner_index : QUAD_CORNER_INDICES) {
+        const auto& corner = corners.at(corner_index);
+        vertex = std::ranges::copy(std::array{ corner.position.x,
+                                               corner.position.y,
+                                               1.0F,
+                                               corner.color.x,
+                                               corner.color.y,
+                                               corner.color.z,
+                                               corner.color.w,
+                                               corner.texture_position.x,
+                                               corner.texture_position.y },
+                                   vertex)
+                   .out;
+    }
+    int first_vertex = vbo_.WriteVertices(vertices, FLOATS_PER_VERTEX);
 
-    Renderer::ModifyVBOVertices(vbo_, vertices);
-    Renderer::SetupVertexArray(vbo_, ebo_, true, true);
-    Renderer::BindTexture(item_sprite_data.opengl_id);
-    Renderer::DrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    shader_.Use();
+    shader_.SetMatrix4("transform", transform);
+    Renderer::SetupVertexArray(vbo_.GetId(), std::nullopt, true, true);
+    Renderer::BindTexture(texture_id);
+    Renderer::DrawArrays(GL_TRIANGLES, first_vertex, (int)QUAD_CORNER_INDICES.size());
 }
 
 glm::vec4 ItemRenderer::GetQuadMainColor(ItemType item_type)
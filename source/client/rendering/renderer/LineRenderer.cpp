@@ -4,9 +4,9 @@ module;
 
 #include <glad/glad.h>
 
+#include <array>
 #include <cmath>
 #include <optional>
-#include <vector>
 
 export module LineRenderer;
 
@@ -36,7 +36,7 @@ public:
 private:
     Shader shader_;
 
-    GpuBuffer vbo_;
+    StreamingGpuBuffer vbo_;
 };
 } // namespace Soldank
 
@@ -45,16 +45,8 @@ namespace Soldank
 LineRenderer::LineRenderer()
     : shader_(ShaderSources::DYNAMIC_COLOR_NO_TEXTURE_VERTEX_SHADER_SOURCE,
               ShaderSources::DYNAMIC_COLOR_NO_TEXTURE_FRAGMENT_SHADER_SOURCE)
+    , vbo_(StreamingGpuBuffer::DEFAULT_CAPACITY)
 {
-    std::vector<float> vertices;
-
-    for (unsigned int i = 0; i < 4; i++) {
-        vertices.push_back(0.0F);
-        vertices.push_back(0.0F);
-        vertices.push_back(0.0F);
-    }
-
-    vbo_ = GpuBuffer::CreateArrayBuffer(vertices, GL_DYNAMIC_DRAW);
 }
 
 LineRenderer::~LineRenderer() {}
@@ -81,7 +73,7 @@ void LineRenderer::Render(glm::mat4 transform,
 
     // Vertex positions for a thick line (rectangle)
     // clang-format off
-    std::vector<float> vertices{
+    std::array vertices{
         p1.x + px, p1.y + py, 1.0F,  // First vertex (offset from start point)
         p1.x - px, p1.y - py, 1.0F,  // Second vertex (opposite side of the start point)
         p2.x + px, p2.y + py, 1.0F,  // Third vertex (offset from end point)
@@ -89,13 +81,13 @@ void LineRenderer::Render(glm::mat4 transform,
     };
     // clang-format on
 
+    int first_vertex = vbo_.WriteVertices(vertices, 3);
+
     shader_.Use();
     Renderer::SetupVertexArray(vbo_.GetId(), std::nullopt, false, false);
     shader_.SetMatrix4("transform", transform);
     shader_.SetVec4("color", color);
 
-    vbo_.UpdateVertices(vertices);
-
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    Renderer::DrawArrays(GL_TRIANGLE_STRIP, first_vertex, 4);
 }
 } // namespace Soldank
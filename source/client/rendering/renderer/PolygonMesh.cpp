@@ -0,0 +1,211 @@
+module;
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <span>
+#include <utility>
+#include <vector>
+
+export module PolygonMesh;
+
+import Extern.Glm;
+
+import Shared.Core.Map.PMSStructs;
+
+export namespace Soldank
+{
+// Polygons are grouped into square chunks by their centers. Positions are stored relative to the
+// chunk's center in 1/POLYGON_MESH_POSITION_SCALE units, so they can reach this far from it:
+// std::numeric_limits<std::int16_t>::max() / POLYGON_MESH_POSITION_SCALE
+// Polygons reaching further than that from their chunk's center get a chunk of their own, centered
+// on the polygon's center snapped to the packed positions' grid.
+constexpr float POLYGON_MESH_CHUNK_SIZE = 1024.0F;
+constexpr float POLYGON_MESH_POSITION_SCALE = 4.0F;
+
+struct PolygonMeshVertex
+{
+    std::int16_t x;
+    std::int16_t y;
+    std::array<std::uint8_t, 4> color;
+    float texture_s;
+    float texture_t;
+};
+static_assert(sizeof(PolygonMeshVertex) == 16);
+
+struct PolygonMeshChunk
+{
+    glm::vec2 origin;
+    unsigned int first_vertex;
+    unsigned int vertices_count;
+};
+
+// The map's polygons baked into vertices that don't change until the polygons do. Vertices of a
+// chunk are next to each other, in the order of the polygons' ids.
+struct PolygonMesh
+{
+    std::vector<PolygonMeshVertex> vertices;
+    std::vector<PolygonMeshChunk> chunks;
+    // Indexed by polygon id
+    std::vector<unsigned int> polygon_chunks;
+    std::vector<unsigned int> polygon_first_vertices;
+    // Vertices too far even from the center of their own polygon, moved to the closest position
+    // that fits
+    unsigned int clamped_vertices_count = 0;
+};
+
+struct PolygonMeshDrawRange
+{
+    unsigned int chunk;
+    unsigned int first_vertex;
+    unsigned int vertices_count;
+};
+
+PolygonMesh BakePolygonMesh(std::span<const PMSPolygon> polygons)
+{
+    constexpr float MAX_POSITION = std::numeric_limits<std::int16_t>::max();
+
+    PolygonMesh polygon_mesh;
+    polygon_mesh.polygon_chunks.reserve(polygons.size());
+    polygon_mesh.polygon_first_vertices.resize(polygons.size());
+
+    const auto get_render_position = [](const PMSVertex& vertex) {
+        return glm::vec2(vertex.x, -vertex.y);
+    };
+    // In 1/POLYGON_MESH_POSITION_SCALE units, before it's clamped to what fits
+    const auto get_packed_offset = [&](const PMSVertex& vertex, glm::vec2 origin) {
+        glm::vec2 offset = (get_render_position(vertex) - origin) * POLYGON_MESH_POSITION_SCALE;
+        return glm::vec2(std::round(offset.x), std::round(offset.y));
+    };
+    // Own chunks are centered on this grid like the cells' origins are, so vertices shared with
+    // polygons of other chunks end up at the same packed positions
+    const auto snap_to_position_grid = [](glm::vec2 position) {
+        return glm::vec2(std::round(position.x * POLYGON_MESH_POSITION_SCALE),
+                         std::round(position.y * POLYGON_MESH_POSITION_SCALE)) /
+               POLYGON_MESH_POSITION_SCALE;
+    };
+    const auto fits_chunk = [&](const PMSPolygon& polygon, glm::vec2 origin) {
+        return std::ranges::all_of(polygon.vertices, [&](const PMSVertex& vertex) {
+            glm::vec2 offset = get_packed_offset(vertex, origin);
+            return std::abs(offset.x) <= MAX_POSITION && std::abs(offset.y) <= MAX_POSITION;
+        });
+    };
+
+    // Chunks are ordered by their lowest polygon id, so that polygons drawn in the order of their
+    // ids mostly go through the vertices in order too
+    std::map<std::pair<int, int>, unsigned int> cell_to_chunk;
+    std::vector<std::vector<unsigned int>> chunk_polygon_ids;
+    for (unsigned int polygon_id = 0; polygon_id < polygons.size(); ++polygon_id) {
+        const PMSPolygon& polygon = polygons[polygon_id];
+        glm::vec2 center{ 0.0F };
+        for (const auto& vertex : polygon.vertices) {
+            center += get_render_position(vertex);
+        }
+        center /= (float)polygon.vertices.size();
+        std::pair<int, int> cell{ (int)std::floor(center.x / POLYGON_MESH_CHUNK_SIZE),
+                                  (int)std::floor(center.y / POLYGON_MESH_CHUNK_SIZE) };
+        glm::vec2 cell_origin =
+          (glm::vec2(cell.first, cell.second) + 0.5F) * POLYGON_MESH_CHUNK_SIZE;
+
+        unsigned int chunk_id = polygon_mesh.chunks.size();
+        if (!fits_chunk(polygon, cell_origin)) {
+            polygon_mesh.chunks.push_back({ .origin = snap_to_position_grid(center),
+                                            .first_vertex = 0,
+                                            .vertices_count = 0 });
+            chunk_polygon_ids.emplace_back();
+        } else {
+            auto [it, inserted] = cell_to_chunk.try_emplace(cell, chunk_id);
+            if (inserted) {
+                polygon_mesh.chunks.push_back(
+                  { .origin = cell_origin, .first_vertex = 0, .vertices_count = 0 });
+                chunk_polygon_ids.emplace_back();
+            }
+            chunk_id = it->second;
+        }
+        polygon_mesh.polygon_chunks.push_back(chunk_id);
+        chunk_polygon_ids.at(chunk_id).push_back(polygon_id);
+    }
+
+    polygon_mesh.vertices.reserve(polygons.size() * 3);
+    for (unsigned int chunk_id = 0; chunk_id < polygon_mesh.chunks.size(); ++chunk_id) {
+        auto& chunk = polygon_mesh.chunks.at(chunk_id);
+        chunk.first_vertex = polygon_mesh.vertices.size();
+        for (unsigned int polygon_id : chunk_polygon_ids.at(chunk_id)) {
+            polygon_mesh.polygon_first_vertices.at(polygon_id) = polygon_mesh.vertices.size();
+            for (const auto& vertex : polygons[polygon_id].vertices) {
+                glm::vec2 position = get_packed_offset(vertex, chunk.origin);
+                glm::vec2 clamped_position(std::clamp(position.x, -MAX_POSITION, MAX_POSITION),
+                                           std::clamp(position.y, -MAX_POSITION, MAX_POSITION));
+                if (clamped_position != position) {
+                    ++polygon_mesh.clamped_vertices_count;
+                }
+
+                polygon_mesh.vertices.push_back({
+                  .x = (std::int16_t)clamped_position.x,
+                  .y = (std::int16_t)clamped_position.y,
+                  .color = { vertex.color.red,
+                             vertex.color.green,
+                             vertex.color.blue,
+                             vertex.color.alpha },
+                  .texture_s = vertex.texture_s,
+                  .texture_t = vertex.texture_t,
+                });
+            }
+        }
+        chunk.vertices_count = polygon_mesh.vertices.size() - chunk.first_vertex;
+    }
+
+    return polygon_mesh;
+}
+
+// Ranges of vertices that draw the polygons listed in polygon_ids. Ranges are ordered by chunk
+// and the vertices within it, so polygons of one chunk are drawn together, in the order of their
+// ids, and polygons next to each other in the chunk are merged into one range wherever they are
+// in polygon_ids.
+void GetPolygonMeshDrawRanges(const PolygonMesh& polygon_mesh,
+                              std::span<const unsigned int> polygon_ids,
+                              std::vector<PolygonMeshDrawRange>& draw_ranges)
+{
+    const auto append_range = [&draw_ranges](std::size_t& ranges_count,
+                                              const PolygonMeshDrawRange& draw_range) {
+        if (ranges_count > 0) {
+            auto& last_range = draw_ranges[ranges_count - 1];
+            if (last_range.chunk == draw_range.chunk &&
+                last_range.first_vertex + last_range.vertices_count == draw_range.first_vertex) {
+                last_range.vertices_count += draw_range.vertices_count;
+                return;
+            }
+        }
+        draw_ranges[ranges_count++] = draw_range;
+    };
+
+    // Polygons listed one after another are mostly next to each other in the mesh too, merging
+    // them first leaves fewer ranges to sort
+    draw_ranges.resize(polygon_ids.size());
+    std::size_t ranges_count = 0;
+    for (unsigned int polygon_id : polygon_ids) {
+        if (polygon_id >= polygon_mesh.polygon_first_vertices.size()) {
+            continue;
+        }
+
+        append_range(ranges_count,
+                     { .chunk = polygon_mesh.polygon_chunks[polygon_id],
+                       .first_vertex = polygon_mesh.polygon_first_vertices[polygon_id],
+                       .vertices_count = 3 });
+    }
+    draw_ranges.resize(ranges_count);
+
+    // Vertices of the chunks follow each other in the order of the chunks
+    std::ranges::sort(draw_ranges, {}, &PolygonMeshDrawRange::first_vertex);
+    const std::size_t sorted_ranges_count = ranges_count;
+    ranges_count = 0;
+    for (std::size_t i = 0; i < sorted_ranges_count; ++i) {
+        append_range(ranges_count, draw_ranges[i]);
+    }
+    draw_ranges.resize(ranges_count);
+}
+} // namespace Soldank
@@ -5,9 +5,11 @@ module;
 #include <glad/glad.h>
 
 #include <array>
+#include <cstddef>
 #include <filesystem>
 #include <vector>
 #include <optional>
+#include <span>
 #include <string>
 
 export module PolygonsRenderer;
@@ -16,10 +18,11 @@ import Extern.Glm;
 
 import Texture;
 import Renderer;
+import Rendering.Gpu.GpuBuffer;
+import PolygonMesh;
 import Shader;
 
 import Shared.Core.Map.Map;
-import Shared.Core.Map.PMSConstants;
 import Shared.Core.Map.PMSStructs;
 
 import Extern.Spdlog;
@@ -39,7 +42,9 @@ public:
     PolygonsRenderer(PolygonsRenderer&&) = delete;
     PolygonsRenderer& operator=(PolygonsRenderer&& other) = delete;
 
-    void Render(glm::mat4 transform);
+    // Draws the polygons listed in polygon_ids, which have to be in increasing order. Runs of
+    // polygons next to each other in the baked mesh are drawn with a single draw call.
+    void Render(glm::mat4 transform, std::span<const unsigned int> polygon_ids);
     void RenderSinglePolygonFirstEdge(glm::mat4 transform, const PMSPolygon& polygon) const;
     void RenderSinglePolygon(glm::mat4 transform, const PMSPolygon& polygon) const;
 
@@ -47,23 +52,20 @@ public:
     unsigned int GetTextureOpenGLID() const { return texture_; };
 
 private:
-    void OnAddPolygon(const PMSPolygon& new_polygon);
-    void OnRemovePolygon(const std::vector<PMSPolygon>& polygons_after_removal);
-    void OnAddPolygons(const std::vector<PMSPolygon>& polygons_after_adding);
-    void OnRemovePolygons(const std::vector<PMSPolygon>& polygons_after_removal);
-    void OnModifyPolygons(const std::vector<PMSPolygon>& polygons_after_modify);
-
-    static void GenerateGLBufferVertices(const std::vector<PMSPolygon>& polygons,
-                                         std::vector<float>& destination_vertices);
+    // Polygons are only baked when the map's polygons change, which happens only in the editor
+    void BakePolygons(const std::vector<PMSPolygon>& polygons);
+
     static void GenerateGLBufferVerticesForPolygon(const PMSPolygon& polygon,
                                                    std::vector<float>& destination_vertices);
     void LoadTexture(const std::string& texture_name);
 
     Shader shader_;
-    unsigned int polygons_count_;
+    Shader mesh_shader_;
 
     unsigned int texture_;
-    unsigned int vbo_;
+    PolygonMesh polygon_mesh_;
+    GpuBuffer vbo_;
+    std::vector<PolygonMeshDrawRange> draw_ranges_;
     unsigned int single_polygon_vbo_;
 
     glm::vec2 texture_dimensions_;
@@ -74,17 +76,14 @@ namespace Soldank
 {
 PolygonsRenderer::PolygonsRenderer(Map& map, const std::string& texture_name)
     : shader_(ShaderSources::VERTEX_SHADER_SOURCE, ShaderSources::FRAGMENT_SHADER_SOURCE)
-    , polygons_count_(map.GetPolygonsCount())
+    , mesh_shader_(ShaderSources::POLYGON_MESH_VERTEX_SHADER_SOURCE,
+                   ShaderSources::FRAGMENT_SHADER_SOURCE)
 {
     LoadTexture(map.GetTextureName());
 
-    std::vector<float> vertices;
-
-    GenerateGLBufferVertices(map.GetPolygons(), vertices);
+    BakePolygons(map.GetPolygons());
 
-    vbo_ = Renderer::CreateVBO(vertices, GL_DYNAMIC_DRAW);
-
-    vertices.clear();
+    std::vector<float> vertices;
     for (unsigned int i = 0; i < 3; ++i) {
         for (unsigned int j = 0; j < 9; ++j) {
             vertices.push_back(0.0F);
@@ -93,11 +92,11 @@ PolygonsRenderer::PolygonsRenderer(Map& map, const std::string& texture_name)
     single_polygon_vbo_ = Renderer::CreateVBO(vertices, GL_DYNAMIC_DRAW);
 
     map.GetMapChangeEvents().added_new_polygon.AddObserver(
-      [this](const PMSPolygon& new_polygon) { OnAddPolygon(new_polygon); });
+      [this, &map](const PMSPolygon& /*new_polygon*/) { BakePolygons(map.GetPolygons()); });
     map.GetMapChangeEvents().removed_polygon.AddObserver(
       [this](const PMSPolygon& /*removed_polygon*/,
              const std::vector<PMSPolygon>& polygons_after_removal) {
-          OnRemovePolygon(polygons_after_removal);
+          BakePolygons(polygons_after_removal);
       });
     map.GetMapChangeEvents().changed_texture_name.AddObserver(
       [this](const std::string& texture_name) {
@@ -107,33 +106,47 @@ PolygonsRenderer::PolygonsRenderer(Map& map, const std::string& texture_name)
     map.GetMapChangeEvents().added_new_polygons.AddObserver(
       [this](const std::vector<PMSPolygon>& /*created_polygons*/,
              const std::vector<PMSPolygon>& polygons_after_adding) {
-          OnAddPolygons(polygons_after_adding);
+          BakePolygons(polygons_after_adding);
       });
     map.GetMapChangeEvents().removed_polygons.AddObserver(
       [this](const std::vector<PMSPolygon>& /*removed_polygons*/,
              const std::vector<PMSPolygon>& polygons_after_removal) {
-          OnRemovePolygons(polygons_after_removal);
+          BakePolygons(polygons_after_removal);
       });
     map.GetMapChangeEvents().modified_polygons.AddObserver(
       [this](const std::vector<PMSPolygon>& polygons_after_modify) {
-          OnModifyPolygons(polygons_after_modify);
+          BakePolygons(polygons_after_modify);
       });
 }
 
 PolygonsRenderer::~PolygonsRenderer()
 {
-    Renderer::FreeVBO(vbo_);
     Renderer::FreeVBO(single_polygon_vbo_);
     Texture::Delete(texture_);
 }
 
-void PolygonsRenderer::Render(glm::mat4 transform)
+void PolygonsRenderer::Render(glm::mat4 transform, std::span<const unsigned int> polygon_ids)
 {
-    Renderer::SetupVertexArray(vbo_, std::nullopt);
-    shader_.Use();
+    GetPolygonMeshDrawRanges(polygon_mesh_, polygon_ids, draw_ranges_);
+    if (draw_ranges_.empty()) {
+        return;
+    }
+
+    Renderer::SetupPackedVertexArray(vbo_.GetId());
+    mesh_shader_.Use();
     Renderer::BindTexture(texture_);
-    shader_.SetMatrix4("transform", transform);
-    Renderer::DrawArrays(GL_TRIANGLES, 0, (int)polygons_count_ * 3);
+    mesh_shader_.SetMatrix4("transform", transform);
+    mesh_shader_.SetFloat("positionScale", POLYGON_MESH_POSITION_SCALE);
+
+    std::optional<unsigned int> current_chunk;
+    for (const auto& draw_range : draw_ranges_) {
+        if (current_chunk != draw_range.chunk) {
+            mesh_shader_.SetVec2("chunkOrigin", polygon_mesh_.chunks.at(draw_range.chunk).origin);
+            current_chunk = draw_range.chunk;
+        }
+        Renderer::DrawArrays(
+          GL_TRIANGLES, (int)draw_range.first_vertex, (int)draw_range.vertices_count);
+    }
 }
 
 void PolygonsRenderer::RenderSinglePolygonFirstEdge(glm::mat4 transform,
@@ -163,65 +176,19 @@ void PolygonsRenderer::RenderSinglePolygon(glm::mat4 transform, const PMSPolygon
     Renderer::DrawArrays(GL_TRIANGLES, 0, 3);
 }
 
-void PolygonsRenderer::OnAddPolygon(const PMSPolygon& new_polygon)
-{
-    std::vector<float> vertices;
-    GenerateGLBufferVerticesForPolygon(new_polygon, vertices);
-
-    int offset = new_polygon.id * 9 * sizeof(GLfloat) * 3;
-    Renderer::ModifyVBOVertices(vbo_, vertices, offset);
-    ++polygons_count_;
-}
-
-void PolygonsRenderer::OnRemovePolygon(const std::vector<PMSPolygon>& polygons_after_removal)
-{
-    std::vector<float> vertices;
-    GenerateGLBufferVertices(polygons_after_removal, vertices);
-    polygons_count_ = vertices.size();
-
-    if (!vertices.empty()) {
-        Renderer::ModifyVBOVertices(vbo_, vertices, 0);
-    }
-}
-
-void PolygonsRenderer::OnAddPolygons(const std::vector<PMSPolygon>& polygons_after_adding)
-{
-    std::vector<float> vertices;
-    GenerateGLBufferVertices(polygons_after_adding, vertices);
-    Renderer::ModifyVBOVertices(vbo_, vertices);
-    polygons_count_ = polygons_after_adding.size();
-}
-
-void PolygonsRenderer::OnRemovePolygons(const std::vector<PMSPolygon>& polygons_after_removal)
-{
-    std::vector<float> vertices;
-    GenerateGLBufferVertices(polygons_after_removal, vertices);
-    Renderer::ModifyVBOVertices(vbo_, vertices);
-    polygons_count_ = polygons_after_removal.size();
-}
-
-void PolygonsRenderer::OnModifyPolygons(const std::vector<PMSPolygon>& polygons_after_modify)
+void PolygonsRenderer::BakePolygons(const std::vector<PMSPolygon>& polygons)
 {
-    std::vector<float> vertices;
-    GenerateGLBufferVertices(polygons_after_modify, vertices);
-    Renderer::ModifyVBOVertices(vbo_, vertices);
-    polygons_count_ = polygons_after_modify.size();
-}
-
-void PolygonsRenderer::GenerateGLBufferVertices(const std::vector<PMSPolygon>& polygons,
-                                                std::vector<float>& destination_vertices)
-{
-    for (const auto& polygon : polygons) {
-        GenerateGLBufferVerticesForPolygon(polygon, destination_vertices);
+    polygon_mesh_ = BakePolygonMesh(polygons);
+    if (polygon_mesh_.clamped_vertices_count > 0) {
+        Spdlog::warn("{} polygon vertices are too far from the center of their chunk",
+                     polygon_mesh_.clamped_vertices_count);
     }
 
-    for (unsigned int i = 0; i < MAX_POLYGONS_COUNT - polygons.size(); ++i) {
-        for (unsigned int j = 0; j < 3; ++j) {
-            for (unsigned int k = 0; k < 9; ++k) {
-                destination_vertices.push_back(0.0F);
-            }
-        }
-    }
+    const auto& vertices = polygon_mesh_.vertices;
+    vbo_ = GpuBuffer(GpuBufferTarget::Array,
+                     vertices.data(),
+                     (long long)vertices.size() * (long long)sizeof(PolygonMeshVertex),
+                     GL_STATIC_DRAW);
 }
 
 void PolygonsRenderer::GenerateGLBufferVerticesForPolygon(const PMSPolygon& polygon,
@@ -0,0 +1,233 @@
+module;
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+export module RenderQueue;
+
+export namespace Soldank
+{
+// The world is drawn layer by layer in this order
+enum class RenderLayer : std::uint8_t
+{
+    Background = 0,
+    BackSceneries,
+    BackDebugOverlay,
+    Bullets,
+    Soldiers,
+    Items,
+    MiddleSceneries,
+    Polygons,
+    FrontSceneries,
+};
+
+constexpr std::size_t RENDER_LAYERS_COUNT = std::to_underlying(RenderLayer::FrontSceneries) + 1;
+
+// Keep in sync with RenderLayer
+constexpr std::array<std::string_view, RENDER_LAYERS_COUNT> RENDER_LAYER_NAMES{
+    "Background", "Back sceneries",   "Back debug overlay", "Bullets",         "Soldiers",
+    "Items",      "Middle sceneries", "Polygons",           "Front sceneries",
+};
+
+// From the most significant bits: layer, shader, texture and depth. Sorting by the key draws the
+// layers in order and groups the draws using the same shader and texture within a layer. Draws
+// with equal shader and texture keep the order of their depth.
+constexpr unsigned int RENDER_SORT_KEY_SHADER_BITS = 12;
+constexpr unsigned int RENDER_SORT_KEY_TEXTURE_BITS = 20;
+constexpr unsigned int RENDER_SORT_KEY_DEPTH_BITS = 24;
+
+constexpr std::uint64_t CreateRenderSortKey(RenderLayer layer,
+                                            unsigned int shader_id,
+                                            unsigned int texture_id,
+                                            unsigned int depth)
+{
+    constexpr auto get_mask = [](unsigned int bits) { return (std::uint64_t{ 1 } << bits) - 1; };
+
+    std::uint64_t key = std::to_underlying(layer);
+    key = (key << RENDER_SORT_KEY_SHADER_BITS) |
+          (shader_id & get_mask(RENDER_SORT_KEY_SHADER_BITS));
+    key = (key << RENDER_SORT_KEY_TEXTURE_BITS) |
+          (texture_id & get_mask(RENDER_SORT_KEY_TEXTURE_BITS));
+    key = (key << RENDER_SORT_KEY_DEPTH_BITS) | (depth & get_mask(RENDER_SORT_KEY_DEPTH_BITS));
+    return key;
+}
+
+constexpr RenderLayer GetRenderSortKeyLayer(std::uint64_t sort_key)
+{
+    return static_cast<RenderLayer>(sort_key >> (RENDER_SORT_KEY_SHADER_BITS +
+                                                 RENDER_SORT_KEY_TEXTURE_BITS +
+                                                 RENDER_SORT_KEY_DEPTH_BITS));
+}
+
+// Writes to order the indices of keys sorted by their key, keys that are equal keep their order.
+// Least significant digit radix sort, 8 bits per pass, passes over digits that are the same in
+// all the keys are skipped.
+void RadixSortRenderKeys(std::span<const std::uint64_t> keys,
+                         std::vector<unsigned int>& order,
+                         std::vector<unsigned int>& scratch)
+{
+    constexpr unsigned int DIGIT_BITS = 8;
+    constexpr unsigned int DIGITS_COUNT = 64 / DIGIT_BITS;
+    constexpr std::size_t BUCKETS_COUNT = std::size_t{ 1 } << DIGIT_BITS;
+
+    order.resize(keys.size());
+    for (unsigned int i = 0; i < keys.size(); ++i) {
+        order[i] = i;
+    }
+    scratch.resize(keys.size());
+
+    std::array<std::array<unsigned int, BUCKETS_COUNT>, DIGITS_COUNT> histograms{};
+    for (std::uint64_t key : keys) {
+        for (unsigned int digit = 0; digit < DIGITS_COUNT; ++digit) {
+            ++histograms.at(digit).at((key >> (digit * DIGIT_BITS)) & (BUCKETS_COUNT - 1));
+        }
+    }
+
+    for (unsigned int digit = 0; digit < DIGITS_COUNT; ++digit) {
+        auto& histogram = histograms.at(digit);
+        unsigned int shift = digit * DIGIT_BITS;
+        if (keys.empty() || histogram.at((keys[0] >> shift) & (BUCKETS_COUNT - 1)) == keys.size()) {
+            continue;
+        }
+
+        unsigned int bucket_offset = 0;
+        for (auto& bucket : histogram) {
+            bucket_offset += std::exchange(bucket, bucket_offset);
+        }
+        for (unsigned int index : order) {
+            scratch[histogram.at((keys[index] >> shift) & (BUCKETS_COUNT - 1))++] = index;
+        }
+        order.swap(scratch);
+    }
+}
+
+struct RenderCommand
+{
+    std::uint64_t sort_key;
+    // 0 when the draw sets the shader or the texture itself
+    unsigned int shader_id;
+    unsigned int texture_id;
+    std::function<void()> draw;
+};
+
+// How the queue sets the state shared by the draws
+struct RenderStateBinder
+{
+    std::function<void(unsigned int shader_id)> use_shader;
+    std::function<void(unsigned int texture_id)> bind_texture;
+    // Optional, called around the draws of every layer that has any
+    std::function<void(RenderLayer layer)> begin_layer = {};
+    std::function<void(RenderLayer layer)> end_layer = {};
+};
+
+struct RenderQueueStats
+{
+    unsigned int commands_count = 0;
+    unsigned int shader_changes_count = 0;
+    unsigned int texture_changes_count = 0;
+
+    unsigned int GetStateChangesCount() const
+    {
+        return shader_changes_count + texture_changes_count;
+    }
+};
+
+// Draws recorded during a frame, executed sorted by their sort keys. The shader and texture are
+// only set when they differ from the ones the previous draw used.
+class RenderQueue
+{
+public:
+    // Depth follows the order of submitting
+    void Submit(RenderLayer layer,
+                unsigned int shader_id,
+                unsigned int texture_id,
+                std::function<void()> draw)
+    {
+        Submit({ .sort_key = CreateRenderSortKey(layer, shader_id, texture_id, next_depth_++),
+                 .shader_id = shader_id,
+                 .texture_id = texture_id,
+                 .draw = std::move(draw) });
+    }
+
+    // For draws that set all their state themselves
+    void Submit(RenderLayer layer, std::function<void()> draw)
+    {
+        Submit(layer, 0, 0, std::move(draw));
+    }
+
+    void Submit(RenderCommand render_command)
+    {
+        sort_keys_.push_back(render_command.sort_key);
+        commands_.push_back(std::move(render_command));
+    }
+
+    unsigned int GetSize() const { return commands_.size(); }
+
+    // Runs and removes all the submitted commands
+    RenderQueueStats Execute(const RenderStateBinder& render_state_binder)
+    {
+        RadixSortRenderKeys(sort_keys_, order_, scratch_);
+
+        RenderQueueStats stats;
+        unsigned int current_shader_id = 0;
+        unsigned int current_texture_id = 0;
+        std::optional<RenderLayer> current_layer;
+        for (unsigned int index : order_) {
+            const auto& command = commands_[index];
+            RenderLayer layer = GetRenderSortKeyLayer(command.sort_key);
+            if (layer != current_layer) {
+                if (current_layer.has_value() && render_state_binder.end_layer) {
+                    render_state_binder.end_layer(*current_layer);
+                }
+                if (render_state_binder.begin_layer) {
+                    render_state_binder.begin_layer(layer);
+                }
+                current_layer = layer;
+            }
+            if (command.shader_id != 0 && command.shader_id != current_shader_id) {
+                render_state_binder.use_shader(command.shader_id);
+                current_shader_id = command.shader_id;
+                ++stats.shader_changes_count;
+            }
+            if (command.texture_id != 0 && command.texture_id != current_texture_id) {
+                render_state_binder.bind_texture(command.texture_id);
+                current_texture_id = command.texture_id;
+                ++stats.texture_changes_count;
+            }
+
+            command.draw();
+            ++stats.commands_count;
+
+            // What the draw set itself is not known to the queue anymore
+            if (command.shader_id == 0) {
+                current_shader_id = 0;
+            }
+            if (command.texture_id == 0) {
+                current_texture_id = 0;
+            }
+        }
+        if (current_layer.has_value() && render_state_binder.end_layer) {
+            render_state_binder.end_layer(*current_layer);
+        }
+
+        commands_.clear();
+        sort_keys_.clear();
+        next_depth_ = 0;
+        return stats;
+    }
+
+private:
+    std::vector<RenderCommand> commands_;
+    std::vector<std::uint64_t> sort_keys_;
+    std::vector<unsigned int> order_;
+    std::vector<unsigned int> scratch_;
+    unsigned int next_depth_ = 0;
+};
+} // namespace Soldank
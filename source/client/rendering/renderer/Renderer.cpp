@@ -6,7 +6,9 @@ module;
 #include <memory>
 #include <vector>
 #include <optional>
+#include <algorithm>
 #include <array>
+#include <span>
 #include <cstdio>
 
 export module Renderer;
@@ -20,10 +22,17 @@ unsigned int CreateEBO(const std::vector<unsigned int>& indices, GLenum usage);
 void FreeVBO(unsigned int vbo);
 void FreeEBO(unsigned int ebo);
 
+// Every vertex holds a position, then optionally a color and a texture coordinate, then the
+// extra attributes with the given float counts, bound from location 3 on
 void SetupVertexArray(unsigned int vbo,
                       std::optional<unsigned int> ebo,
                       bool has_color = true,
-                      bool has_texture = true);
+                      bool has_texture = true,
+                      std::span<const int> extra_attribute_sizes = {});
+
+// Every vertex holds a position as two 16-bit integers, a color as four bytes and a texture
+// coordinate as two floats, 16 bytes in total
+void SetupPackedVertexArray(unsigned int vbo);
 
 void BindTexture(unsigned int texture);
 
@@ -41,6 +50,9 @@ namespace
 unsigned int current_vbo = 0;
 unsigned int current_ebo = 0;
 
+constexpr unsigned int FIRST_EXTRA_ATTRIBUTE_LOCATION = 3;
+constexpr std::size_t MAX_EXTRA_ATTRIBUTES_COUNT = 2;
+
 #ifdef __EMSCRIPTEN__
 void LogMissingBufferOnce(const char* draw_call, const char* buffer_name)
 {
@@ -106,7 +118,8 @@ void FreeEBO(unsigned int ebo)
 void SetupVertexArray(unsigned int vbo,
                       std::optional<unsigned int> ebo,
                       bool has_color,
-                      bool has_texture)
+                      bool has_texture,
+                      std::span<const int> extra_attribute_sizes)
 {
     current_vbo = vbo;
     current_ebo = ebo.value_or(0);
@@ -124,11 +137,19 @@ void SetupVertexArray(unsigned int vbo,
     if (has_texture) {
         stride += 2;
     }
+    extra_attribute_sizes = extra_attribute_sizes.first(
+      std::min(extra_attribute_sizes.size(), MAX_EXTRA_ATTRIBUTES_COUNT));
+    for (int extra_attribute_size : extra_attribute_sizes) {
+        stride += extra_attribute_size;
+    }
     stride *= sizeof(float);
 
     glDisableVertexAttribArray(0);
     glDisableVertexAttribArray(1);
     glDisableVertexAttribArray(2);
+    for (unsigned int i = 0; i < MAX_EXTRA_ATTRIBUTES_COUNT; ++i) {
+        glDisableVertexAttribArray(FIRST_EXTRA_ATTRIBUTE_LOCATION + i);
+    }
     glVertexAttrib4f(1, 1.0F, 1.0F, 1.0F, 1.0F);
     glVertexAttrib2f(2, 0.0F, 0.0F);
 
@@ -149,7 +170,44 @@ void SetupVertexArray(unsigned int vbo,
         // NOLINTNEXTLINE(performance-no-int-to-ptr,cppcoreguidelines-pro-type-cstyle-cast)
         glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(offset * sizeof(float)));
         glEnableVertexAttribArray(2);
+        offset += 2;
+    }
+    unsigned int location = FIRST_EXTRA_ATTRIBUTE_LOCATION;
+    for (int extra_attribute_size : extra_attribute_sizes) {
+        // NOLINTNEXTLINE(performance-no-int-to-ptr,cppcoreguidelines-pro-type-cstyle-cast)
+        auto* attribute_offset = (void*)(offset * sizeof(float));
+        glVertexAttribPointer(
+          location, extra_attribute_size, GL_FLOAT, GL_FALSE, stride, attribute_offset);
+        glEnableVertexAttribArray(location);
+        offset += extra_attribute_size;
+        ++location;
+    }
+}
+
+void SetupPackedVertexArray(unsigned int vbo)
+{
+    constexpr GLsizei STRIDE = 16;
+
+    current_vbo = vbo;
+    current_ebo = 0;
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+    for (unsigned int i = 0; i < MAX_EXTRA_ATTRIBUTES_COUNT; ++i) {
+        glDisableVertexAttribArray(FIRST_EXTRA_ATTRIBUTE_LOCATION + i);
     }
+
+    // position attribute
+    glVertexAttribPointer(0, 2, GL_SHORT, GL_FALSE, STRIDE, nullptr);
+    glEnableVertexAttribArray(0);
+    // color attribute
+    // NOLINTNEXTLINE(performance-no-int-to-ptr,cppcoreguidelines-pro-type-cstyle-cast)
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, STRIDE, (void*)4);
+    glEnableVertexAttribArray(1);
+    // texture coord attribute
+    // NOLINTNEXTLINE(performance-no-int-to-ptr,cppcoreguidelines-pro-type-cstyle-cast)
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, STRIDE, (void*)8);
+    glEnableVertexAttribArray(2);
 }
 
 void BindTexture(unsigned int texture)
@@ -5,10 +5,13 @@ module;
 #include <glad/glad.h>
 
 #include <algorithm>
+#include <array>
 #include <vector>
 #include <memory>
 #include <chrono>
+#include <cmath>
 #include <filesystem>
+#include <span>
 #include <utility>
 
 export module SceneriesRenderer;
@@ -18,6 +21,7 @@ import Extern.Glm;
 import Texture;
 import Renderer;
 import Shader;
+import Rendering.Gpu.GpuBuffer;
 
 import Shared.Core.Map.PMSConstants;
 import Shared.Core.Map.PMSStructs;
@@ -40,24 +44,36 @@ public:
     SceneriesRenderer(SceneriesRenderer&&) = delete;
     SceneriesRenderer& operator=(SceneriesRenderer&& other) = delete;
 
+    // Draws the scenery instances listed in scenery_ids, in the listed order. Consecutive
+    // sceneries with the same texture are drawn with a single draw call.
     void Render(glm::mat4 transform,
-                int target_level,
+                std::span<const unsigned int> scenery_ids,
                 const std::vector<PMSScenery>& scenery_instances);
 
 private:
+    // Must match the size of frameEndTimes in Scenery.vs
+    static constexpr unsigned int MAX_GIF_FRAMES = 64;
+    // GIFs often leave the frame delay at 0, browsers show such frames for 100 ms too
+    static constexpr int DEFAULT_GIF_FRAME_DELAY = 100;
+    // The animation time is wrapped so it doesn't lose precision as a float
+    static constexpr double ANIMATION_TIME_PERIOD = 3600.0;
+
+    // The frames of a GIF are in one texture, the vertex shader picks the frame to show from the
+    // animation time and the frame end times
     class GIFTexture
     {
     public:
         GIFTexture(const std::shared_ptr<Texture::TextureGIFData>& gif_data);
 
-        void Update();
         bool IsValid() const;
         unsigned int GetTextureId() const;
+        glm::vec2 GetFramesGrid() const;
+        std::span<const float> GetFrameEndTimes() const;
 
     private:
         std::shared_ptr<Texture::TextureGIFData> gif_data_;
-        unsigned int current_frame_id_;
-        std::chrono::time_point<std::chrono::system_clock> last_switch_time_;
+        // In seconds from the start of the animation
+        std::vector<float> frame_end_times_;
     };
 
     struct TextureEntry
@@ -66,7 +82,24 @@ private:
         std::shared_ptr<GIFTexture> gif_texture;
     };
 
+    struct DrawBatch
+    {
+        unsigned int texture_id;
+        // nullptr for textures that are not animated
+        const GIFTexture* gif_texture;
+        unsigned int first_index;
+        unsigned int indices_count;
+    };
+
+    // Every vertex holds its position in the scenery, color and texture coordinate, then the
+    // scenery's x, y and rotation and its scale. The vertex shader places the scenery with them,
+    // so nothing has to be computed per scenery when drawing.
+    static constexpr unsigned int FLOATS_PER_VERTEX = 14;
+    static constexpr std::array<int, 2> INSTANCE_ATTRIBUTE_SIZES{ 3, 2 };
+    static constexpr std::array<unsigned int, 6> QUAD_INDICES{ 0, 1, 2, 1, 3, 2 };
+
     void AddNewTexture(const std::filesystem::path& texture_file_name);
+    void SetAnimationUniforms(const GIFTexture* gif_texture) const;
 
     void OnAddScenery(const PMSScenery& new_scenery, unsigned int new_scenery_id);
     void OnAddSceneryType(const PMSSceneryType& new_scenery_type);
@@ -91,14 +124,21 @@ private:
 
     std::vector<TextureEntry> textures_;
     unsigned int vbo_;
-    unsigned int ebo_;
+    // Indices of the visible sceneries' quads, written every time sceneries are drawn
+    GpuBuffer ebo_;
+
+    std::vector<unsigned int> visible_indices_;
+    std::vector<DrawBatch> draw_batches_;
+
+    std::chrono::time_point<std::chrono::steady_clock> animation_start_time_;
 };
 } // namespace Soldank
 
 namespace Soldank
 {
 SceneriesRenderer::SceneriesRenderer(Map& map)
-    : shader_(ShaderSources::VERTEX_SHADER_SOURCE, ShaderSources::FRAGMENT_SHADER_SOURCE)
+    : shader_(ShaderSources::SCENERY_VERTEX_SHADER_SOURCE, ShaderSources::FRAGMENT_SHADER_SOURCE)
+    , animation_start_time_(std::chrono::steady_clock::now())
 {
     for (const auto& scenery_type : map.GetSceneryTypes()) {
         AddNewTexture(scenery_type.name);
@@ -107,18 +147,12 @@ SceneriesRenderer::SceneriesRenderer(Map& map)
     std::vector<float> vertices;
     GenerateGLBufferVertices(map.GetSceneryInstances(), vertices);
 
-    std::vector<unsigned int> indices;
-    for (unsigned int i = 0; i < MAX_SCENERIES_COUNT; ++i) {
-        indices.push_back(i * 4 + 0);
-        indices.push_back(i * 4 + 1);
-        indices.push_back(i * 4 + 2);
-        indices.push_back(i * 4 + 1);
-        indices.push_back(i * 4 + 3);
-        indices.push_back(i * 4 + 2);
-    }
-
     vbo_ = Renderer::CreateVBO(vertices, GL_DYNAMIC_DRAW);
-    ebo_ = Renderer::CreateEBO(indices, GL_STATIC_DRAW);
+    ebo_ = GpuBuffer(GpuBufferTarget::ElementArray,
+                     nullptr,
+                     (long long)MAX_SCENERIES_COUNT * 6 * (long long)sizeof(GLuint),
+                     GL_STREAM_DRAW);
+    visible_indices_.reserve(MAX_SCENERIES_COUNT * 6);
 
     map.GetMapChangeEvents().added_new_scenery.AddObserver(
       [this](const PMSScenery& new_scenery, unsigned int new_scenery_id) {
@@ -160,7 +194,6 @@ SceneriesRenderer::SceneriesRenderer(Map& map)
 SceneriesRenderer::~SceneriesRenderer()
 {
     Renderer::FreeVBO(vbo_);
-    Renderer::FreeVBO(ebo_);
     for (const auto& texture : textures_) {
         if (texture.gif_texture == nullptr && texture.texture_id != 0) {
             Texture::Delete(texture.texture_id);
@@ -169,44 +202,76 @@ SceneriesRenderer::~SceneriesRenderer()
 }
 
 void SceneriesRenderer::Render(glm::mat4 transform,
-                               int target_level,
+                               std::span<const unsigned int> scenery_ids,
                                const std::vector<PMSScenery>& scenery_instances)
 {
-    shader_.Use();
-    Renderer::SetupVertexArray(vbo_, ebo_);
-
-    for (unsigned int i = 0; i < scenery_instances.size(); ++i) {
-        if (scenery_instances[i].level != target_level) {
+    visible_indices_.clear();
+    draw_batches_.clear();
+    for (unsigned int scenery_id : scenery_ids) {
+        if (scenery_id >= scenery_instances.size()) {
             continue;
         }
 
-        glm::mat4 current_scenery_transform = transform;
+        const auto& texture = textures_[scenery_instances[scenery_id].style - 1];
+        unsigned int texture_id = texture.texture_id;
+        const GIFTexture* gif_texture = nullptr;
+        if (texture.gif_texture != nullptr && texture.gif_texture->IsValid()) {
+            gif_texture = texture.gif_texture.get();
+            texture_id = gif_texture->GetTextureId();
+        }
+        if (draw_batches_.empty() || draw_batches_.back().texture_id != texture_id) {
+            draw_batches_.push_back({ .texture_id = texture_id,
+                                      .gif_texture = gif_texture,
+                                      .first_index = (unsigned int)visible_indices_.size(),
+                                      .indices_count = 0 });
+        }
+        for (unsigned int quad_index : QUAD_INDICES) {
+            visible_indices_.push_back(scenery_id * 4 + quad_index);
+        }
+        draw_batches_.back().indices_count += 6;
+    }
 
-        current_scenery_transform =
-          glm::translate(current_scenery_transform,
-                         glm::vec3(scenery_instances[i].x, -scenery_instances[i].y, 0.0));
-        current_scenery_transform = glm::rotate(
-          current_scenery_transform, scenery_instances[i].rotation, glm::vec3(0.0, 0.0, 1.0));
-        current_scenery_transform =
-          glm::scale(current_scenery_transform,
-                     glm::vec3(scenery_instances[i].scale_x, scenery_instances[i].scale_y, 0.0));
+    if (draw_batches_.empty()) {
+        return;
+    }
 
-        shader_.SetMatrix4("transform", current_scenery_transform);
+    ebo_.Replace(visible_indices_.data(),
+                 (long long)visible_indices_.size() * (long long)sizeof(GLuint),
+                 GL_STREAM_DRAW);
 
-        auto& texture = textures_[scenery_instances[i].style - 1];
-        if (texture.gif_texture == nullptr) {
-            Renderer::BindTexture(texture.texture_id);
-        } else {
-            if (!texture.gif_texture->IsValid()) {
-                Renderer::BindTexture(0);
-            } else {
-                texture.gif_texture->Update();
-                Renderer::BindTexture(texture.gif_texture->GetTextureId());
-            }
+    shader_.Use();
+    shader_.SetMatrix4("transform", transform);
+    std::chrono::duration<double> animation_time =
+      std::chrono::steady_clock::now() - animation_start_time_;
+    shader_.SetFloat("time", (float)std::fmod(animation_time.count(), ANIMATION_TIME_PERIOD));
+    Renderer::SetupVertexArray(vbo_, ebo_.GetId(), true, true, INSTANCE_ATTRIBUTE_SIZES);
+
+    for (unsigned int i = 0; i < draw_batches_.size(); ++i) {
+        const auto& draw_batch = draw_batches_[i];
+        if (i == 0 || draw_batch.gif_texture != draw_batches_[i - 1].gif_texture) {
+            SetAnimationUniforms(draw_batch.gif_texture);
         }
+        Renderer::BindTexture(draw_batch.texture_id);
+        Renderer::DrawElements(GL_TRIANGLES,
+                               (int)draw_batch.indices_count,
+                               GL_UNSIGNED_INT,
+                               draw_batch.first_index * sizeof(GLuint));
+    }
+}
 
-        Renderer::DrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (i * 6ULL * sizeof(GLuint)));
+void SceneriesRenderer::SetAnimationUniforms(const GIFTexture* gif_texture) const
+{
+    if (gif_texture == nullptr) {
+        constexpr std::array<float, 1> STILL_FRAME_END_TIMES{ 1.0F };
+        shader_.SetVec2("framesGrid", { 1.0F, 1.0F });
+        shader_.SetInt("framesCount", 1);
+        shader_.SetFloatArray("frameEndTimes", STILL_FRAME_END_TIMES);
+        return;
     }
+
+    shader_.SetVec2("framesGrid", gif_texture->GetFramesGrid());
+    shader_.SetInt("framesCount", (int)gif_texture->GetFrameEndTimes().size());
+    shader_.SetFloatArray("frameEndTimes", gif_texture->GetFrameEndTimes());
 }
 
 void SceneriesRenderer::AddNewTexture(const std::filesystem::path& texture_file_name)
@@ -218,10 +283,17 @@ void SceneriesRenderer::AddNewTexture(const std::filesystem::path& texture_file_
         auto texture_or_error = Texture::LoadGIF(texture_path.string().c_str());
 
         if (texture_or_error.has_value()) {
+            if (texture_or_error.value()->Size() > MAX_GIF_FRAMES) {
+                Spdlog::warn("Only the first {} frames of {} are animated",
+                             MAX_GIF_FRAMES,
+                             texture_path.string());
+            }
             textures_.push_back(
               TextureEntry{ .gif_texture = std::make_shared<GIFTexture>(texture_or_error.value()) });
         } else {
-            Spdlog::critical("Texture file not found {}", texture_path.string());
+            Spdlog::critical("{} {}",
+                             Texture::GetLoadErrorMessage(texture_or_error.error()),
+                             texture_path.string());
             textures_.push_back(TextureEntry{ .texture_id = 0U });
         }
     } else {
@@ -232,7 +304,9 @@ void SceneriesRenderer::AddNewTexture(const std::filesystem::path& texture_file_
         if (texture_or_error.has_value()) {
             textures_.push_back(TextureEntry{ .texture_id = texture_or_error.value().opengl_id });
         } else {
-            Spdlog::critical("Texture file not found {}", texture_path.string());
+            Spdlog::critical("{} {}",
+                             Texture::GetLoadErrorMessage(texture_or_error.error()),
+                             texture_path.string());
             textures_.push_back(TextureEntry{ .texture_id = 0U });
         }
     }
@@ -242,7 +316,7 @@ void SceneriesRenderer::OnAddScenery(const PMSScenery& new_scenery, unsigned int
 {
     std::vector<float> vertices;
     GenerateGLBufferVerticesForScenery(new_scenery, vertices);
-    int offset = new_scenery_id * 4 * 9 * sizeof(GLfloat);
+    int offset = new_scenery_id * 4 * FLOATS_PER_VERTEX * sizeof(GLfloat);
     Renderer::ModifyVBOVertices(vbo_, vertices, offset);
 }
 
@@ -336,7 +410,7 @@ void SceneriesRenderer::GenerateGLBufferVertices(const std::vector<PMSScenery>&
 
     for (unsigned int i = 0; i < MAX_SCENERIES_COUNT - sceneries.size(); ++i) {
         for (unsigned int j = 0; j < 4; ++j) {
-            for (unsigned int k = 0; k < 9; ++k) {
+            for (unsigned int k = 0; k < FLOATS_PER_VERTEX; ++k) {
                 destination_vertices.push_back(0.0F);
             }
         }
@@ -358,6 +432,11 @@ void SceneriesRenderer::GenerateGLBufferVerticesForScenery(const PMSScenery& sce
         destination_vertices.push_back((float)scenery.alpha / 255.0F);
         destination_vertices.push_back(0.0);
         destination_vertices.push_back(0.0);
+        destination_vertices.push_back(scenery.x);
+        destination_vertices.push_back(-scenery.y);
+        destination_vertices.push_back(scenery.rotation);
+        destination_vertices.push_back(scenery.scale_x);
+        destination_vertices.push_back(scenery.scale_y);
     }
 
     destination_vertices[first_index + 0] = 0.0;
@@ -365,43 +444,38 @@ void SceneriesRenderer::GenerateGLBufferVerticesForScenery(const PMSScenery& sce
     destination_vertices[first_index + 7] = 0.0;
     destination_vertices[first_index + 8] = 0.0;
 
-    destination_vertices[first_index + 9] = (float)scenery.width;
-    destination_vertices[first_index + 10] = (float)-scenery.height;
-    destination_vertices[first_index + 16] = 1.0;
-    destination_vertices[first_index + 17] = 0.0;
+    destination_vertices[first_index + 14] = (float)scenery.width;
+    destination_vertices[first_index + 15] = (float)-scenery.height;
+    destination_vertices[first_index + 21] = 1.0;
+    destination_vertices[first_index + 22] = 0.0;
 
-    destination_vertices[first_index + 18] = 0.0;
-    destination_vertices[first_index + 19] = 0.0;
-    destination_vertices[first_index + 25] = 0.0;
-    destination_vertices[first_index + 26] = 1.0;
-
-    destination_vertices[first_index + 27] = (float)scenery.width;
     destination_vertices[first_index + 28] = 0.0;
-    destination_vertices[first_index + 34] = 1.0;
-    destination_vertices[first_index + 35] = 1.0;
+    destination_vertices[first_index + 29] = 0.0;
+    destination_vertices[first_index + 35] = 0.0;
+    destination_vertices[first_index + 36] = 1.0;
+
+    destination_vertices[first_index + 42] = (float)scenery.width;
+    destination_vertices[first_index + 43] = 0.0;
+    destination_vertices[first_index + 49] = 1.0;
+    destination_vertices[first_index + 50] = 1.0;
 }
 
 SceneriesRenderer::GIFTexture::GIFTexture(const std::shared_ptr<Texture::TextureGIFData>& gif_data)
     : gif_data_(gif_data)
-    , current_frame_id_(0)
-    , last_switch_time_(std::chrono::system_clock::now())
-{
-}
-
-void SceneriesRenderer::GIFTexture::Update()
 {
     if (!IsValid()) {
         return;
     }
 
-    auto time_now = std::chrono::system_clock::now();
-    std::chrono::duration<double> delta_time = time_now - last_switch_time_;
-    unsigned int next_frame_id = (current_frame_id_ + 1) % gif_data_->Size();
-    double delay = gif_data_->GetFrame(current_frame_id_).second;
-    delay /= 1000.0;
-    if (delta_time.count() >= delay) {
-        current_frame_id_ = next_frame_id;
-        last_switch_time_ = time_now;
+    float frame_end_time = 0.0F;
+    for (unsigned int frame_id = 0; frame_id < std::min(gif_data_->Size(), MAX_GIF_FRAMES);
+         ++frame_id) {
+        int delay = gif_data_->GetDelay(frame_id);
+        if (delay <= 0) {
+            delay = DEFAULT_GIF_FRAME_DELAY;
+        }
+        frame_end_time += (float)delay / 1000.0F;
+        frame_end_times_.push_back(frame_end_time);
     }
 }
 
@@ -416,6 +490,16 @@ unsigned int SceneriesRenderer::GIFTexture::GetTextureId() const
         return 0;
     }
 
-    return gif_data_->GetFrame(current_frame_id_).first;
+    return gif_data_->GetOpenGLId();
+}
+
+glm::vec2 SceneriesRenderer::GIFTexture::GetFramesGrid() const
+{
+    return { (float)gif_data_->GetColumns(), (float)gif_data_->GetRows() };
+}
+
+std::span<const float> SceneriesRenderer::GIFTexture::GetFrameEndTimes() const
+{
+    return frame_end_times_;
 }
 } // namespace Soldank
@@ -20,8 +20,11 @@ import Extern.Glm;
 
 import Texture;
 import Renderer;
+import Rendering.Gpu.GpuBuffer;
+import RenderSnapshot;
 import SpritesManager;
 import SoldierPartData;
+import SoldierSkinning;
 import Shader;
 
 import Shared.Core.Types.WeaponType;
@@ -29,16 +32,17 @@ import Shared.Core.Math.Calc;
 import Shared.Core.Utility.VisitHelper;
 import Shared.Core.Map.Map;
 import Shared.Core.Entities.Soldier;
-import Shared.Core.Entities.Weapon;
 import Shared.Core.Animations;
 
+import Extern.Spdlog;
+
 export namespace Soldank
 {
 class SoldierRenderer
 {
 public:
     SoldierRenderer(const Sprites::SpriteManager& sprite_manager);
-    ~SoldierRenderer();
+    ~SoldierRenderer() = default;
 
     // it's not safe to be able to copy/move this because we would also need to take care of the
     // created OpenGL buffers and textures
@@ -47,150 +51,119 @@ public:
     SoldierRenderer(SoldierRenderer&&) = delete;
     SoldierRenderer& operator=(SoldierRenderer&& other) = delete;
 
-    static void GenerateVertices(std::vector<float>& vertices,
-                                 const Sprites::SoldierPartData& part_data,
-                                 bool flipped);
+    // Soldiers added during a frame are drawn together by Render, in the order they were added
+    void AddSoldier(const Sprites::SpriteManager& sprite_manager,
+                    const SoldierRenderState& soldier);
+    void AddSoldier(const Sprites::SpriteManager& sprite_manager,
+                    const Soldier& soldier,
+                    double frame_percent);
 
-    void Render(glm::mat4 transform,
-                const Sprites::SpriteManager& sprite_manager,
-                const Soldier& soldier,
-                double frame_percent);
+    // Draws all the added soldiers with a single draw call
+    void Render(glm::mat4 transform);
 
 private:
     static bool IsSoldierPartTypeVisible(Sprites::SoldierPartSpriteType soldier_part_type,
-                                         const Soldier& soldier,
+                                         const SoldierRenderState& soldier,
                                          bool part_base_visibility);
     static bool IsPrimaryWeaponTypeVisible(
       Sprites::SoldierPartPrimaryWeaponSpriteType soldier_part_type,
-      const Soldier& soldier,
+      const SoldierRenderState& soldier,
       bool part_base_visibility);
     static bool IsSecondaryWeaponTypeVisible(
       Sprites::SoldierPartSecondaryWeaponSpriteType soldier_part_type,
-      const Soldier& soldier);
+      const SoldierRenderState& soldier);
     static bool IsTertiaryWeaponTypeVisible(
       Sprites::SoldierPartTertiaryWeaponSpriteType soldier_part_type,
-      const Soldier& soldier);
-
-    static glm::vec4 GetColorForSoldierPart(const Soldier& soldier,
-                                            Sprites::SoldierSpriteColor soldier_color,
-                                            Sprites::SoldierSpriteAlpha soldier_alpha);
+      const SoldierRenderState& soldier);
 
-    static const Weapon& GetPrimaryWeapon(const Soldier& soldier)
-    {
-        return soldier.weapons[soldier.active_weapon];
-    }
-
-    static const Weapon& GetSecondaryWeapon(const Soldier& soldier)
-    {
-        return soldier.weapons[(soldier.active_weapon + 1) % 2];
-    }
-
-    static const Weapon& GetTertiaryWeapon(const Soldier& soldier) { return soldier.weapons[2]; }
+    static void SetColorsForSoldierParts(const SoldierRenderState& soldier,
+                                         SoldierSkinningRecord& soldier_skinning_record);
 
     Shader shader_;
+    StreamingGpuBuffer vbo_;
+    unsigned int atlas_texture_;
+
+    // Parts that have sprites, with their ids in the sprite manager
+    std::vector<SoldierPartGeometry> parts_;
+    std::vector<unsigned int> part_ids_;
 
-    std::vector<std::pair<unsigned int, std::optional<unsigned int>>> vbos_;
-    std::vector<unsigned int> ebos_;
-    std::vector<Sprites::SoldierPartSpriteType> part_types_;
+    SoldierSkinningRecord soldier_skinning_record_{};
+    std::vector<float> vertices_;
 };
 } // namespace Soldank
 
 namespace Soldank
 {
 SoldierRenderer::SoldierRenderer(const Sprites::SpriteManager& sprite_manager)
-    : shader_(ShaderSources::DYNAMIC_COLOR_VERTEX_SHADER_SOURCE,
-              ShaderSources::DYNAMIC_COLOR_FRAGMENT_SHADER_SOURCE)
+    : shader_(ShaderSources::SOLDIER_SKINNING_VERTEX_SHADER_SOURCE,
+              ShaderSources::FRAGMENT_SHADER_SOURCE)
+    , vbo_(StreamingGpuBuffer::DEFAULT_CAPACITY)
+    , atlas_texture_(sprite_manager.GetSoldierPartsAtlas().opengl_id)
 {
-    std::vector<float> vertices;
-    std::vector<unsigned int> indices{ 0, 1, 2, 1, 3, 2 };
-
     for (unsigned int i = 0; i < sprite_manager.GetSoldierPartCount(); i++) {
-        vertices.clear();
-
         const Sprites::SoldierPartData* part_data = sprite_manager.GetSoldierPartData(i);
         if (part_data == nullptr) {
-            vbos_.emplace_back(0, 0);
-            ebos_.push_back(0);
             continue;
         }
-
-        GenerateVertices(vertices, *part_data, false);
-        unsigned int vbo_for_original = Renderer::CreateVBO(vertices, GL_STATIC_DRAW);
-        std::optional<unsigned int> vbo_for_flipped = std::nullopt;
-        if (part_data->IsFlippable()) {
-            vertices.clear();
-            GenerateVertices(vertices, *part_data, true);
-            vbo_for_flipped = Renderer::CreateVBO(vertices, GL_STATIC_DRAW);
+        if (parts_.size() == MAX_SOLDIER_PARTS_COUNT) {
+            Spdlog::error("Too many soldier parts, only the first {} are rendered",
+                          MAX_SOLDIER_PARTS_COUNT);
+            break;
         }
 
-        vbos_.emplace_back(vbo_for_original, vbo_for_flipped);
-        ebos_.push_back(Renderer::CreateEBO(indices, GL_STATIC_DRAW));
-    }
-}
-
-SoldierRenderer::~SoldierRenderer()
-{
-    for (unsigned int ebo : ebos_) {
-        Renderer::FreeEBO(ebo);
-    }
-    for (auto vbo : vbos_) {
-        Renderer::FreeVBO(vbo.first);
-        if (vbo.second.has_value()) {
-            Renderer::FreeVBO(*vbo.second);
+        std::optional<SoldierPartSpriteGeometry> flipped_sprite = std::nullopt;
+        if (part_data->IsFlippable()) {
+            flipped_sprite = CreateSoldierPartSpriteGeometry(
+              part_data->GetCenter(),
+              glm::vec2(part_data->GetTextureFlippedWidth(), part_data->GetTextureFlippedHeight()),
+              true,
+              part_data->GetAtlasFlippedRegion());
         }
+        parts_.push_back({
+          .point = part_data->GetPoint(),
+          .flexibility = part_data->GetFlexibility(),
+          .color = part_data->GetSoldierColor(),
+          .alpha = part_data->GetSoldierAlpha(),
+          .tinted = std::holds_alternative<Sprites::SoldierPartSpriteType>(
+            sprite_manager.GetSoldierPartDataType(i)),
+          .sprite = CreateSoldierPartSpriteGeometry(
+            part_data->GetCenter(),
+            glm::vec2(part_data->GetTextureWidth(), part_data->GetTextureHeight()),
+            false,
+            part_data->GetAtlasRegion()),
+          .flipped_sprite = flipped_sprite,
+        });
+        part_ids_.push_back(i);
     }
 }
 
-void SoldierRenderer::GenerateVertices(std::vector<float>& vertices,
-                                       const Sprites::SoldierPartData& part_data,
-                                       bool flipped)
+void SoldierRenderer::AddSoldier(const Sprites::SpriteManager& sprite_manager,
+                                 const Soldier& soldier,
+                                 double frame_percent)
 {
-    float texture_width = NAN;
-    float texture_height = NAN;
-    float pivot_x = part_data.GetCenter().x;
-    float pivot_y = (1.0F - part_data.GetCenter().y);
-    if (!flipped) {
-        texture_width = (float)part_data.GetTextureWidth();
-        texture_height = (float)part_data.GetTextureHeight();
-    } else {
-        texture_width = (float)part_data.GetTextureFlippedWidth();
-        texture_height = (float)part_data.GetTextureFlippedHeight();
-        pivot_y = 1.0F - pivot_y;
+    auto soldier_render_state = CaptureSoldierRenderState(soldier);
+    const auto& particles = soldier.skeleton->GetParticles();
+    for (unsigned int i = 0; i < SOLDIER_SKELETON_POSITIONS_COUNT && i < particles.size(); i++) {
+        soldier_render_state.skeleton_positions.at(i) = Calc::Lerp(
+          particles[i].old_position, particles[i].position, (float)frame_percent);
     }
-    pivot_x *= texture_width;
-    pivot_y *= texture_height;
-
-    float w0 = 0.0F - pivot_x;
-    float w1 = texture_width - pivot_x;
-    float h0 = 0.0F - pivot_y;
-    float h1 = texture_height - pivot_y;
-
-    // clang-format off
-    vertices = {
-        // position         // texture
-        w0, h0, 1.0,        0.0, 0.0,
-        w1, h0, 1.0,        1.0, 0.0,
-        w0, h1, 1.0,        0.0, 1.0,
-        w1, h1, 1.0,        1.0, 1.0,
-    };
-    // clang-format on
+    AddSoldier(sprite_manager, soldier_render_state);
 }
 
-void SoldierRenderer::Render(glm::mat4 transform,
-                             const Sprites::SpriteManager& sprite_manager,
-                             const Soldier& soldier,
-                             double frame_percent)
+void SoldierRenderer::AddSoldier(const Sprites::SpriteManager& sprite_manager,
+                                 const SoldierRenderState& soldier)
 {
-    shader_.Use();
+    SoldierSkinningRecord& record = soldier_skinning_record_;
 
-    for (unsigned int i = 0; i < vbos_.size(); i++) {
-        const Sprites::SoldierPartData* part_data = sprite_manager.GetSoldierPartData(i);
-        if (part_data == nullptr) {
-            continue;
-        }
+    record.skeleton_positions = soldier.skeleton_positions;
+    record.direction = soldier.direction;
+    SetColorsForSoldierParts(soldier, record);
 
+    record.visible_parts.reset();
+    for (unsigned int i = 0; i < part_ids_.size(); i++) {
+        const Sprites::SoldierPartData* part_data = sprite_manager.GetSoldierPartData(part_ids_[i]);
         bool part_base_visibility = part_data->IsVisible();
-        auto part_type = sprite_manager.GetSoldierPartDataType(i);
+        auto part_type = sprite_manager.GetSoldierPartDataType(part_ids_[i]);
         bool part_visible = std::visit(
           VisitOverload{
             [&soldier, part_base_visibility](Sprites::SoldierPartSpriteType soldier_part_type) {
@@ -209,77 +182,33 @@ void SoldierRenderer::Render(glm::mat4 transform,
                 return SoldierRenderer::IsTertiaryWeaponTypeVisible(weapon_type, soldier);
             } },
           part_type);
+        record.visible_parts.set(i, part_visible);
+    }
 
-        if (!part_visible) {
-            continue;
-        }
-
-        Sprites::SoldierSpriteColor part_soldier_color = part_data->GetSoldierColor();
-        Sprites::SoldierSpriteAlpha part_soldier_alpha = part_data->GetSoldierAlpha();
-        glm::vec4 part_color = std::visit(
-          VisitOverload{ [&soldier, part_soldier_color, part_soldier_alpha](
-                           Sprites::SoldierPartSpriteType /*soldier_part_type*/) {
-                            return SoldierRenderer::GetColorForSoldierPart(
-                              soldier, part_soldier_color, part_soldier_alpha);
-                        },
-                         [](Sprites::SoldierPartPrimaryWeaponSpriteType /*weapon_type*/) {
-                             return glm::vec4{ 1.0F, 1.0F, 1.0F, 1.0F };
-                         },
-                         [](Sprites::SoldierPartSecondaryWeaponSpriteType /*weapon_type*/) {
-                             return glm::vec4{ 1.0F, 1.0F, 1.0F, 1.0F };
-                         },
-                         [](Sprites::SoldierPartTertiaryWeaponSpriteType /*weapon_type*/) {
-                             return glm::vec4{ 1.0F, 1.0F, 1.0F, 1.0F };
-                         } },
-          part_type);
-
-        unsigned int sprite_texture = part_data->GetTexture();
-        glm::vec2 scale = glm::vec2(1.0, 1.0);
-        unsigned int px = part_data->GetPoint().x;
-        unsigned int py = part_data->GetPoint().y;
-        glm::vec2 p0 = Calc::Lerp(
-          soldier.skeleton->GetOldPos(px), soldier.skeleton->GetPos(px), (float)frame_percent);
-        glm::vec2 p1 = Calc::Lerp(
-          soldier.skeleton->GetOldPos(py), soldier.skeleton->GetPos(py), (float)frame_percent);
-        float rot = Calc::Vec2Angle(p1 - p0);
-
-        unsigned int vbo_to_use = vbos_[i].first;
-        if (soldier.direction != 1) {
-            if (part_data->IsFlippable()) {
-                sprite_texture = part_data->GetTextureFlipped();
-                vbo_to_use = *vbos_[i].second;
-            } else {
-                scale.y = -1.0;
-            }
-        }
-
-        if (part_data->GetFlexibility() > 0.0) {
-            scale.x = std::min(1.5F, glm::length(p1 - p0) / part_data->GetFlexibility());
-        }
-
-        // TODO: magic numbers, this is in mod.ini
-        scale.x /= 4.5;
-        scale.y /= 4.5;
+    AppendSoldierSkinningVertices(record, parts_, vertices_);
+}
 
-        Renderer::SetupVertexArray(vbo_to_use, ebos_[i], false, true);
-        glm::mat4 current_part_transform = transform;
+void SoldierRenderer::Render(glm::mat4 transform)
+{
+    if (vertices_.empty()) {
+        return;
+    }
 
-        current_part_transform =
-          glm::translate(current_part_transform, glm::vec3(p0.x, -p0.y - 1.0, 0.0));
-        current_part_transform = glm::rotate(current_part_transform, rot, glm::vec3(0.0, 0.0, 1.0));
-        current_part_transform =
-          glm::scale(current_part_transform, glm::vec3(scale.x, scale.y, 0.0));
+    shader_.Use();
+    shader_.SetMatrix4("transform", transform);
 
-        shader_.SetMatrix4("transform", current_part_transform);
-        shader_.SetVec4("color", part_color);
+    int first_vertex = vbo_.WriteVertices(vertices_, SOLDIER_SKINNING_FLOATS_PER_VERTEX);
+    Renderer::SetupVertexArray(
+      vbo_.GetId(), std::nullopt, true, true, SOLDIER_SKINNING_EXTRA_ATTRIBUTE_SIZES);
+    Renderer::BindTexture(atlas_texture_);
+    Renderer::DrawArrays(
+      GL_TRIANGLES, first_vertex, (int)vertices_.size() / SOLDIER_SKINNING_FLOATS_PER_VERTEX);
 
-        Renderer::BindTexture(sprite_texture);
-        Renderer::DrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, std::nullopt);
-    }
+    vertices_.clear();
 }
 
 bool SoldierRenderer::IsSoldierPartTypeVisible(Sprites::SoldierPartSpriteType soldier_part_type,
-                                               const Soldier& soldier,
+                                               const SoldierRenderState& soldier,
                                                bool part_base_visibility)
 {
     bool has_blood = false; // TODO: need to get real value
@@ -298,7 +227,7 @@ bool SoldierRenderer::IsSoldierPartTypeVisible(Sprites::SoldierPartSpriteType so
         }
     }
 
-    if (soldier.control.jets && soldier.jets_count > 0) {
+    if (soldier.using_jets) {
         switch (soldier_part_type) {
             case Sprites::SoldierPartSpriteType::Stopa:
                 return false;
@@ -309,7 +238,7 @@ bool SoldierRenderer::IsSoldierPartTypeVisible(Sprites::SoldierPartSpriteType so
         }
     }
 
-    if (soldier.vest > 0.0F && soldier_part_type == Sprites::SoldierPartSpriteType::Kamizelka) {
+    if (soldier.has_vest && soldier_part_type == Sprites::SoldierPartSpriteType::Kamizelka) {
         return true;
     }
 
@@ -319,12 +248,12 @@ bool SoldierRenderer::IsSoldierPartTypeVisible(Sprites::SoldierPartSpriteType so
 // TODO: rework this to something more readable
 bool SoldierRenderer::IsPrimaryWeaponTypeVisible(
   Sprites::SoldierPartPrimaryWeaponSpriteType soldier_part_type,
-  const Soldier& soldier,
+  const SoldierRenderState& soldier,
   bool part_base_visibility)
 {
-    auto primary_weapon_type = GetPrimaryWeapon(soldier).GetWeaponParameters().kind;
-    int ammo = GetPrimaryWeapon(soldier).GetAmmoCount();
-    std::uint16_t reload_time_count = GetPrimaryWeapon(soldier).GetReloadTimeCount();
+    auto primary_weapon_type = soldier.primary_weapon_type;
+    int ammo = soldier.primary_weapon_ammo_count;
+    std::uint16_t reload_time_count = soldier.primary_weapon_reload_time_count;
 
     if (primary_weapon_type == WeaponType::Minigun) {
         if (soldier_part_type == Sprites::SoldierPartPrimaryWeaponSpriteType::Minigun) {
@@ -354,7 +283,7 @@ bool SoldierRenderer::IsPrimaryWeaponTypeVisible(
             }
         }
 
-        if (soldier.body_animation->GetType() == AnimationType::ReloadBow) {
+        if (soldier.body_animation_type == AnimationType::ReloadBow) {
             if (soldier_part_type == Sprites::SoldierPartPrimaryWeaponSpriteType::BowReload) {
                 return true;
             }
@@ -425,9 +354,9 @@ bool SoldierRenderer::IsPrimaryWeaponTypeVisible(
               Sprites::SoldierPartPrimaryWeaponSpriteType::FlamerClip
           };
 
-        auto reload_count = GetPrimaryWeapon(soldier).GetReloadTimeCount();
-        auto clip_in_time = GetPrimaryWeapon(soldier).GetClipInTime();
-        auto clip_out_time = GetPrimaryWeapon(soldier).GetClipOutTime();
+        auto reload_count = soldier.primary_weapon_reload_time_count;
+        auto clip_in_time = soldier.primary_weapon_clip_in_time;
+        auto clip_out_time = soldier.primary_weapon_clip_out_time;
 
         if (std::ranges::contains(soldier_part_primary_weapon_clip_types, soldier_part_type)) {
             for (int i = 0; i < (int)soldier_part_primary_weapon_clip_types.size(); i++) {
@@ -478,9 +407,9 @@ bool SoldierRenderer::IsPrimaryWeaponTypeVisible(
 
 bool SoldierRenderer::IsSecondaryWeaponTypeVisible(
   Sprites::SoldierPartSecondaryWeaponSpriteType soldier_part_type,
-  const Soldier& soldier)
+  const SoldierRenderState& soldier)
 {
-    auto secondary_weapon_type = GetSecondaryWeapon(soldier).GetWeaponParameters().kind;
+    auto secondary_weapon_type = soldier.secondary_weapon_type;
     switch (soldier_part_type) {
         case Sprites::SoldierPartSecondaryWeaponSpriteType::Deagles:
             return secondary_weapon_type == WeaponType::DesertEagles;
@@ -521,10 +450,10 @@ bool SoldierRenderer::IsSecondaryWeaponTypeVisible(
 
 bool SoldierRenderer::IsTertiaryWeaponTypeVisible(
   Sprites::SoldierPartTertiaryWeaponSpriteType soldier_part_type,
-  const Soldier& soldier)
+  const SoldierRenderState& soldier)
 {
-    auto tertiary_weapon_type = GetTertiaryWeapon(soldier).GetWeaponParameters().kind;
-    int ammo = GetTertiaryWeapon(soldier).GetAmmoCount();
+    auto tertiary_weapon_type = soldier.tertiary_weapon_type;
+    int ammo = soldier.tertiary_weapon_ammo_count;
     if (tertiary_weapon_type == WeaponType::FragGrenade) {
         std::vector<Sprites::SoldierPartTertiaryWeaponSpriteType> sprite_types{
             Sprites::SoldierPartTertiaryWeaponSpriteType::FragGrenade1,
@@ -535,7 +464,7 @@ bool SoldierRenderer::IsTertiaryWeaponTypeVisible(
         };
 
         int n = 0;
-        if (soldier.body_animation->GetType() == AnimationType::Throw) {
+        if (soldier.body_animation_type == AnimationType::Throw) {
             n = std::min(5, ammo - 1);
         } else {
             n = std::min(5, ammo);
@@ -556,7 +485,7 @@ bool SoldierRenderer::IsTertiaryWeaponTypeVisible(
         };
 
         int n = 0;
-        if (soldier.body_animation->GetType() == AnimationType::Throw) {
+        if (soldier.body_animation_type == AnimationType::Throw) {
             n = std::min(5, ammo - 1);
         } else {
             n = std::min(5, ammo);
@@ -572,37 +501,29 @@ bool SoldierRenderer::IsTertiaryWeaponTypeVisible(
     return false;
 }
 
-glm::vec4 SoldierRenderer::GetColorForSoldierPart(const Soldier& soldier,
-                                                  Sprites::SoldierSpriteColor soldier_color,
-                                                  Sprites::SoldierSpriteAlpha soldier_alpha)
+void SoldierRenderer::SetColorsForSoldierParts(const SoldierRenderState& soldier,
+                                               SoldierSkinningRecord& soldier_skinning_record)
 {
     auto alpha_base = soldier.alpha;
     auto alpha_blood = std::max(0.0F, std::min(255.0F, 200.0F - soldier.health));
 
-    glm::vec3 color;
-    switch (soldier_color) {
-        case Sprites::SoldierSpriteColor::Cygar:
-            if (soldier.has_cigar != 0) {
-                color = { 97.0F, 97.0F, 97.0F };
-            } else {
-                color = { 255.0F, 255.0F, 255.0F };
-            }
-            break;
-        case Sprites::SoldierSpriteColor::None:
-            color = { 255.0F, 255.0F, 255.0F };
-            break;
-        case Sprites::SoldierSpriteColor::Main:  // TODO: Player.Color1
-        case Sprites::SoldierSpriteColor::Pants: // TODO: Player.Color2
-        case Sprites::SoldierSpriteColor::Hair:  // TODO: Player.HairColor
-            color = { 0.0F, 0.0F, 0.0F };
-            break;
-        case Sprites::SoldierSpriteColor::Skin: // TODO: Player.SkinColor
-            color = { 230.0F, 180.0F, 120.0F };
-            break;
-        case Sprites::SoldierSpriteColor::Headblood:
-            color = { 172.0F, 169.0F, 168.0F };
-            break;
+    const auto set_color = [&soldier_skinning_record](Sprites::SoldierSpriteColor soldier_color,
+                                                      glm::vec3 color) {
+        soldier_skinning_record.colors.at(std::to_underlying(soldier_color)) = color / 255.0F;
+    };
+
+    if (soldier.has_cigar) {
+        set_color(Sprites::SoldierSpriteColor::Cygar, { 97.0F, 97.0F, 97.0F });
+    } else {
+        set_color(Sprites::SoldierSpriteColor::Cygar, { 255.0F, 255.0F, 255.0F });
     }
+    set_color(Sprites::SoldierSpriteColor::None, { 255.0F, 255.0F, 255.0F });
+    set_color(Sprites::SoldierSpriteColor::Main, { 0.0F, 0.0F, 0.0F });  // TODO: Player.Color1
+    set_color(Sprites::SoldierSpriteColor::Pants, { 0.0F, 0.0F, 0.0F }); // TODO: Player.Color2
+    set_color(Sprites::SoldierSpriteColor::Hair, { 0.0F, 0.0F, 0.0F });  // TODO: Player.HairColor
+    // TODO: Player.SkinColor
+    set_color(Sprites::SoldierSpriteColor::Skin, { 230.0F, 180.0F, 120.0F });
+    set_color(Sprites::SoldierSpriteColor::Headblood, { 172.0F, 169.0F, 168.0F });
 
     bool realistic_mode = false; // TODO: get real value
 
@@ -619,19 +540,9 @@ glm::vec4 SoldierRenderer::GetColorForSoldierPart(const Soldier& soldier,
 
     float alpha_nades = (0.75F * (float)alpha_base);
 
-    float alpha = 0;
-    switch (soldier_alpha) {
-        case Sprites::SoldierSpriteAlpha::Base:
-            alpha = alpha_base;
-            break;
-        case Sprites::SoldierSpriteAlpha::Blood:
-            alpha = alpha_blood;
-            break;
-        case Sprites::SoldierSpriteAlpha::Nades:
-            alpha = alpha_nades;
-            break;
-    }
-
-    return { color.x / 255.0F, color.y / 255.0F, color.z / 255.0F, alpha / 255.0F };
+    auto& alphas = soldier_skinning_record.alphas;
+    alphas.at(std::to_underlying(Sprites::SoldierSpriteAlpha::Base)) = (float)alpha_base / 255.0F;
+    alphas.at(std::to_underlying(Sprites::SoldierSpriteAlpha::Blood)) = alpha_blood / 255.0F;
+    alphas.at(std::to_underlying(Sprites::SoldierSpriteAlpha::Nades)) = alpha_nades / 255.0F;
 }
 } // namespace Soldank
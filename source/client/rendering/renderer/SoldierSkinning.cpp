@@ -0,0 +1,139 @@
+module;
+
+#include "rendering/data/sprites/SpriteTypes.hpp"
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+export module SoldierSkinning;
+
+import Extern.Glm;
+
+import Texture;
+
+export namespace Soldank
+{
+// Soldier parts are attached between pairs of these skeleton particles
+constexpr unsigned int SOLDIER_SKELETON_POSITIONS_COUNT = 24;
+constexpr unsigned int MAX_SOLDIER_PARTS_COUNT = 256;
+constexpr unsigned int SOLDIER_SPRITE_COLORS_COUNT = 7;
+constexpr unsigned int SOLDIER_SPRITE_ALPHAS_COUNT = 3;
+
+// Position, color and texture position, then the skeleton segment and segment scale attributes
+constexpr std::array<int, 2> SOLDIER_SKINNING_EXTRA_ATTRIBUTE_SIZES{ 4, 2 };
+constexpr int SOLDIER_SKINNING_FLOATS_PER_VERTEX = 3 + 4 + 2 + 4 + 2;
+constexpr int SOLDIER_SKINNING_VERTICES_PER_PART = 6;
+
+struct SoldierPartSpriteGeometry
+{
+    // Corners of the sprite around the skeleton position it's attached at, in pixels
+    glm::vec2 corner_min;
+    glm::vec2 corner_max;
+    Texture::TextureRegion texture_region;
+};
+
+// What is the same for every soldier about a part
+struct SoldierPartGeometry
+{
+    // Skeleton particles the part goes between, counting from 1
+    glm::uvec2 point;
+    // 0 when the part doesn't stretch between the particles
+    float flexibility;
+    Sprites::SoldierSpriteColor color;
+    Sprites::SoldierSpriteAlpha alpha;
+    // Weapons aren't tinted with the soldier's colors
+    bool tinted;
+    SoldierPartSpriteGeometry sprite;
+    // Used when the soldier faces left, parts without it are mirrored instead
+    std::optional<SoldierPartSpriteGeometry> flipped_sprite;
+};
+
+// What is different for every soldier, gathered once per frame
+struct SoldierSkinningRecord
+{
+    std::array<glm::vec2, SOLDIER_SKELETON_POSITIONS_COUNT> skeleton_positions;
+    std::int8_t direction;
+    // Indexed by SoldierSpriteColor and SoldierSpriteAlpha
+    std::array<glm::vec3, SOLDIER_SPRITE_COLORS_COUNT> colors;
+    std::array<float, SOLDIER_SPRITE_ALPHAS_COUNT> alphas;
+    // Indexed like the parts
+    std::bitset<MAX_SOLDIER_PARTS_COUNT> visible_parts;
+};
+
+// center is the point of the sprite that is attached to the skeleton, relative to its size and
+// counted from the top left corner
+SoldierPartSpriteGeometry CreateSoldierPartSpriteGeometry(glm::vec2 center,
+                                                          glm::vec2 size,
+                                                          bool flipped,
+                                                          Texture::TextureRegion texture_region)
+{
+    glm::vec2 pivot{ center.x, 1.0F - center.y };
+    if (flipped) {
+        pivot.y = 1.0F - pivot.y;
+    }
+    pivot *= size;
+
+    return { .corner_min = -pivot, .corner_max = size - pivot, .texture_region = texture_region };
+}
+
+// Appends SOLDIER_SKINNING_VERTICES_PER_PART vertices for every visible part in the order of the
+// parts. The vertex shader places the parts between their skeleton positions.
+void AppendSoldierSkinningVertices(const SoldierSkinningRecord& record,
+                                   std::span<const SoldierPartGeometry> parts,
+                                   std::vector<float>& vertices)
+{
+    constexpr std::array<unsigned int, SOLDIER_SKINNING_VERTICES_PER_PART> QUAD_CORNER_INDICES{
+        0, 1, 2, 0, 2, 3
+    };
+
+    for (unsigned int part_id = 0; part_id < parts.size(); ++part_id) {
+        if (!record.visible_parts.test(part_id)) {
+            continue;
+        }
+
+        const SoldierPartGeometry& part = parts[part_id];
+        bool facing_left = record.direction != 1;
+        const SoldierPartSpriteGeometry& sprite =
+          facing_left && part.flipped_sprite.has_value() ? *part.flipped_sprite : part.sprite;
+        float mirror = facing_left && !part.flipped_sprite.has_value() ? -1.0F : 1.0F;
+
+        glm::vec4 color{ 1.0F };
+        if (part.tinted) {
+            color = glm::vec4(record.colors.at(static_cast<unsigned int>(part.color)),
+                              record.alphas.at(static_cast<unsigned int>(part.alpha)));
+        }
+
+        glm::vec2 p0 = record.skeleton_positions.at(part.point.x - 1);
+        glm::vec2 p1 = record.skeleton_positions.at(part.point.y - 1);
+
+        const glm::vec2& corner_min = sprite.corner_min;
+        const glm::vec2& corner_max = sprite.corner_max;
+        const glm::vec2& texture_min = sprite.texture_region.texture_min;
+        const glm::vec2& texture_max = sprite.texture_region.texture_max;
+        const std::array<std::array<float, 4>, 4> corners{ {
+          { corner_min.x, corner_min.y, texture_min.x, texture_min.y },
+          { corner_max.x, corner_min.y, texture_max.x, texture_min.y },
+          { corner_max.x, corner_max.y, texture_max.x, texture_max.y },
+          { corner_min.x, corner_max.y, texture_min.x, texture_max.y },
+        } };
+
+        for (unsigned int corner_index : QUAD_CORNER_INDICES) {
+            const auto& corner = corners.at(corner_index);
+            vertices.insert(vertices.end(),
+                            {
+                              // clang-format off
+                              corner[0], corner[1], 0.0F,
+                              color.r, color.g, color.b, color.a,
+                              corner[2], corner[3],
+                              p0.x, p0.y, p1.x, p1.y,
+                              part.flexibility, mirror,
+                              // clang-format on
+                            });
+        }
+    }
+}
+} // namespace Soldank
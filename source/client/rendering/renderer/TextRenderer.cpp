@@ -7,15 +7,23 @@ module;
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
+#include <algorithm>
 #include <array>
-#include <map>
+#include <cstddef>
+#include <functional>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 export module TextRenderer;
 
 import Extern.Glm;
+import Renderer;
 import Shader;
+import Rendering.Gpu.GpuBuffer;
 
 import Extern.Spdlog;
 
@@ -23,12 +31,15 @@ export namespace Soldank
 {
 struct Character
 {
-    unsigned int texture_id; // ID handle of the glyph texture
-    glm::ivec2 size;         // Size of glyph
-    glm::ivec2 bearing;      // Offset from baseline to left/top of glyph
-    unsigned int advance;    // Offset to advance to next glyph
+    glm::vec2 texture_min; // Glyph's corners in the atlas, in texture coordinates
+    glm::vec2 texture_max;
+    glm::ivec2 size;       // Size of glyph
+    glm::ivec2 bearing;    // Offset from baseline to left/top of glyph
+    unsigned int advance;  // Offset to advance to next glyph
 };
 
+// Glyphs of all the characters live in a single atlas texture. Texts added during a frame are
+// collected into one vertex buffer and drawn with a single draw call by Render.
 class TextRenderer
 {
 public:
@@ -42,18 +53,49 @@ public:
     TextRenderer(TextRenderer&&) = delete;
     TextRenderer& operator=(TextRenderer&& other) = delete;
 
-    void Render(std::string text,
-                float x,
-                float y,
-                float scale,
-                glm::vec3 color,
-                glm::vec2 window_dimensions);
+    // x and y are the position of the text's baseline start in window pixels, from the bottom left
+    void AddText(std::string_view text, float x, float y, float scale, glm::vec3 color);
+
+    // Draws all the texts added since the last call
+    void Render(glm::vec2 window_dimensions);
 
 private:
+    static constexpr std::size_t CHARACTERS_COUNT = 128;
+    static constexpr int ATLAS_WIDTH = 1024;
+    static constexpr int ATLAS_GLYPH_PADDING = 1;
+    static constexpr std::size_t MAX_CACHED_LAYOUTS = 256;
+    static constexpr std::size_t FLOATS_PER_VERTEX = 9;
+
+    // Glyph quad relative to the text's start, in font pixels
+    struct GlyphQuad
+    {
+        glm::vec2 min;
+        glm::vec2 max;
+        glm::vec2 texture_min;
+        glm::vec2 texture_max;
+    };
+
+    struct TextHash
+    {
+        using is_transparent = void;
+
+        std::size_t operator()(std::string_view text) const
+        {
+            return std::hash<std::string_view>{}(text);
+        }
+    };
+
+    const std::vector<GlyphQuad>& GetLayout(std::string_view text);
+
     Shader shader_;
-    std::map<char, Character> characters_;
+    std::array<Character, CHARACTERS_COUNT> characters_{};
+    unsigned int atlas_texture_;
+
+    std::unordered_map<std::string, std::vector<GlyphQuad>, TextHash, std::equal_to<>>
+      cached_layouts_;
 
-    unsigned int vbo_;
+    std::vector<float> vertices_;
+    GpuBuffer vbo_;
 };
 } // namespace Soldank
 
@@ -61,6 +103,7 @@ namespace Soldank
 {
 TextRenderer::TextRenderer(const std::string& file_path, unsigned int font_height)
     : shader_(ShaderSources::FONT_VERTEX_SHADER_SOURCE, ShaderSources::FONT_FRAGMENT_SHADER_SOURCE)
+    , atlas_texture_(0)
 {
     FT_Library ft = nullptr;
     // All functions return a value different than 0 whenever an error occurred
@@ -80,131 +123,185 @@ TextRenderer::TextRenderer(const std::string& file_path, unsigned int font_heigh
         // set size to load glyphs as
         FT_Set_Pixel_Sizes(face, 0, font_height);
 
-        // disable byte-alignment restriction
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-        // load first 128 characters of ASCII set
-        for (unsigned char c = 0; c < 128; c++) {
+        // load first 128 characters of ASCII set and place them in rows of the atlas
+        std::array<std::vector<unsigned char>, CHARACTERS_COUNT> glyph_bitmaps;
+        std::array<glm::ivec2, CHARACTERS_COUNT> glyph_positions{};
+        glm::ivec2 next_glyph_position{ ATLAS_GLYPH_PADDING };
+        int row_height = 0;
+        for (unsigned char c = 0; c < CHARACTERS_COUNT; c++) {
             // Load character glyph
             if (FT_Load_Char(face, c, FT_LOAD_RENDER) != 0) {
                 Spdlog::error("ERROR::FREETYTPE: Failed to load Glyph");
                 continue;
             }
-            // generate texture
-            unsigned int texture = 0;
-            glActiveTexture(GL_TEXTURE0);
-            glGenTextures(1, &texture);
-            glBindTexture(GL_TEXTURE_2D, texture);
+
+            const FT_Bitmap& bitmap = face->glyph->bitmap;
+            glm::ivec2 glyph_size(bitmap.width, bitmap.rows);
+            if (next_glyph_position.x + glyph_size.x + ATLAS_GLYPH_PADDING > ATLAS_WIDTH) {
+                next_glyph_position = { ATLAS_GLYPH_PADDING,
+                                        next_glyph_position.y + row_height + ATLAS_GLYPH_PADDING };
+                row_height = 0;
+            }
+            glyph_positions.at(c) = next_glyph_position;
+            next_glyph_position.x += glyph_size.x + ATLAS_GLYPH_PADDING;
+            row_height = std::max(row_height, glyph_size.y);
+
+            auto& glyph_bitmap = glyph_bitmaps.at(c);
+            for (int row = 0; row < glyph_size.y; ++row) {
+                const unsigned char* row_start = bitmap.buffer + (std::ptrdiff_t)row * bitmap.pitch;
+                glyph_bitmap.insert(glyph_bitmap.end(), row_start, row_start + glyph_size.x);
+            }
+
+            characters_.at(c) = { .texture_min = {},
+                                  .texture_max = {},
+                                  .size = glyph_size,
+                                  .bearing = { face->glyph->bitmap_left, face->glyph->bitmap_top },
+                                  .advance = static_cast<unsigned int>(face->glyph->advance.x) };
+        }
+
+        int atlas_height = 1;
+        while (atlas_height < next_glyph_position.y + row_height + ATLAS_GLYPH_PADDING) {
+            atlas_height *= 2;
+        }
+        std::vector<unsigned char> atlas((std::size_t)ATLAS_WIDTH * atlas_height, 0);
+        glm::vec2 atlas_dimensions(ATLAS_WIDTH, atlas_height);
+        for (std::size_t c = 0; c < CHARACTERS_COUNT; ++c) {
+            auto& character = characters_.at(c);
+            const auto& glyph_position = glyph_positions.at(c);
+            for (int row = 0; row < character.size.y; ++row) {
+                std::ranges::copy_n(
+                  glyph_bitmaps.at(c).begin() + (std::ptrdiff_t)row * character.size.x,
+                  character.size.x,
+                  atlas.begin() + (std::ptrdiff_t)(glyph_position.y + row) * ATLAS_WIDTH +
+                    glyph_position.x);
+            }
+            character.texture_min = glm::vec2(glyph_position) / atlas_dimensions;
+            character.texture_max = glm::vec2(glyph_position + character.size) / atlas_dimensions;
+        }
+
+        // disable byte-alignment restriction
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+        glActiveTexture(GL_TEXTURE0);
+        glGenTextures(1, &atlas_texture_);
+        glBindTexture(GL_TEXTURE_2D, atlas_texture_);
 #ifdef __EMSCRIPTEN__
-            constexpr GLenum GLYPH_TEXTURE_INTERNAL_FORMAT = 0x8229; // GL_R8
-            constexpr GLenum GLYPH_TEXTURE_FORMAT = GL_RED;
+        constexpr GLenum GLYPH_TEXTURE_INTERNAL_FORMAT = 0x8229; // GL_R8
+        constexpr GLenum GLYPH_TEXTURE_FORMAT = GL_RED;
 #else
-            constexpr GLenum GLYPH_TEXTURE_INTERNAL_FORMAT = GL_RED;
-            constexpr GLenum GLYPH_TEXTURE_FORMAT = GL_RED;
+        constexpr GLenum GLYPH_TEXTURE_INTERNAL_FORMAT = GL_RED;
+        constexpr GLenum GLYPH_TEXTURE_FORMAT = GL_RED;
 #endif
-            const GLsizei glyph_width = static_cast<GLsizei>(face->glyph->bitmap.width);
-            const GLsizei glyph_height = static_cast<GLsizei>(face->glyph->bitmap.rows);
-            const bool has_glyph_bitmap = glyph_width > 0 && glyph_height > 0;
-            const std::array<unsigned char, 1> empty_glyph = { 0 };
-            glTexImage2D(GL_TEXTURE_2D,
-                         0,
-                         GLYPH_TEXTURE_INTERNAL_FORMAT,
-                         has_glyph_bitmap ? glyph_width : 1,
-                         has_glyph_bitmap ? glyph_height : 1,
-                         0,
-                         GLYPH_TEXTURE_FORMAT,
-                         GL_UNSIGNED_BYTE,
-                         has_glyph_bitmap ? face->glyph->bitmap.buffer : empty_glyph.data());
-            // set texture options
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            // now store character for later use
-            Character character = { texture,
-                                    glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-                                    glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-                                    static_cast<unsigned int>(face->glyph->advance.x) };
-            characters_.insert({ c, character });
-        }
+        glTexImage2D(GL_TEXTURE_2D,
+                     0,
+                     GLYPH_TEXTURE_INTERNAL_FORMAT,
+                     ATLAS_WIDTH,
+                     atlas_height,
+                     0,
+                     GLYPH_TEXTURE_FORMAT,
+                     GL_UNSIGNED_BYTE,
+                     atlas.data());
+        // set texture options
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         glBindTexture(GL_TEXTURE_2D, 0);
     }
     // destroy FreeType once we're finished
     FT_Done_Face(face);
     FT_Done_FreeType(ft);
 
-    vbo_ = 0;
-    glGenBuffers(1, &vbo_);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, nullptr, GL_DYNAMIC_DRAW);
+    vbo_ = GpuBuffer(GpuBufferTarget::Array, nullptr, 0, GL_STREAM_DRAW);
 }
 
 TextRenderer::~TextRenderer()
 {
-    glDeleteBuffers(1, &vbo_);
-    for (auto [symbol, character] : characters_) {
-        glDeleteTextures(1, &character.texture_id);
+    if (atlas_texture_ != 0) {
+        glDeleteTextures(1, &atlas_texture_);
     }
 }
 
-void TextRenderer::Render(std::string text,
-                          float x,
-                          float y,
-                          float scale,
-                          glm::vec3 color,
-                          glm::vec2 window_dimensions)
+void TextRenderer::AddText(std::string_view text, float x, float y, float scale, glm::vec3 color)
 {
-    // activate corresponding render state
+    for (const auto& glyph_quad : GetLayout(text)) {
+        glm::vec2 min = glm::vec2(x, y) + glyph_quad.min * scale;
+        glm::vec2 max = glm::vec2(x, y) + glyph_quad.max * scale;
+        // the atlas rows go down from the top of the glyph, so t grows opposite to y
+        std::array<std::array<float, 4>, 6> corners = {
+            { { min.x, max.y, glyph_quad.texture_min.x, glyph_quad.texture_min.y },
+              { min.x, min.y, glyph_quad.texture_min.x, glyph_quad.texture_max.y },
+              { max.x, min.y, glyph_quad.texture_max.x, glyph_quad.texture_max.y },
+
+              { min.x, max.y, glyph_quad.texture_min.x, glyph_quad.texture_min.y },
+              { max.x, min.y, glyph_quad.texture_max.x, glyph_quad.texture_max.y },
+              { max.x, max.y, glyph_quad.texture_max.x, glyph_quad.texture_min.y } }
+        };
+        for (const auto& corner : corners) {
+            vertices_.insert(vertices_.end(),
+                             { corner[0],
+                               corner[1],
+                               0.0F,
+                               color.x,
+                               color.y,
+                               color.z,
+                               1.0F,
+                               corner[2],
+                               corner[3] });
+        }
+    }
+}
+
+void TextRenderer::Render(glm::vec2 window_dimensions)
+{
+    if (vertices_.empty()) {
+        return;
+    }
+
     shader_.Use();
-    shader_.SetVec3("textColor", color);
     glm::mat4 projection = glm::ortho(0.0F, window_dimensions.x, 0.0F, window_dimensions.y);
     shader_.SetMatrix4("projection", projection);
 
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-    glDisableVertexAttribArray(1);
-    glDisableVertexAttribArray(2);
-    glVertexAttrib4f(1, 1.0F, 1.0F, 1.0F, 1.0F);
-    glVertexAttrib2f(2, 0.0F, 0.0F);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), nullptr);
-    glEnableVertexAttribArray(0);
-
-    // iterate through all characters
-    std::string::const_iterator c;
-    for (c = text.begin(); c != text.end(); c++) {
-        auto character = characters_.find(*c);
-        if (character == characters_.end()) {
-            continue;
-        }
-        Character ch = character->second;
+    vbo_.Replace(
+      vertices_.data(), (long long)vertices_.size() * (long long)sizeof(float), GL_STREAM_DRAW);
+    Renderer::SetupVertexArray(vbo_.GetId(), std::nullopt);
+    Renderer::BindTexture(atlas_texture_);
+    Renderer::DrawArrays(GL_TRIANGLES, 0, (int)(vertices_.size() / FLOATS_PER_VERTEX));
+
+    vertices_.clear();
+}
 
-        if (ch.size.x <= 0 || ch.size.y <= 0) {
-            x += (float)(ch.advance >> 6) * scale;
+const std::vector<TextRenderer::GlyphQuad>& TextRenderer::GetLayout(std::string_view text)
+{
+    if (auto cached_layout = cached_layouts_.find(text); cached_layout != cached_layouts_.end()) {
+        return cached_layout->second;
+    }
+
+    // Texts like timers change every frame, so the cache is dropped once it grows too big
+    if (cached_layouts_.size() >= MAX_CACHED_LAYOUTS) {
+        cached_layouts_.clear();
+    }
+
+    std::vector<GlyphQuad> layout;
+    float x = 0.0F;
+    for (char c : text) {
+        auto character_index = static_cast<unsigned char>(c);
+        if (character_index >= CHARACTERS_COUNT) {
             continue;
         }
+        const Character& ch = characters_.at(character_index);
 
-        float xpos = x + (float)ch.bearing.x * scale;
-        float ypos = y - (float)(ch.size.y - ch.bearing.y) * scale;
-
-        float w = (float)ch.size.x * scale;
-        float h = (float)ch.size.y * scale;
-        // update VBO for each character
-        std::array<std::array<float, 4>, 6> vertices = { { { xpos, ypos + h, 0.0, 0.0 },
-                                                           { xpos, ypos, 0.0, 1.0 },
-                                                           { xpos + w, ypos, 1.0, 1.0 },
-
-                                                           { xpos, ypos + h, 0.0, 0.0 },
-                                                           { xpos + w, ypos, 1.0, 1.0 },
-                                                           { xpos + w, ypos + h, 1.0, 0.0 } } };
-        // render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, ch.texture_id);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, 6ULL * 4 * sizeof(float), vertices.data());
-
-        // render quad
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        if (ch.size.x > 0 && ch.size.y > 0) {
+            glm::vec2 min(x + (float)ch.bearing.x, -(float)(ch.size.y - ch.bearing.y));
+            layout.push_back({ .min = min,
+                               .max = min + glm::vec2(ch.size),
+                               .texture_min = ch.texture_min,
+                               .texture_max = ch.texture_max });
+        }
         // now advance cursors for next glyph (note that advance is number of 1/64 pixels)
-        x += (float)(ch.advance >> 6) *
-             scale; // bitshift by 6 to get value in pixels (2^6 = 64 (divide
-                    // amount of 1/64th pixels by 64 to get amount of pixels))
+        x += (float)(ch.advance >> 6);
     }
+
+    return cached_layouts_.emplace(std::string(text), std::move(layout)).first->second;
 }
 } // namespace Soldank
@@ -25,47 +25,46 @@ public:
         game_state_manager.ForEachSoldier([&](const auto& soldier) {
             if (client_state.client_soldier_id.has_value() &&
                 *client_state.client_soldier_id == soldier.id) {
-                text_renderer_.Render(
+                text_renderer_.AddText(
                   "Health: " + std::to_string((int)soldier.health),
                   50.0,
                   100.0,
                   1.0,
-                  { 1.0, 1.0, 1.0 },
-                  { client_state.input.window_width, client_state.input.window_height });
-                text_renderer_.Render(
+                  { 1.0, 1.0, 1.0 });
+                text_renderer_.AddText(
                   "Jets: " + std::to_string((int)soldier.jets_count),
                   50.0,
                   50.0,
                   1.0,
-                  { 1.0, 1.0, 1.0 },
-                  { client_state.input.window_width, client_state.input.window_height });
+                  { 1.0, 1.0, 1.0 });
             }
         });
 
         if (client_state.client_soldier_id.has_value()) {
             game_state_manager.ForEachSoldier([&](const auto& soldier) {
                 if (*client_state.client_soldier_id == soldier.id && soldier.dead_meat) {
-                    text_renderer_.Render(
+                    text_renderer_.AddText(
                       "Respawn timer: " +
                         std::format("{:.2f}", (float)soldier.ticks_to_respawn / 60.0F),
                       400.0,
                       100.0,
                       1.0,
-                      { 1.0, 1.0, 1.0 },
-                      { client_state.input.window_width, client_state.input.window_height });
+                      { 1.0, 1.0, 1.0 });
                 }
             });
         }
 
         if (game_state_manager.IsGamePaused()) {
-            text_renderer_.Render(
+            text_renderer_.AddText(
               "Game paused",
               400.0,
               700.0,
               1.0,
-              { 0.6, 0.7, 0.4 },
-              { client_state.input.window_width, client_state.input.window_height });
+              { 0.6, 0.7, 0.4 });
         }
+
+        text_renderer_.Render(
+          { client_state.input.window_width, client_state.input.window_height });
     }
 
 private:
@@ -3,8 +3,14 @@ module;
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -18,6 +24,7 @@ import Shared.Core.State.StateManager;
 import Shared.Core.State.Control;
 import Shared.Core.Animations;
 import Shared.Core.Types.WeaponType;
+import Shared.Core.Utility.FrameProfiler;
 
 export namespace Soldank::DebugUI
 {
@@ -257,14 +264,189 @@ void AddControlActionTypes(const Control& soldier_control,
     }
 }
 
+// Zones with the same name keep their color from frame to frame
+ImU32 GetProfilerZoneColor(std::string_view zone_name)
+{
+    float hue = (float)(std::hash<std::string_view>{}(zone_name) % 360) / 360.0F;
+    return ImColor::HSV(hue, 0.45F, 0.85F);
+}
+
+void RenderProfiledFrameTimeline(const ProfiledFrame& frame)
+{
+    constexpr float ROW_HEIGHT = 18.0F;
+
+    // GPU zones are in a row of their own below the CPU zones, and may end after the CPU frame
+    int cpu_rows_count = 1;
+    bool has_gpu_zones = false;
+    std::int64_t timeline_end_ns = frame.start_ns + frame.duration_ns;
+    for (const auto& zone : frame.zones) {
+        if (zone.track == ProfilerTrack::Gpu) {
+            has_gpu_zones = true;
+            timeline_end_ns = std::max(timeline_end_ns, zone.start_ns + zone.duration_ns);
+        } else {
+            cpu_rows_count = std::max(cpu_rows_count, zone.depth + 1);
+        }
+    }
+    int rows_count = cpu_rows_count + (has_gpu_zones ? 1 : 0);
+
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    float width = std::max(ImGui::GetContentRegionAvail().x, 1.0F);
+    ImGui::InvisibleButton("##Timeline", { width, (float)rows_count * ROW_HEIGHT });
+    float pixels_per_ns =
+      width / (float)std::max(timeline_end_ns - frame.start_ns, std::int64_t{ 1 });
+
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    const ProfilerZone* hovered_zone = nullptr;
+    for (const auto& zone : frame.zones) {
+        int row = zone.track == ProfilerTrack::Gpu ? cpu_rows_count : zone.depth;
+        ImVec2 zone_min{ origin.x + (float)(zone.start_ns - frame.start_ns) * pixels_per_ns,
+                         origin.y + (float)row * ROW_HEIGHT };
+        ImVec2 zone_max{ zone_min.x + std::max((float)zone.duration_ns * pixels_per_ns, 1.0F),
+                         zone_min.y + ROW_HEIGHT - 1.0F };
+        draw_list->AddRectFilled(zone_min, zone_max, GetProfilerZoneColor(zone.name));
+        draw_list->PushClipRect(zone_min, zone_max, true);
+        draw_list->AddText({ zone_min.x + 2.0F, zone_min.y + 2.0F },
+                           IM_COL32_BLACK,
+                           zone.name.data(),
+                           zone.name.data() + zone.name.size());
+        draw_list->PopClipRect();
+
+        if (ImGui::IsMouseHoveringRect(zone_min, zone_max)) {
+            hovered_zone = &zone;
+        }
+    }
+
+    if (hovered_zone != nullptr) {
+        ImGui::SetTooltip("%s%.*s: %.3f ms",
+                          hovered_zone->track == ProfilerTrack::Gpu ? "GPU " : "",
+                          (int)hovered_zone->name.size(),
+                          hovered_zone->name.data(),
+                          (double)hovered_zone->duration_ns / 1'000'000.0);
+    }
+    if (!has_gpu_zones) {
+        ImGui::TextUnformatted("No GPU timings for this frame, timer queries may be unsupported");
+    }
+}
+
+void RenderFrameProfilerWindow(FrameProfilerWindowState& window_state)
+{
+    constexpr std::string_view TRACE_FILE_PATH = "frame_profile.json";
+
+    FrameProfiler& frame_profiler = GetFrameProfiler();
+    ImGui::Begin("Frame profiler");
+
+    bool is_recording = frame_profiler.IsEnabled();
+    if (ImGui::Checkbox("Record", &is_recording)) {
+        frame_profiler.SetEnabled(is_recording);
+    }
+    ImGui::SameLine();
+    std::string& export_status = window_state.export_status;
+    if (ImGui::Button("Export Chrome trace")) {
+        std::ofstream trace_file(std::string(TRACE_FILE_PATH), std::ios::out | std::ios::trunc);
+        trace_file << frame_profiler.ExportChromeTrace();
+        export_status = trace_file.good() ? "Exported to " : "Could not write ";
+        export_status += TRACE_FILE_PATH;
+    }
+    if (!export_status.empty()) {
+        ImGui::SameLine();
+        ImGui::TextUnformatted(export_status.c_str());
+    }
+
+    std::size_t frames_count = frame_profiler.GetFramesCount();
+    if (frames_count == 0) {
+        ImGui::TextUnformatted("No frames recorded");
+        ImGui::End();
+        return;
+    }
+
+    std::vector<float>& frame_durations_ms = window_state.frame_durations_ms;
+    frame_durations_ms.clear();
+    std::size_t slowest_frame_index = 0;
+    for (std::size_t i = 0; i < frames_count; ++i) {
+        frame_durations_ms.push_back((float)frame_profiler.GetFrame(i).duration_ns / 1'000'000.0F);
+        if (frame_durations_ms.at(i) > frame_durations_ms.at(slowest_frame_index)) {
+            slowest_frame_index = i;
+        }
+    }
+
+    // Clicking the graph picks a frame
+    std::optional<std::uint64_t>& picked_frame_number = window_state.picked_frame_number;
+    ImGui::PlotHistogram("##Frame durations",
+                         frame_durations_ms.data(),
+                         (int)frames_count,
+                         0,
+                         "Frame durations (click to pick a frame)",
+                         0.0F,
+                         std::max(*std::ranges::max_element(frame_durations_ms), 1.0F),
+                         { -1.0F, 60.0F });
+    if (ImGui::IsItemClicked()) {
+        float item_width = std::max(ImGui::GetItemRectSize().x, 1.0F);
+        float picked_position = (ImGui::GetMousePos().x - ImGui::GetItemRectMin().x) / item_width;
+        auto picked_frame_index = (std::size_t)std::clamp(
+          picked_position * (float)frames_count, 0.0F, (float)frames_count - 1.0F);
+        picked_frame_number = frame_profiler.GetFrame(picked_frame_index).frame_number;
+    }
+    if (ImGui::Button("Newest")) {
+        picked_frame_number.reset();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Slowest")) {
+        picked_frame_number = frame_profiler.GetFrame(slowest_frame_index).frame_number;
+    }
+
+    const ProfiledFrame* frame = nullptr;
+    if (picked_frame_number.has_value()) {
+        frame = frame_profiler.FindFrame(*picked_frame_number);
+    }
+    if (frame == nullptr) {
+        // GPU timings of the newest frames aren't known yet, the newest frame having them is
+        // shown instead when there is one among the last few
+        constexpr std::size_t MAX_GPU_LATENCY_FRAMES_COUNT = 8;
+        picked_frame_number.reset();
+        frame = &frame_profiler.GetFrame(frames_count - 1);
+        for (std::size_t i = 0; i < std::min(frames_count, MAX_GPU_LATENCY_FRAMES_COUNT); ++i) {
+            const ProfiledFrame& recent_frame = frame_profiler.GetFrame(frames_count - 1 - i);
+            if (std::ranges::any_of(recent_frame.zones, [](const ProfilerZone& zone) {
+                    return zone.track == ProfilerTrack::Gpu;
+                })) {
+                frame = &recent_frame;
+                break;
+            }
+        }
+    }
+
+    constexpr auto to_ms = [](std::int64_t nanoseconds) {
+        return (double)nanoseconds / 1'000'000.0;
+    };
+    ImGui::Text("Frame %llu: %.3f ms",
+                (unsigned long long)frame->frame_number,
+                to_ms(frame->duration_ns));
+    ImGui::Text("Input %.3f ms, network %.3f ms, simulation %.3f ms, render %.3f ms",
+                to_ms(frame->GetZonesDuration("Input")),
+                to_ms(frame->GetZonesDuration("Network")),
+                to_ms(frame->GetZonesDuration("Simulation tick")),
+                to_ms(frame->GetZonesDuration("Render")));
+    RenderProfiledFrameTimeline(*frame);
+
+    ImGui::End();
+}
+
 void RenderFrameContents(const StateManager& game_state_manager, ClientState& client_state, int fps)
 {
     if (client_state.debug_render.is_game_debug_interface_enabled) {
+        RenderFrameProfilerWindow(client_state.debug_render.frame_profiler_window);
+
         {
             ImGui::Begin("Network window (Works only when connected to a server)");
             ImGui::Checkbox("Server reconciliation", &client_state.network.server_reconciliation);
             ImGui::Checkbox("Client side prediction", &client_state.network.client_side_prediction);
             ImGui::Checkbox("Objects interpolation", &client_state.network.objects_interpolation);
+            ImGui::Checkbox("Remote soldiers interpolation",
+                            &client_state.network.remote_soldiers_interpolation);
+            ImGui::Text(
+              "Remote soldiers delay: %u ticks, resyncs %u",
+              client_state.network.remote_soldier_snapshots.GetDelayTicks(),
+              client_state.network.remote_soldier_snapshots.GetResynchronizationCount());
             ImGui::Text("Non-acknowledged inputs: %zu", client_state.network.pending_inputs.size());
             ImGui::Text("Ping: %hu", client_state.network.ping_timer.GetLastPingMeasure());
             ImGui::Text("Input delay: target %u, active %u, resyncs %u",
@@ -274,12 +456,10 @@ void RenderFrameContents(const StateManager& game_state_manager, ClientState& cl
             ImGui::SliderInt("Fake lag (milliseconds)", &client_state.network.network_lag, 0, 500);
             ImGui::Checkbox("Draw server POV client position",
                             &client_state.network.draw_server_pov_client_pos);
-#ifndef NDEBUG
             ImGui::Text("Local correction: %.3f (max %.3f, count %u)",
                         client_state.network.last_local_correction_distance,
                         client_state.network.maximum_local_correction_distance,
                         client_state.network.local_correction_count);
-#endif
             ImGui::End();
         }
 
@@ -294,6 +474,8 @@ void RenderFrameContents(const StateManager& game_state_manager, ClientState& cl
             ImGui::Checkbox("Draw item hitboxes", &client_state.debug_render.draw_item_hitboxes);
             ImGui::Checkbox("Draw collision sectors", &client_state.debug_render.draw_sectors);
             ImGui::Checkbox("Draw map boundaries", &client_state.debug_render.draw_map_boundaries);
+            ImGui::Checkbox("Render from tick snapshots",
+                            &client_state.world_render_options.render_from_snapshots);
 
             ImGui::Checkbox("Smooth camera", &client_state.camera.smooth);
             ImGui::Text("Application average %.3f ms/frame (%d FPS)", 1000.0F / (float)fps, fps);
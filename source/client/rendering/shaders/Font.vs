@@ -1,11 +1,15 @@
 R"(
 #version 120
-attribute vec4 vertex;
+attribute vec3 position;
+attribute vec4 color;
+attribute vec2 texturePosition;
+varying vec4 TextColor;
 varying vec2 TexCoords;
 uniform mat4 projection;
 
 void main(void) {
-    gl_Position = projection * vec4(vertex.xy, 0.0, 1.0);
-TexCoords = vertex.zw;
+    gl_Position = projection * vec4(position.xy, 0.0, 1.0);
+    TextColor = color;
+    TexCoords = texturePosition;
 }
-)"
\ No newline at end of file
+)"
@@ -0,0 +1,21 @@
+R"(
+#version 120
+uniform mat4 transform;
+// Positions are relative to the center of the chunk the vertex belongs to, in 1/positionScale
+// units
+uniform vec2 chunkOrigin;
+uniform float positionScale;
+attribute vec2 position;
+attribute vec4 color;
+attribute vec2 texturePosition;
+
+varying vec4 vertexColor;
+varying vec2 vertexTexturePosition;
+
+void main()
+{
+    gl_Position = transform * vec4(chunkOrigin + position / positionScale, 0.0, 1.0);
+    vertexColor = color;
+    vertexTexturePosition = texturePosition;
+}
+)"
@@ -0,0 +1,42 @@
+R"(
+#version 120
+uniform mat4 transform;
+// Seconds since the sceneries started animating
+uniform float time;
+// Animated textures hold their frames in a grid of framesGrid.x columns and framesGrid.y rows.
+// Frame i is shown until frameEndTimes[i] seconds into the animation, then the animation loops.
+// Still textures are a single frame.
+uniform vec2 framesGrid;
+uniform int framesCount;
+uniform float frameEndTimes[64];
+attribute vec3 position;
+attribute vec4 color;
+attribute vec2 texturePosition;
+// x, y and rotation of the scenery the vertex belongs to
+attribute vec3 instanceTransform;
+attribute vec2 instanceScale;
+
+varying vec4 vertexColor;
+varying vec2 vertexTexturePosition;
+
+void main()
+{
+    vec2 scaledPosition = position.xy * instanceScale;
+    float rotationCos = cos(instanceTransform.z);
+    float rotationSin = sin(instanceTransform.z);
+    vec2 rotatedPosition = vec2(scaledPosition.x * rotationCos - scaledPosition.y * rotationSin,
+                                scaledPosition.x * rotationSin + scaledPosition.y * rotationCos);
+    gl_Position = transform * vec4(instanceTransform.xy + rotatedPosition, 0.0, 1.0);
+    vertexColor = color;
+
+    float animationTime = mod(time, frameEndTimes[framesCount - 1]);
+    int frame = 0;
+    for (int i = 0; i < 63; ++i) {
+        if (i < framesCount - 1 && animationTime >= frameEndTimes[i]) {
+            frame = i + 1;
+        }
+    }
+    vec2 frameCell = vec2(mod(float(frame), framesGrid.x), floor(float(frame) / framesGrid.x));
+    vertexTexturePosition = (frameCell + texturePosition) / framesGrid;
+}
+)"
@@ -3,6 +3,7 @@ module;
 #include <glad/glad.h>
 
 #include <array>
+#include <span>
 #include <string>
 #include <string_view>
 #include <fstream>
@@ -31,9 +32,12 @@ public:
     Shader& operator=(Shader&& other) = delete;
 
     void Use() const;
+    // 0 when the shader program isn't ready to be used
+    unsigned int GetId() const;
     void SetBool(const std::string& name, bool value) const;
     void SetInt(const std::string& name, int value) const;
     void SetFloat(const std::string& name, float value) const;
+    void SetFloatArray(const std::string& name, std::span<const float> values) const;
     void SetVec2(const std::string& name, const glm::vec2& value) const;
     void SetVec3(const std::string& name, const glm::vec3& value) const;
     void SetVec4(const std::string& name, const glm::vec4& value) const;
@@ -143,6 +147,18 @@ Shader::Shader(const char* vertex_shader_source, const char* fragment_shader_sou
     if (vertex_source_view.find(" vec2 texturePosition") != std::string_view::npos) {
         glBindAttribLocation(id_, 2, "texturePosition");
     }
+    if (vertex_source_view.find(" vec3 instanceTransform") != std::string_view::npos) {
+        glBindAttribLocation(id_, 3, "instanceTransform");
+    }
+    if (vertex_source_view.find(" vec2 instanceScale") != std::string_view::npos) {
+        glBindAttribLocation(id_, 4, "instanceScale");
+    }
+    if (vertex_source_view.find(" vec4 skeletonSegment") != std::string_view::npos) {
+        glBindAttribLocation(id_, 3, "skeletonSegment");
+    }
+    if (vertex_source_view.find(" vec2 segmentScale") != std::string_view::npos) {
+        glBindAttribLocation(id_, 4, "segmentScale");
+    }
     glLinkProgram(id_);
     is_linked_ = CheckCompileErrors(id_, "PROGRAM");
 
@@ -187,6 +203,11 @@ bool Shader::IsReady() const
 #endif
 }
 
+unsigned int Shader::GetId() const
+{
+    return IsReady() ? id_ : 0;
+}
+
 void Shader::SetBool(const std::string& name, bool value) const
 {
     if (!IsReady()) {
@@ -211,6 +232,14 @@ void Shader::SetFloat(const std::string& name, float value) const
     glUniform1f(glGetUniformLocation(id_, name.c_str()), value);
 }
 
+void Shader::SetFloatArray(const std::string& name, std::span<const float> values) const
+{
+    if (!IsReady()) {
+        return;
+    }
+    glUniform1fv(glGetUniformLocation(id_, name.c_str()), (GLsizei)values.size(), values.data());
+}
+
 void Shader::SetVec2(const std::string& name, const glm::vec2& value) const
 {
     if (!IsReady()) {
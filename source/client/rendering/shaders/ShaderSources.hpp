@@ -11,6 +11,18 @@ constexpr const char* const FRAGMENT_SHADER_SOURCE =
 #include "Standard.fs"
   ;
 
+constexpr const char* const SCENERY_VERTEX_SHADER_SOURCE =
+#include "Scenery.vs"
+  ;
+
+constexpr const char* const POLYGON_MESH_VERTEX_SHADER_SOURCE =
+#include "PolygonMesh.vs"
+  ;
+
+constexpr const char* const SOLDIER_SKINNING_VERTEX_SHADER_SOURCE =
+#include "SoldierSkinning.vs"
+  ;
+
 constexpr const char* const NO_TEXTURE_VERTEX_SHADER_SOURCE =
 #include "NoTexture.vs"
   ;
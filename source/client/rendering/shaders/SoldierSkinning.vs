@@ -0,0 +1,40 @@
+R"(
+#version 120
+uniform mat4 transform;
+attribute vec3 position;
+attribute vec4 color;
+attribute vec2 texturePosition;
+// Skeleton positions the part is attached between, the sprite's pivot is at the first one.
+// Skeleton positions have y pointing down.
+attribute vec4 skeletonSegment;
+// x is the part's flexibility, 0 when it doesn't stretch. y is -1 when the sprite is mirrored.
+attribute vec2 segmentScale;
+
+varying vec4 vertexColor;
+varying vec2 vertexTexturePosition;
+
+void main()
+{
+    vec2 segment = skeletonSegment.zw - skeletonSegment.xy;
+    float segmentLength = length(segment);
+    vec2 scale = vec2(1.0, segmentScale.y);
+    if (segmentScale.x > 0.0) {
+        scale.x = min(1.5, segmentLength / segmentScale.x);
+    }
+    // TODO: magic numbers, this is in mod.ini
+    vec2 scaledPosition = position.xy * scale / 4.5;
+
+    float rotation = 0.0;
+    if (segmentLength > 0.0) {
+        rotation = -atan(segment.y, segment.x);
+    }
+    float rotationCos = cos(rotation);
+    float rotationSin = sin(rotation);
+    vec2 rotatedPosition = vec2(scaledPosition.x * rotationCos - scaledPosition.y * rotationSin,
+                                scaledPosition.x * rotationSin + scaledPosition.y * rotationCos);
+    vec2 pivot = vec2(skeletonSegment.x, -skeletonSegment.y - 1.0);
+    gl_Position = transform * vec4(pivot + rotatedPosition, 0.0, 1.0);
+    vertexColor = color;
+    vertexTexturePosition = texturePosition;
+}
+)"
@@ -1,6 +1,9 @@
 module;
 
+#include <cstdint>
 #include <memory>
+#include <random>
+#include <utility>
 #include <vector>
 
 export module Application;
@@ -16,6 +19,7 @@ import Sessions.PlayerSessionManager;
 import Scripting.ScriptingEngine;
 import Scripting.DaScript;
 
+import Networking.AdminEndpoint;
 import Networking.IGameServer;
 import Networking.GameServer;
 import Networking.CoreEventsConnectionNotifier;
@@ -27,10 +31,16 @@ import Networking.EventHandlers.SoldierInputNetworkEventHandler;
 
 import Shared.Core.IWorld;
 import Shared.Core.World;
+import Shared.Core.Data.AssetPack;
+import Shared.Core.Data.FileReader;
+import Shared.Core.Data.IFileReader;
+import Shared.Core.Data.PackFileReader;
 import Shared.CoreEventHandler;
 
 import Shared.Networking.NetworkEventDispatcher;
 
+import Extern.Spdlog;
+
 namespace Soldank
 {
 export class Application
@@ -39,13 +49,19 @@ public:
     Application()
         : config_(ServerConfigLoader().Load())
         , bootstrap_(std::make_unique<ServerBootstrap>())
-        , world_(std::make_shared<World>())
+        , file_reader_(CreateFileReader(config_))
+        , world_(std::make_shared<World>(file_reader_))
         , server_state_(std::make_shared<ServerState>())
         , lobby_client_(std::make_shared<LobbyClient>())
         , player_session_manager_(std::make_unique<PlayerSessionManager>())
         , command_queues_(std::make_unique<ServerCommandQueues>())
     {
         world_->GetStateManager()->LoadMapDocument(config_.map_path);
+        const std::uint64_t simulation_seed =
+          config_.simulation_seed.value_or(GenerateSimulationSeed());
+        world_->GetStateManager()->SeedRandom(simulation_seed);
+        world_->SetLagCompensationEnabled(config_.lag_compensation);
+        Spdlog::info("Simulation seed: {}", simulation_seed);
 
         scripting_engine_ = std::make_shared<DaScriptScriptingEngine>();
 
@@ -69,6 +85,10 @@ public:
         CoreEventsConnectionNotifier::ObserveAll(
           game_server_.get(), world_->GetWorldEvents(), world_->GetPhysicsEvents());
         network_host_ = std::make_unique<ServerNetworkHost>(game_server_);
+        if (config_.admin_port != 0) {
+            admin_endpoint_ = std::make_unique<AdminEndpoint>();
+            admin_endpoint_->Start(config_.admin_port);
+        }
         server_runtime_ = std::make_unique<ServerRuntime>(
           config_,
           world_,
@@ -88,9 +108,36 @@ public:
     void Run() { server_runtime_->Run(); }
 
 private:
+    static std::uint64_t GenerateSimulationSeed()
+    {
+        std::random_device random_device;
+        return (static_cast<std::uint64_t>(random_device()) << 32U) | random_device();
+    }
+
+    static std::shared_ptr<const IFileReader> CreateFileReader(const ServerConfig& config)
+    {
+        auto file_reader = std::make_shared<FileReader>();
+        if (config.asset_pack_path.empty()) {
+            return file_reader;
+        }
+
+        auto asset_pack = AssetPack::Open(config.asset_pack_path);
+        if (!asset_pack.has_value()) {
+            Spdlog::warn("Could not open asset pack {} (error {}), reading assets from disk",
+                         config.asset_pack_path,
+                         static_cast<int>(asset_pack.error()));
+            return file_reader;
+        }
+
+        Spdlog::info(
+          "Loaded asset pack {} with {} assets", config.asset_pack_path, asset_pack->GetAssetsCount());
+        return std::make_shared<PackFileReader>(std::move(*asset_pack), file_reader);
+    }
+
     ServerConfig config_;
     std::unique_ptr<ServerBootstrap> bootstrap_;
     std::shared_ptr<IGameServer> game_server_;
+    std::shared_ptr<const IFileReader> file_reader_;
     std::shared_ptr<IWorld> world_;
     std::shared_ptr<NetworkEventDispatcher> server_network_event_dispatcher_;
     std::shared_ptr<ServerState> server_state_;
@@ -100,6 +147,7 @@ private:
     std::unique_ptr<PlayerSessionManager> player_session_manager_;
     std::unique_ptr<ServerCommandQueues> command_queues_;
     std::unique_ptr<ServerRuntime> server_runtime_;
+    std::unique_ptr<AdminEndpoint> admin_endpoint_;
 };
 
 } // namespace Soldank
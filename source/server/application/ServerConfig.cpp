@@ -1,6 +1,7 @@
 module;
 
 #include <cstdint>
+#include <optional>
 #include <string>
 
 export module Application.ServerConfig;
@@ -12,6 +13,17 @@ struct ServerConfig
     std::string server_name;
     std::uint16_t server_port = 0;
     std::string map_path = "maps/ctf_Ash.pms";
+    // Optional asset pack built with asset_pack_builder, assets are read from disk when empty
+    std::string asset_pack_path;
+    // Match replay is recorded to this file when it's set
+    std::string replay_path;
+    std::uint32_t replay_keyframe_interval = 600;
+    // Seed of the simulation random generator, a random one is drawn when it's not configured
+    std::optional<std::uint64_t> simulation_seed;
     int fps_limit = 60;
+    // Late player inputs fire at targets rewound to the tick the player aimed at
+    bool lag_compensation = true;
+    // Counters are served on 127.0.0.1 at this port, the admin endpoint is disabled when it's 0
+    std::uint16_t admin_port = 0;
 };
 } // namespace Soldank
@@ -1,5 +1,8 @@
 module;
 
+#include <charconv>
+#include <cstdint>
+#include <cstring>
 #include <limits>
 #include <stdexcept>
 #include <string>
@@ -47,6 +50,52 @@ public:
             config.fps_limit = static_cast<int>(fps_limit);
         }
 
+        config.lag_compensation =
+          ini_config.GetBoolValue("NETWORK", "Lag_Compensation", config.lag_compensation);
+
+        const long admin_port = ini_config.GetLongValue("ADMIN", "Port", config.admin_port);
+        if (admin_port < 0 || admin_port > std::numeric_limits<std::uint16_t>::max()) {
+            Spdlog::warn("Invalid admin Port: {}. The admin endpoint is disabled", admin_port);
+        } else {
+            config.admin_port = static_cast<std::uint16_t>(admin_port);
+        }
+
+        const char* asset_pack_path_cstr = ini_config.GetValue("ASSETS", "Pack_File");
+        if (asset_pack_path_cstr != nullptr) {
+            config.asset_pack_path = asset_pack_path_cstr;
+        }
+
+        const char* replay_path_cstr = ini_config.GetValue("REPLAY", "Record_File");
+        if (replay_path_cstr != nullptr) {
+            config.replay_path = replay_path_cstr;
+        }
+
+        const long replay_keyframe_interval = ini_config.GetLongValue(
+          "REPLAY", "Keyframe_Interval", config.replay_keyframe_interval);
+        if (replay_keyframe_interval <= 0 ||
+            replay_keyframe_interval > std::numeric_limits<std::int32_t>::max()) {
+            Spdlog::warn("Invalid Keyframe_Interval: {}. Using default: {}",
+                         replay_keyframe_interval,
+                         config.replay_keyframe_interval);
+        } else {
+            config.replay_keyframe_interval = static_cast<std::uint32_t>(replay_keyframe_interval);
+        }
+
+        const char* simulation_seed_cstr = ini_config.GetValue("SIMULATION", "Seed");
+        if (simulation_seed_cstr != nullptr) {
+            std::uint64_t simulation_seed = 0;
+            const char* simulation_seed_end =
+              simulation_seed_cstr + std::strlen(simulation_seed_cstr);
+            auto [parse_end, parse_error] =
+              std::from_chars(simulation_seed_cstr, simulation_seed_end, simulation_seed);
+            if (parse_error != std::errc{} || parse_end != simulation_seed_end) {
+                Spdlog::warn("Invalid simulation Seed: {}. Using a random one",
+                             simulation_seed_cstr);
+            } else {
+                config.simulation_seed = simulation_seed;
+            }
+        }
+
         return config;
     }
 };
@@ -0,0 +1,102 @@
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+
+export module Networking.AdminEndpoint;
+
+import Shared.Core.Utility.Counters;
+import Shared.Networking.NetworkEvent;
+
+import Extern.Httplib;
+import Extern.Spdlog;
+
+export namespace Soldank
+{
+// Prometheus text format, one "soldank_<name> <value>" line per counter and gauge
+std::string FormatCountersAsText(const CountersSnapshot& snapshot)
+{
+    std::string text;
+    for (std::size_t i = 0; i < COUNTERS_COUNT; ++i) {
+        text += std::format("soldank_{}_total {}\n", COUNTER_NAMES.at(i), snapshot.counters.at(i));
+    }
+    for (std::size_t i = 0; i < GAUGES_COUNT; ++i) {
+        text += std::format("soldank_{} {}\n", GAUGE_NAMES.at(i), snapshot.gauges.at(i));
+    }
+    for (std::size_t i = 0; i < NETWORK_EVENTS_COUNT; ++i) {
+        const auto network_event_name = GetNetworkEventName(static_cast<NetworkEvent>(i));
+        text += std::format("soldank_network_bytes_sent_total{{event=\"{}\"}} {}\n",
+                            network_event_name,
+                            snapshot.network_bytes_sent.at(i));
+        text += std::format("soldank_network_bytes_received_total{{event=\"{}\"}} {}\n",
+                            network_event_name,
+                            snapshot.network_bytes_received.at(i));
+    }
+    return text;
+}
+
+// Serves the process counters over HTTP on the loopback interface only, so they can be scraped
+// continuously on the server's machine without exposing them to players
+class AdminEndpoint
+{
+public:
+    AdminEndpoint() = default;
+
+    ~AdminEndpoint() { Stop(); }
+
+    AdminEndpoint(const AdminEndpoint&) = delete;
+    AdminEndpoint& operator=(const AdminEndpoint&) = delete;
+    AdminEndpoint(AdminEndpoint&&) = delete;
+    AdminEndpoint& operator=(AdminEndpoint&&) = delete;
+
+    // Port 0 binds any free port. Returns the bound port or std::nullopt when binding failed.
+    std::optional<std::uint16_t> Start(std::uint16_t port)
+    {
+        server_.Get("/counters", [](const Httplib::ServerRequest& /*request*/) {
+            return Httplib::ServerResponse{
+                .status = 200,
+                .body = FormatCountersAsText(GetCounterRegistry().TakeSnapshot()),
+                .content_type = "text/plain; version=0.0.4",
+                .headers = {},
+            };
+        });
+
+        int bound_port = port;
+        if (port == 0) {
+            bound_port = server_.BindToAnyPort(LOOPBACK_HOST);
+        } else if (!server_.BindToPort(LOOPBACK_HOST, port)) {
+            bound_port = -1;
+        }
+        if (bound_port < 0) {
+            Spdlog::error("[AdminEndpoint] Failed to listen on {}:{}", LOOPBACK_HOST, port);
+            return std::nullopt;
+        }
+
+        server_thread_ = std::thread([this]() { server_.ListenAfterBind(); });
+        server_.WaitUntilReady();
+        Spdlog::info("[AdminEndpoint] Counters served on http://{}:{}/counters",
+                     LOOPBACK_HOST,
+                     bound_port);
+        return static_cast<std::uint16_t>(bound_port);
+    }
+
+    void Stop()
+    {
+        if (server_thread_.joinable()) {
+            server_.Stop();
+            server_thread_.join();
+        }
+    }
+
+private:
+    static constexpr const char* LOOPBACK_HOST = "127.0.0.1";
+
+    Httplib::Server server_;
+    std::thread server_thread_;
+};
+} // namespace Soldank
@@ -3,6 +3,7 @@ module;
 #include <memory>
 #include <cassert>
 #include <cstdint>
+#include <functional>
 #include <optional>
 #include <span>
 #include <string>
@@ -122,6 +123,27 @@ public:
         return player_poll_group_->GetConnectionSoldierId(connection_id);
     }
 
+    void ForEachPlayerConnection(
+      const std::function<void(unsigned int connection_id)>& for_each_connection_function) override
+    {
+        player_poll_group_->ForEachConnection(for_each_connection_function);
+#if defined(SOLDANK_ENABLE_WEBRTC_SERVER_TRANSPORT)
+        for (const auto& [connection_id, connection] : web_rtc_connections_) {
+            if (connection.soldier_id.has_value()) {
+                for_each_connection_function(connection_id);
+            }
+        }
+#endif
+    }
+
+    std::optional<ConnectionQuality> GetConnectionQuality(unsigned int connection_id) override
+    {
+        if (player_poll_group_->IsConnectionAssigned(connection_id)) {
+            return player_poll_group_->GetConnectionQuality(connection_id);
+        }
+        return std::nullopt;
+    }
+
 private:
     std::unique_ptr<EntryPollGroup> entry_poll_group_;
     std::shared_ptr<PlayerPollGroup> player_poll_group_;
@@ -208,18 +230,18 @@ private:
 
     void ProcessWebRtcIncomingPackets(IServerTransport& transport)
     {
-        for (const auto& packet : transport.PollIncomingPackets()) {
+        transport.PollIncomingPackets([&](const ReceivedPacket& packet) {
             const auto connection = web_rtc_connections_.find(packet.connection_id);
             if (connection == web_rtc_connections_.end() ||
                 !connection->second.soldier_id.has_value()) {
                 AcceptWebRtcConnection(transport, packet);
-                continue;
+                return;
             }
 
             std::span<const char> received_bytes{
                 reinterpret_cast<const char*>(packet.payload.data()), packet.payload.size()
             };
-            NetworkMessage network_message(received_bytes);
+            const NetworkMessageView network_message{ received_bytes };
             ConnectionMetadata connection_metadata{
                 .connection_id = packet.connection_id,
                 .send_message_to_connection =
@@ -228,7 +250,7 @@ private:
                   }
             };
             network_event_dispatcher_->ProcessNetworkMessage(connection_metadata, network_message);
-        }
+        });
     }
 
     void AcceptWebRtcConnection(IServerTransport& transport, const ReceivedPacket& first_packet)
@@ -1,5 +1,11 @@
+module;
+
+#include <functional>
+#include <optional>
+
 export module Networking.IGameServer;
 
+import Networking.Transport.TransportTypes;
 import Shared.Networking.NetworkMessage;
 
 export namespace Soldank
@@ -15,5 +21,8 @@ public:
     virtual void SendNetworkMessageToAll(const NetworkMessage& network_message) = 0;
 
     virtual unsigned int GetSoldierIdFromConnectionId(unsigned int connection_id) = 0;
+    virtual void ForEachPlayerConnection(
+      const std::function<void(unsigned int connection_id)>& for_each_connection_function) = 0;
+    virtual std::optional<ConnectionQuality> GetConnectionQuality(unsigned int connection_id) = 0;
 };
 } // namespace Soldank
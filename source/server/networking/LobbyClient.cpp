@@ -1,14 +1,21 @@
 module;
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <cstdio>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <utility>
 #include <cctype>
 #include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <thread>
 
 export module Networking.LobbyClient;
@@ -20,112 +27,338 @@ import Shared.Core.Data.FileReader;
 
 export namespace Soldank
 {
+struct LobbyEndpoint
+{
+    std::string scheme_host_port;
+    std::string api_endpoint;
+};
+
+enum class LobbyRegistrationState
+{
+    NotRegistered = 0,
+    Registered,
+    Failed,
+};
+
+struct LobbyRegistrationStatus
+{
+    std::string host;
+    LobbyRegistrationState state = LobbyRegistrationState::NotRegistered;
+    int last_http_status = 0;
+    std::string last_error;
+    unsigned int consecutive_failures_count = 0;
+};
+
+struct LobbyClientOptions
+{
+    std::chrono::milliseconds connection_timeout{ 3000 };
+    std::chrono::milliseconds read_timeout{ 5000 };
+    std::chrono::milliseconds write_timeout{ 5000 };
+    // A lobby that failed is skipped for this long, the delay doubles with every further failure
+    std::chrono::milliseconds initial_backoff{ 10000 };
+    std::chrono::milliseconds max_backoff{ 600000 };
+};
+
+namespace LobbyServerInfoJson
+{
+std::string EscapeString(std::string_view text)
+{
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char character : text) {
+        switch (character) {
+            case '"':
+                escaped += "\\\"";
+                break;
+            case '\\':
+                escaped += "\\\\";
+                break;
+            case '\n':
+                escaped += "\\n";
+                break;
+            case '\r':
+                escaped += "\\r";
+                break;
+            case '\t':
+                escaped += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(character) < 0x20) {
+                    std::array<char, 7> code{};
+                    std::snprintf(code.data(),
+                                  code.size(),
+                                  "\\u%04x",
+                                  static_cast<unsigned int>(static_cast<unsigned char>(character)));
+                    escaped += code.data();
+                } else {
+                    escaped += character;
+                }
+                break;
+        }
+    }
+    return escaped;
+}
+
+std::string Serialize(const LobbyServerInfo& server_info, std::string_view operating_system)
+{
+    const auto quoted = [](std::string_view text) { return '"' + EscapeString(text) + '"'; };
+    const auto boolean = [](bool value) { return std::string{ value ? "true" : "false" }; };
+
+    std::string json = "{";
+    json += R"("advanced":false,)";
+    json += R"("anti_cheat_on":false,)";
+    json += R"("bonus_frequency":0,)";
+    json += R"("country":)" + quoted(server_info.country) + ",";
+    json += R"("current_map":)" + quoted(server_info.current_map) + ",";
+    json += R"("game_style":)" + quoted(server_info.game_style) + ",";
+    json += R"("info":)" + quoted(server_info.info) + ",";
+    json += R"("max_players":)" + std::to_string(server_info.max_players) + ",";
+    json += R"("name":)" + quoted(server_info.name) + ",";
+    json += R"("num_bots":0,)";
+    json += R"("num_players":)" + std::to_string(server_info.players_count) + ",";
+    json += R"("os":)" + quoted(operating_system) + ",";
+    // Player nicks are not known to the runtime, only their count is advertised
+    json += R"("players":[],)";
+    json += R"("port":)" + std::to_string(server_info.port) + ",";
+    json += R"("private":)" + boolean(server_info.is_private) + ",";
+    json += R"("realistic":false,)";
+    json += R"("respawn":)" + std::to_string(server_info.respawn_time) + ",";
+    json += R"("survival":false,)";
+    json += R"("version":"1",)";
+    json += R"("wm":false)";
+    json += "}";
+    return json;
+}
+} // namespace LobbyServerInfoJson
+
+// Registers the server in the lobbies from a background worker. Register only queues the server
+// info, so a slow or unreachable lobby never stalls the simulation. Only the newest
+// registrations are kept when the worker falls behind.
 class LobbyClient : public ILobbyRegistrationClient
 {
 public:
+    static constexpr std::size_t MAX_PENDING_REGISTRATIONS_COUNT = 2;
+
     LobbyClient()
+        : LobbyClient(ReadLobbyEndpoints("lobby_servers.txt"))
     {
-        std::string file_path = "lobby_servers.txt";
+    }
+
+    explicit LobbyClient(const std::vector<LobbyEndpoint>& lobby_endpoints,
+                         LobbyClientOptions options = {})
+        : options_(options)
+    {
+        for (const auto& lobby_endpoint : lobby_endpoints) {
+            lobbies_.push_back({ .sender = Httplib::Client(lobby_endpoint.scheme_host_port),
+                                 .api_endpoint = lobby_endpoint.api_endpoint,
+                                 .backoff = std::chrono::milliseconds{ 0 },
+                                 .next_attempt_time = {} });
+            lobbies_.back().sender.set_follow_location(true);
+            lobbies_.back().sender.set_keep_alive(false);
+            lobbies_.back().sender.set_connection_timeout(options_.connection_timeout);
+            lobbies_.back().sender.set_read_timeout(options_.read_timeout);
+            lobbies_.back().sender.set_write_timeout(options_.write_timeout);
+            statuses_.push_back({ .host = lobbies_.back().sender.host() });
+        }
+
+        worker_thread_ = std::thread([this]() { RunWorker(); });
+    }
+
+    ~LobbyClient() override
+    {
+        {
+            std::lock_guard lock{ mutex_ };
+            is_stopping_ = true;
+        }
+        worker_condition_variable_.notify_all();
+        worker_thread_.join();
+    }
+
+    LobbyClient(const LobbyClient&) = delete;
+    LobbyClient& operator=(const LobbyClient&) = delete;
+    LobbyClient(LobbyClient&&) = delete;
+    LobbyClient& operator=(LobbyClient&&) = delete;
+
+    void Register(const LobbyServerInfo& server_info) override
+    {
+        {
+            std::lock_guard lock{ mutex_ };
+            if (pending_registrations_.size() >= MAX_PENDING_REGISTRATIONS_COUNT) {
+                pending_registrations_.pop_front();
+                ++dropped_registrations_count_;
+            }
+            pending_registrations_.push_back(server_info);
+        }
+        worker_condition_variable_.notify_one();
+    }
+
+    std::vector<LobbyRegistrationStatus> GetStatuses() const
+    {
+        std::lock_guard lock{ mutex_ };
+        return statuses_;
+    }
+
+    std::size_t GetDroppedRegistrationsCount() const
+    {
+        std::lock_guard lock{ mutex_ };
+        return dropped_registrations_count_;
+    }
+
+    // Returns false when the queued registrations were not sent within the timeout
+    bool WaitUntilIdle(std::chrono::milliseconds timeout) const
+    {
+        std::unique_lock lock{ mutex_ };
+        return idle_condition_variable_.wait_for(lock, timeout, [this]() {
+            return pending_registrations_.empty() && !is_registering_;
+        });
+    }
+
+private:
+    struct Lobby
+    {
+        Httplib::Client sender;
+        std::string api_endpoint;
+        std::chrono::milliseconds backoff;
+        std::chrono::steady_clock::time_point next_attempt_time;
+    };
+
+    static std::vector<LobbyEndpoint> ReadLobbyEndpoints(const std::string& file_path)
+    {
+        std::vector<LobbyEndpoint> lobby_endpoints;
         FileReader file_reader;
-        auto file_data = file_reader.Read("lobby_servers.txt");
+        auto file_data = file_reader.Read(file_path);
         if (!file_data.has_value()) {
             Spdlog::critical("Could not open lobby servers file: {}", file_path);
-        } else {
-            std::stringstream data_buffer{ *file_data };
-            std::string protocol;
-            std::string scheme_host_port;
-            std::string api_endpoint;
-            while (data_buffer >> protocol >> scheme_host_port >> api_endpoint) {
-                std::transform(protocol.begin(),
-                               protocol.end(),
-                               protocol.begin(),
-                               [](unsigned char c) { return std::tolower(c); });
-                if (api_endpoint.ends_with("/")) {
-                    api_endpoint.pop_back();
-                }
+            return lobby_endpoints;
+        }
+
+        std::stringstream data_buffer{ *file_data };
+        std::string protocol;
+        std::string scheme_host_port;
+        std::string api_endpoint;
+        while (data_buffer >> protocol >> scheme_host_port >> api_endpoint) {
+            std::transform(protocol.begin(),
+                           protocol.end(),
+                           protocol.begin(),
+                           [](unsigned char c) { return std::tolower(c); });
+            if (api_endpoint.ends_with("/")) {
+                api_endpoint.pop_back();
+            }
 #ifdef CPPHTTPLIB_OPENSSL_SUPPORT
-                if (protocol == "https") {
-                    protocol = "https://";
-                } else {
+            if (protocol == "https") {
+                protocol = "https://";
+            } else {
 #endif
-                    protocol = "http://";
+                protocol = "http://";
 #ifdef CPPHTTPLIB_OPENSSL_SUPPORT
-                }
-#endif
-                http_clients_.push_back(
-                  { Httplib::Client(std::string{ protocol }.append(scheme_host_port)),
-                    api_endpoint });
-                http_clients_.back().sender.set_follow_location(true);
-                http_clients_.back().sender.set_keep_alive(false);
             }
+#endif
+            lobby_endpoints.push_back(
+              { .scheme_host_port = std::string{ protocol }.append(scheme_host_port),
+                .api_endpoint = api_endpoint });
         }
+        return lobby_endpoints;
     }
 
-    void Register(const std::string& server_name, std::uint16_t server_port) override
+    static std::string_view GetOperatingSystemName()
     {
 #ifdef _WIN32
-        std::string operating_system = "Windows";
+        return "Windows";
 #elif defined __linux__
-        std::string operating_system = "Linux";
+        return "Linux";
 #elif defined __APPLE__
-        std::string operating_system = "MacOS";
+        return "MacOS";
 #elif defined __unix__
-        std::string operating_system = "UNIX";
+        return "UNIX";
 #else
-        std::string operating_system = "UNKNOWN";
+        return "UNKNOWN";
 #endif
+    }
 
-        // TODO: populate with proper settings
-        std::string server_info = "{";
-
-        server_info += R"("advanced": false,)";
-        server_info += R"("anti_cheat_on": false,)";
-        server_info += R"("bonus_frequency": 0,)";
-        server_info += R"("country": PL,)";
-        server_info += R"("current_map": "ctf_Ash",)";
-        server_info += R"("game_style": "CTF",)";
-        server_info += R"("info": "Test info",)";
-        server_info += R"("max_players": 12,)";
-        server_info += R"("name": "server_name",)";
-        server_info += R"("num_bots": 1,)";
-        server_info += R"("os": ")" + operating_system + R"(",)";
-        server_info += R"("players": [],)";
-        server_info += R"("port": ")" + std::to_string(server_port) + ",)";
-        server_info += R"("private": false,)";
-        server_info += R"("realistic": false,)";
-        server_info += R"("respawn": 180,)";
-        server_info += R"("survival": false,)";
-        server_info += R"("version": "1",)";
-        server_info += R"("wm": false")";
-
-        server_info += "}";
-
-        for (auto& http_client : http_clients_) {
-            auto response = http_client.sender.Post(
-              http_client.api_endpoint + "/servers", server_info, "application/json");
+    void RunWorker()
+    {
+        std::unique_lock lock{ mutex_ };
+        while (true) {
+            worker_condition_variable_.wait(
+              lock, [this]() { return is_stopping_ || !pending_registrations_.empty(); });
+            if (is_stopping_) {
+                return;
+            }
+
+            const LobbyServerInfo server_info = std::move(pending_registrations_.front());
+            pending_registrations_.pop_front();
+            is_registering_ = true;
+            lock.unlock();
+
+            const std::string server_info_json =
+              LobbyServerInfoJson::Serialize(server_info, GetOperatingSystemName());
+            for (std::size_t i = 0; i < lobbies_.size(); ++i) {
+                RegisterInLobby(i, server_info_json);
+            }
+
+            lock.lock();
+            is_registering_ = false;
+            idle_condition_variable_.notify_all();
+        }
+    }
+
+    void RegisterInLobby(std::size_t lobby_index, const std::string& server_info_json)
+    {
+        auto& lobby = lobbies_.at(lobby_index);
+        const auto now = std::chrono::steady_clock::now();
+        if (now < lobby.next_attempt_time) {
+            return;
+        }
+
+        auto response =
+          lobby.sender.Post(lobby.api_endpoint + "/servers", server_info_json, "application/json");
+        const bool is_registered = response && response->status == 201;
+        if (is_registered) {
+            Spdlog::info("Registering in the lobby: {}", lobby.sender.host());
+            lobby.backoff = std::chrono::milliseconds{ 0 };
+        } else {
             if (response) {
-                if (response->status == 201) {
-                    Spdlog::info("Registering in the lobby: {}", http_client.sender.host());
-                } else {
-                    Spdlog::error("Failed registering in the lobby: {}. Returned status = {}",
-                                  http_client.sender.host(),
-                                  response->status);
-                }
+                Spdlog::error("Failed registering in the lobby: {}. Returned status = {}",
+                              lobby.sender.host(),
+                              response->status);
             } else {
-                Spdlog::error("Could not register the server in the lobby. Error ({}): {}",
+                Spdlog::error("Could not register the server in the lobby {}. Error ({}): {}",
+                              lobby.sender.host(),
                               response.error_code(),
                               response.error_message());
             }
+            lobby.backoff = lobby.backoff.count() == 0
+                              ? options_.initial_backoff
+                              : std::min(lobby.backoff * 2, options_.max_backoff);
+            lobby.next_attempt_time = std::chrono::steady_clock::now() + lobby.backoff;
+        }
+
+        std::lock_guard lock{ mutex_ };
+        auto& status = statuses_.at(lobby_index);
+        if (is_registered) {
+            status.state = LobbyRegistrationState::Registered;
+            status.consecutive_failures_count = 0;
+            status.last_error.clear();
+        } else {
+            status.state = LobbyRegistrationState::Failed;
+            ++status.consecutive_failures_count;
+            status.last_error = response ? "Unexpected HTTP status" : response.error_message();
         }
+        status.last_http_status = response ? response->status : 0;
     }
 
-private:
-    struct HTTPClient
-    {
-        Httplib::Client sender;
-        std::string api_endpoint;
-    };
+    LobbyClientOptions options_;
+    // Only accessed by the worker thread once it is started
+    std::vector<Lobby> lobbies_;
 
-    std::vector<HTTPClient> http_clients_;
+    mutable std::mutex mutex_;
+    std::condition_variable worker_condition_variable_;
+    mutable std::condition_variable idle_condition_variable_;
+    std::deque<LobbyServerInfo> pending_registrations_;
+    std::vector<LobbyRegistrationStatus> statuses_;
+    std::size_t dropped_registrations_count_ = 0;
+    bool is_registering_ = false;
+    bool is_stopping_ = false;
+    std::thread worker_thread_;
 };
 } // namespace Soldank
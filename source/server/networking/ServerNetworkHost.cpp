@@ -1,6 +1,8 @@
 module;
 
+#include <functional>
 #include <memory>
+#include <optional>
 
 export module Networking.ServerNetworkHost;
 
@@ -37,6 +39,17 @@ public:
         return game_server_->GetSoldierIdFromConnectionId(connection_id);
     }
 
+    void ForEachPlayerConnection(
+      const std::function<void(unsigned int connection_id)>& for_each_connection_function) override
+    {
+        game_server_->ForEachPlayerConnection(for_each_connection_function);
+    }
+
+    std::optional<ConnectionQuality> GetConnectionQuality(unsigned int connection_id) override
+    {
+        return game_server_->GetConnectionQuality(connection_id);
+    }
+
 private:
     std::shared_ptr<IGameServer> game_server_;
 };
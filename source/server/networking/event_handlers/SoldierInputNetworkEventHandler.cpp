@@ -3,6 +3,8 @@ module;
 #include <cstdint>
 #include <memory>
 
+#include "core/utility/Expected.hpp"
+
 export module Networking.EventHandlers.SoldierInputNetworkEventHandler;
 
 import Networking.IGameServer;
@@ -12,15 +14,19 @@ import Sessions.PlayerSessionManager;
 
 import Shared.Networking.NetworkEventDispatcher;
 import Shared.Networking.NetworkEvent;
+import Shared.Networking.NetworkMessage;
 import Shared.Networking.NetworkPackets;
 import Shared.Networking.ProtocolConversions;
+import Shared.Networking.SoldierInputCodec;
 import Shared.Core.Simulation.SimulationCommands;
 
 import Extern.Spdlog;
 
 export namespace Soldank
 {
-class SoldierInputNetworkEventHandler : public NetworkEventHandlerBase<SoldierInputPacket>
+// SoldierInput messages are bit packed and repeat the inputs the client has not seen
+// acknowledged yet, so they are decoded here instead of through NetworkEventHandlerBase
+class SoldierInputNetworkEventHandler : public INetworkEventHandler
 {
 public:
     SoldierInputNetworkEventHandler(const std::shared_ptr<IGameServer>& game_server,
@@ -32,36 +38,43 @@ public:
     {
     }
 
-private:
-    NetworkEvent GetTargetNetworkEvent() const override { return NetworkEvent::SoldierInput; }
+    NetworkEvent GetHandledNetworkEvent() const override { return NetworkEvent::SoldierInput; }
 
-    NetworkEventHandlerResult HandleNetworkMessageImpl(
+    std::expected<NetworkEventHandlerResult, ParseError> HandleNetworkMessage(
       unsigned int sender_connection_id,
-      SoldierInputPacket soldier_input_packet) override
+      NetworkMessageView network_message) override
     {
-        unsigned int input_sequence_id = soldier_input_packet.input_sequence_id;
-        unsigned int soldier_id = game_server_->GetSoldierIdFromConnectionId(sender_connection_id);
-        PlayerInputCommand player_input_command = ProtocolConversions::ToPlayerInputCommand(
-          static_cast<std::uint8_t>(soldier_id), soldier_input_packet);
+        auto soldier_input_batch = SoldierInputCodec::Decode(network_message);
+        if (!soldier_input_batch.has_value()) {
+            return std::unexpected(soldier_input_batch.error());
+        }
+
+        auto soldier_id = static_cast<std::uint8_t>(
+          game_server_->GetSoldierIdFromConnectionId(sender_connection_id));
+        bool is_any_input_accepted = false;
+        // Inputs that were already received through an earlier message are skipped
+        for (const auto& soldier_input_packet : soldier_input_batch->GetInputs()) {
+            // TODO: validate arguments
+            const std::uint32_t input_sequence_id = soldier_input_packet.input_sequence_id;
+            if (!player_session_manager_.ShouldAcceptInput(soldier_id, input_sequence_id)) {
+                continue;
+            }
 
-        // TODO: validate arguments
-        // Spdlog::info("{} Soldier pos from client: {} {}",
-        //              input_sequence_id - 1,
-        //              soldier_position.x,
-        //              soldier_position.y);
-        if (!player_session_manager_.ShouldAcceptInput(static_cast<std::uint8_t>(soldier_id),
-                                                       input_sequence_id)) {
+            player_session_manager_.MarkInputReceived(soldier_id, input_sequence_id);
+            command_queues_.StorePendingPlayerInput(
+              ProtocolConversions::ToPlayerInputCommand(soldier_id, soldier_input_packet));
+            is_any_input_accepted = true;
+        }
+
+        if (!is_any_input_accepted) {
             Spdlog::warn("*************** LATE PACKET ***************************");
             return NetworkEventHandlerResult::Failure;
         }
 
-        player_session_manager_.MarkInputReceived(static_cast<std::uint8_t>(soldier_id),
-                                                  input_sequence_id);
-        command_queues_.StorePendingPlayerInput(player_input_command);
-
         return NetworkEventHandlerResult::Success;
     }
 
+private:
     std::shared_ptr<IGameServer> game_server_;
     PlayerSessionManager& player_session_manager_;
     ServerCommandQueues& command_queues_;
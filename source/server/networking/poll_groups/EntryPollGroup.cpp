@@ -3,6 +3,7 @@ module;
 #include <utility>
 #include <span>
 #include <cassert>
+#include <cstddef>
 #include <unordered_map>
 #include <string>
 #include <memory>
@@ -32,37 +33,30 @@ public:
     void PollIncomingMessages() override
     {
         while (true) {
-            GNS::ISteamNetworkingMessage* incoming_message = nullptr;
             int messages_count = GetInterface()->ReceiveMessagesOnPollGroup(
-              GetPollGroupHandle(), &incoming_message, 1);
+              GetPollGroupHandle(),
+              incoming_messages_.data(),
+              GnsServerTransport::RECEIVE_MESSAGES_BATCH_SIZE);
             if (messages_count == 0) {
                 break;
             }
             if (messages_count < 0) {
                 Spdlog::error("[EntryPollGroup] Error checking for messages");
+                break;
+            }
+
+            std::span received_messages{ incoming_messages_.data(),
+                                         static_cast<std::size_t>(messages_count) };
+            for (auto* incoming_message : received_messages) {
+                assert(incoming_message);
+                AssignNick(GnsServerTransport::ToConnectionId(incoming_message->m_conn),
+                           GnsServerTransport::GetMessagePayload(*incoming_message));
+            }
+            GnsServerTransport::ReleaseMessages(received_messages);
+
+            if (messages_count < GnsServerTransport::RECEIVE_MESSAGES_BATCH_SIZE) {
+                break;
             }
-            assert(messages_count == 1 && incoming_message);
-            const auto connection_id =
-              GnsServerTransport::ToConnectionId(incoming_message->m_conn);
-            assert(IsConnectionAssigned(connection_id));
-            auto it_client = FindConnection(connection_id);
-
-            std::string message_from_client;
-            message_from_client.assign(static_cast<char*>(incoming_message->m_pData),
-                                       incoming_message->m_cbSize);
-            it_client->second.nick = message_from_client;
-            SetClientNick(it_client->second.connection_id, it_client->second.nick);
-            Spdlog::info("[EntryPollGroup] Name assigned to connection {}: {}",
-                         it_client->second.connection_id,
-                         it_client->second.nick);
-            incoming_message->Release();
-
-            SendNetworkMessage(
-              it_client->second.connection_id,
-              { NetworkEvent::ChatMessage, "Welcome to the server " + it_client->second.nick });
-
-            player_poll_group_->AssignConnection(it_client->second);
-            EraseConnection(it_client);
         }
     }
 
@@ -103,6 +97,30 @@ public:
     }
 
 private:
+    void AssignNick(ConnectionId connection_id, std::span<const char> nick)
+    {
+        if (!IsConnectionAssigned(connection_id)) {
+            // The connection was handed over to the player poll group by an earlier message of
+            // the same batch
+            return;
+        }
+        auto it_client = FindConnection(connection_id);
+
+        it_client->second.nick.assign(nick.begin(), nick.end());
+        SetClientNick(it_client->second.connection_id, it_client->second.nick);
+        Spdlog::info("[EntryPollGroup] Name assigned to connection {}: {}",
+                     it_client->second.connection_id,
+                     it_client->second.nick);
+
+        SendNetworkMessage(
+          it_client->second.connection_id,
+          { NetworkEvent::ChatMessage, "Welcome to the server " + it_client->second.nick });
+
+        player_poll_group_->AssignConnection(it_client->second);
+        EraseConnection(it_client);
+    }
+
     std::shared_ptr<IPollGroup> player_poll_group_;
+    GnsServerTransport::TReceivedMessagesBatch incoming_messages_{};
 };
 } // namespace Soldank
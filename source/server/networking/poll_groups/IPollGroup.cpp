@@ -1,5 +1,6 @@
 module;
 
+#include <functional>
 #include <optional>
 #include <string>
 
@@ -33,6 +34,9 @@ public:
     virtual bool IsConnectionAssigned(ConnectionId connection_id) = 0;
     virtual unsigned int GetConnectionSoldierId(ConnectionId connection_id) = 0;
     virtual std::string GetConnectionSoldierNick(ConnectionId connection_id) = 0;
+    virtual void ForEachConnection(
+      const std::function<void(ConnectionId connection_id)>& for_each_connection_function) = 0;
+    virtual std::optional<ConnectionQuality> GetConnectionQuality(ConnectionId connection_id) = 0;
 
     virtual void SendNetworkMessage(ConnectionId connection_id,
                                     const NetworkMessage& network_message) = 0;
@@ -1,6 +1,7 @@
 module;
 
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <span>
@@ -30,6 +31,10 @@ public:
     PlayerPollGroup(GNS::ISteamNetworkingSockets* interface)
         : PollGroupBase(interface)
     {
+        // Reused for every received message, only the connection id changes
+        connection_metadata_.send_message_to_connection = [this](const NetworkMessage& message) {
+            SendNetworkMessage(connection_metadata_.connection_id, message);
+        };
     }
 
     void SetServerNetworkEventDispatcher(
@@ -43,9 +48,10 @@ public:
     void PollIncomingMessages() override
     {
         while (true) {
-            GNS::ISteamNetworkingMessage* incoming_message = nullptr;
             int messages_count = GetInterface()->ReceiveMessagesOnPollGroup(
-              GetPollGroupHandle(), &incoming_message, 1);
+              GetPollGroupHandle(),
+              incoming_messages_.data(),
+              GnsServerTransport::RECEIVE_MESSAGES_BATCH_SIZE);
             if (messages_count == 0) {
                 break;
             }
@@ -53,23 +59,26 @@ public:
                 Spdlog::error("Error checking for messages");
                 break;
             }
-            assert(messages_count == 1 && incoming_message);
-            const auto connection_id =
-              GnsServerTransport::ToConnectionId(incoming_message->m_conn);
-            assert(IsConnectionAssigned(connection_id));
-
-            std::span<char> received_bytes{ static_cast<char*>(incoming_message->m_pData),
-                                            static_cast<unsigned int>(incoming_message->m_cbSize) };
-            NetworkMessage network_message(received_bytes);
-
-            ConnectionMetadata connection_metadata{
-                .connection_id = connection_id,
-                .send_message_to_connection =
-                  [&](const NetworkMessage& message) { SendNetworkMessage(connection_id, message); }
-            };
-
-            incoming_message->Release();
-            network_event_dispatcher_->ProcessNetworkMessage(connection_metadata, network_message);
+
+            // Messages are dispatched straight from the GNS buffers and released together after
+            // the whole batch is handled
+            std::span received_messages{ incoming_messages_.data(),
+                                         static_cast<std::size_t>(messages_count) };
+            for (auto* incoming_message : received_messages) {
+                assert(incoming_message);
+                connection_metadata_.connection_id =
+                  GnsServerTransport::ToConnectionId(incoming_message->m_conn);
+                assert(IsConnectionAssigned(connection_metadata_.connection_id));
+
+                network_event_dispatcher_->ProcessNetworkMessage(
+                  connection_metadata_,
+                  NetworkMessageView{ GnsServerTransport::GetMessagePayload(*incoming_message) });
+            }
+            GnsServerTransport::ReleaseMessages(received_messages);
+
+            if (messages_count < GnsServerTransport::RECEIVE_MESSAGES_BATCH_SIZE) {
+                break;
+            }
         }
     }
 
@@ -104,5 +113,8 @@ private:
 
     std::shared_ptr<NetworkEventDispatcher> network_event_dispatcher_;
     std::shared_ptr<IWorld> world_;
+
+    GnsServerTransport::TReceivedMessagesBatch incoming_messages_{};
+    ConnectionMetadata connection_metadata_{};
 };
 } // namespace Soldank
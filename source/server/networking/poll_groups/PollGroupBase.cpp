@@ -1,6 +1,7 @@
 module;
 
 #include <cassert>
+#include <functional>
 #include <string>
 #include <optional>
 #include <unordered_map>
@@ -119,6 +120,19 @@ public:
         return it_client->second.nick;
     }
 
+    void ForEachConnection(
+      const std::function<void(ConnectionId connection_id)>& for_each_connection_function) override
+    {
+        for (const auto& connection : connections_) {
+            for_each_connection_function(connection.first);
+        }
+    }
+
+    std::optional<ConnectionQuality> GetConnectionQuality(ConnectionId connection_id) override
+    {
+        return GnsServerTransport::GetConnectionQuality(GetInterface(), connection_id);
+    }
+
     void SendNetworkMessage(ConnectionId connection_id,
                             const NetworkMessage& network_message) override
     {
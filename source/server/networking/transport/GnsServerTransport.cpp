@@ -1,5 +1,9 @@
 module;
 
+#include <array>
+#include <algorithm>
+#include <cstddef>
+#include <optional>
 #include <span>
 #include <string>
 
@@ -16,6 +20,12 @@ export namespace Soldank
 class GnsServerTransport
 {
 public:
+    // Messages are received in batches of this size, one GNS call serves a whole tick's worth of
+    // inputs from all players
+    static constexpr int RECEIVE_MESSAGES_BATCH_SIZE = 64;
+    using TReceivedMessagesBatch =
+      std::array<GNS::ISteamNetworkingMessage*, RECEIVE_MESSAGES_BATCH_SIZE>;
+
     static ConnectionId ToConnectionId(GNS::HSteamNetConnection connection_handle)
     {
         return static_cast<ConnectionId>(connection_handle);
@@ -43,6 +53,7 @@ public:
                                            network_message.GetData().size(),
                                            ToSendFlag(delivery_mode),
                                            nullptr);
+        CountSentPacket(network_message.GetData());
     }
 
     static void SendString(GNS::ISteamNetworkingSockets* interface,
@@ -71,6 +82,46 @@ public:
         interface->CloseConnection(ToConnectionHandle(connection_id), 0, nullptr, false);
     }
 
+    static std::span<const char> GetMessagePayload(const GNS::ISteamNetworkingMessage& message)
+    {
+        return { static_cast<const char*>(message.m_pData),
+                 static_cast<std::size_t>(message.m_cbSize) };
+    }
+
+    static void ReleaseMessages(std::span<GNS::ISteamNetworkingMessage*> messages)
+    {
+        for (auto* message : messages) {
+            message->Release();
+        }
+    }
+
+    static std::optional<ConnectionQuality> GetConnectionQuality(
+      GNS::ISteamNetworkingSockets* interface,
+      ConnectionId connection_id)
+    {
+        GNS::SteamNetConnectionRealTimeStatus_t status{};
+        if (interface->GetConnectionRealTimeStatus(
+              ToConnectionHandle(connection_id), &status, 0, nullptr) != GNS::EResult::OK) {
+            return std::nullopt;
+        }
+
+        // The remote quality is the fraction of our packets the client received, so it's the loss
+        // in the direction we send in. It's negative while it is unknown.
+        const float delivered_ratio = status.m_flConnectionQualityRemote < 0.0F
+                                        ? 1.0F
+                                        : std::min(status.m_flConnectionQualityRemote, 1.0F);
+        return ConnectionQuality{
+            .round_trip_time_milliseconds = std::max(status.m_nPing, 0),
+            .packet_loss_ratio = 1.0F - delivered_ratio,
+            .pending_unreliable_bytes =
+              static_cast<std::size_t>(std::max(status.m_cbPendingUnreliable, 0)),
+            .pending_reliable_bytes =
+              static_cast<std::size_t>(std::max(status.m_cbPendingReliable, 0)),
+            .send_rate_bytes_per_second =
+              static_cast<std::size_t>(std::max(status.m_nSendRateBytesPerSecond, 0)),
+        };
+    }
+
     static void SetConnectionName(GNS::ISteamNetworkingSockets* interface,
                                   ConnectionId connection_id,
                                   const std::string& nick)
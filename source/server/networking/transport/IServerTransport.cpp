@@ -31,6 +31,8 @@ class IServerTransport
 public:
     using ConnectionStateChangedHandler =
       std::function<void(const ConnectionStateChangedEvent&)>;
+    // The packet is only valid during the call, its storage is reused for later packets
+    using ReceivedPacketHandler = std::function<void(const ReceivedPacket&)>;
 
     virtual ~IServerTransport() = default;
 
@@ -41,7 +43,7 @@ public:
 
     virtual void Init(std::uint16_t port) = 0;
     virtual void PollConnectionStateChanges() = 0;
-    virtual std::vector<ReceivedPacket> PollIncomingPackets() = 0;
+    virtual void PollIncomingPackets(const ReceivedPacketHandler& handler) = 0;
     virtual void RegisterObserver(ConnectionStateChangedHandler observer) = 0;
     virtual void Send(ConnectionId connection_id,
                       std::span<const char> payload,
@@ -1,12 +1,17 @@
 module;
 
 #include <cstddef>
+#include <span>
+#include <utility>
 #include <vector>
 
 export module Networking.Transport.TransportTypes;
 
 export import Shared.Networking.DeliveryMode;
 
+import Shared.Core.Utility.Counters;
+import Shared.Networking.NetworkMessage;
+
 export namespace Soldank
 {
 using ConnectionId = unsigned int;
@@ -16,4 +21,27 @@ struct ReceivedPacket
     ConnectionId connection_id;
     std::vector<std::byte> payload;
 };
+
+// Link statistics of a connection as reported by its transport
+struct ConnectionQuality
+{
+    int round_trip_time_milliseconds = 0;
+    // Fraction of the packets that did not reach the peer, from 0 to 1
+    float packet_loss_ratio = 0.0F;
+    std::size_t pending_unreliable_bytes = 0;
+    std::size_t pending_reliable_bytes = 0;
+    // Estimated bandwidth available for sending to the peer, 0 when unknown
+    std::size_t send_rate_bytes_per_second = 0;
+};
+
+// Transports call this for every packet they send, so that all the sends are counted no matter
+// which part of the server made them
+void CountSentPacket(std::span<const char> payload)
+{
+    const auto network_event = NetworkMessageView{ payload }.GetNetworkEvent();
+    if (network_event.has_value()) {
+        GetCounterRegistry().AddNetworkBytesSent(std::to_underlying(*network_event),
+                                                 payload.size());
+    }
+}
 } // namespace Soldank
@@ -1,9 +1,11 @@
 module;
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <condition_variable>
 #include <chrono>
-#include <deque>
+#include <cstring>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -23,6 +25,9 @@ export module Networking.Transport.WebRtcServerTransport;
 import Networking.Transport.IServerTransport;
 import Networking.Transport.TransportTypes;
 
+import Shared.Core.Utility.Counters;
+import Shared.Core.Utility.SpscQueue;
+
 import Extern.Httplib;
 import Extern.Spdlog;
 
@@ -67,15 +72,26 @@ public:
 
     void PollConnectionStateChanges() override {}
 
-    std::vector<ReceivedPacket> PollIncomingPackets() override
+    // Never blocks on the transport threads: every data channel has its own SPSC queue and the
+    // session table is an immutable snapshot
+    void PollIncomingPackets(const ReceivedPacketHandler& handler) override
     {
-        std::vector<ReceivedPacket> packets;
-        std::scoped_lock incoming_packets_lock(incoming_packets_mutex_);
-        while (!incoming_packets_.empty()) {
-            packets.push_back(std::move(incoming_packets_.front()));
-            incoming_packets_.pop_front();
+        const auto sessions = sessions_.load(std::memory_order_acquire);
+        for (const auto& [connection_id, session] : *sessions) {
+            // Reliable packets go first, the first packet of a connection is its nick
+            while (session.reliable_incoming_packets->TryPop(handler)) {
+            }
+            while (session.unreliable_incoming_packets->TryPop(handler)) {
+            }
+        }
+
+        const auto dropped_packets_count =
+          dropped_packets_count_.exchange(0, std::memory_order_relaxed);
+        if (dropped_packets_count > 0) {
+            GetCounterRegistry().Add(Counter::IncomingPacketsDropped, dropped_packets_count);
+            Spdlog::warn("[WebRtcServerTransport] Dropped {} packets, incoming queues were full",
+                         dropped_packets_count);
         }
-        return packets;
     }
 
     void RegisterObserver(ConnectionStateChangedHandler observer) override
@@ -107,6 +123,7 @@ public:
             return;
         }
 
+        CountSentPacket(payload);
         rtc::binary message;
         message.reserve(payload.size());
         for (const char byte : payload) {
@@ -137,14 +154,23 @@ private:
         bool gathering_complete = false;
     };
 
+    static constexpr std::size_t INCOMING_PACKETS_QUEUE_CAPACITY = 256;
+    // Written by the data channel's callback thread and read by the game thread. The slots keep
+    // their payload buffers, so receiving stops allocating once the queue is warmed up.
+    using TIncomingPacketsQueue = SpscQueue<ReceivedPacket, INCOMING_PACKETS_QUEUE_CAPACITY>;
+
     struct PeerSession
     {
         ConnectionId connection_id;
         std::shared_ptr<rtc::PeerConnection> peer_connection;
         std::shared_ptr<rtc::DataChannel> unreliable_data_channel;
         std::shared_ptr<rtc::DataChannel> reliable_data_channel;
+        std::shared_ptr<TIncomingPacketsQueue> unreliable_incoming_packets;
+        std::shared_ptr<TIncomingPacketsQueue> reliable_incoming_packets;
     };
 
+    using TSessionTable = std::unordered_map<ConnectionId, PeerSession>;
+
     struct LocalCandidate
     {
         std::string candidate;
@@ -270,23 +296,34 @@ private:
     std::shared_ptr<rtc::DataChannel> FindDataChannel(ConnectionId connection_id,
                                                       DeliveryMode delivery_mode)
     {
-        std::scoped_lock sessions_lock(sessions_mutex_);
-        auto session = sessions_.find(connection_id);
-        if (session == sessions_.end()) {
+        const auto sessions = sessions_.load(std::memory_order_acquire);
+        auto session = sessions->find(connection_id);
+        if (session == sessions->end()) {
             return {};
         }
         return delivery_mode == DeliveryMode::Reliable ? session->second.reliable_data_channel
                                                        : session->second.unreliable_data_channel;
     }
 
+    // Session changes are rare (signaling and data channel setup), so they copy the table and
+    // publish the new snapshot. Readers never take a lock.
+    template<typename Update>
+    void UpdateSessions(Update&& update)
+    {
+        std::scoped_lock sessions_write_lock(sessions_write_mutex_);
+        auto sessions = std::make_shared<TSessionTable>(*sessions_.load(std::memory_order_acquire));
+        update(*sessions);
+        sessions_.store(std::move(sessions), std::memory_order_release);
+    }
+
     void RegisterDataChannel(ConnectionId connection_id,
                              const std::shared_ptr<rtc::DataChannel>& data_channel)
     {
         const auto label = data_channel->label();
-        {
-            std::scoped_lock sessions_lock(sessions_mutex_);
-            auto session = sessions_.find(connection_id);
-            if (session == sessions_.end()) {
+        std::shared_ptr<TIncomingPacketsQueue> incoming_packets;
+        UpdateSessions([&](TSessionTable& sessions) {
+            auto session = sessions.find(connection_id);
+            if (session == sessions.end()) {
                 Spdlog::warn(
                   "[WebRtcServerTransport] DataChannel '{}' arrived for unknown connection {}",
                   label,
@@ -295,15 +332,19 @@ private:
             }
             if (label == ToChannelLabel(DeliveryMode::Reliable)) {
                 session->second.reliable_data_channel = data_channel;
+                incoming_packets = session->second.reliable_incoming_packets;
             } else if (label == ToChannelLabel(DeliveryMode::Unreliable)) {
                 session->second.unreliable_data_channel = data_channel;
+                incoming_packets = session->second.unreliable_incoming_packets;
             } else {
                 Spdlog::warn(
                   "[WebRtcServerTransport] Ignoring unexpected DataChannel '{}' for connection {}",
                   label,
                   connection_id);
-                return;
             }
+        });
+        if (!incoming_packets) {
+            return;
         }
 
         data_channel->onOpen([connection_id, label]() {
@@ -316,30 +357,28 @@ private:
                          label,
                          connection_id);
         });
-        data_channel->onMessage([this, connection_id](rtc::message_variant data) {
-            ReceivedPacket packet{ .connection_id = connection_id, .payload = {} };
-            if (std::holds_alternative<rtc::binary>(data)) {
-                const auto& bytes = std::get<rtc::binary>(data);
-                packet.payload.assign(bytes.begin(), bytes.end());
-            } else {
-                const auto& text = std::get<std::string>(data);
-                packet.payload.reserve(text.size());
-                for (const char character : text) {
-                    packet.payload.push_back(static_cast<std::byte>(character));
-                }
-            }
-
-            {
-                std::scoped_lock incoming_packets_lock(incoming_packets_mutex_);
-                incoming_packets_.push_back(std::move(packet));
-            }
-        });
+        data_channel->onMessage(
+          [this, connection_id, incoming_packets](rtc::message_variant data) {
+              const bool is_pushed = incoming_packets->TryPush([&](ReceivedPacket& packet) {
+                  packet.connection_id = connection_id;
+                  if (std::holds_alternative<rtc::binary>(data)) {
+                      const auto& bytes = std::get<rtc::binary>(data);
+                      packet.payload.assign(bytes.begin(), bytes.end());
+                  } else {
+                      const auto& text = std::get<std::string>(data);
+                      packet.payload.resize(text.size());
+                      std::memcpy(packet.payload.data(), text.data(), text.size());
+                  }
+              });
+              if (!is_pushed) {
+                  dropped_packets_count_.fetch_add(1, std::memory_order_relaxed);
+              }
+          });
     }
 
     void RemoveSession(ConnectionId connection_id)
     {
-        std::scoped_lock sessions_lock(sessions_mutex_);
-        sessions_.erase(connection_id);
+        UpdateSessions([connection_id](TSessionTable& sessions) { sessions.erase(connection_id); });
     }
 
     Httplib::ServerResponse HandleOffer(const Httplib::ServerRequest& request)
@@ -348,11 +387,8 @@ private:
             return JsonResponse(400, R"({"error":"empty WebRTC offer"})");
         }
 
-        ConnectionId connection_id;
-        {
-            std::scoped_lock sessions_lock(sessions_mutex_);
-            connection_id = next_connection_id_++;
-        }
+        const ConnectionId connection_id =
+          next_connection_id_.fetch_add(1, std::memory_order_relaxed);
         const auto session_id = std::to_string(connection_id);
         auto peer_connection = std::make_shared<rtc::PeerConnection>(rtc::Configuration{});
         auto pending_description = std::make_shared<PendingDescription>();
@@ -379,14 +415,17 @@ private:
               }
           });
 
-        {
-            std::scoped_lock sessions_lock(sessions_mutex_);
-            sessions_.emplace(connection_id,
-                              PeerSession{ .connection_id = connection_id,
-                                           .peer_connection = peer_connection,
-                                           .unreliable_data_channel = nullptr,
-                                           .reliable_data_channel = nullptr });
-        }
+        UpdateSessions([&](TSessionTable& sessions) {
+            sessions.emplace(
+              connection_id,
+              PeerSession{
+                .connection_id = connection_id,
+                .peer_connection = peer_connection,
+                .unreliable_data_channel = nullptr,
+                .reliable_data_channel = nullptr,
+                .unreliable_incoming_packets = std::make_shared<TIncomingPacketsQueue>(),
+                .reliable_incoming_packets = std::make_shared<TIncomingPacketsQueue>() });
+        });
 
         peer_connection->onDataChannel(
           [this, connection_id](std::shared_ptr<rtc::DataChannel> data_channel) {
@@ -471,9 +510,9 @@ private:
 
         std::shared_ptr<rtc::PeerConnection> peer_connection;
         {
-            std::scoped_lock sessions_lock(sessions_mutex_);
-            auto session = sessions_.find(connection_id);
-            if (session != sessions_.end()) {
+            const auto sessions = sessions_.load(std::memory_order_acquire);
+            auto session = sessions->find(connection_id);
+            if (session != sessions->end()) {
                 peer_connection = session->second.peer_connection;
             }
         }
@@ -496,13 +535,15 @@ private:
     }
 
     std::uint16_t port_ = 0;
-    ConnectionId next_connection_id_ = 1;
+    std::atomic<ConnectionId> next_connection_id_ = 1;
     Httplib::Server signaling_server_;
     std::thread signaling_thread_;
-    std::mutex sessions_mutex_;
-    std::unordered_map<ConnectionId, PeerSession> sessions_;
+    // Serializes the writers only, readers load the current snapshot
+    std::mutex sessions_write_mutex_;
+    std::atomic<std::shared_ptr<const TSessionTable>> sessions_{
+        std::make_shared<const TSessionTable>()
+    };
     std::vector<ConnectionStateChangedHandler> observers_;
-    std::mutex incoming_packets_mutex_;
-    std::deque<ReceivedPacket> incoming_packets_;
+    std::atomic<std::size_t> dropped_packets_count_ = 0;
 };
 } // namespace Soldank
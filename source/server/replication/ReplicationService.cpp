@@ -1,11 +1,17 @@
 module;
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 export module Replication.ReplicationService;
 
+import Replication.SendRateController;
 import Runtime.ServerRuntimeServices;
 import Sessions.PlayerSessionManager;
 
@@ -31,10 +37,17 @@ public:
     {
     }
 
+    // Every client gets the state at its own rate and within its own byte budget, see
+    // SendRateController. The client's own soldier is always sent first, the remaining soldiers
+    // start from a rotating offset, so the ones that did not fit are sent first next time.
     void BroadcastTick(const StateManager& state_manager)
     {
+        soldier_states_.clear();
+        for (auto& soldier_state_messages : soldier_state_messages_) {
+            soldier_state_messages.clear();
+        }
         state_manager.ForEachSoldier([&](const auto& soldier) {
-            SoldierStatePacket packet{
+            soldier_states_.push_back({
                 .server_tick = state_manager.GetGameTick(),
                 .player_id = soldier.id,
                 .position_x = soldier.particle.position.x,
@@ -65,9 +78,35 @@ public:
                 .jets_count = soldier.jets_count,
                 .active_weapon = soldier.active_weapon,
                 .last_applied_input_id = player_session_manager_.GetLastAppliedInputId(soldier.id),
-            };
-            network_host_.SendNetworkMessageToAll({ NetworkEvent::SoldierState, packet });
+            });
+        });
+
+        connection_ids_.clear();
+        network_host_.ForEachPlayerConnection([&](unsigned int connection_id) {
+            connection_ids_.insert(connection_id);
+            auto& send_rate_controller = send_rate_controllers_[connection_id];
+            const auto connection_quality = network_host_.GetConnectionQuality(connection_id);
+            if (connection_quality.has_value()) {
+                send_rate_controller.Update(*connection_quality);
+            }
+            if (send_rate_controller.ShouldSendSnapshot()) {
+                SendSnapshot(connection_id,
+                             send_rate_controller.GetSnapshotByteBudget(),
+                             send_rate_controller.GetSnapshotIntervalTicks());
+            }
         });
+        std::erase_if(send_rate_controllers_, [&](const auto& send_rate_controller) {
+            return !connection_ids_.contains(send_rate_controller.first);
+        });
+        ++snapshot_rotation_;
+    }
+
+    const SendRateController* FindSendRateController(unsigned int connection_id) const
+    {
+        const auto send_rate_controller = send_rate_controllers_.find(connection_id);
+        return send_rate_controller != send_rate_controllers_.end()
+                 ? &send_rate_controller->second
+                 : nullptr;
     }
 
     void OnSimulationEvents(std::span<const SimulationEvent> events) override
@@ -89,7 +128,79 @@ public:
     }
 
 private:
+    struct SoldierStateMessage
+    {
+        std::uint8_t soldier_id;
+        NetworkMessage network_message;
+    };
+
+    // The states are encoded once per tick for every snapshot interval the clients are sent
+    // snapshots at
+    const std::vector<SoldierStateMessage>& GetSoldierStateMessages(
+      unsigned int snapshot_interval_ticks)
+    {
+        auto& soldier_state_messages = soldier_state_messages_.at(snapshot_interval_ticks);
+        if (soldier_state_messages.empty()) {
+            for (auto soldier_state : soldier_states_) {
+                soldier_state.snapshot_interval_ticks =
+                  static_cast<std::uint8_t>(snapshot_interval_ticks);
+                soldier_state_messages.push_back(
+                  { .soldier_id = soldier_state.player_id,
+                    .network_message = { NetworkEvent::SoldierState, soldier_state } });
+            }
+        }
+        return soldier_state_messages;
+    }
+
+    // SoldierStatePacket::snapshot_interval_ticks has room for intervals up to 3 ticks
+    static_assert(SendRateController::MAX_SNAPSHOT_INTERVAL_TICKS <= 3);
+
+    void SendSnapshot(unsigned int connection_id,
+                      std::size_t byte_budget,
+                      unsigned int snapshot_interval_ticks)
+    {
+        const auto& soldier_state_messages = GetSoldierStateMessages(snapshot_interval_ticks);
+        if (soldier_state_messages.empty()) {
+            return;
+        }
+
+        const unsigned int own_soldier_id =
+          network_host_.GetSoldierIdFromConnectionId(connection_id);
+        std::size_t sent_bytes = 0;
+        for (const auto& soldier_state_message : soldier_state_messages) {
+            if (soldier_state_message.soldier_id == own_soldier_id) {
+                network_host_.SendNetworkMessage(connection_id,
+                                                 soldier_state_message.network_message);
+                sent_bytes += soldier_state_message.network_message.GetData().size();
+                break;
+            }
+        }
+
+        const std::size_t messages_count = soldier_state_messages.size();
+        for (std::size_t i = 0; i < messages_count; ++i) {
+            const auto& soldier_state_message =
+              soldier_state_messages[(snapshot_rotation_ + i) % messages_count];
+            if (soldier_state_message.soldier_id == own_soldier_id) {
+                continue;
+            }
+            const std::size_t message_size = soldier_state_message.network_message.GetData().size();
+            if (sent_bytes + message_size > byte_budget) {
+                break;
+            }
+            network_host_.SendNetworkMessage(connection_id, soldier_state_message.network_message);
+            sent_bytes += message_size;
+        }
+    }
+
     IServerNetworkHost& network_host_;
     const PlayerSessionManager& player_session_manager_;
+    std::vector<SoldierStatePacket> soldier_states_;
+    // Indexed by the snapshot interval the messages announce
+    std::array<std::vector<SoldierStateMessage>,
+               SendRateController::MAX_SNAPSHOT_INTERVAL_TICKS + 1>
+      soldier_state_messages_;
+    std::unordered_map<unsigned int, SendRateController> send_rate_controllers_;
+    std::unordered_set<unsigned int> connection_ids_;
+    std::size_t snapshot_rotation_ = 0;
 };
 } // namespace Soldank
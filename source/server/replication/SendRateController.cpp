@@ -0,0 +1,119 @@
+module;
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+export module Replication.SendRateController;
+
+import Networking.Transport.TransportTypes;
+
+export namespace Soldank
+{
+// Decides how often and how much state is sent to one client. The snapshot rate is lowered
+// from every tick (60 Hz) to every third tick (20 Hz) as soon as the link shows congestion:
+// growing send queues, packet loss or round trip time well above the lowest one seen. It is
+// raised again one step at a time once the link stays healthy. Every snapshot carries the current
+// interval, so the client lengthens its playback delay as soon as the rate is lowered.
+class SendRateController
+{
+public:
+    static constexpr unsigned int TICKS_PER_SECOND = 60;
+    static constexpr unsigned int MIN_SNAPSHOT_INTERVAL_TICKS = 1;
+    static constexpr unsigned int MAX_SNAPSHOT_INTERVAL_TICKS = 3;
+    // Always enough for the client's own soldier state, which reconciliation depends on
+    static constexpr std::size_t MIN_SNAPSHOT_BYTE_BUDGET = 256;
+
+    // Called once per tick with the latest link statistics
+    void Update(const ConnectionQuality& connection_quality)
+    {
+        connection_quality_ = connection_quality;
+        if (connection_quality.round_trip_time_milliseconds > 0) {
+            lowest_round_trip_time_milliseconds_ =
+              std::min(lowest_round_trip_time_milliseconds_,
+                       connection_quality.round_trip_time_milliseconds);
+        }
+
+        if (ticks_since_rate_change_ < std::numeric_limits<unsigned int>::max()) {
+            ++ticks_since_rate_change_;
+        }
+
+        if (IsCongested(connection_quality)) {
+            healthy_ticks_count_ = 0;
+            // Give the previous decrease time to show in the statistics before reacting again
+            if (ticks_since_rate_change_ >= CONGESTION_REACTION_TICKS &&
+                snapshot_interval_ticks_ < MAX_SNAPSHOT_INTERVAL_TICKS) {
+                ++snapshot_interval_ticks_;
+                ticks_since_rate_change_ = 0;
+            }
+            return;
+        }
+
+        ++healthy_ticks_count_;
+        if (healthy_ticks_count_ >= RECOVERY_TICKS &&
+            snapshot_interval_ticks_ > MIN_SNAPSHOT_INTERVAL_TICKS) {
+            --snapshot_interval_ticks_;
+            healthy_ticks_count_ = 0;
+            ticks_since_rate_change_ = 0;
+        }
+    }
+
+    // Called once per tick, returns true on the ticks a snapshot should be sent
+    bool ShouldSendSnapshot()
+    {
+        ++ticks_since_snapshot_;
+        if (ticks_since_snapshot_ < snapshot_interval_ticks_) {
+            return false;
+        }
+        ticks_since_snapshot_ = 0;
+        return true;
+    }
+
+    // Bytes of state that fit in the snapshot. Queued reliable messages are paid for first, so
+    // state never delays the events.
+    std::size_t GetSnapshotByteBudget() const
+    {
+        if (connection_quality_.send_rate_bytes_per_second == 0) {
+            return std::numeric_limits<std::size_t>::max();
+        }
+
+        const std::size_t bytes_per_snapshot = connection_quality_.send_rate_bytes_per_second *
+                                               snapshot_interval_ticks_ / TICKS_PER_SECOND;
+        const std::size_t queued_bytes = connection_quality_.pending_reliable_bytes +
+                                         connection_quality_.pending_unreliable_bytes;
+        if (bytes_per_snapshot <= queued_bytes + MIN_SNAPSHOT_BYTE_BUDGET) {
+            return MIN_SNAPSHOT_BYTE_BUDGET;
+        }
+        return bytes_per_snapshot - queued_bytes;
+    }
+
+    unsigned int GetSnapshotIntervalTicks() const { return snapshot_interval_ticks_; }
+    unsigned int GetSnapshotRate() const { return TICKS_PER_SECOND / snapshot_interval_ticks_; }
+
+private:
+    static constexpr std::size_t CONGESTED_QUEUED_BYTES = 4096;
+    static constexpr float CONGESTED_PACKET_LOSS_RATIO = 0.05F;
+    static constexpr int CONGESTED_ROUND_TRIP_TIME_INCREASE_MILLISECONDS = 100;
+    static constexpr unsigned int CONGESTION_REACTION_TICKS = TICKS_PER_SECOND / 2;
+    static constexpr unsigned int RECOVERY_TICKS = TICKS_PER_SECOND * 2;
+
+    bool IsCongested(const ConnectionQuality& connection_quality) const
+    {
+        const std::size_t queued_bytes = connection_quality.pending_reliable_bytes +
+                                         connection_quality.pending_unreliable_bytes;
+        const bool is_round_trip_time_increased =
+          connection_quality.round_trip_time_milliseconds >
+          lowest_round_trip_time_milliseconds_ + CONGESTED_ROUND_TRIP_TIME_INCREASE_MILLISECONDS;
+        return queued_bytes > CONGESTED_QUEUED_BYTES ||
+               connection_quality.packet_loss_ratio > CONGESTED_PACKET_LOSS_RATIO ||
+               is_round_trip_time_increased;
+    }
+
+    ConnectionQuality connection_quality_;
+    int lowest_round_trip_time_milliseconds_ = std::numeric_limits<int>::max() / 2;
+    unsigned int snapshot_interval_ticks_ = MIN_SNAPSHOT_INTERVAL_TICKS;
+    unsigned int ticks_since_snapshot_ = 0;
+    unsigned int ticks_since_rate_change_ = CONGESTION_REACTION_TICKS;
+    unsigned int healthy_ticks_count_ = 0;
+};
+} // namespace Soldank
@@ -4,6 +4,7 @@ module;
 #include <cstddef>
 #include <cstdint>
 #include <optional>
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -13,26 +14,104 @@ import Shared.Core.Simulation.SimulationCommands;
 import Shared.Core.Config.Config;
 import Shared.Core.Utility.SerialNumber;
 
-export namespace Soldank
+namespace Soldank
 {
-#ifndef NDEBUG
-struct ServerInputQueueDebugStats
+// Pending inputs of one player ordered by apply_server_tick, so the due inputs are always at the
+// front of the ring
+class PendingPlayerInputs
+{
+public:
+    static constexpr std::size_t CAPACITY = 64;
+
+    // Returns how many pending inputs were superseded by the new one, or std::nullopt when the
+    // ring is full and the new input was dropped
+    std::optional<std::size_t> Push(const PlayerInputCommand& command)
+    {
+        // A newer input scheduled for the same or an earlier tick than the pending ones replaces
+        // them, applying them afterwards would apply older inputs after a newer one
+        std::size_t superseded_input_count = 0;
+        while (count_ > 0 &&
+               !IsSerialNumberNewer(command.apply_server_tick, GetBack().apply_server_tick)) {
+            --count_;
+            ++superseded_input_count;
+        }
+
+        if (count_ == CAPACITY) {
+            return std::nullopt;
+        }
+
+        inputs_.at((first_ + count_) % CAPACITY) = command;
+        ++count_;
+        return superseded_input_count;
+    }
+
+    // Removes all the inputs due at server_tick and returns the newest of them
+    std::optional<PlayerInputCommand> PopNewestDue(std::uint32_t server_tick,
+                                                   std::size_t& late_applied_input_count,
+                                                   std::size_t& superseded_input_count)
+    {
+        std::optional<PlayerInputCommand> newest_due_input;
+        while (count_ > 0 && !IsSerialNumberNewer(GetFront().apply_server_tick, server_tick)) {
+            if (IsSerialNumberOlder(GetFront().apply_server_tick, server_tick)) {
+                ++late_applied_input_count;
+            }
+            if (newest_due_input.has_value()) {
+                ++superseded_input_count;
+            }
+            newest_due_input = GetFront();
+            first_ = (first_ + 1) % CAPACITY;
+            --count_;
+        }
+        return newest_due_input;
+    }
+
+    std::size_t GetSize() const { return count_; }
+
+private:
+    const PlayerInputCommand& GetFront() const { return inputs_.at(first_); }
+    const PlayerInputCommand& GetBack() const
+    {
+        return inputs_.at((first_ + count_ - 1) % CAPACITY);
+    }
+
+    std::array<PlayerInputCommand, CAPACITY> inputs_{};
+    std::size_t first_ = 0;
+    std::size_t count_ = 0;
+};
+
+export struct ServerInputQueueStats
 {
     std::size_t received_input_count;
     std::size_t late_applied_input_count;
     std::size_t superseded_input_count;
+    // Inputs with an invalid soldier id or that did not fit in the player's pending inputs
+    std::size_t dropped_input_count;
 };
-#endif
 
-class ServerCommandQueues
+// Commands received from the network, waiting for the server tick they are applied in. The pending
+// inputs of each player are bounded, so a client that sends inputs faster than they are applied
+// cannot grow the server's memory, and nothing is allocated on the tick.
+export class ServerCommandQueues
 {
 public:
-    void StorePendingPlayerInput(PlayerInputCommand command)
+    static constexpr std::size_t MAX_PENDING_INPUTS_PER_PLAYER = PendingPlayerInputs::CAPACITY;
+
+    // Returns false when the input was dropped
+    bool StorePendingPlayerInput(const PlayerInputCommand& command)
     {
-        pending_player_inputs_.at(command.soldier_id).push_back(std::move(command));
-#ifndef NDEBUG
-        received_input_count_++;
-#endif
+        ++input_stats_.received_input_count;
+        if (command.soldier_id >= Config::MAX_PLAYERS) {
+            ++input_stats_.dropped_input_count;
+            return false;
+        }
+
+        auto superseded_input_count = pending_player_inputs_.at(command.soldier_id).Push(command);
+        if (!superseded_input_count.has_value()) {
+            ++input_stats_.dropped_input_count;
+            return false;
+        }
+        input_stats_.superseded_input_count += *superseded_input_count;
+        return true;
     }
 
     void EnqueueSimulationCommand(SimulationCommand command)
@@ -40,65 +119,55 @@ public:
         simulation_commands_.push_back(std::move(command));
     }
 
-    std::vector<PlayerInputCommand> SelectPlayerInputsForSimulation(std::uint32_t server_tick)
+    // Writes the newest due input of every player to player_inputs and returns the written part.
+    // player_inputs needs room for Config::MAX_PLAYERS inputs.
+    std::span<const PlayerInputCommand> SelectPlayerInputsForSimulation(
+      std::uint32_t server_tick,
+      std::span<PlayerInputCommand> player_inputs)
     {
-        std::vector<PlayerInputCommand> player_inputs;
+        std::size_t player_inputs_count = 0;
         for (auto& pending_player_inputs : pending_player_inputs_) {
-            std::optional<PlayerInputCommand> newest_due_input;
-            for (auto input = pending_player_inputs.begin();
-                 input != pending_player_inputs.end();) {
-                if (!IsSerialNumberNewer(input->apply_server_tick, server_tick)) {
-#ifndef NDEBUG
-                    if (IsSerialNumberOlder(input->apply_server_tick, server_tick)) {
-                        late_applied_input_count_++;
-                    }
-                    if (newest_due_input.has_value()) {
-                        superseded_input_count_++;
-                    }
-#endif
-                    newest_due_input = std::move(*input);
-                    input = pending_player_inputs.erase(input);
-                } else {
-                    ++input;
-                }
-            }
-            if (newest_due_input.has_value()) {
-                player_inputs.push_back(std::move(*newest_due_input));
+            auto newest_due_input =
+              pending_player_inputs.PopNewestDue(server_tick,
+                                                 input_stats_.late_applied_input_count,
+                                                 input_stats_.superseded_input_count);
+            if (newest_due_input.has_value() && player_inputs_count < player_inputs.size()) {
+                player_inputs[player_inputs_count] = *newest_due_input;
+                ++player_inputs_count;
             }
         }
-        return player_inputs;
+        return player_inputs.first(player_inputs_count);
     }
 
-#ifndef NDEBUG
-    ServerInputQueueDebugStats GetInputDebugStats() const
+    std::size_t GetPendingPlayerInputCount(std::uint8_t soldier_id) const
     {
-        return { .received_input_count = received_input_count_,
-                 .late_applied_input_count = late_applied_input_count_,
-                 .superseded_input_count = superseded_input_count_ };
+        return pending_player_inputs_.at(soldier_id).GetSize();
     }
 
-    void ResetInputDebugStats()
+    std::size_t GetPendingPlayerInputCount() const
     {
-        received_input_count_ = 0;
-        late_applied_input_count_ = 0;
-        superseded_input_count_ = 0;
+        std::size_t pending_player_input_count = 0;
+        for (const auto& pending_player_inputs : pending_player_inputs_) {
+            pending_player_input_count += pending_player_inputs.GetSize();
+        }
+        return pending_player_input_count;
     }
-#endif
 
-    std::vector<SimulationCommand> DrainSimulationCommands()
+    ServerInputQueueStats GetInputStats() const { return input_stats_; }
+
+    void ResetInputStats() { input_stats_ = {}; }
+
+    // Moves the queued commands to simulation_commands. The two vectors trade their buffers, so
+    // once both have grown nothing is allocated.
+    void DrainSimulationCommands(std::vector<SimulationCommand>& simulation_commands)
     {
-        std::vector<SimulationCommand> simulation_commands;
+        simulation_commands.clear();
         simulation_commands.swap(simulation_commands_);
-        return simulation_commands;
     }
 
 private:
-    std::array<std::vector<PlayerInputCommand>, Config::MAX_PLAYERS> pending_player_inputs_{};
+    std::array<PendingPlayerInputs, Config::MAX_PLAYERS> pending_player_inputs_{};
     std::vector<SimulationCommand> simulation_commands_;
-#ifndef NDEBUG
-    std::size_t received_input_count_ = 0;
-    std::size_t late_applied_input_count_ = 0;
-    std::size_t superseded_input_count_ = 0;
-#endif
+    ServerInputQueueStats input_stats_{};
 };
 } // namespace Soldank
@@ -0,0 +1,136 @@
+module;
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+export module Runtime.ServerReplayRecording;
+
+import Shared.Core.Replay.ReplayFormat;
+import Shared.Core.Replay.ReplayRecorder;
+import Shared.Core.Simulation.WorldTick;
+import Shared.Core.State.StateManager;
+
+import Extern.Spdlog;
+
+export namespace Soldank
+{
+// Streams the match replay to a file. The recording is appended in chunks, so a crashed server
+// still leaves a replay that plays up to the last flushed chunk. Chunks are written on a thread of
+// their own to one stream that stays open, so the ticks never wait for the disk.
+class ServerReplayRecording
+{
+public:
+    static constexpr std::size_t MAX_PENDING_BYTES_COUNT = 64 * 1024;
+
+    ServerReplayRecording(std::filesystem::path replay_path, ReplayHeader header)
+        : replay_path_(std::move(replay_path))
+        , recorder_(std::move(header))
+        , replay_file_(replay_path_, std::ios::out | std::ios::binary | std::ios::trunc)
+    {
+        if (!replay_file_.is_open()) {
+            Spdlog::warn("Could not open replay file {}", replay_path_.string());
+        }
+        writer_thread_ = std::thread([this]() { RunWriter(); });
+    }
+
+    // Writes everything recorded so far before returning
+    ~ServerReplayRecording()
+    {
+        Flush();
+        {
+            std::lock_guard lock{ mutex_ };
+            is_stopping_ = true;
+        }
+        writer_condition_variable_.notify_all();
+        writer_thread_.join();
+    }
+
+    ServerReplayRecording(const ServerReplayRecording&) = delete;
+    ServerReplayRecording& operator=(const ServerReplayRecording&) = delete;
+    ServerReplayRecording(ServerReplayRecording&&) = delete;
+    ServerReplayRecording& operator=(ServerReplayRecording&&) = delete;
+
+    void RecordTick(const WorldTickInput& input, const StateManager& state_manager)
+    {
+        const std::size_t keyframes_count = recorder_.GetKeyframesCount();
+        recorder_.RecordTick(input, state_manager);
+        if (recorder_.GetKeyframesCount() != keyframes_count ||
+            recorder_.GetPendingBytesCount() >= MAX_PENDING_BYTES_COUNT) {
+            Flush();
+        }
+    }
+
+    // Hands the recorded data over to the writer thread
+    void Flush()
+    {
+        if (recorder_.GetPendingBytesCount() == 0) {
+            return;
+        }
+
+        {
+            std::lock_guard lock{ mutex_ };
+            pending_chunks_.push_back(recorder_.TakeRecordedData());
+        }
+        writer_condition_variable_.notify_one();
+    }
+
+    std::size_t GetRecordedBytesCount() const { return recorder_.GetRecordedBytesCount(); }
+
+private:
+    // Chunks still pending when stopping are written before the thread returns
+    void RunWriter()
+    {
+        std::unique_lock lock{ mutex_ };
+        while (true) {
+            writer_condition_variable_.wait(
+              lock, [this]() { return is_stopping_ || !pending_chunks_.empty(); });
+            if (pending_chunks_.empty()) {
+                return;
+            }
+
+            const std::vector<std::byte> chunk = std::move(pending_chunks_.front());
+            pending_chunks_.pop_front();
+            lock.unlock();
+
+            WriteChunk(chunk);
+
+            lock.lock();
+        }
+    }
+
+    // Only called by the writer thread
+    void WriteChunk(const std::vector<std::byte>& chunk)
+    {
+        if (!replay_file_.is_open() || replay_file_.bad()) {
+            return;
+        }
+
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        replay_file_.write(reinterpret_cast<const char*>(chunk.data()),
+                           static_cast<std::streamsize>(chunk.size()));
+        replay_file_.flush();
+        if (replay_file_.bad()) {
+            Spdlog::warn("Could not write replay chunk to {}", replay_path_.string());
+        }
+    }
+
+    std::filesystem::path replay_path_;
+    ReplayRecorder recorder_;
+    // Only accessed by the writer thread once it is started
+    std::ofstream replay_file_;
+
+    std::mutex mutex_;
+    std::condition_variable writer_condition_variable_;
+    std::deque<std::vector<std::byte>> pending_chunks_;
+    bool is_stopping_ = false;
+    std::thread writer_thread_;
+};
+} // namespace Soldank
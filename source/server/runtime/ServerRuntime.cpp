@@ -1,7 +1,12 @@
 module;
 
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstdint>
+#include <filesystem>
 #include <memory>
+#include <optional>
 #include <thread>
 #include <utility>
 #include <vector>
@@ -11,16 +16,20 @@ export module Runtime.ServerRuntime;
 import Application.ServerConfig;
 import Replication.ReplicationService;
 import Runtime.ServerCommandQueues;
+import Runtime.ServerReplayRecording;
 import Runtime.ServerRuntimeServices;
 import Runtime.ServerSimulationEventRouter;
 import Sessions.PlayerSessionManager;
 
 import Shared.Core.IWorld;
+import Shared.Core.Config.Config;
 import Shared.Core.Entities.Bullet;
 import Shared.Core.Loop.FixedTimestepRunner;
 import Shared.Core.Loop.NativeFixedTimestepLoop;
+import Shared.Core.Replay.ReplayFormat;
 import Shared.Core.Simulation.SimulationCommands;
 import Shared.Core.Simulation.WorldTick;
+import Shared.Core.Utility.Counters;
 
 import Extern.Spdlog;
 
@@ -44,6 +53,14 @@ public:
         , replication_service_(network_host_, player_session_manager_)
     {
         simulation_event_router_.AddSink(replication_service_);
+        if (!config_.replay_path.empty()) {
+            replay_recording_.emplace(config_.replay_path,
+                                      ReplayHeader{
+                                        .keyframe_interval = config_.replay_keyframe_interval,
+                                        .map_path = config_.map_path,
+                                        .lag_compensation = config_.lag_compensation,
+                                      });
+        }
     }
 
     void Run()
@@ -60,29 +77,32 @@ public:
             .should_tick = []() { return true; },
             .tick =
               [&](double /*delta_time*/) {
+                  const auto tick_start_time = std::chrono::steady_clock::now();
                   network_host_.Update();
 
                   const std::uint32_t server_tick = world_->GetStateManager()->GetGameTick();
-                  auto player_inputs = command_queues_.SelectPlayerInputsForSimulation(server_tick);
-                  auto simulation_commands = command_queues_.DrainSimulationCommands();
+                  const auto player_inputs = command_queues_.SelectPlayerInputsForSimulation(
+                    server_tick, selected_player_inputs_);
+                  command_queues_.DrainSimulationCommands(simulation_commands_);
                   const WorldTickInput input{
                       .tick = server_tick,
                       .player_inputs = player_inputs,
-                      .commands = simulation_commands,
+                      .commands = simulation_commands_,
                   };
+                  if (replay_recording_.has_value()) {
+                      replay_recording_->RecordTick(input, *world_->GetStateManager());
+                  }
                   WorldTickResult result = world_->Tick(input);
                   for (const auto& player_input : player_inputs) {
                       player_session_manager_.MarkInputApplied(player_input.soldier_id,
                                                                player_input.input_sequence_id);
                   }
-#ifndef NDEBUG
-                  command_queues_.ResetInputDebugStats();
-#endif
                   simulation_event_router_.OnSimulationEvents(result.events);
                   replication_service_.BroadcastTick(*world_->GetStateManager());
+                  PublishTickCounters(tick_start_time);
 
                   if (world_->GetStateManager()->GetGameTick() % (3600 * 3) == 0) {
-                      lobby_client_.Register(config_.server_name, config_.server_port);
+                      lobby_client_.Register(CreateLobbyServerInfo());
                   }
               },
             .after_tick =
@@ -100,11 +120,51 @@ public:
         };
 
         native_loop.Run(fixed_timestep_runner, callbacks, [&]() { return config_.fps_limit; });
+        // Writes the ticks recorded since the last flushed chunk
+        replay_recording_.reset();
 
         std::this_thread::sleep_for(std::chrono::milliseconds(500));
     }
 
 private:
+    // Moves the tick's statistics to the process counters read by the admin endpoint
+    void PublishTickCounters(std::chrono::steady_clock::time_point tick_start_time)
+    {
+        auto& counter_registry = GetCounterRegistry();
+        const auto input_stats = command_queues_.GetInputStats();
+        command_queues_.ResetInputStats();
+        counter_registry.Add(Counter::InputsReceived, input_stats.received_input_count);
+        counter_registry.Add(Counter::InputsLateApplied, input_stats.late_applied_input_count);
+        counter_registry.Add(Counter::InputsSuperseded, input_stats.superseded_input_count);
+        counter_registry.Add(Counter::InputsDropped, input_stats.dropped_input_count);
+        counter_registry.Set(
+          Gauge::PendingPlayerInputs,
+          static_cast<std::int64_t>(command_queues_.GetPendingPlayerInputCount()));
+        counter_registry.Set(Gauge::SimulationCommandsPerTick,
+                             static_cast<std::int64_t>(simulation_commands_.size()));
+
+        const auto tick_duration = std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - tick_start_time);
+        counter_registry.Set(Gauge::TickDurationMicroseconds, tick_duration.count());
+        const auto tick_budget = std::chrono::microseconds(std::chrono::seconds(1)) /
+                                 std::max(config_.fps_limit, 1);
+        if (tick_duration > tick_budget) {
+            counter_registry.Add(Counter::TickOverruns);
+        }
+    }
+
+    LobbyServerInfo CreateLobbyServerInfo() const
+    {
+        unsigned int players_count = 0;
+        world_->GetStateManager()->ForEachSoldier(
+          [&](const auto& /*soldier*/) { ++players_count; });
+        return { .name = config_.server_name,
+                 .port = config_.server_port,
+                 .current_map = std::filesystem::path(config_.map_path).stem().string(),
+                 .players_count = players_count,
+                 .max_players = Config::MAX_PLAYERS };
+    }
+
     ServerConfig config_;
     std::shared_ptr<IWorld> world_;
     IServerNetworkHost& network_host_;
@@ -113,5 +173,9 @@ private:
     ServerCommandQueues& command_queues_;
     ReplicationService replication_service_;
     ServerSimulationEventRouter simulation_event_router_;
+    std::optional<ServerReplayRecording> replay_recording_;
+    // Reused every tick, so selecting the tick's inputs and commands does not allocate
+    std::array<PlayerInputCommand, Config::MAX_PLAYERS> selected_player_inputs_{};
+    std::vector<SimulationCommand> simulation_commands_;
 };
 } // namespace Soldank
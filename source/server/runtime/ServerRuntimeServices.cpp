@@ -1,10 +1,13 @@
 module;
 
 #include <cstdint>
+#include <functional>
+#include <optional>
 #include <string>
 
 export module Runtime.ServerRuntimeServices;
 
+export import Networking.Transport.TransportTypes;
 import Shared.Networking.NetworkMessage;
 
 export namespace Soldank
@@ -19,6 +22,26 @@ public:
                                     const NetworkMessage& network_message) = 0;
     virtual void SendNetworkMessageToAll(const NetworkMessage& network_message) = 0;
     virtual unsigned int GetSoldierIdFromConnectionId(unsigned int connection_id) = 0;
+    // Connections of the players in the game, the ones that receive the state broadcasts
+    virtual void ForEachPlayerConnection(
+      const std::function<void(unsigned int connection_id)>& for_each_connection_function) = 0;
+    // Returns nullopt when the connection's transport does not report link statistics
+    virtual std::optional<ConnectionQuality> GetConnectionQuality(unsigned int connection_id) = 0;
+};
+
+// Snapshot of the server state that is advertised in the lobbies
+struct LobbyServerInfo
+{
+    std::string name;
+    std::uint16_t port = 0;
+    std::string current_map;
+    unsigned int players_count = 0;
+    unsigned int max_players = 0;
+    std::string game_style = "CTF";
+    std::string country = "PL";
+    std::string info;
+    unsigned int respawn_time = 180;
+    bool is_private = false;
 };
 
 class ILobbyRegistrationClient
@@ -26,6 +49,7 @@ class ILobbyRegistrationClient
 public:
     virtual ~ILobbyRegistrationClient() = default;
 
-    virtual void Register(const std::string& server_name, std::uint16_t server_port) = 0;
+    // Called from the simulation tick, so it must not wait for the lobbies to respond
+    virtual void Register(const LobbyServerInfo& server_info) = 0;
 };
 } // namespace Soldank
@@ -0,0 +1,158 @@
+module;
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+export module Shared.Networking.NetworkBitStream;
+
+export namespace Soldank
+{
+// Writes values packed to the given number of bits, least significant bit first. The last byte
+// is padded with zero bits.
+class NetworkBitWriter
+{
+public:
+    NetworkBitWriter() = default;
+
+    // Bits are appended after the already written bytes, e.g. a serialized NetworkEvent
+    explicit NetworkBitWriter(std::vector<char> data)
+        : data_(std::move(data))
+    {
+    }
+
+    // Fills the free bits of the last byte first and then whole bytes at a time
+    void WriteBits(std::uint32_t value, unsigned int bits_count)
+    {
+        while (bits_count > 0) {
+            if (free_bits_count_ == 0) {
+                data_.push_back(0);
+                free_bits_count_ = 8;
+            }
+            const unsigned int chunk_bits_count = std::min(bits_count, free_bits_count_);
+            const std::uint32_t chunk = value & ((1U << chunk_bits_count) - 1);
+            data_.back() = static_cast<char>(static_cast<unsigned char>(data_.back()) |
+                                             (chunk << (8 - free_bits_count_)));
+            value >>= chunk_bits_count;
+            bits_count -= chunk_bits_count;
+            free_bits_count_ -= chunk_bits_count;
+        }
+    }
+
+    void WriteBool(bool value) { WriteBits(value ? 1 : 0, 1); }
+
+    // Groups of 7 bits with a continuation bit, small values take a single byte worth of bits
+    void WriteVarUInt(std::uint32_t value)
+    {
+        while (value >= 0x80) {
+            WriteBits((value & 0x7F) | 0x80, 8);
+            value >>= 7;
+        }
+        WriteBits(value, 8);
+    }
+
+    void WriteVarInt(std::int32_t value)
+    {
+        WriteVarUInt((static_cast<std::uint32_t>(value) << 1) ^
+                     static_cast<std::uint32_t>(value >> 31));
+    }
+
+    // Lossless delta of a float to the previous one. The XOR of close values has its upper bits
+    // cleared, unchanged values take a single bit.
+    void WriteFloatDelta(float value, float previous)
+    {
+        const std::uint32_t difference =
+          std::bit_cast<std::uint32_t>(value) ^ std::bit_cast<std::uint32_t>(previous);
+        WriteBool(difference != 0);
+        if (difference != 0) {
+            WriteVarUInt(difference);
+        }
+    }
+
+    std::span<const char> GetData() const { return data_; }
+    std::vector<char> TakeData() { return std::move(data_); }
+
+private:
+    std::vector<char> data_;
+    unsigned int free_bits_count_ = 0;
+};
+
+// Reading past the end of the data yields zeros and marks the reader as overflowed, so a
+// decoder only has to check for it once all values are read
+class NetworkBitReader
+{
+public:
+    explicit NetworkBitReader(std::span<const char> data)
+        : data_(data)
+    {
+    }
+
+    std::uint32_t ReadBits(unsigned int bits_count)
+    {
+        if (bit_offset_ + bits_count > data_.size() * 8) {
+            is_overflowed_ = true;
+            bit_offset_ = data_.size() * 8;
+            return 0;
+        }
+
+        std::uint32_t value = 0;
+        unsigned int read_bits_count = 0;
+        while (read_bits_count < bits_count) {
+            const auto byte = static_cast<unsigned char>(data_[bit_offset_ / 8]);
+            const unsigned int bit_in_byte = bit_offset_ % 8;
+            const unsigned int chunk_bits_count =
+              std::min(bits_count - read_bits_count, 8 - bit_in_byte);
+            const std::uint32_t chunk =
+              (static_cast<std::uint32_t>(byte) >> bit_in_byte) & ((1U << chunk_bits_count) - 1);
+            value |= chunk << read_bits_count;
+            read_bits_count += chunk_bits_count;
+            bit_offset_ += chunk_bits_count;
+        }
+        return value;
+    }
+
+    bool ReadBool() { return ReadBits(1) != 0; }
+
+    std::uint32_t ReadVarUInt()
+    {
+        std::uint32_t value = 0;
+        for (unsigned int shift = 0; shift < 32; shift += 7) {
+            const std::uint32_t group = ReadBits(8);
+            value |= (group & 0x7F) << shift;
+            if ((group & 0x80) == 0) {
+                return value;
+            }
+        }
+        is_overflowed_ = true;
+        return 0;
+    }
+
+    std::int32_t ReadVarInt()
+    {
+        const std::uint32_t value = ReadVarUInt();
+        return static_cast<std::int32_t>(value >> 1) ^ -static_cast<std::int32_t>(value & 1);
+    }
+
+    float ReadFloatDelta(float previous)
+    {
+        if (!ReadBool()) {
+            return previous;
+        }
+        return std::bit_cast<float>(ReadVarUInt() ^ std::bit_cast<std::uint32_t>(previous));
+    }
+
+    bool IsOverflowed() const { return is_overflowed_; }
+
+    // Only the padding of the last byte may be left unread
+    bool HasUnreadBytes() const { return (bit_offset_ + 7) / 8 < data_.size(); }
+
+private:
+    std::span<const char> data_;
+    std::size_t bit_offset_ = 0;
+    bool is_overflowed_ = false;
+};
+} // namespace Soldank
@@ -1,3 +1,9 @@
+module;
+
+#include <cstddef>
+#include <string_view>
+#include <utility>
+
 export module Shared.Networking.NetworkEvent;
 
 export namespace Soldank
@@ -17,4 +23,38 @@ enum class NetworkEvent : unsigned int
     KillSoldier,
     HitSoldier
 };
+
+// Has to be kept in sync with the last NetworkEvent, dispatch tables are indexed by the event
+constexpr std::size_t NETWORK_EVENTS_COUNT = std::to_underlying(NetworkEvent::HitSoldier) + 1;
+
+constexpr std::string_view GetNetworkEventName(NetworkEvent network_event)
+{
+    switch (network_event) {
+        case NetworkEvent::ChatMessage:
+            return "chat_message";
+        case NetworkEvent::AssignPlayerId:
+            return "assign_player_id";
+        case NetworkEvent::SpawnSoldier:
+            return "spawn_soldier";
+        case NetworkEvent::SoldierInput:
+            return "soldier_input";
+        case NetworkEvent::SoldierState:
+            return "soldier_state";
+        case NetworkEvent::SoldierInfo:
+            return "soldier_info";
+        case NetworkEvent::PlayerLeave:
+            return "player_leave";
+        case NetworkEvent::PingCheck:
+            return "ping_check";
+        case NetworkEvent::ProjectileSpawn:
+            return "projectile_spawn";
+        case NetworkEvent::KillCommand:
+            return "kill_command";
+        case NetworkEvent::KillSoldier:
+            return "kill_soldier";
+        case NetworkEvent::HitSoldier:
+            return "hit_soldier";
+    }
+    return "unknown";
 }
+} // namespace Soldank
@@ -1,6 +1,9 @@
 module;
 
+#include <array>
+#include <cstddef>
 #include <memory>
+#include <tuple>
 #include <optional>
 #include <variant>
 #include <utility>
@@ -13,6 +16,7 @@ export module Shared.Networking.NetworkEventDispatcher;
 
 import Extern.Glm;
 
+import Shared.Core.Utility.Counters;
 import Shared.Networking.NetworkEvent;
 import Shared.Networking.NetworkMessage;
 import Shared.Networking.NetworkPackets;
@@ -48,64 +52,45 @@ class INetworkEventHandler
 {
 public:
     virtual ~INetworkEventHandler() = default;
-    virtual bool ShouldHandleNetworkEvent(NetworkEvent network_event) const = 0;
-    virtual std::optional<ParseError> ValidateNetworkMessage(
-      const NetworkMessage& network_message) const = 0;
-    virtual NetworkEventHandlerResult HandleNetworkMessage(
+    virtual NetworkEvent GetHandledNetworkEvent() const = 0;
+    // Parses the message once and passes the parsed arguments straight to the handler
+    virtual std::expected<NetworkEventHandlerResult, ParseError> HandleNetworkMessage(
       unsigned int sender_connection_id,
-      const NetworkMessage& network_message) = 0;
+      NetworkMessageView network_message) = 0;
 };
 
 template<typename... NetworkMessageArgs>
 class NetworkEventHandlerBase : public INetworkEventHandler
 {
 public:
-    bool ShouldHandleNetworkEvent(NetworkEvent network_event) const override
-    {
-        return network_event == GetTargetNetworkEvent();
-    }
+    NetworkEvent GetHandledNetworkEvent() const final { return GetTargetNetworkEvent(); }
 
-    std::optional<ParseError> ValidateNetworkMessage(
-      const NetworkMessage& network_message) const override
-    {
-        auto parsed = GetNetworkMessageOrError(network_message);
-        if (!parsed.has_value()) {
-            return parsed.error();
-        }
-
-        return std::nullopt;
-    }
-
-    NetworkEventHandlerResult HandleNetworkMessage(unsigned int sender_connection_id,
-                                                   const NetworkMessage& network_message) override
+    std::expected<NetworkEventHandlerResult, ParseError> HandleNetworkMessage(
+      unsigned int sender_connection_id,
+      NetworkMessageView network_message) override
     {
-        auto parsed = GetNetworkMessageOrError(network_message);
+        auto parsed = network_message.Parse<NetworkEvent, NetworkMessageArgs...>();
         if (!parsed.has_value()) {
-            // Before using this method, the network_message should be validated. Here we just
-            // assume the network_message is correct
-            return NetworkEventHandlerResult::Failure;
+            return std::unexpected(parsed.error());
         }
 
         return std::apply(
           [this, sender_connection_id](NetworkEvent /*ignore*/,
-                                       NetworkMessageArgs... network_message_args) {
-              return HandleNetworkMessageImpl(sender_connection_id, network_message_args...);
+                                       NetworkMessageArgs&... network_message_args) {
+              return HandleNetworkMessageImpl(sender_connection_id,
+                                              std::move(network_message_args)...);
           },
           *parsed);
     }
 
 protected:
-    std::expected<std::tuple<NetworkEvent, NetworkMessageArgs...>, ParseError>
-    GetNetworkMessageOrError(const NetworkMessage& network_message) const
-    {
-        return network_message.Parse<NetworkEvent, NetworkMessageArgs...>();
-    }
-
     virtual NetworkEvent GetTargetNetworkEvent() const = 0;
     virtual NetworkEventHandlerResult HandleNetworkMessageImpl(unsigned int sender_connection_id,
                                                                NetworkMessageArgs...) = 0;
 };
 
+static_assert(NETWORK_EVENTS_COUNT <= MAX_COUNTED_NETWORK_EVENTS);
+
 class NetworkEventDispatcher
 {
 
@@ -115,50 +100,58 @@ public:
 
     NetworkEventDispatcher(
       const std::vector<std::shared_ptr<INetworkEventHandler>>& network_event_handlers)
-        : network_event_handlers_(network_event_handlers)
     {
+        for (const auto& network_event_handler : network_event_handlers) {
+            AddNetworkEventHandler(network_event_handler);
+        }
     }
 
     TDispatchResult ProcessNetworkMessage(const ConnectionMetadata& connection_metadata,
-                                          const NetworkMessage& network_message)
+                                          NetworkMessageView network_message)
     {
         auto network_event_or_error = network_message.GetNetworkEvent();
         if (!network_event_or_error.has_value()) {
             return { NetworkEventDispatchResult::ParseError, network_event_or_error.error() };
         }
 
-        auto network_event = *network_event_or_error;
-
-        for (const auto& network_event_handler : network_event_handlers_) {
-            if (!network_event_handler->ShouldHandleNetworkEvent(network_event)) {
-                continue;
-            }
-
-            auto parse_error_or_nothing =
-              network_event_handler->ValidateNetworkMessage(network_message);
-            if (parse_error_or_nothing.has_value()) {
-                return { NetworkEventDispatchResult::ParseError, parse_error_or_nothing.value() };
-            }
-
-            auto handler_result = network_event_handler->HandleNetworkMessage(
-              connection_metadata.connection_id, network_message);
-            switch (handler_result) {
-                case NetworkEventHandlerResult::Success:
-                    return { NetworkEventDispatchResult::Success, handler_result };
-                case NetworkEventHandlerResult::Failure:
-                    return { NetworkEventDispatchResult::HandlerFailure, handler_result };
-            }
+        auto network_event_index = std::to_underlying(*network_event_or_error);
+        if (network_event_index >= NETWORK_EVENTS_COUNT ||
+            network_event_handlers_.at(network_event_index) == nullptr) {
+            return { NetworkEventDispatchResult::ParseError, ParseError::InvalidNetworkEvent };
+        }
+        GetCounterRegistry().AddNetworkBytesReceived(network_event_index,
+                                                      network_message.GetData().size());
+
+        auto handler_result_or_error =
+          network_event_handlers_.at(network_event_index)
+            ->HandleNetworkMessage(connection_metadata.connection_id, network_message);
+        if (!handler_result_or_error.has_value()) {
+            return { NetworkEventDispatchResult::ParseError, handler_result_or_error.error() };
+        }
+
+        auto handler_result = *handler_result_or_error;
+        switch (handler_result) {
+            case NetworkEventHandlerResult::Success:
+                return { NetworkEventDispatchResult::Success, handler_result };
+            case NetworkEventHandlerResult::Failure:
+                return { NetworkEventDispatchResult::HandlerFailure, handler_result };
         }
 
-        return { NetworkEventDispatchResult::ParseError, ParseError::InvalidNetworkEvent };
+        return { NetworkEventDispatchResult::HandlerFailure, handler_result };
     }
 
+    // Only the first handler added for a network event is used
     void AddNetworkEventHandler(const std::shared_ptr<INetworkEventHandler>& network_event_handler)
     {
-        network_event_handlers_.push_back(network_event_handler);
+        auto& handler_slot = network_event_handlers_.at(
+          std::to_underlying(network_event_handler->GetHandledNetworkEvent()));
+        if (handler_slot == nullptr) {
+            handler_slot = network_event_handler;
+        }
     }
 
 private:
-    std::vector<std::shared_ptr<INetworkEventHandler>> network_event_handlers_;
+    // Indexed by NetworkEvent
+    std::array<std::shared_ptr<INetworkEventHandler>, NETWORK_EVENTS_COUNT> network_event_handlers_;
 };
 } // namespace Soldank
@@ -1,5 +1,6 @@
 module;
 
+#include <algorithm>
 #include <span>
 #include <vector>
 #include <string>
@@ -8,12 +9,17 @@ module;
 #include <utility>
 #include <cstring>
 #include <cstdint>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
 
 #include "core/utility/Expected.hpp"
 
 export module Shared.Networking.NetworkMessage;
 
+import Shared.Networking.NetworkBitStream;
 import Shared.Networking.NetworkEvent;
+import Shared.Networking.PacketSchema;
 
 namespace Soldank
 {
@@ -27,134 +33,145 @@ export enum class ParseError : unsigned short {
 
 namespace
 {
-template<unsigned int N>
-struct NetworkMessageData
+namespace NetworkMessageDecoder
 {
-    template<typename Arg>
-    static typename std::enable_if<!std::is_same<std::string, Arg>::value,
-                                   std::expected<Arg, ParseError>>::type
-    ParseDataParameter(std::span<const char> data)
-    {
-        if (data.size() < sizeof(Arg)) {
-            return std::unexpected(ParseError::BufferTooSmall);
-        }
+template<typename Arg>
+constexpr bool IS_FIXED_SIZE_PARAMETER = !std::is_same_v<Arg, std::string>;
+
+// Packets with a schema are bit-packed, everything else is copied byte by byte
+template<typename Arg>
+constexpr std::size_t ENCODED_SIZE = sizeof(Arg);
 
-        Arg converted_data{};
-        std::memcpy(&converted_data, data.subspan(0, sizeof(Arg)).data(), sizeof(Arg));
-        return converted_data;
+template<HasPacketSchema Arg>
+constexpr std::size_t ENCODED_SIZE<Arg> = PacketSchemaOf<Arg>::Type::BYTES;
+
+// Copies the fixed size parameter at offset, which has to be in bounds
+template<typename Arg>
+void DecodeFixedSizeParameter(std::span<const char> data, std::size_t offset, Arg& parameter)
+{
+    if constexpr (HasPacketSchema<Arg>) {
+        NetworkBitReader reader{ data.subspan(offset, ENCODED_SIZE<Arg>) };
+        PacketSchemaOf<Arg>::Type::Decode(reader, parameter);
+    } else {
+        std::memcpy(&parameter, data.data() + offset, sizeof(Arg));
     }
+}
 
-    template<typename Arg>
-    static typename std::enable_if<std::is_same<std::string, Arg>::value,
-                                   std::expected<std::string, ParseError>>::type
-    ParseDataParameter(std::span<const char> data)
-    {
-        auto text_size_or_error =
-          ParseDataParameter<std::uint16_t>(data.subspan(0, sizeof(std::uint16_t)));
-        if (!text_size_or_error.has_value()) {
-            return std::unexpected(text_size_or_error.error());
+// Decodes a single parameter at offset and moves the offset past it
+template<typename Arg>
+std::optional<ParseError> DecodeParameter(std::span<const char> data,
+                                          std::size_t& offset,
+                                          Arg& parameter)
+{
+    if constexpr (IS_FIXED_SIZE_PARAMETER<Arg>) {
+        if (data.size() - offset < ENCODED_SIZE<Arg>) {
+            return ParseError::BufferTooSmall;
         }
 
-        std::uint16_t text_size = *text_size_or_error;
-        if (text_size == 0 || text_size > data.size() - sizeof(std::uint16_t)) {
-            return std::unexpected(ParseError::InvalidStringSize);
+        DecodeFixedSizeParameter(data, offset, parameter);
+        offset += ENCODED_SIZE<Arg>;
+    } else {
+        std::uint16_t text_size{};
+        if (data.size() - offset < sizeof(text_size)) {
+            return ParseError::BufferTooSmall;
         }
 
-        for (char character : data.subspan(sizeof(std::uint16_t), text_size)) {
-            if (character == 0) {
-                return std::unexpected(ParseError::InvalidString);
-            }
+        std::memcpy(&text_size, data.data() + offset, sizeof(text_size));
+        offset += sizeof(text_size);
+        if (text_size == 0 || text_size > data.size() - offset) {
+            return ParseError::InvalidStringSize;
         }
 
-        auto text_data = data.subspan(sizeof(std::uint16_t), text_size);
-        std::string text{ text_data.begin(), text_data.end() };
-        return text;
-    }
-
-    template<typename Arg>
-    static typename std::enable_if<!std::is_same<std::string, Arg>::value,
-                                   std::expected<unsigned int, ParseError>>::type
-    ParseDataParameterSize(std::span<const char> data)
-    {
-        if (data.size() < sizeof(Arg)) {
-            return std::unexpected(ParseError::BufferTooSmall);
+        auto text_data = data.subspan(offset, text_size);
+        if (std::ranges::find(text_data, '\0') != text_data.end()) {
+            return ParseError::InvalidString;
         }
 
-        return sizeof(Arg);
+        parameter.assign(text_data.begin(), text_data.end());
+        offset += text_size;
     }
 
-    template<typename Arg>
-    static typename std::enable_if<std::is_same<std::string, Arg>::value,
-                                   std::expected<unsigned int, ParseError>>::type
-    ParseDataParameterSize(std::span<const char> data)
-    {
-        auto text_size_or_error =
-          ParseDataParameter<std::uint16_t>(data.subspan(0, sizeof(std::uint16_t)));
-        if (!text_size_or_error.has_value()) {
-            return std::unexpected(text_size_or_error.error());
-        }
-        std::uint16_t text_size = *text_size_or_error;
-        if ((text_size == 0) || text_size > data.size() - sizeof(std::uint16_t)) {
-            return std::unexpected(ParseError::InvalidStringSize);
-        }
+    return std::nullopt;
+}
 
-        return sizeof(std::uint16_t) + text_size;
-    }
+// Decodes the whole message in a single pass straight into the resulting tuple. Messages made
+// only of fixed size parameters have their size known at compile time, so the buffer is checked
+// once and the parameters are copied from constant offsets.
+template<typename... Args>
+std::expected<std::tuple<Args...>, ParseError> Decode(std::span<const char> data)
+{
+    std::tuple<Args...> parameters{};
 
-    template<typename Head, typename... Tail>
-    static
-      typename std::enable_if<N != 1, std::expected<std::tuple<Head, Tail...>, ParseError>>::type
-      ParseData(std::span<const char> data)
-    {
-        if (data.empty()) {
+    if constexpr ((IS_FIXED_SIZE_PARAMETER<Args> && ...)) {
+        constexpr std::size_t MESSAGE_SIZE = (ENCODED_SIZE<Args> + ...);
+        if (data.size() < MESSAGE_SIZE) {
             return std::unexpected(ParseError::BufferTooSmall);
         }
-
-        auto head_or_error = ParseDataParameter<Head>(data);
-        if (!head_or_error.has_value()) {
-            return std::unexpected(head_or_error.error());
+        if (data.size() > MESSAGE_SIZE) {
+            return std::unexpected(ParseError::BufferTooBig);
         }
 
-        auto tail_offset_or_error = ParseDataParameterSize<Head>(data);
-        if (!tail_offset_or_error.has_value()) {
-            return std::unexpected(tail_offset_or_error.error());
+        std::size_t offset = 0;
+        std::apply(
+          [&](Args&... parameter) {
+              ((DecodeFixedSizeParameter(data, offset, parameter), offset += ENCODED_SIZE<Args>),
+               ...);
+          },
+          parameters);
+    } else {
+        std::size_t offset = 0;
+        std::optional<ParseError> parse_error;
+        std::apply(
+          [&](Args&... parameter) {
+              static_cast<void>(
+                ((parse_error = DecodeParameter(data, offset, parameter), !parse_error) && ...));
+          },
+          parameters);
+        if (parse_error.has_value()) {
+            return std::unexpected(*parse_error);
         }
-
-        auto tail_or_error = NetworkMessageData<N - 1>::template ParseData<Tail...>(
-          data.subspan(*tail_offset_or_error));
-        if (!tail_or_error.has_value()) {
-            return std::unexpected(tail_or_error.error());
+        if (offset != data.size()) {
+            return std::unexpected(ParseError::BufferTooBig);
         }
-        std::tuple<Head> head_in_tuple{ *head_or_error };
-        return std::tuple_cat(head_in_tuple, *tail_or_error);
     }
 
-    template<typename Arg>
-    static typename std::enable_if<N == 1, std::expected<std::tuple<Arg>, ParseError>>::type
-    ParseData(std::span<const char> data)
+    return parameters;
+}
+} // namespace NetworkMessageDecoder
+} // namespace
+
+// Non-owning view of a serialized network message. Received messages are dispatched through it
+// straight from the transport's receive buffers, so the view must not outlive them.
+export class NetworkMessageView
+{
+public:
+    explicit NetworkMessageView(std::span<const char> data)
+        : data_(data)
     {
-        if (data.empty()) {
-            return std::unexpected(ParseError::BufferTooSmall);
-        }
+    }
 
-        auto last_parameter_size_or_error = ParseDataParameterSize<Arg>(data);
-        if (!last_parameter_size_or_error.has_value()) {
-            return std::unexpected(last_parameter_size_or_error.error());
-        }
-        auto last_parameter_size = *last_parameter_size_or_error;
-        if (data.size() > last_parameter_size) {
-            return std::unexpected(ParseError::BufferTooBig);
-        }
+    std::span<const char> GetData() const { return data_; }
 
-        auto parsed_or_error = ParseDataParameter<Arg>(data);
-        if (!parsed_or_error.has_value()) {
-            return std::unexpected(parsed_or_error.error());
-        }
+    template<typename... Args>
+    std::expected<std::tuple<Args...>, ParseError> Parse() const
+    {
+        return NetworkMessageDecoder::Decode<Args...>(data_);
+    }
 
-        return { *parsed_or_error };
+    std::expected<NetworkEvent, ParseError> GetNetworkEvent() const
+    {
+        auto parsed = NetworkMessageDecoder::Decode<NetworkEvent>(
+          data_.subspan(0, std::min(sizeof(NetworkEvent), data_.size())));
+        if (!parsed.has_value()) {
+            return std::unexpected(parsed.error());
+        }
+        auto [network_event] = *parsed;
+        return network_event;
     }
+
+private:
+    std::span<const char> data_;
 };
-} // namespace
 
 export class NetworkMessage
 {
@@ -222,6 +239,14 @@ public:
         data_.insert(data_.end(), text_bytes_to_append.begin(), text_bytes_to_append.end());
     }
 
+    template<HasPacketSchema Packet>
+    void AppendBytes(Packet packet)
+    {
+        NetworkBitWriter writer{ std::move(data_) };
+        PacketSchemaOf<Packet>::Type::Encode(packet, writer);
+        data_ = writer.TakeData();
+    }
+
     template<typename Head>
     void AppendBytes(Head head)
     {
@@ -235,31 +260,24 @@ public:
     template<typename... Args>
     static std::expected<std::tuple<Args...>, ParseError> ParseData(std::span<const char> data)
     {
-        return NetworkMessageData<sizeof...(Args)>::template ParseData<Args...>(data);
+        return NetworkMessageDecoder::Decode<Args...>(data);
     }
 
     template<typename... Args>
     std::expected<std::tuple<Args...>, ParseError> Parse() const
     {
-        return NetworkMessageData<sizeof...(Args)>::template ParseData<Args...>(data_);
+        return GetView().Parse<Args...>();
     }
 
     std::expected<NetworkEvent, ParseError> GetNetworkEvent() const
     {
-        if (data_.empty()) {
-            return std::unexpected(ParseError::BufferTooSmall);
-        }
-
-        std::span<const char> data{ data_ };
-        auto parsed = NetworkMessageData<1>::template ParseData<NetworkEvent>(
-          data.subspan(0, std::min(sizeof(NetworkEvent), data.size())));
-        if (!parsed.has_value()) {
-            return std::unexpected(parsed.error());
-        }
-        auto [network_event] = *parsed;
-        return network_event;
+        return GetView().GetNetworkEvent();
     }
 
+    NetworkMessageView GetView() const { return NetworkMessageView{ data_ }; }
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    operator NetworkMessageView() const { return GetView(); }
+
 private:
     std::vector<char> data_;
 };
@@ -9,6 +9,7 @@ import Shared.Core.Animations;
 import Shared.Core.Types.BulletType;
 import Shared.Core.Types.TeamType;
 import Shared.Core.Types.WeaponType;
+import Shared.Networking.PacketSchema;
 
 export namespace Soldank
 {
@@ -20,6 +21,9 @@ struct SoldierInputPacket
     std::uint32_t client_tick;
     // Authoritative server tick at which the control state must be simulated.
     std::uint32_t apply_server_tick;
+    // Server tick of the remote soldiers' states the client was drawing when it predicted this
+    // control state.
+    std::uint32_t view_server_tick;
     float position_x;
     float position_y;
     float mouse_map_position_x;
@@ -62,9 +66,55 @@ struct SoldierStatePacket
     std::int32_t jets_count;
     std::uint8_t active_weapon;
     std::uint32_t last_applied_input_id;
+    // Ticks between the snapshots the server currently sends to this client, so the client can
+    // delay its playback of remote soldiers before the longer gaps show up.
+    std::uint8_t snapshot_interval_ticks;
 };
 #pragma pack(pop)
 
+// Position, velocity and force are sent bit exact, the client compares them with its prediction
+// and replays its inputs from them. Old position is only used for drawing.
+template<>
+struct PacketSchemaOf<SoldierStatePacket>
+{
+    using Type = PacketSchema<
+      SoldierStatePacket,
+      FullRangeField<&SoldierStatePacket::server_tick>,
+      RangedField<&SoldierStatePacket::player_id, 0, 31>,
+      FloatField<&SoldierStatePacket::position_x>,
+      FloatField<&SoldierStatePacket::position_y>,
+      QuantizedFloatField<&SoldierStatePacket::old_position_x, -32768, 32767, 64>,
+      QuantizedFloatField<&SoldierStatePacket::old_position_y, -32768, 32767, 64>,
+      RangedField<&SoldierStatePacket::body_animation_type, 0, 63>,
+      RangedField<&SoldierStatePacket::body_animation_frame, 0, 255>,
+      RangedField<&SoldierStatePacket::body_animation_speed, 0, 255>,
+      RangedField<&SoldierStatePacket::body_animation_count, 0, 255>,
+      RangedField<&SoldierStatePacket::legs_animation_type, 0, 63>,
+      RangedField<&SoldierStatePacket::legs_animation_frame, 0, 255>,
+      RangedField<&SoldierStatePacket::legs_animation_speed, 0, 255>,
+      RangedField<&SoldierStatePacket::legs_animation_count, 0, 255>,
+      FloatField<&SoldierStatePacket::velocity_x>,
+      FloatField<&SoldierStatePacket::velocity_y>,
+      FloatField<&SoldierStatePacket::force_x>,
+      FloatField<&SoldierStatePacket::force_y>,
+      BoolField<&SoldierStatePacket::on_ground>,
+      BoolField<&SoldierStatePacket::on_ground_for_law>,
+      BoolField<&SoldierStatePacket::on_ground_last_frame>,
+      BoolField<&SoldierStatePacket::on_ground_permanent>,
+      RangedField<&SoldierStatePacket::old_direction, -1, 1>,
+      RangedField<&SoldierStatePacket::stance, 0, 3>,
+      QuantizedFloatField<&SoldierStatePacket::mouse_map_position_x, -32768, 32767, 1>,
+      QuantizedFloatField<&SoldierStatePacket::mouse_map_position_y, -32768, 32767, 1>,
+      BoolField<&SoldierStatePacket::using_jets>,
+      RangedField<&SoldierStatePacket::jets_count, 0, 65535>,
+      RangedField<&SoldierStatePacket::active_weapon, 0, 3>,
+      FullRangeField<&SoldierStatePacket::last_applied_input_id>,
+      RangedField<&SoldierStatePacket::snapshot_interval_ticks, 0, 3>>;
+};
+// Exact sizes, so that changing the schema in a way that grows the packets is noticed
+static_assert(PacketSchemaOf<SoldierStatePacket>::Type::BITS == 426);
+static_assert(PacketSchemaOf<SoldierStatePacket>::Type::BYTES == 54);
+
 #pragma pack(push, 1)
 struct SoldierInfoPacket
 {
@@ -88,4 +138,24 @@ struct ProjectileSpawnPacket
     std::uint8_t owner_id;
 };
 #pragma pack(pop)
+
+template<>
+struct PacketSchemaOf<ProjectileSpawnPacket>
+{
+    using Type = PacketSchema<
+      ProjectileSpawnPacket,
+      FullRangeField<&ProjectileSpawnPacket::projectile_id>,
+      RangedField<&ProjectileSpawnPacket::style, 0, 15>,
+      RangedField<&ProjectileSpawnPacket::weapon, 0, 31>,
+      QuantizedFloatField<&ProjectileSpawnPacket::position_x, -32768, 32767, 256>,
+      QuantizedFloatField<&ProjectileSpawnPacket::position_y, -32768, 32767, 256>,
+      QuantizedFloatField<&ProjectileSpawnPacket::velocity_x, -256, 255, 1024>,
+      QuantizedFloatField<&ProjectileSpawnPacket::velocity_y, -256, 255, 1024>,
+      RangedField<&ProjectileSpawnPacket::timeout, -32768, 32767>,
+      FloatField<&ProjectileSpawnPacket::hit_multiply>,
+      RangedField<&ProjectileSpawnPacket::team, 0, 7>,
+      FullRangeField<&ProjectileSpawnPacket::owner_id>>;
+};
+static_assert(PacketSchemaOf<ProjectileSpawnPacket>::Type::BITS == 170);
+static_assert(PacketSchemaOf<ProjectileSpawnPacket>::Type::BYTES == 22);
 } // namespace Soldank
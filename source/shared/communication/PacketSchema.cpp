@@ -0,0 +1,185 @@
+module;
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+export module Shared.Networking.PacketSchema;
+
+import Shared.Networking.NetworkBitStream;
+
+export namespace Soldank
+{
+namespace PacketSchemaDetail
+{
+template<auto Member>
+struct MemberTraits;
+
+template<typename Packet, typename Value, Value Packet::* Member>
+struct MemberTraits<Member>
+{
+    using PacketType = Packet;
+    using ValueType = Value;
+};
+
+template<typename Value>
+std::int64_t ToInteger(Value value)
+{
+    if constexpr (std::is_enum_v<Value>) {
+        return static_cast<std::int64_t>(static_cast<std::underlying_type_t<Value>>(value));
+    } else {
+        return static_cast<std::int64_t>(value);
+    }
+}
+
+template<typename Value>
+Value FromInteger(std::int64_t value)
+{
+    if constexpr (std::is_enum_v<Value>) {
+        return static_cast<Value>(static_cast<std::underlying_type_t<Value>>(value));
+    } else {
+        return static_cast<Value>(value);
+    }
+}
+} // namespace PacketSchemaDetail
+
+// Integer or enum member with values from Min to Max, stored as the offset from Min. Values out
+// of the range are clamped, on both sides of the link.
+template<auto Member, std::int64_t Min, std::int64_t Max>
+struct RangedField
+{
+    using PacketType = typename PacketSchemaDetail::MemberTraits<Member>::PacketType;
+    using ValueType = typename PacketSchemaDetail::MemberTraits<Member>::ValueType;
+
+    static_assert(Min <= Max);
+    static constexpr unsigned int BITS = std::bit_width(static_cast<std::uint64_t>(Max - Min));
+    static_assert(BITS <= 32, "Ranged fields are limited to 32 bits");
+
+    static void Write(NetworkBitWriter& writer, const PacketType& packet)
+    {
+        const std::int64_t value =
+          std::clamp(PacketSchemaDetail::ToInteger(packet.*Member), Min, Max);
+        writer.WriteBits(static_cast<std::uint32_t>(value - Min), BITS);
+    }
+
+    static void Read(NetworkBitReader& reader, PacketType& packet)
+    {
+        const std::int64_t value =
+          std::min(static_cast<std::int64_t>(reader.ReadBits(BITS)) + Min, Max);
+        packet.*Member = PacketSchemaDetail::FromInteger<ValueType>(value);
+    }
+};
+
+// Unsigned member that uses its whole width, e.g. ticks and sequence ids
+template<auto Member>
+using FullRangeField = RangedField<
+  Member,
+  0,
+  static_cast<std::int64_t>(
+    std::numeric_limits<typename PacketSchemaDetail::MemberTraits<Member>::ValueType>::max())>;
+
+template<auto Member>
+struct BoolField
+{
+    using PacketType = typename PacketSchemaDetail::MemberTraits<Member>::PacketType;
+
+    static constexpr unsigned int BITS = 1;
+
+    static void Write(NetworkBitWriter& writer, const PacketType& packet)
+    {
+        writer.WriteBool(packet.*Member);
+    }
+
+    static void Read(NetworkBitReader& reader, PacketType& packet)
+    {
+        packet.*Member = reader.ReadBool();
+    }
+};
+
+// Float member sent bit exact, for values the simulation is replayed from
+template<auto Member>
+struct FloatField
+{
+    using PacketType = typename PacketSchemaDetail::MemberTraits<Member>::PacketType;
+
+    static constexpr unsigned int BITS = 32;
+
+    static void Write(NetworkBitWriter& writer, const PacketType& packet)
+    {
+        writer.WriteBits(std::bit_cast<std::uint32_t>(packet.*Member), BITS);
+    }
+
+    static void Read(NetworkBitReader& reader, PacketType& packet)
+    {
+        packet.*Member = std::bit_cast<float>(reader.ReadBits(BITS));
+    }
+};
+
+// Float member from Min to Max rounded to 1 / StepsPerUnit. Values out of the range and NaNs are
+// clamped.
+template<auto Member, std::int32_t Min, std::int32_t Max, std::uint32_t StepsPerUnit>
+struct QuantizedFloatField
+{
+    using PacketType = typename PacketSchemaDetail::MemberTraits<Member>::PacketType;
+
+    static_assert(Min < Max && StepsPerUnit > 0);
+    static constexpr std::uint64_t STEPS_COUNT =
+      static_cast<std::uint64_t>(static_cast<std::int64_t>(Max) - Min) * StepsPerUnit;
+    static constexpr unsigned int BITS = std::bit_width(STEPS_COUNT);
+    static_assert(BITS <= 32, "Quantized fields are limited to 32 bits");
+
+    static void Write(NetworkBitWriter& writer, const PacketType& packet)
+    {
+        const float value = packet.*Member;
+        std::uint32_t step = 0;
+        if (value >= static_cast<float>(Max)) {
+            step = static_cast<std::uint32_t>(STEPS_COUNT);
+        } else if (value > static_cast<float>(Min)) {
+            step = static_cast<std::uint32_t>(
+              std::llround((static_cast<double>(value) - Min) * StepsPerUnit));
+        }
+        writer.WriteBits(step, BITS);
+    }
+
+    static void Read(NetworkBitReader& reader, PacketType& packet)
+    {
+        const std::uint64_t step = std::min<std::uint64_t>(reader.ReadBits(BITS), STEPS_COUNT);
+        packet.*Member =
+          static_cast<float>(Min + static_cast<double>(step) / static_cast<double>(StepsPerUnit));
+    }
+};
+
+// Bit-packed wire layout of a packet struct, listed field by field. The encoded size is known at
+// compile time, so schema packets are still decoded from constant offsets inside a message.
+template<typename Packet, typename... Fields>
+struct PacketSchema
+{
+    static_assert((std::is_same_v<typename Fields::PacketType, Packet> && ...),
+                  "All fields have to be members of the packet");
+
+    static constexpr std::size_t BITS = (Fields::BITS + ... + 0);
+    static constexpr std::size_t BYTES = (BITS + 7) / 8;
+
+    static void Encode(const Packet& packet, NetworkBitWriter& writer)
+    {
+        (Fields::Write(writer, packet), ...);
+    }
+
+    static void Decode(NetworkBitReader& reader, Packet& packet)
+    {
+        (Fields::Read(reader, packet), ...);
+    }
+};
+
+// Specialized next to a packet with a `Type` alias naming its PacketSchema. NetworkMessage
+// encodes packets that have one with the schema instead of copying their bytes.
+template<typename Packet>
+struct PacketSchemaOf;
+
+template<typename Packet>
+concept HasPacketSchema = requires { typename PacketSchemaOf<Packet>::Type; };
+} // namespace Soldank
@@ -20,6 +20,7 @@ PlayerInputCommand ToPlayerInputCommand(std::uint8_t soldier_id, const SoldierIn
         .input_sequence_id = packet.input_sequence_id,
         .client_tick = packet.client_tick,
         .apply_server_tick = packet.apply_server_tick,
+        .view_server_tick = packet.view_server_tick,
         .control = packet.control,
         .mouse_map_position = { packet.mouse_map_position_x, packet.mouse_map_position_y },
     };
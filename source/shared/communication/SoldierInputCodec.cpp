@@ -0,0 +1,160 @@
+module;
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "core/utility/Expected.hpp"
+
+export module Shared.Networking.SoldierInputCodec;
+
+import Shared.Core.State.Control;
+import Shared.Networking.NetworkBitStream;
+import Shared.Networking.NetworkEvent;
+import Shared.Networking.NetworkMessage;
+import Shared.Networking.NetworkPackets;
+
+export namespace Soldank
+{
+// Every SoldierInput message repeats the latest not yet acknowledged inputs, so the server can
+// still apply an input whose own datagram was lost
+constexpr std::size_t MAX_SOLDIER_INPUTS_PER_MESSAGE = 4;
+
+struct SoldierInputBatch
+{
+    std::array<SoldierInputPacket, MAX_SOLDIER_INPUTS_PER_MESSAGE> inputs;
+    std::size_t inputs_count;
+
+    std::span<const SoldierInputPacket> GetInputs() const
+    {
+        return std::span{ inputs }.first(inputs_count);
+    }
+};
+
+// SoldierInput message layout after the NetworkEvent:
+//   inputs count - 1 (2 bits)
+//   inputs from the oldest to the newest, each one delta encoded against the previous input
+//   (the first one against a zeroed input): sequence id, ticks and mouse aim as varints, control
+//   flags as a bit mask and positions as XOR float deltas. The view server tick is encoded
+//   against the input's own apply server tick, which it trails by a few ticks.
+namespace SoldierInputCodec
+{
+namespace Detail
+{
+constexpr unsigned int INPUTS_COUNT_BITS = 2;
+
+static_assert((1U << INPUTS_COUNT_BITS) == MAX_SOLDIER_INPUTS_PER_MESSAGE);
+
+std::int32_t TickDistance(std::uint32_t from, std::uint32_t to)
+{
+    return static_cast<std::int32_t>(to - from);
+}
+
+// Deltas wrap around like the tick distances, so no decoded delta can overflow the value
+std::int32_t ValueDelta(std::int32_t from, std::int32_t to)
+{
+    return TickDistance(static_cast<std::uint32_t>(from), static_cast<std::uint32_t>(to));
+}
+
+std::int32_t ApplyValueDelta(std::int32_t value, std::int32_t delta)
+{
+    return static_cast<std::int32_t>(static_cast<std::uint32_t>(value) +
+                                     static_cast<std::uint32_t>(delta));
+}
+
+void WriteInput(NetworkBitWriter& writer,
+                const SoldierInputPacket& input,
+                const SoldierInputPacket& previous)
+{
+    writer.WriteVarUInt(input.input_sequence_id - previous.input_sequence_id);
+    writer.WriteVarInt(TickDistance(previous.client_tick, input.client_tick));
+    writer.WriteVarInt(TickDistance(previous.apply_server_tick, input.apply_server_tick));
+    writer.WriteVarInt(TickDistance(input.apply_server_tick, input.view_server_tick));
+    writer.WriteFloatDelta(input.position_x, previous.position_x);
+    writer.WriteFloatDelta(input.position_y, previous.position_y);
+    writer.WriteFloatDelta(input.mouse_map_position_x, previous.mouse_map_position_x);
+    writer.WriteFloatDelta(input.mouse_map_position_y, previous.mouse_map_position_y);
+    writer.WriteBits(PackControlFlags(input.control), CONTROL_FLAGS_COUNT);
+    writer.WriteVarInt(ValueDelta(previous.control.mouse_aim_x, input.control.mouse_aim_x));
+    writer.WriteVarInt(ValueDelta(previous.control.mouse_aim_y, input.control.mouse_aim_y));
+    writer.WriteVarInt(ValueDelta(previous.control.mouse_dist, input.control.mouse_dist));
+}
+
+SoldierInputPacket ReadInput(NetworkBitReader& reader, const SoldierInputPacket& previous)
+{
+    SoldierInputPacket input{};
+    input.input_sequence_id = previous.input_sequence_id + reader.ReadVarUInt();
+    input.client_tick = previous.client_tick + static_cast<std::uint32_t>(reader.ReadVarInt());
+    input.apply_server_tick =
+      previous.apply_server_tick + static_cast<std::uint32_t>(reader.ReadVarInt());
+    input.view_server_tick =
+      input.apply_server_tick + static_cast<std::uint32_t>(reader.ReadVarInt());
+    input.position_x = reader.ReadFloatDelta(previous.position_x);
+    input.position_y = reader.ReadFloatDelta(previous.position_y);
+    input.mouse_map_position_x = reader.ReadFloatDelta(previous.mouse_map_position_x);
+    input.mouse_map_position_y = reader.ReadFloatDelta(previous.mouse_map_position_y);
+    UnpackControlFlags(reader.ReadBits(CONTROL_FLAGS_COUNT), input.control);
+    input.control.mouse_aim_x = ApplyValueDelta(previous.control.mouse_aim_x, reader.ReadVarInt());
+    input.control.mouse_aim_y = ApplyValueDelta(previous.control.mouse_aim_y, reader.ReadVarInt());
+    input.control.mouse_dist = ApplyValueDelta(previous.control.mouse_dist, reader.ReadVarInt());
+    return input;
+}
+} // namespace Detail
+
+// Encodes the last MAX_SOLDIER_INPUTS_PER_MESSAGE inputs. There has to be at least one input and
+// the inputs have to be ordered from the oldest to the newest.
+NetworkMessage Encode(std::span<const SoldierInputPacket> inputs)
+{
+    if (inputs.size() > MAX_SOLDIER_INPUTS_PER_MESSAGE) {
+        inputs = inputs.last(MAX_SOLDIER_INPUTS_PER_MESSAGE);
+    }
+
+    const auto network_event = std::to_underlying(NetworkEvent::SoldierInput);
+    std::vector<char> data(sizeof(network_event));
+    std::memcpy(data.data(), &network_event, sizeof(network_event));
+
+    NetworkBitWriter writer{ std::move(data) };
+    writer.WriteBits(static_cast<std::uint32_t>(inputs.size() - 1), Detail::INPUTS_COUNT_BITS);
+    SoldierInputPacket previous{};
+    for (const auto& input : inputs) {
+        Detail::WriteInput(writer, input, previous);
+        previous = input;
+    }
+
+    return { writer.GetData() };
+}
+
+std::expected<SoldierInputBatch, ParseError> Decode(NetworkMessageView network_message)
+{
+    auto network_event = network_message.GetNetworkEvent();
+    if (!network_event.has_value()) {
+        return std::unexpected(network_event.error());
+    }
+    if (*network_event != NetworkEvent::SoldierInput) {
+        return std::unexpected(ParseError::InvalidNetworkEvent);
+    }
+
+    NetworkBitReader reader{ network_message.GetData().subspan(sizeof(NetworkEvent)) };
+    SoldierInputBatch batch{};
+    batch.inputs_count = reader.ReadBits(Detail::INPUTS_COUNT_BITS) + 1;
+    SoldierInputPacket previous{};
+    for (std::size_t i = 0; i < batch.inputs_count; ++i) {
+        batch.inputs.at(i) = Detail::ReadInput(reader, previous);
+        previous = batch.inputs.at(i);
+    }
+
+    if (reader.IsOverflowed()) {
+        return std::unexpected(ParseError::BufferTooSmall);
+    }
+    if (reader.HasUnreadBytes()) {
+        return std::unexpected(ParseError::BufferTooBig);
+    }
+
+    return batch;
+}
+} // namespace SoldierInputCodec
+} // namespace Soldank
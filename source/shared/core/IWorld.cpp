@@ -69,5 +69,8 @@ public:
     virtual void SetPreProjectileSpawnCallback(TPreProjectileSpawnCallback callback) = 0;
 
     virtual void SetFPSLimit(int new_fps_limit) = 0;
+    // Server only. Clients simulate their inputs ahead of the server, so there is nothing to
+    // compensate for.
+    virtual void SetLagCompensationEnabled(bool is_enabled) = 0;
 };
 } // namespace Soldank
@@ -3,7 +3,8 @@ module;
 #include "spdlog/spdlog.h"
 
 #include <algorithm>
-#include <random>
+#include <array>
+#include <cstdint>
 #include <ranges>
 #include <memory>
 #include <stdexcept>
@@ -18,8 +19,11 @@ export module Shared.Core.World;
 import Extern.Glm;
 
 import Shared.Core.IWorld;
+import Shared.Core.Data.FileReader;
+import Shared.Core.Data.IFileReader;
 import Shared.Core.WorldEvents;
 import Shared.Core.Physics.BulletPhysics;
+import Shared.Core.Physics.HitboxHistory;
 import Shared.Core.Physics.ItemPhysics;
 import Shared.Core.Physics.SoldierPhysics;
 import Shared.Core.Physics.SoldierSkeletonPhysics;
@@ -43,6 +47,8 @@ import Shared.Core.Physics.Particles;
 import Shared.Core.State.Control;
 import Shared.Core.Entities.WeaponParametersFactory;
 import Shared.Core.Types.WeaponType;
+import Shared.Core.Utility.FrameProfiler;
+import Shared.Core.Utility.SerialNumber;
 import Shared.Core.Utility.VisitHelper;
 
 export namespace Soldank
@@ -50,14 +56,20 @@ export namespace Soldank
 class World final : public IWorld
 {
 public:
-    World()
-
+    // Every shared simulation asset (animations, skeletons, weapon INIs and maps) is read
+    // through file_reader, so e.g. a PackFileReader can serve all of them from one file
+    explicit World(std::shared_ptr<const IFileReader> file_reader = std::make_shared<FileReader>())
         : physics_events_(std::make_unique<PhysicsEvents>())
         , world_events_(std::make_unique<WorldEvents>())
         , fps_limit_(0)
     {
-        animation_data_manager_.LoadAllAnimationDatas();
-        state_manager_ = std::make_shared<StateManager>(animation_data_manager_);
+        // Weapon parameters are cached on the first access, State's constructor relies on that
+        static_cast<void>(
+          WeaponParametersFactory::GetParameters(WeaponType::DesertEagles, false, *file_reader));
+        animation_data_manager_.LoadAllAnimationDatas(*file_reader);
+        auto skeleton = ParticleSystem::Load(ParticleSystemType::Soldier, 4.5F, *file_reader);
+        state_manager_ = std::make_shared<StateManager>(
+          animation_data_manager_, std::move(skeleton), std::move(file_reader));
     }
 
     void RunLoop() final
@@ -74,6 +86,7 @@ public:
               },
             .before_frame =
               [&]() {
+                  GetFrameProfiler().BeginFrame();
                   if (pre_game_loop_iteration_callback_) {
                       pre_game_loop_iteration_callback_();
                   }
@@ -91,6 +104,7 @@ public:
                       .player_inputs = player_inputs,
                       .commands = commands,
                   };
+                  ScopedProfilerZone tick_zone(GetFrameProfiler(), "Simulation tick");
                   static_cast<void>(Tick(input));
               },
             .after_tick =
@@ -105,6 +119,7 @@ public:
                   if (post_game_loop_iteration_callback_) {
                       post_game_loop_iteration_callback_(*state_manager_, frame_percent, last_fps);
                   }
+                  GetFrameProfiler().EndFrame();
               },
             .report_stats =
               [](int frame_count_since_last_fps_check, int world_updates) {
@@ -121,10 +136,15 @@ public:
     WorldTickResult Tick(const WorldTickInput& input) final
     {
         pending_simulation_events_.clear();
+        if (last_tick_.has_value() && input.tick != *last_tick_ + 1) {
+            hitbox_history_.Clear();
+        }
+        last_tick_ = input.tick;
         state_manager_->SetGameTick(input.tick);
 
         for (const auto& player_input : input.player_inputs) {
             ApplyPlayerInputCommand(*state_manager_, player_input);
+            UpdateLagCompensationTicks(player_input, input.tick);
         }
 
         for (const auto& command : input.commands) {
@@ -165,12 +185,24 @@ public:
             }
         });
 
+        if (is_lag_compensation_enabled_) {
+            hitbox_history_.Record(state_manager_->GetGameTick(), *state_manager_);
+        }
+
         state_manager_->TransformBullets([&](auto& bullet) {
-            BulletPhysics::UpdateBullet(
-              *physics_events_, bullet, state_manager_->GetMap(), *state_manager_);
+            BulletPhysics::UpdateBullet(*physics_events_,
+                                        bullet,
+                                        state_manager_->GetMap(),
+                                        *state_manager_,
+                                        hitbox_history_);
         });
 
-        for (const auto& bullet_params : state_manager_->GetBulletEmitter()) {
+        for (auto bullet_params : state_manager_->GetBulletEmitter()) {
+            if (is_lag_compensation_enabled_ && bullet_params.owner_id < MAX_SOLDIERS_COUNT) {
+                bullet_params.lag_compensation_ticks =
+                  soldier_lag_compensation_ticks_.at(bullet_params.owner_id);
+            }
+
             bool should_spawn_projectile = false;
             if (pre_projectile_spawn_callback_) {
                 should_spawn_projectile = pre_projectile_spawn_callback_(bullet_params);
@@ -376,7 +408,36 @@ public:
 
     void SetFPSLimit(int new_fps_limit) final { fps_limit_ = new_fps_limit; }
 
+    void SetLagCompensationEnabled(bool is_enabled) final
+    {
+        is_lag_compensation_enabled_ = is_enabled;
+        soldier_lag_compensation_ticks_.fill(0);
+        hitbox_history_.Clear();
+    }
+
 private:
+    // The player aimed at remote soldiers as they were at view_server_tick, so the bullets the
+    // input fires are tested against targets as they were back then. The claimed view is trusted
+    // up to MAX_LAG_COMPENSATION_VIEW_DELAY_TICKS before apply_server_tick, and an input that
+    // arrives late is rewound further by its lateness, as far back as the hitbox history goes.
+    void UpdateLagCompensationTicks(const PlayerInputCommand& player_input, std::uint32_t tick)
+    {
+        if (!is_lag_compensation_enabled_ || player_input.soldier_id >= MAX_SOLDIERS_COUNT) {
+            return;
+        }
+
+        const std::int64_t late_ticks =
+          SerialNumberSignedDistance(player_input.apply_server_tick, tick);
+        const std::int64_t view_delay_ticks = std::clamp<std::int64_t>(
+          SerialNumberSignedDistance(player_input.view_server_tick,
+                                     player_input.apply_server_tick),
+          0,
+          MAX_LAG_COMPENSATION_VIEW_DELAY_TICKS);
+        soldier_lag_compensation_ticks_.at(player_input.soldier_id) =
+          static_cast<std::uint8_t>(std::clamp<std::int64_t>(
+            late_ticks + view_delay_ticks, 0, MAX_LAG_COMPENSATION_TICKS));
+    }
+
     void ApplySimulationCommand(const SimulationCommand& command)
     {
         std::visit(
@@ -414,6 +475,11 @@ private:
 
     int fps_limit_;
     std::vector<SimulationEvent> pending_simulation_events_;
+
+    bool is_lag_compensation_enabled_ = false;
+    HitboxHistory hitbox_history_;
+    std::array<std::uint8_t, MAX_SOLDIERS_COUNT> soldier_lag_compensation_ticks_{};
+    std::optional<std::uint32_t> last_tick_;
 };
 
 } // namespace Soldank
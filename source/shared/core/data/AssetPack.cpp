@@ -0,0 +1,502 @@
+module;
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif !defined(__EMSCRIPTEN__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "core/utility/Expected.hpp"
+
+export module Shared.Core.Data.AssetPack;
+
+import Shared.Core.Data.IFileWriter;
+import Shared.Core.Data.FileWriter;
+
+export namespace Soldank
+{
+// Asset pack layout (little-endian, like PMS maps):
+//   AssetPackHeader
+//   AssetPackIndexEntry[entries_count], sorted by (path_hash, path)
+//   asset paths, concatenated without separators
+//   asset data, every blob aligned to ASSET_PACK_DATA_ALIGNMENT
+constexpr std::array<char, 8> ASSET_PACK_MAGIC{ 'S', 'D', 'K', 'P', 'A', 'C', 'K', '\0' };
+constexpr std::uint32_t ASSET_PACK_VERSION = 1;
+constexpr std::uint64_t ASSET_PACK_DATA_ALIGNMENT = 16;
+
+struct AssetPackHeader
+{
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t entries_count;
+    std::uint64_t index_offset;
+    std::uint64_t paths_offset;
+    std::uint64_t paths_size;
+    std::uint64_t file_size;
+    // CRC32 of the index and the path table
+    std::uint32_t index_checksum;
+    // CRC32 of every header field above
+    std::uint32_t header_checksum;
+};
+
+struct AssetPackIndexEntry
+{
+    std::uint64_t path_hash;
+    std::uint64_t data_offset;
+    std::uint64_t data_size;
+    std::uint32_t path_offset;
+    std::uint32_t path_size;
+    // CRC32 of the asset data
+    std::uint32_t checksum;
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(AssetPackHeader) == 56);
+static_assert(sizeof(AssetPackIndexEntry) == 40);
+static_assert(std::is_trivially_copyable_v<AssetPackHeader>);
+static_assert(std::is_trivially_copyable_v<AssetPackIndexEntry>);
+
+enum class AssetPackError
+{
+    NoError = 0,
+    FileNotFound,
+    MappingFailed,
+    InvalidHeader,
+    UnsupportedVersion,
+    CorruptedIndex,
+    ChecksumMismatch
+};
+
+enum class AssetPackVerification
+{
+    // Header and index are validated, asset data is trusted until it's read
+    IndexOnly = 0,
+    // Additionally checks the checksum of every asset, touches every page of the pack
+    Full
+};
+
+std::uint32_t ComputeAssetChecksum(std::span<const std::byte> data)
+{
+    static constexpr std::array<std::uint32_t, 256> CRC32_TABLE = [] {
+        std::array<std::uint32_t, 256> table{};
+        for (std::uint32_t i = 0; i < table.size(); ++i) {
+            std::uint32_t value = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                value = (value & 1U) != 0 ? 0xEDB88320U ^ (value >> 1U) : value >> 1U;
+            }
+            table.at(i) = value;
+        }
+        return table;
+    }();
+
+    std::uint32_t crc = 0xFFFFFFFFU;
+    for (std::byte byte : data) {
+        crc = CRC32_TABLE[(crc ^ std::to_integer<std::uint32_t>(byte)) & 0xFFU] ^ (crc >> 8U);
+    }
+    return crc ^ 0xFFFFFFFFU;
+}
+
+std::string NormalizeAssetPath(std::string_view asset_path)
+{
+    std::string normalized_path{ asset_path };
+    std::ranges::replace(normalized_path, '\\', '/');
+    while (normalized_path.starts_with("./")) {
+        normalized_path.erase(0, 2);
+    }
+    return normalized_path;
+}
+
+// FNV-1a, expects an already normalized path
+std::uint64_t HashAssetPath(std::string_view normalized_asset_path)
+{
+    std::uint64_t hash = 0xCBF29CE484222325ULL;
+    for (char character : normalized_asset_path) {
+        hash ^= static_cast<unsigned char>(character);
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+class AssetPack
+{
+public:
+    static std::expected<AssetPack, AssetPackError> Open(
+      const std::filesystem::path& pack_path,
+      AssetPackVerification verification = AssetPackVerification::IndexOnly)
+    {
+        auto mapped_file = MapFile(pack_path);
+        if (!mapped_file.has_value()) {
+            return std::unexpected(mapped_file.error());
+        }
+
+        return FromStorage(std::move(mapped_file->first), mapped_file->second, verification);
+    }
+
+    static std::expected<AssetPack, AssetPackError> FromBuffer(
+      std::vector<std::byte> pack_data,
+      AssetPackVerification verification = AssetPackVerification::IndexOnly)
+    {
+        auto buffer = std::make_shared<std::vector<std::byte>>(std::move(pack_data));
+        const std::size_t size = buffer->size();
+        std::shared_ptr<const std::byte> storage(buffer, buffer->data());
+        return FromStorage(std::move(storage), size, verification);
+    }
+
+    std::optional<std::span<const std::byte>> Find(std::string_view asset_path) const
+    {
+        const std::string normalized_path = NormalizeAssetPath(asset_path);
+        const std::uint64_t path_hash = HashAssetPath(normalized_path);
+
+        auto entry_it =
+          std::ranges::lower_bound(entries_, path_hash, {}, &AssetPackIndexEntry::path_hash);
+        for (; entry_it != entries_.end() && entry_it->path_hash == path_hash; ++entry_it) {
+            if (GetEntryPath(*entry_it) == normalized_path) {
+                return GetEntryData(*entry_it);
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    bool Contains(std::string_view asset_path) const { return Find(asset_path).has_value(); }
+
+    std::vector<std::string_view> GetAssetPaths() const
+    {
+        std::vector<std::string_view> asset_paths;
+        asset_paths.reserve(entries_.size());
+        for (const auto& entry : entries_) {
+            asset_paths.push_back(GetEntryPath(entry));
+        }
+        return asset_paths;
+    }
+
+    std::size_t GetAssetsCount() const { return entries_.size(); }
+
+    std::span<const std::byte> GetBytes() const { return { storage_.get(), size_ }; }
+
+private:
+    AssetPack(std::shared_ptr<const std::byte> storage,
+              std::size_t size,
+              std::uint64_t paths_offset,
+              std::vector<AssetPackIndexEntry> entries)
+        : storage_(std::move(storage))
+        , size_(size)
+        , paths_offset_(paths_offset)
+        , entries_(std::move(entries))
+    {
+    }
+
+    static std::expected<AssetPack, AssetPackError> FromStorage(
+      std::shared_ptr<const std::byte> storage,
+      std::size_t size,
+      AssetPackVerification verification)
+    {
+        const std::span<const std::byte> bytes{ storage.get(), size };
+
+        AssetPackHeader header{};
+        if (bytes.size() < sizeof(AssetPackHeader)) {
+            return std::unexpected(AssetPackError::InvalidHeader);
+        }
+        std::memcpy(&header, bytes.data(), sizeof(AssetPackHeader));
+
+        if (header.magic != ASSET_PACK_MAGIC) {
+            return std::unexpected(AssetPackError::InvalidHeader);
+        }
+        if (header.version != ASSET_PACK_VERSION) {
+            return std::unexpected(AssetPackError::UnsupportedVersion);
+        }
+        if (header.header_checksum !=
+            ComputeAssetChecksum(bytes.first(offsetof(AssetPackHeader, header_checksum)))) {
+            return std::unexpected(AssetPackError::ChecksumMismatch);
+        }
+        if (header.file_size != bytes.size()) {
+            return std::unexpected(AssetPackError::InvalidHeader);
+        }
+
+        const std::uint64_t index_size =
+          static_cast<std::uint64_t>(header.entries_count) * sizeof(AssetPackIndexEntry);
+        if (header.index_offset < sizeof(AssetPackHeader) ||
+            !IsRangeInside(header.index_offset, index_size, bytes.size()) ||
+            header.paths_offset < header.index_offset + index_size ||
+            !IsRangeInside(header.paths_offset, header.paths_size, bytes.size())) {
+            return std::unexpected(AssetPackError::CorruptedIndex);
+        }
+
+        const auto index_and_paths =
+          bytes.subspan(header.index_offset,
+                        header.paths_offset + header.paths_size - header.index_offset);
+        if (header.index_checksum != ComputeAssetChecksum(index_and_paths)) {
+            return std::unexpected(AssetPackError::ChecksumMismatch);
+        }
+
+        // The index is copied out of the pack, so it never has to be accessed through a
+        // misaligned or type-punned pointer. Asset data itself stays in the mapping.
+        std::vector<AssetPackIndexEntry> entries(header.entries_count);
+        if (!entries.empty()) {
+            std::memcpy(entries.data(), bytes.data() + header.index_offset, index_size);
+        }
+
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            const auto& entry = entries[i];
+            if (!IsRangeInside(entry.path_offset, entry.path_size, header.paths_size) ||
+                !IsRangeInside(entry.data_offset, entry.data_size, bytes.size())) {
+                return std::unexpected(AssetPackError::CorruptedIndex);
+            }
+            if (i > 0 && entries[i - 1].path_hash > entry.path_hash) {
+                return std::unexpected(AssetPackError::CorruptedIndex);
+            }
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            const std::string_view entry_path{ reinterpret_cast<const char*>(
+                                                 bytes.data() + header.paths_offset +
+                                                 entry.path_offset),
+                                               entry.path_size };
+            if (HashAssetPath(entry_path) != entry.path_hash) {
+                return std::unexpected(AssetPackError::CorruptedIndex);
+            }
+
+            if (verification == AssetPackVerification::Full &&
+                ComputeAssetChecksum(bytes.subspan(entry.data_offset, entry.data_size)) !=
+                  entry.checksum) {
+                return std::unexpected(AssetPackError::ChecksumMismatch);
+            }
+        }
+
+        return AssetPack(std::move(storage), size, header.paths_offset, std::move(entries));
+    }
+
+    static bool IsRangeInside(std::uint64_t offset, std::uint64_t size, std::uint64_t total_size)
+    {
+        return offset <= total_size && size <= total_size - offset;
+    }
+
+    std::string_view GetEntryPath(const AssetPackIndexEntry& entry) const
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        return { reinterpret_cast<const char*>(storage_.get() + paths_offset_ + entry.path_offset),
+                 entry.path_size };
+    }
+
+    std::span<const std::byte> GetEntryData(const AssetPackIndexEntry& entry) const
+    {
+        return { storage_.get() + entry.data_offset, entry.data_size };
+    }
+
+    using MappedFile = std::pair<std::shared_ptr<const std::byte>, std::size_t>;
+
+    static std::expected<MappedFile, AssetPackError> MapFile(const std::filesystem::path& pack_path)
+    {
+        std::error_code error_code;
+        const auto file_size = std::filesystem::file_size(pack_path, error_code);
+        if (error_code) {
+            return std::unexpected(AssetPackError::FileNotFound);
+        }
+        if (file_size < sizeof(AssetPackHeader)) {
+            return std::unexpected(AssetPackError::InvalidHeader);
+        }
+
+#if defined(_WIN32)
+        HANDLE file_handle = CreateFileW(pack_path.c_str(),
+                                         GENERIC_READ,
+                                         FILE_SHARE_READ,
+                                         nullptr,
+                                         OPEN_EXISTING,
+                                         FILE_ATTRIBUTE_NORMAL,
+                                         nullptr);
+        if (file_handle == INVALID_HANDLE_VALUE) {
+            return std::unexpected(AssetPackError::FileNotFound);
+        }
+        HANDLE mapping_handle =
+          CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file_handle);
+        if (mapping_handle == nullptr) {
+            return std::unexpected(AssetPackError::MappingFailed);
+        }
+        void* address = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+        // The view keeps the mapping object alive
+        CloseHandle(mapping_handle);
+        if (address == nullptr) {
+            return std::unexpected(AssetPackError::MappingFailed);
+        }
+
+        std::shared_ptr<const std::byte> storage(
+          static_cast<const std::byte*>(address),
+          [](const std::byte* mapped_address) { UnmapViewOfFile(mapped_address); });
+        return MappedFile{ std::move(storage), static_cast<std::size_t>(file_size) };
+#elif defined(__EMSCRIPTEN__)
+        // The browser's virtual file system is already in memory, a plain read is enough
+        std::ifstream pack_file(pack_path, std::ios::in | std::ios::binary);
+        if (!pack_file.is_open()) {
+            return std::unexpected(AssetPackError::FileNotFound);
+        }
+        auto buffer = std::make_shared<std::vector<std::byte>>(file_size);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        if (!pack_file.read(reinterpret_cast<char*>(buffer->data()),
+                            static_cast<std::streamsize>(buffer->size()))) {
+            return std::unexpected(AssetPackError::MappingFailed);
+        }
+        std::shared_ptr<const std::byte> storage(buffer, buffer->data());
+        return MappedFile{ std::move(storage), buffer->size() };
+#else
+        const int file_descriptor = open(pack_path.c_str(), O_RDONLY);
+        if (file_descriptor < 0) {
+            return std::unexpected(AssetPackError::FileNotFound);
+        }
+        const auto mapped_size = static_cast<std::size_t>(file_size);
+        void* address = mmap(nullptr, mapped_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+        // The mapping stays valid after the descriptor is closed
+        close(file_descriptor);
+        if (address == MAP_FAILED) {
+            return std::unexpected(AssetPackError::MappingFailed);
+        }
+
+        std::shared_ptr<const std::byte> storage(
+          static_cast<const std::byte*>(address), [mapped_size](const std::byte* mapped_address) {
+              // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+              munmap(const_cast<std::byte*>(mapped_address), mapped_size);
+          });
+        return MappedFile{ std::move(storage), mapped_size };
+#endif
+    }
+
+    std::shared_ptr<const std::byte> storage_;
+    std::size_t size_;
+    std::uint64_t paths_offset_;
+    std::vector<AssetPackIndexEntry> entries_;
+};
+
+class AssetPackBuilder
+{
+public:
+    // Adding the same path twice replaces the previous data
+    void AddAsset(std::string_view asset_path, std::string_view data)
+    {
+        assets_.insert_or_assign(NormalizeAssetPath(asset_path), std::string{ data });
+    }
+
+    std::size_t GetAssetsCount() const { return assets_.size(); }
+
+    std::vector<std::byte> Build() const
+    {
+        struct PendingEntry
+        {
+            std::uint64_t path_hash;
+            const std::string* path;
+            const std::string* data;
+        };
+
+        std::vector<PendingEntry> pending_entries;
+        pending_entries.reserve(assets_.size());
+        for (const auto& [path, data] : assets_) {
+            pending_entries.push_back({ HashAssetPath(path), &path, &data });
+        }
+        std::ranges::sort(pending_entries, [](const auto& lhs, const auto& rhs) {
+            if (lhs.path_hash != rhs.path_hash) {
+                return lhs.path_hash < rhs.path_hash;
+            }
+            return *lhs.path < *rhs.path;
+        });
+
+        AssetPackHeader header{};
+        header.magic = ASSET_PACK_MAGIC;
+        header.version = ASSET_PACK_VERSION;
+        header.entries_count = static_cast<std::uint32_t>(pending_entries.size());
+        header.index_offset = sizeof(AssetPackHeader);
+        header.paths_offset =
+          header.index_offset + pending_entries.size() * sizeof(AssetPackIndexEntry);
+
+        std::vector<AssetPackIndexEntry> entries;
+        entries.reserve(pending_entries.size());
+        std::string paths;
+        for (const auto& pending_entry : pending_entries) {
+            AssetPackIndexEntry entry{};
+            entry.path_hash = pending_entry.path_hash;
+            entry.path_offset = static_cast<std::uint32_t>(paths.size());
+            entry.path_size = static_cast<std::uint32_t>(pending_entry.path->size());
+            entry.data_size = pending_entry.data->size();
+            entry.checksum = ComputeAssetChecksum(std::as_bytes(std::span{ *pending_entry.data }));
+            paths += *pending_entry.path;
+            entries.push_back(entry);
+        }
+        header.paths_size = paths.size();
+
+        std::uint64_t data_offset = AlignUp(header.paths_offset + header.paths_size);
+        for (auto& entry : entries) {
+            entry.data_offset = data_offset;
+            data_offset = AlignUp(data_offset + entry.data_size);
+        }
+        header.file_size = data_offset;
+
+        std::vector<std::byte> pack_data(header.file_size);
+        if (!entries.empty()) {
+            std::memcpy(pack_data.data() + header.index_offset,
+                        entries.data(),
+                        entries.size() * sizeof(AssetPackIndexEntry));
+        }
+        if (!paths.empty()) {
+            std::memcpy(pack_data.data() + header.paths_offset, paths.data(), paths.size());
+        }
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            const std::string& data = *pending_entries[i].data;
+            if (!data.empty()) {
+                std::memcpy(pack_data.data() + entries[i].data_offset, data.data(), data.size());
+            }
+        }
+
+        header.index_checksum = ComputeAssetChecksum(
+          std::span{ pack_data }.subspan(header.index_offset,
+                                         header.paths_offset + header.paths_size -
+                                           header.index_offset));
+        std::memcpy(pack_data.data(), &header, sizeof(AssetPackHeader));
+        header.header_checksum = ComputeAssetChecksum(
+          std::span{ pack_data }.first(offsetof(AssetPackHeader, header_checksum)));
+        std::memcpy(pack_data.data(), &header, sizeof(AssetPackHeader));
+
+        return pack_data;
+    }
+
+    FileWriterError Write(
+      const std::filesystem::path& pack_path,
+      std::shared_ptr<IFileWriter> file_writer = std::make_shared<FileWriter>()) const
+    {
+        const auto pack_data = Build();
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        auto error = file_writer->AppendData(reinterpret_cast<const char*>(pack_data.data()),
+                                             static_cast<std::streamsize>(pack_data.size()));
+        if (error != FileWriterError::NoError) {
+            return error;
+        }
+
+        return file_writer->Write(pack_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    }
+
+private:
+    static std::uint64_t AlignUp(std::uint64_t value)
+    {
+        return (value + ASSET_PACK_DATA_ALIGNMENT - 1) / ASSET_PACK_DATA_ALIGNMENT *
+               ASSET_PACK_DATA_ALIGNMENT;
+    }
+
+    std::map<std::string, std::string> assets_;
+};
+} // namespace Soldank
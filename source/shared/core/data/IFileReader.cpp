@@ -1,7 +1,10 @@
 module;
 
+#include <cstddef>
 #include <string>
 #include <ios>
+#include <optional>
+#include <span>
 
 #include "core/utility/Expected.hpp"
 
@@ -22,5 +25,13 @@ public:
     virtual std::expected<std::string, FileReaderError> Read(
       const std::string& file_path,
       std::ios_base::openmode mode = std::ios_base::in) const = 0;
+
+    // Readers backed by memory (e.g. a mapped asset pack) can expose the file contents without
+    // copying them. The view stays valid for as long as the reader is alive.
+    virtual std::optional<std::span<const std::byte>> ReadView(
+      const std::string& /*file_path*/) const
+    {
+        return std::nullopt;
+    }
 };
 } // namespace Soldank
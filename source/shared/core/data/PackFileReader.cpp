@@ -0,0 +1,62 @@
+module;
+
+#include <cstddef>
+#include <ios>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+
+#include "core/utility/Expected.hpp"
+
+export module Shared.Core.Data.PackFileReader;
+
+import Shared.Core.Data.AssetPack;
+import Shared.Core.Data.IFileReader;
+
+export namespace Soldank
+{
+class PackFileReader : public IFileReader
+{
+public:
+    // Files missing from the pack are read with fallback_file_reader if one is given
+    explicit PackFileReader(AssetPack asset_pack,
+                            std::shared_ptr<const IFileReader> fallback_file_reader = nullptr)
+        : asset_pack_(std::move(asset_pack))
+        , fallback_file_reader_(std::move(fallback_file_reader))
+    {
+    }
+
+    std::expected<std::string, FileReaderError> Read(
+      const std::string& file_path,
+      std::ios_base::openmode mode = std::ios_base::in) const override
+    {
+        auto asset_data = asset_pack_.Find(file_path);
+        if (!asset_data.has_value()) {
+            if (fallback_file_reader_ != nullptr) {
+                return fallback_file_reader_->Read(file_path, mode);
+            }
+            return std::unexpected(FileReaderError::FileNotFound);
+        }
+
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        return std::string(reinterpret_cast<const char*>(asset_data->data()), asset_data->size());
+    }
+
+    std::optional<std::span<const std::byte>> ReadView(const std::string& file_path) const override
+    {
+        auto asset_data = asset_pack_.Find(file_path);
+        if (!asset_data.has_value() && fallback_file_reader_ != nullptr) {
+            return fallback_file_reader_->ReadView(file_path);
+        }
+        return asset_data;
+    }
+
+    const AssetPack& GetAssetPack() const { return asset_pack_; }
+
+private:
+    AssetPack asset_pack_;
+    std::shared_ptr<const IFileReader> fallback_file_reader_;
+};
+} // namespace Soldank
@@ -24,6 +24,8 @@ struct BulletParams
     TeamType team;
     std::uint8_t owner_id;
     float push;
+    // How many ticks back the owner saw its targets, they are tested where they were back then
+    std::uint8_t lag_compensation_ticks = 0;
 };
 
 struct Bullet
@@ -54,6 +56,7 @@ struct Bullet
         , hit_multiply(params.hit_multiply)
         , hit_multiply_prev(params.hit_multiply)
         , push(params.push)
+        , lag_compensation_ticks(params.lag_compensation_ticks)
     {
     }
 
@@ -72,5 +75,6 @@ struct Bullet
     float hit_multiply_prev{};
     std::uint32_t degrade_count = 0;
     float push{};
+    std::uint8_t lag_compensation_ticks{};
 };
 } // namespace Soldank
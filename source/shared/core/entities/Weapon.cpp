@@ -57,6 +57,7 @@ public:
     std::uint16_t GetReloadTimeCount() const { return reload_time_count_; };
 
     std::uint8_t GetAmmoCount() const { return ammo_count_; }
+    void SetAmmoCount(std::uint8_t ammo_count) { ammo_count_ = ammo_count; }
     std::uint16_t GetClipInTime() const { return clip_in_time_; }
     std::uint16_t GetClipOutTime() const { return clip_out_time_; }
 
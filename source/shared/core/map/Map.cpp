@@ -2,6 +2,7 @@ module;
 
 #include <array>
 #include <cmath>
+#include <cstddef>
 #include <filesystem>
 #include <memory>
 #include <optional>
@@ -25,6 +26,11 @@ import Shared.Core.Map.PMSStructs;
 
 import Shared.Core.Utility.Observable;
 
+namespace Soldank
+{
+class PMSDataReader;
+} // namespace Soldank
+
 export namespace Soldank
 {
 struct MapData
@@ -106,6 +112,9 @@ public:
     void LoadMap(const std::filesystem::path& map_path,
                  const IFileReader& file_reader = FileReader());
 
+    // Parses PMS data in place, map_data only has to stay alive for the duration of the call
+    void LoadMap(const std::filesystem::path& map_path, std::span<const std::byte> map_data);
+
     void SaveMap(const std::filesystem::path& map_path,
                  std::shared_ptr<IFileWriter> file_writer = std::make_shared<FileWriter>()) const;
 
@@ -338,19 +347,19 @@ private:
     MapData map_data_;
     MapChangeEvents map_change_events_;
 
-    void ReadPolygonsFromBuffer(std::stringstream& buffer);
+    void ReadPolygonsFromBuffer(PMSDataReader& buffer);
 
-    void ReadSectorsFromBuffer(std::stringstream& buffer);
+    void ReadSectorsFromBuffer(PMSDataReader& buffer);
 
-    void ReadSceneryInstancesFromBuffer(std::stringstream& buffer);
+    void ReadSceneryInstancesFromBuffer(PMSDataReader& buffer);
 
-    void ReadSceneryTypesFromBuffer(std::stringstream& buffer);
+    void ReadSceneryTypesFromBuffer(PMSDataReader& buffer);
 
-    void ReadCollidersFromBuffer(std::stringstream& buffer);
+    void ReadCollidersFromBuffer(PMSDataReader& buffer);
 
-    void ReadSpawnPointsFromBuffer(std::stringstream& buffer);
+    void ReadSpawnPointsFromBuffer(PMSDataReader& buffer);
 
-    void ReadWayPointsFromBuffer(std::stringstream& buffer);
+    void ReadWayPointsFromBuffer(PMSDataReader& buffer);
 
     void AppendPolygonsToFileWriter(std::shared_ptr<IFileWriter>& file_writer) const;
 
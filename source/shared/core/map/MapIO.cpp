@@ -3,6 +3,7 @@ module;
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstddef>
 #include <cstring>
 #include <cstdint>
 #include <filesystem>
@@ -12,7 +13,6 @@ module;
 #include <optional>
 #include <span>
 #include <stdexcept>
-#include <sstream>
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -36,33 +36,6 @@ import Shared.Core.Utility.Observable;
 
 namespace
 {
-constexpr std::size_t MAX_SERIALIZED_COLLECTION_COUNT = 100000;
-
-template<typename DataType>
-void ReadValue(std::stringstream& buffer, DataType& value)
-{
-    static_assert(std::is_trivially_copyable_v<DataType>);
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-    if (!buffer.read(reinterpret_cast<char*>(&value), sizeof(DataType))) {
-        throw std::runtime_error("Unexpected end of PMS map data");
-    }
-}
-
-void ReadFixedString(std::stringstream& buffer, std::string& value, std::size_t max_size)
-{
-    unsigned char string_size = 0;
-    ReadValue(buffer, string_size);
-    if (string_size > max_size) {
-        throw std::runtime_error("PMS string length exceeds its fixed-width field");
-    }
-
-    std::vector<char> bytes(max_size);
-    if (!buffer.read(bytes.data(), static_cast<std::streamsize>(bytes.size()))) {
-        throw std::runtime_error("Unexpected end of PMS string data");
-    }
-    value.assign(bytes.data(), string_size);
-}
-
 template<typename DataType>
 void AppendValue(std::shared_ptr<Soldank::IFileWriter>& file_writer, const DataType& data)
 {
@@ -97,24 +70,6 @@ void AppendFixedString(std::shared_ptr<Soldank::IFileWriter>& file_writer,
     }
 }
 
-template<typename DataType>
-void ReadCollection(std::stringstream& buffer,
-                    std::vector<DataType>& values,
-                    std::size_t max_count = MAX_SERIALIZED_COLLECTION_COUNT)
-{
-    std::uint32_t count = 0;
-    ReadValue(buffer, count);
-    if (count > max_count) {
-        throw std::runtime_error("PMS collection count exceeds the supported limit");
-    }
-
-    std::vector<DataType> loaded_values(count);
-    for (auto& value : loaded_values) {
-        ReadValue(buffer, value);
-    }
-    values = std::move(loaded_values);
-}
-
 template<typename DataType, typename Transform = std::identity>
 void AppendCollection(std::shared_ptr<Soldank::IFileWriter>& file_writer,
                       const std::vector<DataType>& values,
@@ -133,6 +88,88 @@ void AppendCollection(std::shared_ptr<Soldank::IFileWriter>& file_writer,
 
 namespace Soldank
 {
+// Reads PMS data in place. Every section is checked against the remaining bytes before
+// anything is allocated for it, so a corrupted count can't trigger a huge allocation.
+class PMSDataReader
+{
+public:
+    static constexpr std::size_t MAX_SERIALIZED_COLLECTION_COUNT = 100000;
+
+    explicit PMSDataReader(std::span<const std::byte> data)
+        : data_(data)
+    {
+    }
+
+    template<typename DataType>
+    void ReadValue(DataType& value)
+    {
+        static_assert(std::is_trivially_copyable_v<DataType>);
+        std::memcpy(&value, Take(sizeof(DataType)).data(), sizeof(DataType));
+    }
+
+    template<typename DataType>
+    void ReadArray(std::span<DataType> values)
+    {
+        static_assert(std::is_trivially_copyable_v<DataType>);
+        auto bytes = Take(values.size_bytes());
+        if (!values.empty()) {
+            std::memcpy(values.data(), bytes.data(), bytes.size());
+        }
+    }
+
+    void ReadFixedString(std::string& value, std::size_t max_size)
+    {
+        unsigned char string_size = 0;
+        ReadValue(string_size);
+        if (string_size > max_size) {
+            throw std::runtime_error("PMS string length exceeds its fixed-width field");
+        }
+
+        auto bytes = Take(max_size);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        value.assign(reinterpret_cast<const char*>(bytes.data()), string_size);
+    }
+
+    template<typename DataType>
+    void ReadCollection(std::vector<DataType>& values,
+                        std::size_t max_count = MAX_SERIALIZED_COLLECTION_COUNT)
+    {
+        std::uint32_t count = 0;
+        ReadValue(count);
+        if (count > max_count) {
+            throw std::runtime_error("PMS collection count exceeds the supported limit");
+        }
+        ExpectSection(count, sizeof(DataType));
+
+        std::vector<DataType> loaded_values(count);
+        ReadArray(std::span{ loaded_values });
+        values = std::move(loaded_values);
+    }
+
+    void ExpectSection(std::size_t count, std::size_t element_size) const
+    {
+        if (element_size != 0 && count > GetRemainingSize() / element_size) {
+            throw std::runtime_error("PMS section exceeds the map data");
+        }
+    }
+
+    std::size_t GetRemainingSize() const { return data_.size() - offset_; }
+
+private:
+    std::span<const std::byte> Take(std::size_t size)
+    {
+        if (size > GetRemainingSize()) {
+            throw std::runtime_error("Unexpected end of PMS map data");
+        }
+        auto bytes = data_.subspan(offset_, size);
+        offset_ += size;
+        return bytes;
+    }
+
+    std::span<const std::byte> data_;
+    std::size_t offset_ = 0;
+};
+
 void Map::CreateEmptyMap()
 {
     map_data_ = MapData{};
@@ -164,28 +201,40 @@ void Map::CreateEmptyMap()
 
 void Map::LoadMap(const std::filesystem::path& map_path, const IFileReader& file_reader)
 {
+    // Readers backed by memory (asset packs) let the parser work on the mapped bytes directly
+    auto file_view = file_reader.ReadView(map_path.string());
+    if (file_view.has_value()) {
+        LoadMap(map_path, *file_view);
+        return;
+    }
+
     auto file_data = file_reader.Read(map_path.string(), std::ios::in | std::ios::binary);
     if (!file_data.has_value()) {
         spdlog::critical("Map not found {}", map_path.string());
         // TODO: should return an error
         return;
     }
-    std::stringstream data_buffer{ *file_data };
+    LoadMap(map_path, std::as_bytes(std::span{ *file_data }));
+}
+
+void Map::LoadMap(const std::filesystem::path& map_path, std::span<const std::byte> map_data)
+{
+    PMSDataReader data_buffer{ map_data };
     Map loaded_map;
     loaded_map.map_data_.name = map_path.filename().string();
 
-    ReadValue(data_buffer, loaded_map.map_data_.version);
-    ReadFixedString(data_buffer, loaded_map.map_data_.description, DESCRIPTION_MAX_LENGTH);
-    ReadFixedString(data_buffer, loaded_map.map_data_.texture_name, TEXTURE_NAME_MAX_LENGTH);
+    data_buffer.ReadValue(loaded_map.map_data_.version);
+    data_buffer.ReadFixedString(loaded_map.map_data_.description, DESCRIPTION_MAX_LENGTH);
+    data_buffer.ReadFixedString(loaded_map.map_data_.texture_name, TEXTURE_NAME_MAX_LENGTH);
 
-    ReadValue(data_buffer, loaded_map.map_data_.background_top_color);
-    ReadValue(data_buffer, loaded_map.map_data_.background_bottom_color);
-    ReadValue(data_buffer, loaded_map.map_data_.jet_count);
-    ReadValue(data_buffer, loaded_map.map_data_.grenades_count);
-    ReadValue(data_buffer, loaded_map.map_data_.medikits_count);
-    ReadValue(data_buffer, loaded_map.map_data_.weather_type);
-    ReadValue(data_buffer, loaded_map.map_data_.step_type);
-    ReadValue(data_buffer, loaded_map.map_data_.random_id);
+    data_buffer.ReadValue(loaded_map.map_data_.background_top_color);
+    data_buffer.ReadValue(loaded_map.map_data_.background_bottom_color);
+    data_buffer.ReadValue(loaded_map.map_data_.jet_count);
+    data_buffer.ReadValue(loaded_map.map_data_.grenades_count);
+    data_buffer.ReadValue(loaded_map.map_data_.medikits_count);
+    data_buffer.ReadValue(loaded_map.map_data_.weather_type);
+    data_buffer.ReadValue(loaded_map.map_data_.step_type);
+    data_buffer.ReadValue(loaded_map.map_data_.random_id);
 
     loaded_map.ReadPolygonsFromBuffer(data_buffer);
     loaded_map.ReadSectorsFromBuffer(data_buffer);
@@ -243,22 +292,27 @@ void Map::SaveMap(const std::filesystem::path& map_path,
     }
 }
 
-void Map::ReadPolygonsFromBuffer(std::stringstream& buffer)
+void Map::ReadPolygonsFromBuffer(PMSDataReader& buffer)
 {
+    constexpr std::size_t POLYGON_RECORD_SIZE =
+      3 * sizeof(PMSVertex) + 3 * sizeof(PMSVector) + sizeof(PMSPolygonType);
+
     std::uint32_t polygons_count = 0;
-    ReadValue(buffer, polygons_count);
+    buffer.ReadValue(polygons_count);
     if (polygons_count > MAX_POLYGONS_COUNT) {
         throw std::runtime_error("PMS polygon count exceeds the supported limit");
     }
+    buffer.ExpectSection(polygons_count, POLYGON_RECORD_SIZE);
     map_data_.polygons.clear();
     map_data_.polygons.reserve(polygons_count);
     for (std::uint32_t i = 0; i < polygons_count; ++i) {
         PMSPolygon new_polygon;
         new_polygon.id = i;
 
-        for (unsigned int j = 0; j < 3; ++j) {
-            ReadValue(buffer, new_polygon.vertices.at(j));
+        buffer.ReadArray(std::span{ new_polygon.vertices });
+        buffer.ReadArray(std::span{ new_polygon.perpendiculars });
 
+        for (unsigned int j = 0; j < 3; ++j) {
             if (new_polygon.vertices.at(j).x < map_data_.polygons_min_x) {
                 map_data_.polygons_min_x = new_polygon.vertices.at(j).x;
             }
@@ -273,9 +327,6 @@ void Map::ReadPolygonsFromBuffer(std::stringstream& buffer)
                 map_data_.polygons_max_y = new_polygon.vertices.at(j).y;
             }
         }
-        for (unsigned int j = 0; j < 3; ++j) {
-            ReadValue(buffer, new_polygon.perpendiculars.at(j));
-        }
         new_polygon.bounciness =
           glm::length(glm::vec2(new_polygon.perpendiculars[2].x, new_polygon.perpendiculars[2].y));
 
@@ -286,35 +337,37 @@ void Map::ReadPolygonsFromBuffer(std::stringstream& buffer)
             new_polygon.perpendiculars.at(j).y = normalized_perpendiculars.y;
         }
 
-        ReadValue(buffer, new_polygon.polygon_type);
+        buffer.ReadValue(new_polygon.polygon_type);
 
         map_data_.polygons.push_back(new_polygon);
     }
 }
 
-void Map::ReadSectorsFromBuffer(std::stringstream& buffer)
+void Map::ReadSectorsFromBuffer(PMSDataReader& buffer)
 {
-    ReadValue(buffer, map_data_.sectors_size);
-    ReadValue(buffer, map_data_.sectors_count);
+    buffer.ReadValue(map_data_.sectors_size);
+    buffer.ReadValue(map_data_.sectors_count);
     if (map_data_.sectors_size <= 0 || map_data_.sectors_count < 0 ||
         map_data_.sectors_count > (SECTORS_COUNT - 1) / 2) {
         throw std::runtime_error("Invalid PMS sector dimensions");
     }
 
     int n = 2 * map_data_.sectors_count + 1;
+    buffer.ExpectSection(static_cast<std::size_t>(n) * n, sizeof(unsigned short));
     map_data_.sectors_poly = std::vector<std::vector<PMSSector>>(n, std::vector<PMSSector>(n));
 
     for (auto& sec_i : map_data_.sectors_poly) {
         for (auto& sec_ij : sec_i) {
             unsigned short sector_polygons_count = 0;
-            ReadValue(buffer, sector_polygons_count);
+            buffer.ReadValue(sector_polygons_count);
             if (sector_polygons_count > map_data_.polygons.size()) {
                 throw std::runtime_error("PMS sector contains too many polygon references");
             }
+            buffer.ExpectSection(sector_polygons_count, sizeof(unsigned short));
 
             sec_ij.polygons.resize(sector_polygons_count);
-            for (auto& polygon_id : sec_ij.polygons) {
-                ReadValue(buffer, polygon_id);
+            buffer.ReadArray(std::span{ sec_ij.polygons });
+            for (auto polygon_id : sec_ij.polygons) {
                 if (polygon_id == 0 || polygon_id > map_data_.polygons.size()) {
                     throw std::runtime_error("PMS sector references an invalid polygon");
                 }
@@ -323,40 +376,44 @@ void Map::ReadSectorsFromBuffer(std::stringstream& buffer)
     }
 }
 
-void Map::ReadSceneryInstancesFromBuffer(std::stringstream& buffer)
+void Map::ReadSceneryInstancesFromBuffer(PMSDataReader& buffer)
 {
-    ReadCollection(buffer, map_data_.scenery_instances, MAX_SCENERIES_COUNT);
+    buffer.ReadCollection(map_data_.scenery_instances, MAX_SCENERIES_COUNT);
 }
 
-void Map::ReadSceneryTypesFromBuffer(std::stringstream& buffer)
+void Map::ReadSceneryTypesFromBuffer(PMSDataReader& buffer)
 {
+    constexpr std::size_t SCENERY_TYPE_RECORD_SIZE =
+      1 + SCENERY_NAME_MAX_LENGTH + sizeof(PMSTimestamp);
+
     std::uint32_t scenery_types_count = 0;
-    ReadValue(buffer, scenery_types_count);
+    buffer.ReadValue(scenery_types_count);
     if (scenery_types_count > MAX_SCENERIES_COUNT) {
         throw std::runtime_error("PMS scenery type count exceeds the supported limit");
     }
+    buffer.ExpectSection(scenery_types_count, SCENERY_TYPE_RECORD_SIZE);
     map_data_.scenery_types.clear();
     map_data_.scenery_types.reserve(scenery_types_count);
     for (std::uint32_t i = 0; i < scenery_types_count; ++i) {
         map_data_.scenery_types.push_back({});
-        ReadFixedString(buffer, map_data_.scenery_types.back().name, SCENERY_NAME_MAX_LENGTH);
-        ReadValue(buffer, map_data_.scenery_types.back().timestamp);
+        buffer.ReadFixedString(map_data_.scenery_types.back().name, SCENERY_NAME_MAX_LENGTH);
+        buffer.ReadValue(map_data_.scenery_types.back().timestamp);
     }
 }
 
-void Map::ReadCollidersFromBuffer(std::stringstream& buffer)
+void Map::ReadCollidersFromBuffer(PMSDataReader& buffer)
 {
-    ReadCollection(buffer, map_data_.colliders);
+    buffer.ReadCollection(map_data_.colliders);
 }
 
-void Map::ReadSpawnPointsFromBuffer(std::stringstream& buffer)
+void Map::ReadSpawnPointsFromBuffer(PMSDataReader& buffer)
 {
-    ReadCollection(buffer, map_data_.spawn_points, MAX_SPAWN_POINTS_COUNT);
+    buffer.ReadCollection(map_data_.spawn_points, MAX_SPAWN_POINTS_COUNT);
 }
 
-void Map::ReadWayPointsFromBuffer(std::stringstream& buffer)
+void Map::ReadWayPointsFromBuffer(PMSDataReader& buffer)
 {
-    ReadCollection(buffer, map_data_.way_points);
+    buffer.ReadCollection(map_data_.way_points);
 }
 
 void Map::AppendPolygonsToFileWriter(std::shared_ptr<IFileWriter>& file_writer) const
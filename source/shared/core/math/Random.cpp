@@ -0,0 +1,83 @@
+module;
+
+#include <cstdint>
+
+export module Shared.Core.Math.Random;
+
+export namespace Soldank
+{
+struct SimulationRandomState
+{
+    std::uint64_t state;
+    std::uint64_t increment;
+};
+
+// PCG32 (XSH RR) generator. Its whole state is two integers, so it can be copied into snapshots
+// and replays, and two worlds seeded with the same value draw the same numbers on every platform.
+// Standard library distributions are implementation-defined and must not be used with it.
+class SimulationRandom
+{
+public:
+    static constexpr std::uint64_t DEFAULT_SEED = 0x853C49E6748FEA9BULL;
+
+    explicit SimulationRandom(std::uint64_t seed = DEFAULT_SEED) { Seed(seed); }
+
+    void Seed(std::uint64_t seed, std::uint64_t stream = 0xDA3E39CB94B95BDBULL)
+    {
+        state_ = 0;
+        increment_ = (stream << 1U) | 1U;
+        NextUInt32();
+        state_ += seed;
+        NextUInt32();
+    }
+
+    std::uint32_t NextUInt32()
+    {
+        const std::uint64_t old_state = state_;
+        state_ = old_state * MULTIPLIER + increment_;
+        const auto xor_shifted =
+          static_cast<std::uint32_t>(((old_state >> 18U) ^ old_state) >> 27U);
+        const auto rotation = static_cast<std::uint32_t>(old_state >> 59U);
+        return (xor_shifted >> rotation) | (xor_shifted << ((~rotation + 1U) & 31U));
+    }
+
+    // Uniform in [0, bound), without modulo bias. Returns 0 when bound is 0.
+    std::uint32_t NextUInt32(std::uint32_t bound)
+    {
+        if (bound == 0) {
+            return 0;
+        }
+
+        const std::uint32_t threshold = (~bound + 1U) % bound;
+        while (true) {
+            const std::uint32_t value = NextUInt32();
+            if (value >= threshold) {
+                return value % bound;
+            }
+        }
+    }
+
+    // Uniform in [0, 1)
+    float NextFloat() { return static_cast<float>(NextUInt32() >> 8U) * 0x1.0p-24F; }
+
+    // Uniform in [min, max)
+    float NextFloat(float min, float max) { return min + (max - min) * NextFloat(); }
+
+    SimulationRandomState GetState() const
+    {
+        return { .state = state_, .increment = increment_ };
+    }
+
+    void SetState(const SimulationRandomState& random_state)
+    {
+        state_ = random_state.state;
+        increment_ = random_state.increment;
+    }
+
+private:
+    static constexpr std::uint64_t MULTIPLIER = 6364136223846793005ULL;
+
+    std::uint64_t state_{};
+    std::uint64_t increment_{};
+};
+} // namespace Soldank
@@ -4,6 +4,7 @@ module;
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
 #include <optional>
 #include <utility>
 
@@ -22,6 +23,7 @@ import Shared.Core.Types.TeamType;
 import Shared.Core.Types.WeaponType;
 import Shared.Core.Entities.WeaponParametersFactory;
 import Shared.Core.Map.Map;
+import Shared.Core.Physics.HitboxHistory;
 import Shared.Core.Physics.PhysicsEvents;
 
 namespace Soldank
@@ -60,7 +62,12 @@ static glm::vec2 GetSoldierCollisionPoint(const Soldier& soldier)
     return soldier.particle.position;
 }
 
-static std::optional<int> FindSoldierCollisionPoint(const Soldier& soldier, const Bullet& bullet)
+// get_part_position returns the position of a skeleton particle, either the current one or a
+// lag compensated one from HitboxHistory
+template<typename TGetPartPosition>
+static std::optional<int> FindSoldierCollisionPoint(const Soldier& soldier,
+                                                    const Bullet& bullet,
+                                                    const TGetPartPosition& get_part_position)
 {
     const auto body_parts_priority = std::array{ 12, 11, 10, 6, 5, 4, 3 };
     glm::vec2 pos;
@@ -93,7 +100,7 @@ static std::optional<int> FindSoldierCollisionPoint(const Soldier& soldier, cons
     float min_dist = 9999999; // TODO: max float
 
     for (auto body_part_id : body_parts_priority) {
-        auto body_part_offset = soldier.skeleton->GetPos(body_part_id) - soldier.particle.position;
+        auto body_part_offset = get_part_position(body_part_id) - soldier.particle.position;
         auto col_pos = col + body_part_offset;
 
         // TODO: check opensoldat code
@@ -115,9 +122,45 @@ static std::optional<int> FindSoldierCollisionPoint(const Soldier& soldier, cons
 
     return where;
 }
+
+static std::optional<HitboxSnapshot> FindLagCompensatedHitbox(const Soldier& soldier,
+                                                               const Bullet& bullet,
+                                                               const StateManager& state_manager,
+                                                               const HitboxHistory& hitbox_history)
+{
+    if (bullet.lag_compensation_ticks == 0) {
+        return std::nullopt;
+    }
+
+    const std::uint32_t rewind_ticks =
+      std::min(bullet.lag_compensation_ticks, MAX_LAG_COMPENSATION_TICKS);
+    return hitbox_history.Find(soldier.id, state_manager.GetGameTick() - rewind_ticks);
+}
+
+static std::optional<int> FindSoldierCollisionPoint(const Soldier& soldier,
+                                                    const Bullet& bullet,
+                                                    const StateManager& state_manager,
+                                                    const HitboxHistory& hitbox_history)
+{
+    // Targets that have no history for the rewound tick (e.g. they just spawned) are tested
+    // where they are now
+    auto lag_compensated_hitbox =
+      FindLagCompensatedHitbox(soldier, bullet, state_manager, hitbox_history);
+    if (lag_compensated_hitbox.has_value()) {
+        return FindSoldierCollisionPoint(soldier, bullet, [&](unsigned int particle_num) {
+            return lag_compensated_hitbox->GetPos(particle_num);
+        });
+    }
+
+    return FindSoldierCollisionPoint(soldier, bullet, [&](unsigned int particle_num) {
+        return soldier.skeleton->GetPos(particle_num);
+    });
+}
+
 static std::optional<glm::vec2> CheckSoldierCollision(const PhysicsEvents& physics_events,
                                                       Bullet& bullet,
                                                       StateManager& state_manager,
+                                                      const HitboxHistory& hitbox_history,
                                                       float lasthitdist)
 {
     // TODO: can't throw knife (with short hold) because it immediately collides with the owner
@@ -136,12 +179,12 @@ static std::optional<glm::vec2> CheckSoldierCollision(const PhysicsEvents& physi
     if (bullet.style != BulletType::ClusterGrenade) {
         // TODO: filter soldiers by distance
         const auto* soldier = state_manager.FindSoldier([&](const auto& soldier) {
-            auto where = FindSoldierCollisionPoint(soldier, bullet);
+            auto where = FindSoldierCollisionPoint(soldier, bullet, state_manager, hitbox_history);
             return where.has_value();
         });
         if (soldier != nullptr) {
             // TODO: FindSoldierCollisionPoint is called twice, inefficient
-            auto where = FindSoldierCollisionPoint(*soldier, bullet);
+            auto where = FindSoldierCollisionPoint(*soldier, bullet, state_manager, hitbox_history);
             // temporary:
             // if (where != 0) {
             //     return glm::vec2{ 0, 0 };
@@ -363,7 +406,8 @@ export namespace Soldank::BulletPhysics
 void UpdateBullet(const PhysicsEvents& physics_events,
                   Bullet& bullet,
                   const Map& map,
-                  StateManager& state_manager)
+                  StateManager& state_manager,
+                  const HitboxHistory& hitbox_history)
 {
     bullet.velocity_prev = bullet.particle.velocity_;
     bullet.particle.Euler();
@@ -405,7 +449,8 @@ void UpdateBullet(const PhysicsEvents& physics_events,
         bullet.active = false;
     }
 
-    auto soldier_collision = CheckSoldierCollision(physics_events, bullet, state_manager, -1.0F);
+    auto soldier_collision =
+      CheckSoldierCollision(physics_events, bullet, state_manager, hitbox_history, -1.0F);
     if (soldier_collision.has_value()) {
         bullet.active = false;
         spdlog::debug("soldier hit");
@@ -0,0 +1,120 @@
+module;
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+export module Shared.Core.Physics.HitboxHistory;
+
+import Extern.Glm;
+
+import Shared.Core.Entities.Soldier;
+import Shared.Core.Physics.Particles;
+import Shared.Core.State.State;
+import Shared.Core.State.StateManager;
+
+export namespace Soldank
+{
+// ~0.5 s at 60 ticks per second, which covers the links lag compensation is meant for
+constexpr std::size_t HITBOX_HISTORY_LENGTH = 32;
+constexpr std::uint8_t MAX_LAG_COMPENSATION_TICKS = HITBOX_HISTORY_LENGTH - 1;
+// Clients are trusted to have drawn their targets at most this many ticks before their inputs'
+// apply_server_tick, which leaves room for the input delay plus the interpolation delay
+constexpr std::uint8_t MAX_LAG_COMPENSATION_VIEW_DELAY_TICKS = 24;
+// The soldier skeleton has fewer particles, the rest of a snapshot stays unused
+constexpr std::size_t MAX_HITBOX_PARTICLES_COUNT = 24;
+
+// Skeleton particle positions of one soldier at one tick
+class HitboxSnapshot
+{
+public:
+    HitboxSnapshot(const float* xs, const float* ys)
+        : xs_(xs)
+        , ys_(ys)
+    {
+    }
+
+    // particle_num is 1-based, like in ParticleSystem::GetPos
+    glm::vec2 GetPos(unsigned int particle_num) const
+    {
+        return { xs_[particle_num - 1], ys_[particle_num - 1] };
+    }
+
+private:
+    const float* xs_;
+    const float* ys_;
+};
+
+// Ring buffer of soldier skeletons for the last HITBOX_HISTORY_LENGTH ticks, so bullets fired by
+// lagging players can be tested against where targets were on the shooter's screen. All storage
+// is allocated once and recording a tick only copies particle positions.
+class HitboxHistory
+{
+public:
+    HitboxHistory()
+        : soldier_histories_(std::make_unique<SoldierHitboxHistories>())
+    {
+        Clear();
+    }
+
+    // Records the skeletons of all active soldiers. Inactive soldiers get no entry for the tick.
+    void Record(std::uint32_t tick, const StateManager& state_manager)
+    {
+        const std::size_t index = tick % HITBOX_HISTORY_LENGTH;
+        state_manager.ForEachSoldier([&](const Soldier& soldier) {
+            auto& soldier_history = soldier_histories_->at(soldier.id);
+            const auto& particles = soldier.skeleton->GetParticles();
+            const std::size_t particles_count =
+              std::min(particles.size(), MAX_HITBOX_PARTICLES_COUNT);
+            auto& xs = soldier_history.xs.at(index);
+            auto& ys = soldier_history.ys.at(index);
+            for (std::size_t i = 0; i < particles_count; ++i) {
+                xs[i] = particles[i].position.x;
+                ys[i] = particles[i].position.y;
+            }
+            soldier_history.ticks.at(index) = tick;
+            soldier_history.is_recorded.at(index) = true;
+        });
+    }
+
+    std::optional<HitboxSnapshot> Find(std::uint8_t soldier_id, std::uint32_t tick) const
+    {
+        if (soldier_id >= MAX_SOLDIERS_COUNT) {
+            return std::nullopt;
+        }
+
+        const std::size_t index = tick % HITBOX_HISTORY_LENGTH;
+        const auto& soldier_history = soldier_histories_->at(soldier_id);
+        if (!soldier_history.is_recorded.at(index) || soldier_history.ticks.at(index) != tick) {
+            return std::nullopt;
+        }
+
+        return HitboxSnapshot{ soldier_history.xs.at(index).data(),
+                               soldier_history.ys.at(index).data() };
+    }
+
+    // Has to be called when the simulation jumps in time (e.g. a replay seeks), otherwise
+    // entries of the abandoned timeline would be found for the ticks that repeat
+    void Clear()
+    {
+        for (auto& soldier_history : *soldier_histories_) {
+            soldier_history.is_recorded.fill(false);
+        }
+    }
+
+private:
+    struct SoldierHitboxHistory
+    {
+        std::array<std::uint32_t, HITBOX_HISTORY_LENGTH> ticks{};
+        std::array<bool, HITBOX_HISTORY_LENGTH> is_recorded{};
+        std::array<std::array<float, MAX_HITBOX_PARTICLES_COUNT>, HITBOX_HISTORY_LENGTH> xs{};
+        std::array<std::array<float, MAX_HITBOX_PARTICLES_COUNT>, HITBOX_HISTORY_LENGTH> ys{};
+    };
+    using SoldierHitboxHistories = std::array<SoldierHitboxHistory, MAX_SOLDIERS_COUNT>;
+
+    std::unique_ptr<SoldierHitboxHistories> soldier_histories_;
+};
+} // namespace Soldank
@@ -0,0 +1,870 @@
+module;
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "core/utility/Expected.hpp"
+
+export module Shared.Core.Replay.ReplayFormat;
+
+import Extern.Glm;
+
+import Shared.Core.Animations;
+import Shared.Core.Entities.Bullet;
+import Shared.Core.Math.Random;
+import Shared.Core.Simulation.SimulationCommands;
+import Shared.Core.State.Control;
+import Shared.Core.Types.BulletType;
+import Shared.Core.Types.ItemType;
+import Shared.Core.Types.TeamType;
+import Shared.Core.Types.WeaponType;
+import Shared.Core.Utility.VisitHelper;
+
+export namespace Soldank
+{
+// Replay stream layout:
+//   ReplayHeader
+//   records, each starting with a ReplayRecordType byte
+// Integers are LEB128 varints (signed ones zigzag encoded) and every tick record is delta
+// encoded against the previous record. Keyframes reset the delta state, so decoding can start
+// at any keyframe without reading what comes before it.
+constexpr std::array<char, 4> REPLAY_MAGIC{ 'S', 'D', 'R', 'P' };
+constexpr std::uint32_t REPLAY_VERSION = 6;
+
+enum class ReplayRecordType : std::uint8_t
+{
+    Tick = 1,
+    Keyframe
+};
+
+enum class ReplayError
+{
+    NoError = 0,
+    FileNotFound,
+    InvalidHeader,
+    UnsupportedVersion,
+    CorruptedData,
+    TickOutOfRange
+};
+
+struct ReplayHeader
+{
+    std::uint32_t keyframe_interval = 0;
+    std::string map_path;
+    // Bullets of late inputs hit differently with lag compensation, so it has to be replayed
+    // with the same setting it was recorded with
+    bool lag_compensation = false;
+};
+
+struct ReplayWeaponKeyframe
+{
+    WeaponType weapon_type;
+    std::uint8_t ammo_count;
+};
+
+// Soldier fields the simulation carries from one tick to the next. Skeletons are rebuilt by the
+// simulation itself from the particle and the animation states.
+struct ReplaySoldierKeyframe
+{
+    std::uint8_t id{};
+    bool active{};
+    bool dead_meat{};
+    float health{};
+    std::int32_t ticks_to_respawn{};
+    glm::vec2 position{};
+    glm::vec2 old_position{};
+    glm::vec2 velocity{};
+    glm::vec2 force{};
+    glm::vec2 mouse{};
+    AnimationType body_animation_type{};
+    std::uint32_t body_animation_frame{};
+    std::int32_t body_animation_speed{};
+    std::int32_t body_animation_count{};
+    AnimationType legs_animation_type{};
+    std::uint32_t legs_animation_frame{};
+    std::int32_t legs_animation_speed{};
+    std::int32_t legs_animation_count{};
+    bool on_ground{};
+    bool on_ground_for_law{};
+    bool on_ground_last_frame{};
+    bool on_ground_permanent{};
+    bool half_dead{};
+    bool is_shooting{};
+    bool grenade_can_throw{};
+    bool is_holding_flags{};
+    std::int8_t direction{};
+    std::int8_t old_direction{};
+    std::uint8_t stance{};
+    std::uint8_t fired{};
+    std::int32_t jets_count{};
+    std::int32_t jets_count_prev{};
+    Control control{};
+    std::uint8_t active_weapon{};
+    std::array<WeaponType, 2> weapon_choices{};
+    std::vector<ReplayWeaponKeyframe> weapons;
+};
+
+// Projectiles created later take the first free slot, so the slot is kept too
+struct ReplayBulletKeyframe
+{
+    std::uint16_t slot{};
+    BulletType style{};
+    WeaponType weapon{};
+    TeamType team{};
+    std::uint8_t owner_id{};
+    glm::vec2 position{};
+    glm::vec2 old_position{};
+    glm::vec2 velocity{};
+    glm::vec2 force{};
+    glm::vec2 initial_position{};
+    glm::vec2 velocity_prev{};
+    std::int16_t timeout{};
+    std::int16_t timeout_prev{};
+    float timeout_real{};
+    float hit_multiply{};
+    float hit_multiply_prev{};
+    std::uint32_t degrade_count{};
+    float push{};
+    std::uint8_t lag_compensation_ticks{};
+};
+
+struct ReplayItemParticleKeyframe
+{
+    glm::vec2 position{};
+    glm::vec2 old_position{};
+    glm::vec2 force{};
+};
+
+// Flags, dropped weapons and kits. The skeleton is loaded again for the item's style and only
+// its particles' state is kept.
+struct ReplayItemKeyframe
+{
+    std::uint8_t id{};
+    ItemType style{};
+    std::uint8_t owner{};
+    std::uint8_t holding_soldier_id{};
+    std::uint8_t ammo_count{};
+    float radius{};
+    std::int32_t time_out{};
+    bool static_type{};
+    std::int32_t interest{};
+    bool collide_with_bullets{};
+    bool in_base{};
+    std::uint8_t last_spawn{};
+    std::uint8_t team{};
+    bool flipped{};
+    std::array<std::uint8_t, 4> collide_count{};
+    std::vector<ReplayItemParticleKeyframe> particles;
+};
+
+struct ReplayKeyframe
+{
+    std::uint32_t tick{};
+    SimulationRandomState random_state{};
+    std::vector<ReplaySoldierKeyframe> soldiers;
+    std::vector<ReplayBulletKeyframe> bullets;
+    // Projectiles fired during the previous tick that are created at the start of the next one
+    std::vector<BulletParams> bullet_emitter;
+    std::vector<ReplayItemKeyframe> items;
+};
+
+struct ReplayTickRecord
+{
+    std::uint32_t tick{};
+    std::vector<PlayerInputCommand> player_inputs;
+    std::vector<SimulationCommand> commands;
+};
+
+class ReplayByteWriter
+{
+public:
+    void WriteByte(std::uint8_t value) { data_.push_back(static_cast<std::byte>(value)); }
+
+    void WriteVarUInt(std::uint64_t value)
+    {
+        while (value >= 0x80) {
+            WriteByte(static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        WriteByte(static_cast<std::uint8_t>(value));
+    }
+
+    void WriteVarInt(std::int64_t value)
+    {
+        WriteVarUInt((static_cast<std::uint64_t>(value) << 1) ^
+                     static_cast<std::uint64_t>(value >> 63));
+    }
+
+    void WriteBool(bool value) { WriteByte(value ? 1 : 0); }
+
+    void WriteFloat(float value)
+    {
+        const auto bits = std::bit_cast<std::uint32_t>(value);
+        for (int i = 0; i < 4; ++i) {
+            WriteByte(static_cast<std::uint8_t>(bits >> (i * 8)));
+        }
+    }
+
+    void WriteString(const std::string& value)
+    {
+        WriteVarUInt(value.size());
+        for (char character : value) {
+            WriteByte(static_cast<std::uint8_t>(character));
+        }
+    }
+
+    const std::vector<std::byte>& GetData() const { return data_; }
+    std::vector<std::byte> TakeData() { return std::exchange(data_, {}); }
+
+private:
+    std::vector<std::byte> data_;
+};
+
+class ReplayByteReader
+{
+public:
+    explicit ReplayByteReader(std::span<const std::byte> data, std::size_t offset = 0)
+        : data_(data)
+        , offset_(offset)
+    {
+    }
+
+    std::uint8_t ReadByte()
+    {
+        if (offset_ >= data_.size()) {
+            throw std::runtime_error("Unexpected end of replay data");
+        }
+        return static_cast<std::uint8_t>(data_[offset_++]);
+    }
+
+    std::uint64_t ReadVarUInt()
+    {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const std::uint8_t byte = ReadByte();
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw std::runtime_error("Replay varint is too long");
+    }
+
+    std::int64_t ReadVarInt()
+    {
+        const std::uint64_t value = ReadVarUInt();
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+
+    bool ReadBool() { return ReadByte() != 0; }
+
+    float ReadFloat()
+    {
+        std::uint32_t bits = 0;
+        for (int i = 0; i < 4; ++i) {
+            bits |= static_cast<std::uint32_t>(ReadByte()) << (i * 8);
+        }
+        return std::bit_cast<float>(bits);
+    }
+
+    std::string ReadString()
+    {
+        const std::uint64_t size = ReadVarUInt();
+        if (size > GetRemainingSize()) {
+            throw std::runtime_error("Replay string exceeds the replay data");
+        }
+        std::string value(size, '\0');
+        for (auto& character : value) {
+            character = static_cast<char>(ReadByte());
+        }
+        return value;
+    }
+
+    std::size_t GetOffset() const { return offset_; }
+    std::size_t GetRemainingSize() const { return data_.size() - offset_; }
+    bool IsAtEnd() const { return offset_ >= data_.size(); }
+
+private:
+    std::span<const std::byte> data_;
+    std::size_t offset_;
+};
+
+// Previous input of every soldier, player inputs are encoded as a difference to it
+class ReplayDeltaContext
+{
+public:
+    void Reset()
+    {
+        previous_inputs_.clear();
+        previous_tick_.reset();
+    }
+
+    const PlayerInputCommand& GetPreviousInput(std::uint8_t soldier_id)
+    {
+        return previous_inputs_.try_emplace(soldier_id, PlayerInputCommand{}).first->second;
+    }
+
+    void SetPreviousInput(const PlayerInputCommand& player_input)
+    {
+        previous_inputs_[player_input.soldier_id] = player_input;
+    }
+
+    std::optional<std::uint32_t> GetPreviousTick() const { return previous_tick_; }
+    void SetPreviousTick(std::uint32_t tick) { previous_tick_ = tick; }
+
+private:
+    std::map<std::uint8_t, PlayerInputCommand> previous_inputs_;
+    std::optional<std::uint32_t> previous_tick_;
+};
+
+namespace ReplayFormat
+{
+namespace Detail
+{
+void WriteControl(ReplayByteWriter& writer, const Control& control, const Control& previous)
+{
+    writer.WriteVarUInt(PackControlFlags(control));
+    writer.WriteVarInt(static_cast<std::int64_t>(control.mouse_aim_x) - previous.mouse_aim_x);
+    writer.WriteVarInt(static_cast<std::int64_t>(control.mouse_aim_y) - previous.mouse_aim_y);
+    writer.WriteVarInt(static_cast<std::int64_t>(control.mouse_dist) - previous.mouse_dist);
+}
+
+Control ReadControl(ReplayByteReader& reader, const Control& previous)
+{
+    Control control{};
+    UnpackControlFlags(static_cast<std::uint32_t>(reader.ReadVarUInt()), control);
+    control.mouse_aim_x = static_cast<int>(previous.mouse_aim_x + reader.ReadVarInt());
+    control.mouse_aim_y = static_cast<int>(previous.mouse_aim_y + reader.ReadVarInt());
+    control.mouse_dist = static_cast<int>(previous.mouse_dist + reader.ReadVarInt());
+    return control;
+}
+
+// Unchanged floats encode to a single byte
+void WriteFloatDelta(ReplayByteWriter& writer, float value, float previous)
+{
+    writer.WriteVarUInt(std::bit_cast<std::uint32_t>(value) ^
+                        std::bit_cast<std::uint32_t>(previous));
+}
+
+float ReadFloatDelta(ReplayByteReader& reader, float previous)
+{
+    return std::bit_cast<float>(static_cast<std::uint32_t>(reader.ReadVarUInt()) ^
+                                std::bit_cast<std::uint32_t>(previous));
+}
+
+std::int64_t TickDistance(std::uint32_t from, std::uint32_t to)
+{
+    return static_cast<std::int32_t>(to - from);
+}
+
+void WritePlayerInput(ReplayByteWriter& writer,
+                      std::uint32_t tick,
+                      const PlayerInputCommand& player_input,
+                      ReplayDeltaContext& delta_context)
+{
+    const PlayerInputCommand& previous = delta_context.GetPreviousInput(player_input.soldier_id);
+    writer.WriteByte(player_input.soldier_id);
+    writer.WriteVarInt(TickDistance(previous.input_sequence_id, player_input.input_sequence_id));
+    writer.WriteVarInt(TickDistance(player_input.client_tick, tick));
+    writer.WriteVarInt(TickDistance(tick, player_input.apply_server_tick));
+    writer.WriteVarInt(TickDistance(player_input.view_server_tick, tick));
+    WriteControl(writer, player_input.control, previous.control);
+    WriteFloatDelta(writer, player_input.mouse_map_position.x, previous.mouse_map_position.x);
+    WriteFloatDelta(writer, player_input.mouse_map_position.y, previous.mouse_map_position.y);
+    delta_context.SetPreviousInput(player_input);
+}
+
+PlayerInputCommand ReadPlayerInput(ReplayByteReader& reader,
+                                   std::uint32_t tick,
+                                   ReplayDeltaContext& delta_context)
+{
+    PlayerInputCommand player_input{};
+    player_input.soldier_id = reader.ReadByte();
+    const PlayerInputCommand& previous = delta_context.GetPreviousInput(player_input.soldier_id);
+    player_input.input_sequence_id =
+      previous.input_sequence_id + static_cast<std::uint32_t>(reader.ReadVarInt());
+    player_input.client_tick = tick - static_cast<std::uint32_t>(reader.ReadVarInt());
+    player_input.apply_server_tick = tick + static_cast<std::uint32_t>(reader.ReadVarInt());
+    player_input.view_server_tick = tick - static_cast<std::uint32_t>(reader.ReadVarInt());
+    player_input.control = ReadControl(reader, previous.control);
+    player_input.mouse_map_position.x = ReadFloatDelta(reader, previous.mouse_map_position.x);
+    player_input.mouse_map_position.y = ReadFloatDelta(reader, previous.mouse_map_position.y);
+    delta_context.SetPreviousInput(player_input);
+    return player_input;
+}
+
+void WriteCommand(ReplayByteWriter& writer, const SimulationCommand& command)
+{
+    writer.WriteByte(static_cast<std::uint8_t>(command.index()));
+    std::visit(VisitOverload{
+                 [&](const SpawnSoldierCommand& spawn_command) {
+                     writer.WriteByte(spawn_command.soldier_id);
+                     writer.WriteBool(spawn_command.spawn_position.has_value());
+                     if (spawn_command.spawn_position.has_value()) {
+                         writer.WriteFloat(spawn_command.spawn_position->x);
+                         writer.WriteFloat(spawn_command.spawn_position->y);
+                     }
+                 },
+                 [&](const KillSoldierCommand& kill_command) {
+                     writer.WriteByte(kill_command.soldier_id);
+                 },
+                 [&](const RemoveSoldierCommand& remove_command) {
+                     writer.WriteByte(remove_command.soldier_id);
+                 },
+                 [&](const SetWeaponChoiceCommand& weapon_choice_command) {
+                     writer.WriteByte(weapon_choice_command.soldier_id);
+                     writer.WriteVarUInt(
+                       std::to_underlying(weapon_choice_command.primary_weapon_type));
+                     writer.WriteVarUInt(
+                       std::to_underlying(weapon_choice_command.secondary_weapon_type));
+                 },
+               },
+               command);
+}
+
+SimulationCommand ReadCommand(ReplayByteReader& reader)
+{
+    const std::uint8_t command_index = reader.ReadByte();
+    switch (command_index) {
+        case 0: {
+            SpawnSoldierCommand spawn_command{ .soldier_id = reader.ReadByte() };
+            if (reader.ReadBool()) {
+                const float x = reader.ReadFloat();
+                const float y = reader.ReadFloat();
+                spawn_command.spawn_position = glm::vec2{ x, y };
+            }
+            return spawn_command;
+        }
+        case 1:
+            return KillSoldierCommand{ .soldier_id = reader.ReadByte() };
+        case 2:
+            return RemoveSoldierCommand{ .soldier_id = reader.ReadByte() };
+        case 3: {
+            SetWeaponChoiceCommand weapon_choice_command{ .soldier_id = reader.ReadByte() };
+            weapon_choice_command.primary_weapon_type =
+              static_cast<WeaponType>(reader.ReadVarUInt());
+            weapon_choice_command.secondary_weapon_type =
+              static_cast<WeaponType>(reader.ReadVarUInt());
+            return weapon_choice_command;
+        }
+        default:
+            throw std::runtime_error("Unknown replay simulation command");
+    }
+}
+
+void WriteVec2(ReplayByteWriter& writer, glm::vec2 value)
+{
+    writer.WriteFloat(value.x);
+    writer.WriteFloat(value.y);
+}
+
+glm::vec2 ReadVec2(ReplayByteReader& reader)
+{
+    const float x = reader.ReadFloat();
+    const float y = reader.ReadFloat();
+    return { x, y };
+}
+
+void WriteSoldierKeyframe(ReplayByteWriter& writer, const ReplaySoldierKeyframe& soldier)
+{
+    writer.WriteByte(soldier.id);
+    writer.WriteBool(soldier.active);
+    writer.WriteBool(soldier.dead_meat);
+    writer.WriteFloat(soldier.health);
+    writer.WriteVarInt(soldier.ticks_to_respawn);
+    WriteVec2(writer, soldier.position);
+    WriteVec2(writer, soldier.old_position);
+    WriteVec2(writer, soldier.velocity);
+    WriteVec2(writer, soldier.force);
+    WriteVec2(writer, soldier.mouse);
+    writer.WriteVarUInt(std::to_underlying(soldier.body_animation_type));
+    writer.WriteVarUInt(soldier.body_animation_frame);
+    writer.WriteVarInt(soldier.body_animation_speed);
+    writer.WriteVarInt(soldier.body_animation_count);
+    writer.WriteVarUInt(std::to_underlying(soldier.legs_animation_type));
+    writer.WriteVarUInt(soldier.legs_animation_frame);
+    writer.WriteVarInt(soldier.legs_animation_speed);
+    writer.WriteVarInt(soldier.legs_animation_count);
+    writer.WriteBool(soldier.on_ground);
+    writer.WriteBool(soldier.on_ground_for_law);
+    writer.WriteBool(soldier.on_ground_last_frame);
+    writer.WriteBool(soldier.on_ground_permanent);
+    writer.WriteBool(soldier.half_dead);
+    writer.WriteBool(soldier.is_shooting);
+    writer.WriteBool(soldier.grenade_can_throw);
+    writer.WriteBool(soldier.is_holding_flags);
+    writer.WriteVarInt(soldier.direction);
+    writer.WriteVarInt(soldier.old_direction);
+    writer.WriteByte(soldier.stance);
+    writer.WriteByte(soldier.fired);
+    writer.WriteVarInt(soldier.jets_count);
+    writer.WriteVarInt(soldier.jets_count_prev);
+    WriteControl(writer, soldier.control, Control{});
+    writer.WriteByte(soldier.active_weapon);
+    for (auto weapon_choice : soldier.weapon_choices) {
+        writer.WriteVarUInt(std::to_underlying(weapon_choice));
+    }
+    writer.WriteVarUInt(soldier.weapons.size());
+    for (const auto& weapon : soldier.weapons) {
+        writer.WriteVarUInt(std::to_underlying(weapon.weapon_type));
+        writer.WriteByte(weapon.ammo_count);
+    }
+}
+
+ReplaySoldierKeyframe ReadSoldierKeyframe(ReplayByteReader& reader)
+{
+    ReplaySoldierKeyframe soldier;
+    soldier.id = reader.ReadByte();
+    soldier.active = reader.ReadBool();
+    soldier.dead_meat = reader.ReadBool();
+    soldier.health = reader.ReadFloat();
+    soldier.ticks_to_respawn = static_cast<std::int32_t>(reader.ReadVarInt());
+    soldier.position = ReadVec2(reader);
+    soldier.old_position = ReadVec2(reader);
+    soldier.velocity = ReadVec2(reader);
+    soldier.force = ReadVec2(reader);
+    soldier.mouse = ReadVec2(reader);
+    soldier.body_animation_type = static_cast<AnimationType>(reader.ReadVarUInt());
+    soldier.body_animation_frame = static_cast<std::uint32_t>(reader.ReadVarUInt());
+    soldier.body_animation_speed = static_cast<std::int32_t>(reader.ReadVarInt());
+    soldier.body_animation_count = static_cast<std::int32_t>(reader.ReadVarInt());
+    soldier.legs_animation_type = static_cast<AnimationType>(reader.ReadVarUInt());
+    soldier.legs_animation_frame = static_cast<std::uint32_t>(reader.ReadVarUInt());
+    soldier.legs_animation_speed = static_cast<std::int32_t>(reader.ReadVarInt());
+    soldier.legs_animation_count = static_cast<std::int32_t>(reader.ReadVarInt());
+    soldier.on_ground = reader.ReadBool();
+    soldier.on_ground_for_law = reader.ReadBool();
+    soldier.on_ground_last_frame = reader.ReadBool();
+    soldier.on_ground_permanent = reader.ReadBool();
+    soldier.half_dead = reader.ReadBool();
+    soldier.is_shooting = reader.ReadBool();
+    soldier.grenade_can_throw = reader.ReadBool();
+    soldier.is_holding_flags = reader.ReadBool();
+    soldier.direction = static_cast<std::int8_t>(reader.ReadVarInt());
+    soldier.old_direction = static_cast<std::int8_t>(reader.ReadVarInt());
+    soldier.stance = reader.ReadByte();
+    soldier.fired = reader.ReadByte();
+    soldier.jets_count = static_cast<std::int32_t>(reader.ReadVarInt());
+    soldier.jets_count_prev = static_cast<std::int32_t>(reader.ReadVarInt());
+    soldier.control = ReadControl(reader, Control{});
+    soldier.active_weapon = reader.ReadByte();
+    for (auto& weapon_choice : soldier.weapon_choices) {
+        weapon_choice = static_cast<WeaponType>(reader.ReadVarUInt());
+    }
+    const std::uint64_t weapons_count = reader.ReadVarUInt();
+    if (weapons_count > reader.GetRemainingSize()) {
+        throw std::runtime_error("Replay weapon count exceeds the replay data");
+    }
+    soldier.weapons.reserve(weapons_count);
+    for (std::uint64_t i = 0; i < weapons_count; ++i) {
+        const auto weapon_type = static_cast<WeaponType>(reader.ReadVarUInt());
+        soldier.weapons.push_back({ .weapon_type = weapon_type, .ammo_count = reader.ReadByte() });
+    }
+    return soldier;
+}
+
+// Counts read from the replay are checked against the remaining data before reserving
+std::uint64_t ReadElementsCount(ReplayByteReader& reader, const char* error_message)
+{
+    const std::uint64_t elements_count = reader.ReadVarUInt();
+    if (elements_count > reader.GetRemainingSize()) {
+        throw std::runtime_error(error_message);
+    }
+    return elements_count;
+}
+
+void WriteBulletKeyframe(ReplayByteWriter& writer, const ReplayBulletKeyframe& bullet)
+{
+    writer.WriteVarUInt(bullet.slot);
+    writer.WriteVarUInt(std::to_underlying(bullet.style));
+    writer.WriteVarUInt(std::to_underlying(bullet.weapon));
+    writer.WriteVarUInt(std::to_underlying(bullet.team));
+    writer.WriteByte(bullet.owner_id);
+    WriteVec2(writer, bullet.position);
+    WriteVec2(writer, bullet.old_position);
+    WriteVec2(writer, bullet.velocity);
+    WriteVec2(writer, bullet.force);
+    WriteVec2(writer, bullet.initial_position);
+    WriteVec2(writer, bullet.velocity_prev);
+    writer.WriteVarInt(bullet.timeout);
+    writer.WriteVarInt(bullet.timeout_prev);
+    writer.WriteFloat(bullet.timeout_real);
+    writer.WriteFloat(bullet.hit_multiply);
+    writer.WriteFloat(bullet.hit_multiply_prev);
+    writer.WriteVarUInt(bullet.degrade_count);
+    writer.WriteFloat(bullet.push);
+    writer.WriteByte(bullet.lag_compensation_ticks);
+}
+
+ReplayBulletKeyframe ReadBulletKeyframe(ReplayByteReader& reader)
+{
+    ReplayBulletKeyframe bullet;
+    bullet.slot = static_cast<std::uint16_t>(reader.ReadVarUInt());
+    bullet.style = static_cast<BulletType>(reader.ReadVarUInt());
+    bullet.weapon = static_cast<WeaponType>(reader.ReadVarUInt());
+    bullet.team = static_cast<TeamType>(reader.ReadVarUInt());
+    bullet.owner_id = reader.ReadByte();
+    bullet.position = ReadVec2(reader);
+    bullet.old_position = ReadVec2(reader);
+    bullet.velocity = ReadVec2(reader);
+    bullet.force = ReadVec2(reader);
+    bullet.initial_position = ReadVec2(reader);
+    bullet.velocity_prev = ReadVec2(reader);
+    bullet.timeout = static_cast<std::int16_t>(reader.ReadVarInt());
+    bullet.timeout_prev = static_cast<std::int16_t>(reader.ReadVarInt());
+    bullet.timeout_real = reader.ReadFloat();
+    bullet.hit_multiply = reader.ReadFloat();
+    bullet.hit_multiply_prev = reader.ReadFloat();
+    bullet.degrade_count = static_cast<std::uint32_t>(reader.ReadVarUInt());
+    bullet.push = reader.ReadFloat();
+    bullet.lag_compensation_ticks = reader.ReadByte();
+    return bullet;
+}
+
+void WriteBulletParams(ReplayByteWriter& writer, const BulletParams& bullet_params)
+{
+    writer.WriteVarUInt(std::to_underlying(bullet_params.style));
+    writer.WriteVarUInt(std::to_underlying(bullet_params.weapon));
+    WriteVec2(writer, bullet_params.position);
+    WriteVec2(writer, bullet_params.velocity);
+    writer.WriteVarInt(bullet_params.timeout);
+    writer.WriteFloat(bullet_params.hit_multiply);
+    writer.WriteVarUInt(std::to_underlying(bullet_params.team));
+    writer.WriteByte(bullet_params.owner_id);
+    writer.WriteFloat(bullet_params.push);
+    writer.WriteByte(bullet_params.lag_compensation_ticks);
+}
+
+BulletParams ReadBulletParams(ReplayByteReader& reader)
+{
+    BulletParams bullet_params{};
+    bullet_params.style = static_cast<BulletType>(reader.ReadVarUInt());
+    bullet_params.weapon = static_cast<WeaponType>(reader.ReadVarUInt());
+    bullet_params.position = ReadVec2(reader);
+    bullet_params.velocity = ReadVec2(reader);
+    bullet_params.timeout = static_cast<std::int16_t>(reader.ReadVarInt());
+    bullet_params.hit_multiply = reader.ReadFloat();
+    bullet_params.team = static_cast<TeamType>(reader.ReadVarUInt());
+    bullet_params.owner_id = reader.ReadByte();
+    bullet_params.push = reader.ReadFloat();
+    bullet_params.lag_compensation_ticks = reader.ReadByte();
+    return bullet_params;
+}
+
+void WriteItemKeyframe(ReplayByteWriter& writer, const ReplayItemKeyframe& item)
+{
+    writer.WriteByte(item.id);
+    writer.WriteByte(std::to_underlying(item.style));
+    writer.WriteByte(item.owner);
+    writer.WriteByte(item.holding_soldier_id);
+    writer.WriteByte(item.ammo_count);
+    writer.WriteFloat(item.radius);
+    writer.WriteVarInt(item.time_out);
+    writer.WriteBool(item.static_type);
+    writer.WriteVarInt(item.interest);
+    writer.WriteBool(item.collide_with_bullets);
+    writer.WriteBool(item.in_base);
+    writer.WriteByte(item.last_spawn);
+    writer.WriteByte(item.team);
+    writer.WriteBool(item.flipped);
+    for (auto collide_count : item.collide_count) {
+        writer.WriteByte(collide_count);
+    }
+    writer.WriteVarUInt(item.particles.size());
+    for (const auto& particle : item.particles) {
+        WriteVec2(writer, particle.position);
+        WriteVec2(writer, particle.old_position);
+        WriteVec2(writer, particle.force);
+    }
+}
+
+ReplayItemKeyframe ReadItemKeyframe(ReplayByteReader& reader)
+{
+    ReplayItemKeyframe item;
+    item.id = reader.ReadByte();
+    item.style = static_cast<ItemType>(reader.ReadByte());
+    item.owner = reader.ReadByte();
+    item.holding_soldier_id = reader.ReadByte();
+    item.ammo_count = reader.ReadByte();
+    item.radius = reader.ReadFloat();
+    item.time_out = static_cast<std::int32_t>(reader.ReadVarInt());
+    item.static_type = reader.ReadBool();
+    item.interest = static_cast<std::int32_t>(reader.ReadVarInt());
+    item.collide_with_bullets = reader.ReadBool();
+    item.in_base = reader.ReadBool();
+    item.last_spawn = reader.ReadByte();
+    item.team = reader.ReadByte();
+    item.flipped = reader.ReadBool();
+    for (auto& collide_count : item.collide_count) {
+        collide_count = reader.ReadByte();
+    }
+    const std::uint64_t particles_count =
+      ReadElementsCount(reader, "Replay item particle count exceeds the replay data");
+    item.particles.reserve(particles_count);
+    for (std::uint64_t i = 0; i < particles_count; ++i) {
+        ReplayItemParticleKeyframe particle;
+        particle.position = ReadVec2(reader);
+        particle.old_position = ReadVec2(reader);
+        particle.force = ReadVec2(reader);
+        item.particles.push_back(particle);
+    }
+    return item;
+}
+} // namespace Detail
+
+void WriteHeader(ReplayByteWriter& writer, const ReplayHeader& header)
+{
+    for (char character : REPLAY_MAGIC) {
+        writer.WriteByte(static_cast<std::uint8_t>(character));
+    }
+    writer.WriteVarUInt(REPLAY_VERSION);
+    writer.WriteVarUInt(header.keyframe_interval);
+    writer.WriteString(header.map_path);
+    writer.WriteBool(header.lag_compensation);
+}
+
+std::expected<ReplayHeader, ReplayError> ReadHeader(ReplayByteReader& reader)
+{
+    try {
+        for (char character : REPLAY_MAGIC) {
+            if (reader.ReadByte() != static_cast<std::uint8_t>(character)) {
+                return std::unexpected(ReplayError::InvalidHeader);
+            }
+        }
+        if (reader.ReadVarUInt() != REPLAY_VERSION) {
+            return std::unexpected(ReplayError::UnsupportedVersion);
+        }
+
+        ReplayHeader header;
+        header.keyframe_interval = static_cast<std::uint32_t>(reader.ReadVarUInt());
+        header.map_path = reader.ReadString();
+        header.lag_compensation = reader.ReadBool();
+        return header;
+    } catch (const std::runtime_error& /*error*/) {
+        return std::unexpected(ReplayError::InvalidHeader);
+    }
+}
+
+void WriteKeyframe(ReplayByteWriter& writer,
+                   const ReplayKeyframe& keyframe,
+                   ReplayDeltaContext& delta_context)
+{
+    delta_context.Reset();
+    writer.WriteByte(std::to_underlying(ReplayRecordType::Keyframe));
+    writer.WriteVarUInt(keyframe.tick);
+    writer.WriteVarUInt(keyframe.random_state.state);
+    writer.WriteVarUInt(keyframe.random_state.increment);
+    writer.WriteVarUInt(keyframe.soldiers.size());
+    for (const auto& soldier : keyframe.soldiers) {
+        Detail::WriteSoldierKeyframe(writer, soldier);
+    }
+    writer.WriteVarUInt(keyframe.bullets.size());
+    for (const auto& bullet : keyframe.bullets) {
+        Detail::WriteBulletKeyframe(writer, bullet);
+    }
+    writer.WriteVarUInt(keyframe.bullet_emitter.size());
+    for (const auto& bullet_params : keyframe.bullet_emitter) {
+        Detail::WriteBulletParams(writer, bullet_params);
+    }
+    writer.WriteVarUInt(keyframe.items.size());
+    for (const auto& item : keyframe.items) {
+        Detail::WriteItemKeyframe(writer, item);
+    }
+    delta_context.SetPreviousTick(keyframe.tick);
+}
+
+void WriteTick(ReplayByteWriter& writer,
+               const ReplayTickRecord& tick_record,
+               ReplayDeltaContext& delta_context)
+{
+    writer.WriteByte(std::to_underlying(ReplayRecordType::Tick));
+    writer.WriteVarUInt(
+      static_cast<std::uint32_t>(tick_record.tick - delta_context.GetPreviousTick().value_or(0)));
+    writer.WriteVarUInt(tick_record.player_inputs.size());
+    for (const auto& player_input : tick_record.player_inputs) {
+        Detail::WritePlayerInput(writer, tick_record.tick, player_input, delta_context);
+    }
+    writer.WriteVarUInt(tick_record.commands.size());
+    for (const auto& command : tick_record.commands) {
+        Detail::WriteCommand(writer, command);
+    }
+    delta_context.SetPreviousTick(tick_record.tick);
+}
+
+// Reads the record that follows the type byte
+ReplayKeyframe ReadKeyframe(ReplayByteReader& reader, ReplayDeltaContext& delta_context)
+{
+    delta_context.Reset();
+    ReplayKeyframe keyframe;
+    keyframe.tick = static_cast<std::uint32_t>(reader.ReadVarUInt());
+    keyframe.random_state.state = reader.ReadVarUInt();
+    keyframe.random_state.increment = reader.ReadVarUInt();
+    const std::uint64_t soldiers_count = reader.ReadVarUInt();
+    if (soldiers_count > reader.GetRemainingSize()) {
+        throw std::runtime_error("Replay soldier count exceeds the replay data");
+    }
+    keyframe.soldiers.reserve(soldiers_count);
+    for (std::uint64_t i = 0; i < soldiers_count; ++i) {
+        keyframe.soldiers.push_back(Detail::ReadSoldierKeyframe(reader));
+    }
+    const std::uint64_t bullets_count =
+      Detail::ReadElementsCount(reader, "Replay bullet count exceeds the replay data");
+    keyframe.bullets.reserve(bullets_count);
+    for (std::uint64_t i = 0; i < bullets_count; ++i) {
+        keyframe.bullets.push_back(Detail::ReadBulletKeyframe(reader));
+    }
+    const std::uint64_t bullet_emitter_count =
+      Detail::ReadElementsCount(reader, "Replay bullet emitter count exceeds the replay data");
+    keyframe.bullet_emitter.reserve(bullet_emitter_count);
+    for (std::uint64_t i = 0; i < bullet_emitter_count; ++i) {
+        keyframe.bullet_emitter.push_back(Detail::ReadBulletParams(reader));
+    }
+    const std::uint64_t items_count =
+      Detail::ReadElementsCount(reader, "Replay item count exceeds the replay data");
+    keyframe.items.reserve(items_count);
+    for (std::uint64_t i = 0; i < items_count; ++i) {
+        keyframe.items.push_back(Detail::ReadItemKeyframe(reader));
+    }
+    delta_context.SetPreviousTick(keyframe.tick);
+    return keyframe;
+}
+
+ReplayTickRecord ReadTick(ReplayByteReader& reader, ReplayDeltaContext& delta_context)
+{
+    ReplayTickRecord tick_record;
+    tick_record.tick = delta_context.GetPreviousTick().value_or(0) +
+                       static_cast<std::uint32_t>(reader.ReadVarUInt());
+
+    const std::uint64_t player_inputs_count = reader.ReadVarUInt();
+    if (player_inputs_count > reader.GetRemainingSize()) {
+        throw std::runtime_error("Replay input count exceeds the replay data");
+    }
+    tick_record.player_inputs.reserve(player_inputs_count);
+    for (std::uint64_t i = 0; i < player_inputs_count; ++i) {
+        tick_record.player_inputs.push_back(
+          Detail::ReadPlayerInput(reader, tick_record.tick, delta_context));
+    }
+
+    const std::uint64_t commands_count = reader.ReadVarUInt();
+    if (commands_count > reader.GetRemainingSize()) {
+        throw std::runtime_error("Replay command count exceeds the replay data");
+    }
+    tick_record.commands.reserve(commands_count);
+    for (std::uint64_t i = 0; i < commands_count; ++i) {
+        tick_record.commands.push_back(Detail::ReadCommand(reader));
+    }
+    delta_context.SetPreviousTick(tick_record.tick);
+    return tick_record;
+}
+} // namespace ReplayFormat
+} // namespace Soldank
@@ -0,0 +1,270 @@
+module;
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+export module Shared.Core.Replay.ReplayKeyframes;
+
+import Shared.Core.IWorld;
+import Shared.Core.Entities.Bullet;
+import Shared.Core.Entities.Item;
+import Shared.Core.Entities.Soldier;
+import Shared.Core.Entities.Weapon;
+import Shared.Core.Entities.WeaponParametersFactory;
+import Shared.Core.Replay.ReplayFormat;
+import Shared.Core.State.StateManager;
+
+export namespace Soldank::ReplayKeyframes
+{
+ReplayKeyframe Capture(const StateManager& state_manager)
+{
+    ReplayKeyframe keyframe{ .tick = state_manager.GetGameTick(),
+                             .random_state = state_manager.GetRandomState(),
+                             .soldiers = {},
+                             .bullets = {},
+                             .bullet_emitter = state_manager.GetBulletEmitter(),
+                             .items = {} };
+    state_manager.ForEachSoldier([&](const Soldier& soldier) {
+        ReplaySoldierKeyframe soldier_keyframe{
+            .id = soldier.id,
+            .active = soldier.active,
+            .dead_meat = soldier.dead_meat,
+            .health = soldier.health,
+            .ticks_to_respawn = soldier.ticks_to_respawn,
+            .position = soldier.particle.position,
+            .old_position = soldier.particle.old_position,
+            .velocity = soldier.particle.GetVelocity(),
+            .force = soldier.particle.GetForce(),
+            .mouse = soldier.mouse,
+            .body_animation_type = soldier.body_animation->GetType(),
+            .body_animation_frame = soldier.body_animation->GetFrame(),
+            .body_animation_speed = soldier.body_animation->GetSpeed(),
+            .body_animation_count = soldier.body_animation->GetCount(),
+            .legs_animation_type = soldier.legs_animation->GetType(),
+            .legs_animation_frame = soldier.legs_animation->GetFrame(),
+            .legs_animation_speed = soldier.legs_animation->GetSpeed(),
+            .legs_animation_count = soldier.legs_animation->GetCount(),
+            .on_ground = soldier.on_ground,
+            .on_ground_for_law = soldier.on_ground_for_law,
+            .on_ground_last_frame = soldier.on_ground_last_frame,
+            .on_ground_permanent = soldier.on_ground_permanent,
+            .half_dead = soldier.half_dead,
+            .is_shooting = soldier.is_shooting,
+            .grenade_can_throw = soldier.grenade_can_throw,
+            .is_holding_flags = soldier.is_holding_flags,
+            .direction = soldier.direction,
+            .old_direction = soldier.old_direction,
+            .stance = soldier.stance,
+            .fired = soldier.fired,
+            .jets_count = soldier.jets_count,
+            .jets_count_prev = soldier.jets_count_prev,
+            .control = soldier.control,
+            .active_weapon = soldier.active_weapon,
+            .weapon_choices = soldier.weapon_choices,
+            .weapons = {},
+        };
+        soldier_keyframe.weapons.reserve(soldier.weapons.size());
+        for (const auto& weapon : soldier.weapons) {
+            soldier_keyframe.weapons.push_back({ .weapon_type = weapon.GetWeaponParameters().kind,
+                                                 .ammo_count = weapon.GetAmmoCount() });
+        }
+        keyframe.soldiers.push_back(std::move(soldier_keyframe));
+    });
+
+    for (std::size_t slot = 0; slot < state_manager.GetBulletSlotsCount(); ++slot) {
+        const Bullet& bullet = state_manager.GetBulletSlot(slot);
+        if (!bullet.active) {
+            continue;
+        }
+
+        keyframe.bullets.push_back({
+          .slot = static_cast<std::uint16_t>(slot),
+          .style = bullet.style,
+          .weapon = bullet.weapon,
+          .team = bullet.team,
+          .owner_id = bullet.owner_id,
+          .position = bullet.particle.position,
+          .old_position = bullet.particle.old_position,
+          .velocity = bullet.particle.GetVelocity(),
+          .force = bullet.particle.GetForce(),
+          .initial_position = bullet.initial_position,
+          .velocity_prev = bullet.velocity_prev,
+          .timeout = bullet.timeout,
+          .timeout_prev = bullet.timeout_prev,
+          .timeout_real = bullet.timeout_real,
+          .hit_multiply = bullet.hit_multiply,
+          .hit_multiply_prev = bullet.hit_multiply_prev,
+          .degrade_count = bullet.degrade_count,
+          .push = bullet.push,
+          .lag_compensation_ticks = bullet.lag_compensation_ticks,
+        });
+    }
+
+    state_manager.ForEachItem([&](const Item& item) {
+        ReplayItemKeyframe item_keyframe{
+            .id = item.id,
+            .style = item.style,
+            .owner = item.owner,
+            .holding_soldier_id = item.holding_soldier_id,
+            .ammo_count = item.ammo_count,
+            .radius = item.radius,
+            .time_out = item.time_out,
+            .static_type = item.static_type,
+            .interest = item.interest,
+            .collide_with_bullets = item.collide_with_bullets,
+            .in_base = item.in_base,
+            .last_spawn = item.last_spawn,
+            .team = item.team,
+            .flipped = item.flipped,
+            .collide_count = item.collide_count,
+            .particles = {},
+        };
+        item_keyframe.particles.reserve(item.skeleton->GetParticles().size());
+        for (const auto& particle : item.skeleton->GetParticles()) {
+            item_keyframe.particles.push_back({ .position = particle.position,
+                                                .old_position = particle.old_position,
+                                                .force = particle.GetForce() });
+        }
+        keyframe.items.push_back(std::move(item_keyframe));
+    });
+    return keyframe;
+}
+
+// Soldiers, projectiles and items are restored completely. Items get their skeletons loaded
+// again, so they have to be restored after the soldiers that own them.
+void Restore(IWorld& world, const ReplayKeyframe& keyframe)
+{
+    auto& state_manager = *world.GetStateManager();
+
+    std::vector<std::uint8_t> soldiers_to_remove;
+    state_manager.ForEachSoldier([&](const Soldier& soldier) {
+        if (std::ranges::none_of(keyframe.soldiers, [&](const auto& soldier_keyframe) {
+                return soldier_keyframe.id == soldier.id;
+            })) {
+            soldiers_to_remove.push_back(soldier.id);
+        }
+    });
+    for (auto soldier_id : soldiers_to_remove) {
+        state_manager.RemoveSoldier(soldier_id);
+    }
+
+    state_manager.TransformBullets([](Bullet& bullet) { bullet.active = false; });
+    state_manager.ClearBulletEmitter();
+    state_manager.TransformItems([](Item& item) { item.active = false; });
+
+    for (const auto& soldier_keyframe : keyframe.soldiers) {
+        world.CreateSoldier(soldier_keyframe.id);
+        state_manager.TransformSoldier(soldier_keyframe.id, [&](Soldier& soldier) {
+            soldier.active = soldier_keyframe.active;
+            soldier.dead_meat = soldier_keyframe.dead_meat;
+            soldier.health = soldier_keyframe.health;
+            soldier.ticks_to_respawn = soldier_keyframe.ticks_to_respawn;
+            soldier.particle.position = soldier_keyframe.position;
+            soldier.particle.old_position = soldier_keyframe.old_position;
+            soldier.particle.SetVelocity(soldier_keyframe.velocity);
+            soldier.particle.SetForce(soldier_keyframe.force);
+            soldier.mouse = soldier_keyframe.mouse;
+
+            soldier.body_animation =
+              world.GetBodyAnimationState(soldier_keyframe.body_animation_type);
+            soldier.body_animation->SetFrame(soldier_keyframe.body_animation_frame);
+            soldier.body_animation->SetSpeed(soldier_keyframe.body_animation_speed);
+            soldier.body_animation->SetCount(soldier_keyframe.body_animation_count);
+            soldier.legs_animation =
+              world.GetLegsAnimationState(soldier_keyframe.legs_animation_type);
+            soldier.legs_animation->SetFrame(soldier_keyframe.legs_animation_frame);
+            soldier.legs_animation->SetSpeed(soldier_keyframe.legs_animation_speed);
+            soldier.legs_animation->SetCount(soldier_keyframe.legs_animation_count);
+
+            soldier.on_ground = soldier_keyframe.on_ground;
+            soldier.on_ground_for_law = soldier_keyframe.on_ground_for_law;
+            soldier.on_ground_last_frame = soldier_keyframe.on_ground_last_frame;
+            soldier.on_ground_permanent = soldier_keyframe.on_ground_permanent;
+            soldier.half_dead = soldier_keyframe.half_dead;
+            soldier.is_shooting = soldier_keyframe.is_shooting;
+            soldier.grenade_can_throw = soldier_keyframe.grenade_can_throw;
+            soldier.is_holding_flags = soldier_keyframe.is_holding_flags;
+            soldier.direction = soldier_keyframe.direction;
+            soldier.old_direction = soldier_keyframe.old_direction;
+            soldier.stance = soldier_keyframe.stance;
+            soldier.fired = soldier_keyframe.fired;
+            soldier.jets_count = soldier_keyframe.jets_count;
+            soldier.jets_count_prev = soldier_keyframe.jets_count_prev;
+            soldier.control = soldier_keyframe.control;
+            soldier.active_weapon = soldier_keyframe.active_weapon;
+            soldier.weapon_choices = soldier_keyframe.weapon_choices;
+
+            soldier.weapons.clear();
+            for (const auto& weapon_keyframe : soldier_keyframe.weapons) {
+                Weapon weapon{ WeaponParametersFactory::GetParameters(weapon_keyframe.weapon_type,
+                                                                      false) };
+                weapon.SetAmmoCount(weapon_keyframe.ammo_count);
+                soldier.weapons.push_back(weapon);
+            }
+        });
+    }
+
+    for (const auto& bullet_keyframe : keyframe.bullets) {
+        Bullet bullet{ BulletParams{ .style = bullet_keyframe.style,
+                                     .weapon = bullet_keyframe.weapon,
+                                     .position = bullet_keyframe.position,
+                                     .velocity = bullet_keyframe.velocity,
+                                     .timeout = bullet_keyframe.timeout,
+                                     .hit_multiply = bullet_keyframe.hit_multiply,
+                                     .team = bullet_keyframe.team,
+                                     .owner_id = bullet_keyframe.owner_id,
+                                     .push = bullet_keyframe.push,
+                                     .lag_compensation_ticks =
+                                       bullet_keyframe.lag_compensation_ticks } };
+        bullet.particle.old_position = bullet_keyframe.old_position;
+        bullet.particle.SetForce(bullet_keyframe.force);
+        bullet.initial_position = bullet_keyframe.initial_position;
+        bullet.velocity_prev = bullet_keyframe.velocity_prev;
+        bullet.timeout_prev = bullet_keyframe.timeout_prev;
+        bullet.timeout_real = bullet_keyframe.timeout_real;
+        bullet.hit_multiply_prev = bullet_keyframe.hit_multiply_prev;
+        bullet.degrade_count = bullet_keyframe.degrade_count;
+        state_manager.SetBulletSlot(bullet_keyframe.slot, bullet);
+    }
+    for (const auto& bullet_params : keyframe.bullet_emitter) {
+        state_manager.EnqueueNewProjectile(bullet_params);
+    }
+
+    for (const auto& item_keyframe : keyframe.items) {
+        if (item_keyframe.particles.empty()) {
+            continue;
+        }
+
+        Item& item = state_manager.CreateItem(item_keyframe.particles.front().position,
+                                              item_keyframe.owner,
+                                              item_keyframe.style,
+                                              item_keyframe.id);
+        item.holding_soldier_id = item_keyframe.holding_soldier_id;
+        item.ammo_count = item_keyframe.ammo_count;
+        item.radius = item_keyframe.radius;
+        item.time_out = item_keyframe.time_out;
+        item.static_type = item_keyframe.static_type;
+        item.interest = item_keyframe.interest;
+        item.collide_with_bullets = item_keyframe.collide_with_bullets;
+        item.in_base = item_keyframe.in_base;
+        item.last_spawn = item_keyframe.last_spawn;
+        item.team = item_keyframe.team;
+        item.flipped = item_keyframe.flipped;
+        item.collide_count = item_keyframe.collide_count;
+        const auto particles_count =
+          std::min(item_keyframe.particles.size(), item.skeleton->GetParticles().size());
+        for (unsigned int i = 0; i < particles_count; ++i) {
+            const auto& particle_keyframe = item_keyframe.particles.at(i);
+            item.skeleton->SetPos(i + 1, particle_keyframe.position);
+            item.skeleton->SetOldPos(i + 1, particle_keyframe.old_position);
+            item.skeleton->SetForce(i + 1, particle_keyframe.force);
+        }
+    }
+
+    state_manager.SetRandomState(keyframe.random_state);
+    state_manager.SetGameTick(keyframe.tick);
+}
+} // namespace Soldank::ReplayKeyframes
@@ -0,0 +1,241 @@
+module;
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <ios>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "core/utility/Expected.hpp"
+
+export module Shared.Core.Replay.ReplayPlayer;
+
+import Shared.Core.IWorld;
+import Shared.Core.Data.FileReader;
+import Shared.Core.Data.IFileReader;
+import Shared.Core.Replay.ReplayFormat;
+import Shared.Core.Replay.ReplayKeyframes;
+import Shared.Core.Simulation.SimulationCommands;
+import Shared.Core.Simulation.WorldTick;
+import Shared.Core.State.StateManager;
+
+export namespace Soldank
+{
+struct ReplayKeyframeIndexEntry
+{
+    std::uint32_t tick;
+    // Offset of the keyframe record in the replay data
+    std::size_t offset;
+};
+
+// Plays recorded tick inputs back into a world without any frame pacing, so a replay is
+// simulated as fast as the CPU allows
+class ReplayPlayer
+{
+public:
+    static std::expected<ReplayPlayer, ReplayError> FromData(std::vector<std::byte> replay_data)
+    {
+        ReplayByteReader reader{ replay_data };
+        auto header = ReplayFormat::ReadHeader(reader);
+        if (!header.has_value()) {
+            return std::unexpected(header.error());
+        }
+
+        // A recording that was cut short (e.g. the server crashed) is played up to its last
+        // complete record
+        std::vector<ReplayKeyframeIndexEntry> keyframes;
+        std::uint32_t last_tick = 0;
+        std::size_t valid_size = reader.GetOffset();
+        bool is_truncated = false;
+        ReplayDeltaContext delta_context;
+        try {
+            while (!reader.IsAtEnd()) {
+                const std::size_t record_offset = reader.GetOffset();
+                const auto record_type = static_cast<ReplayRecordType>(reader.ReadByte());
+                if (record_type == ReplayRecordType::Keyframe) {
+                    auto keyframe = ReplayFormat::ReadKeyframe(reader, delta_context);
+                    keyframes.push_back({ .tick = keyframe.tick, .offset = record_offset });
+                    last_tick = keyframe.tick;
+                } else if (record_type == ReplayRecordType::Tick && !keyframes.empty()) {
+                    last_tick = ReplayFormat::ReadTick(reader, delta_context).tick;
+                } else {
+                    throw std::runtime_error("Unexpected replay record");
+                }
+                valid_size = reader.GetOffset();
+            }
+        } catch (const std::runtime_error& /*error*/) {
+            is_truncated = true;
+        }
+
+        if (keyframes.empty()) {
+            return std::unexpected(ReplayError::CorruptedData);
+        }
+
+        replay_data.resize(valid_size);
+        return ReplayPlayer(std::move(*header),
+                            std::move(replay_data),
+                            std::move(keyframes),
+                            last_tick,
+                            is_truncated);
+    }
+
+    static std::expected<ReplayPlayer, ReplayError> Load(
+      const std::filesystem::path& replay_path,
+      const IFileReader& file_reader = FileReader())
+    {
+        auto file_data = file_reader.Read(replay_path.string(), std::ios::in | std::ios::binary);
+        if (!file_data.has_value()) {
+            return std::unexpected(ReplayError::FileNotFound);
+        }
+
+        std::vector<std::byte> replay_data(file_data->size());
+        if (!replay_data.empty()) {
+            std::memcpy(replay_data.data(), file_data->data(), file_data->size());
+        }
+        return FromData(std::move(replay_data));
+    }
+
+    const ReplayHeader& GetHeader() const { return header_; }
+    const std::vector<ReplayKeyframeIndexEntry>& GetKeyframes() const { return keyframes_; }
+    std::uint32_t GetFirstTick() const { return keyframes_.front().tick; }
+    std::uint32_t GetLastTick() const { return last_tick_; }
+    bool IsTruncated() const { return is_truncated_; }
+
+    // Restores the nearest keyframe at or before target_tick and simulates forward from it. The
+    // world is left at the start of target_tick.
+    ReplayError SeekTo(IWorld& world, std::uint32_t target_tick) const
+    {
+        if (target_tick < GetFirstTick() || target_tick > GetLastTick() + 1) {
+            return ReplayError::TickOutOfRange;
+        }
+
+        return Simulate(world, FindKeyframeIndex(target_tick), std::nullopt, target_tick);
+    }
+
+    // Continues simulating from the world's current tick up to the start of target_tick
+    ReplayError PlayTo(IWorld& world, std::uint32_t target_tick) const
+    {
+        const std::uint32_t current_tick = world.GetStateManager()->GetGameTick();
+        if (current_tick < GetFirstTick() || target_tick < current_tick ||
+            target_tick > GetLastTick() + 1) {
+            return ReplayError::TickOutOfRange;
+        }
+
+        return Simulate(world, FindKeyframeIndex(current_tick), current_tick, target_tick);
+    }
+
+private:
+    ReplayPlayer(ReplayHeader header,
+                 std::vector<std::byte> replay_data,
+                 std::vector<ReplayKeyframeIndexEntry> keyframes,
+                 std::uint32_t last_tick,
+                 bool is_truncated)
+        : header_(std::move(header))
+        , replay_data_(std::move(replay_data))
+        , keyframes_(std::move(keyframes))
+        , last_tick_(last_tick)
+        , is_truncated_(is_truncated)
+    {
+    }
+
+    std::size_t FindKeyframeIndex(std::uint32_t tick) const
+    {
+        auto it = std::ranges::upper_bound(
+          keyframes_, tick, {}, [](const ReplayKeyframeIndexEntry& entry) { return entry.tick; });
+        return static_cast<std::size_t>(std::distance(keyframes_.begin(), it)) - 1;
+    }
+
+    // Without start_tick the keyframe is restored into the world, otherwise the world already
+    // is at start_tick and the records before it are only decoded
+    ReplayError Simulate(IWorld& world,
+                         std::size_t keyframe_index,
+                         std::optional<std::uint32_t> start_tick,
+                         std::uint32_t target_tick) const
+    {
+        if (!start_tick.has_value()) {
+            world.SetLagCompensationEnabled(header_.lag_compensation);
+            // Bullets fired right after the keyframe are tested against targets as they were
+            // before it, so the ticks before it are simulated from the previous keyframe to record
+            // their hitboxes. Lag compensated hits right after the previous keyframe have no
+            // history themselves and can still leave these hitboxes off the recorded ones.
+            if (header_.lag_compensation && keyframe_index > 0) {
+                SimulateFromKeyframe(world,
+                                     keyframe_index - 1,
+                                     std::nullopt,
+                                     keyframes_.at(keyframe_index).tick);
+            }
+        }
+
+        SimulateFromKeyframe(world, keyframe_index, start_tick, target_tick);
+        return ReplayError::NoError;
+    }
+
+    void SimulateFromKeyframe(IWorld& world,
+                              std::size_t keyframe_index,
+                              std::optional<std::uint32_t> start_tick,
+                              std::uint32_t target_tick) const
+    {
+        ReplayByteReader reader{ replay_data_, keyframes_.at(keyframe_index).offset };
+        ReplayDeltaContext delta_context;
+        static_cast<void>(reader.ReadByte());
+        const auto keyframe = ReplayFormat::ReadKeyframe(reader, delta_context);
+        if (!start_tick.has_value()) {
+            ReplayKeyframes::Restore(world, keyframe);
+        }
+
+        std::uint32_t tick = start_tick.value_or(keyframe.tick);
+        auto next_record = ReadNextTickRecord(reader, delta_context);
+        while (tick < target_tick) {
+            while (next_record.has_value() && next_record->tick < tick) {
+                next_record = ReadNextTickRecord(reader, delta_context);
+            }
+
+            if (next_record.has_value() && next_record->tick == tick) {
+                TickWorld(world, tick, next_record->player_inputs, next_record->commands);
+                next_record = ReadNextTickRecord(reader, delta_context);
+            } else {
+                TickWorld(world, tick, {}, {});
+            }
+            ++tick;
+        }
+    }
+
+    // Keyframes met on the way only reset the delta state, the simulation itself carries on
+    static std::optional<ReplayTickRecord> ReadNextTickRecord(ReplayByteReader& reader,
+                                                              ReplayDeltaContext& delta_context)
+    {
+        while (!reader.IsAtEnd()) {
+            const auto record_type = static_cast<ReplayRecordType>(reader.ReadByte());
+            if (record_type == ReplayRecordType::Keyframe) {
+                static_cast<void>(ReplayFormat::ReadKeyframe(reader, delta_context));
+                continue;
+            }
+            return ReplayFormat::ReadTick(reader, delta_context);
+        }
+        return std::nullopt;
+    }
+
+    static void TickWorld(IWorld& world,
+                          std::uint32_t tick,
+                          std::span<const PlayerInputCommand> player_inputs,
+                          std::span<const SimulationCommand> commands)
+    {
+        static_cast<void>(
+          world.Tick({ .tick = tick, .player_inputs = player_inputs, .commands = commands }));
+        world.GetStateManager()->SetGameTick(tick + 1);
+    }
+
+    ReplayHeader header_;
+    std::vector<std::byte> replay_data_;
+    std::vector<ReplayKeyframeIndexEntry> keyframes_;
+    std::uint32_t last_tick_;
+    bool is_truncated_;
+};
+} // namespace Soldank
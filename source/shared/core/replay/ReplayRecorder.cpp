@@ -0,0 +1,83 @@
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+export module Shared.Core.Replay.ReplayRecorder;
+
+import Shared.Core.Replay.ReplayFormat;
+import Shared.Core.Replay.ReplayKeyframes;
+import Shared.Core.Simulation.WorldTick;
+import Shared.Core.State.StateManager;
+
+export namespace Soldank
+{
+class ReplayRecorder
+{
+public:
+    // 10 seconds at 60 ticks per second
+    static constexpr std::uint32_t DEFAULT_KEYFRAME_INTERVAL = 600;
+
+    explicit ReplayRecorder(ReplayHeader header)
+        : header_(std::move(header))
+    {
+        if (header_.keyframe_interval == 0) {
+            header_.keyframe_interval = DEFAULT_KEYFRAME_INTERVAL;
+        }
+        ReplayFormat::WriteHeader(writer_, header_);
+    }
+
+    // Has to be called before the tick is simulated, keyframes capture the state the tick
+    // starts from
+    void RecordTick(const WorldTickInput& input, const StateManager& state_manager)
+    {
+        if (!last_keyframe_tick_.has_value() ||
+            input.tick - *last_keyframe_tick_ >= header_.keyframe_interval) {
+            auto keyframe = ReplayKeyframes::Capture(state_manager);
+            keyframe.tick = input.tick;
+            ReplayFormat::WriteKeyframe(writer_, keyframe, delta_context_);
+            last_keyframe_tick_ = input.tick;
+            ++keyframes_count_;
+        }
+
+        // Ticks without inputs and commands are implied by the tick delta of the next record
+        if (input.player_inputs.empty() && input.commands.empty()) {
+            return;
+        }
+
+        ReplayFormat::WriteTick(writer_,
+                                { .tick = input.tick,
+                                  .player_inputs = { input.player_inputs.begin(),
+                                                     input.player_inputs.end() },
+                                  .commands = { input.commands.begin(), input.commands.end() } },
+                                delta_context_);
+    }
+
+    // Returns everything recorded since the previous call, so the stream can be appended to a
+    // file in chunks while the match is still running
+    std::vector<std::byte> TakeRecordedData()
+    {
+        recorded_bytes_count_ += writer_.GetData().size();
+        return writer_.TakeData();
+    }
+
+    std::size_t GetPendingBytesCount() const { return writer_.GetData().size(); }
+    std::size_t GetRecordedBytesCount() const
+    {
+        return recorded_bytes_count_ + writer_.GetData().size();
+    }
+    std::size_t GetKeyframesCount() const { return keyframes_count_; }
+    const ReplayHeader& GetHeader() const { return header_; }
+
+private:
+    ReplayHeader header_;
+    ReplayByteWriter writer_;
+    ReplayDeltaContext delta_context_;
+    std::optional<std::uint32_t> last_keyframe_tick_;
+    std::size_t keyframes_count_ = 0;
+    std::size_t recorded_bytes_count_ = 0;
+};
+} // namespace Soldank
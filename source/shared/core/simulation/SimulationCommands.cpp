@@ -19,6 +19,8 @@ struct PlayerInputCommand
     std::uint32_t input_sequence_id;
     std::uint32_t client_tick;
     std::uint32_t apply_server_tick;
+    // Server tick of the remote soldiers' states the client was drawing when it sent the input
+    std::uint32_t view_server_tick;
     Control control;
     glm::vec2 mouse_map_position;
 };
@@ -1,3 +1,9 @@
+module;
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
 export module Shared.Core.State.Control;
 
 export namespace Soldank
@@ -42,4 +48,61 @@ struct Control
     bool was_throwing_grenade;
     bool was_reloading_weapon;
 };
+
+constexpr unsigned int CONTROL_FLAGS_COUNT = 18;
+
+// Packs every bool of the control into a bit mask, used by the compact input encodings
+std::uint32_t PackControlFlags(const Control& control)
+{
+    const std::array<bool, CONTROL_FLAGS_COUNT> flags{ control.left,
+                                                       control.right,
+                                                       control.up,
+                                                       control.down,
+                                                       control.fire,
+                                                       control.jets,
+                                                       control.change,
+                                                       control.throw_grenade,
+                                                       control.drop,
+                                                       control.reload,
+                                                       control.prone,
+                                                       control.flag_throw,
+                                                       control.was_running_left,
+                                                       control.was_jumping,
+                                                       control.was_throwing_weapon,
+                                                       control.was_changing_weapon,
+                                                       control.was_throwing_grenade,
+                                                       control.was_reloading_weapon };
+    std::uint32_t packed_flags = 0;
+    for (std::size_t i = 0; i < flags.size(); ++i) {
+        if (flags.at(i)) {
+            packed_flags |= 1U << i;
+        }
+    }
+    return packed_flags;
+}
+
+void UnpackControlFlags(std::uint32_t packed_flags, Control& control)
+{
+    const std::array<bool*, CONTROL_FLAGS_COUNT> flags{ &control.left,
+                                                        &control.right,
+                                                        &control.up,
+                                                        &control.down,
+                                                        &control.fire,
+                                                        &control.jets,
+                                                        &control.change,
+                                                        &control.throw_grenade,
+                                                        &control.drop,
+                                                        &control.reload,
+                                                        &control.prone,
+                                                        &control.flag_throw,
+                                                        &control.was_running_left,
+                                                        &control.was_jumping,
+                                                        &control.was_throwing_weapon,
+                                                        &control.was_changing_weapon,
+                                                        &control.was_throwing_grenade,
+                                                        &control.was_reloading_weapon };
+    for (std::size_t i = 0; i < flags.size(); ++i) {
+        *flags.at(i) = (packed_flags & (1U << i)) != 0;
+    }
+}
 } // namespace Soldank
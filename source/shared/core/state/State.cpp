@@ -11,6 +11,7 @@ import Shared.Core.Physics.Particles;
 import Shared.Core.Animations;
 import Shared.Core.Entities.WeaponParametersFactory;
 import Shared.Core.Map.Map;
+import Shared.Core.Math.Random;
 import Shared.Core.Entities.Bullet;
 import Shared.Core.Entities.Soldier;
 import Shared.Core.Entities.Item;
@@ -39,6 +40,8 @@ struct State
 
     unsigned int game_tick{};
     bool paused{};
+    // Every random draw of the simulation goes through it, so it is part of the world state
+    SimulationRandom random;
     Map map;
     std::array<Bullet, MAX_BULLETS_COUNT> bullets;
     std::array<Soldier, MAX_SOLDIERS_COUNT> soldiers;
@@ -2,11 +2,12 @@ module;
 
 #include "spdlog/spdlog.h"
 #include <algorithm>
+#include <cstdint>
 #include <utility>
 #include <memory>
 #include <filesystem>
 #include <functional>
-#include <random>
+#include <optional>
 #include <stdexcept>
 #include <vector>
 
@@ -14,12 +15,15 @@ export module Shared.Core.State.StateManager;
 
 import Extern.Glm;
 
+import Shared.Core.Data.FileReader;
+import Shared.Core.Data.IFileReader;
 import Shared.Core.Entities.Weapon;
 import Shared.Core.Entities.WeaponParametersFactory;
 import Shared.Core.Entities.Bullet;
 import Shared.Core.Entities.Soldier;
 import Shared.Core.Entities.Item;
 import Shared.Core.Math.Calc;
+import Shared.Core.Math.Random;
 import Shared.Core.Map.Map;
 import Shared.Core.Map.MapDocument;
 import Shared.Core.Map.PMSEnums;
@@ -39,7 +43,8 @@ class StateManager
 public:
     StateManager(
       AnimationDataManager& animation_data_manager,
-      std::shared_ptr<ParticleSystem> skeleton = ParticleSystem::Load(ParticleSystemType::Soldier));
+      std::shared_ptr<ParticleSystem> skeleton = ParticleSystem::Load(ParticleSystemType::Soldier),
+      std::shared_ptr<const IFileReader> file_reader = std::make_shared<FileReader>());
 
     Map& GetMap() { return state_.map; } // TODO: Change this to const
     const Map& GetConstMap() const { return state_.map; }
@@ -58,7 +63,7 @@ public:
     void LoadMapDocument(const std::filesystem::path& map_path)
     {
         MapDocument map_document;
-        map_document.LoadMap(map_path);
+        map_document.LoadMap(map_path, *file_reader_);
         ApplyMapDocument(map_document);
     }
     RuntimeMap BuildRuntimeMapFromDocument() const
@@ -108,8 +113,15 @@ public:
       const std::function<void(const Bullet& bullet)>& for_each_bullet_function) const;
     std::size_t GetBulletsCount() const;
     void TransformBullets(const std::function<void(Bullet& bullet)>& transform_bullet_function);
-
-    Item& CreateItem(glm::vec2 position, std::uint8_t owner_id, ItemType style);
+    // All the slots, inactive bullets included, so that saved states are restored slot by slot
+    std::size_t GetBulletSlotsCount() const { return state_.bullets.size(); }
+    const Bullet& GetBulletSlot(std::size_t slot) const { return state_.bullets.at(slot); }
+    void SetBulletSlot(std::size_t slot, const Bullet& bullet) { state_.bullets.at(slot) = bullet; }
+
+    Item& CreateItem(glm::vec2 position,
+                     std::uint8_t owner_id,
+                     ItemType style,
+                     std::optional<std::uint8_t> force_item_id = std::nullopt);
     void SetItemPosition(unsigned int id, glm::vec2 new_position);
     void MoveItemIntoDirection(unsigned int id, glm::vec2 direction);
     void TransformItems(const std::function<void(Item& item)>& transform_item_function);
@@ -123,15 +135,20 @@ public:
     void UnPauseGame() { state_.paused = false; }
     void TogglePauseGame() { state_.paused = !state_.paused; }
 
+    void SeedRandom(std::uint64_t seed) { state_.random.Seed(seed); }
+    SimulationRandomState GetRandomState() const { return state_.random.GetState(); }
+    void SetRandomState(const SimulationRandomState& random_state)
+    {
+        state_.random.SetState(random_state);
+    }
+
 private:
     Soldier& GetSoldierRef(std::uint8_t soldier_id);
     Item& GetItemRef(std::uint8_t item_id);
 
     State state_;
     std::vector<BulletParams> bullet_emitter_;
-
-    std::random_device random_device_{};
-    std::mt19937 mersenne_twister_engine_{ random_device_() };
+    std::shared_ptr<const IFileReader> file_reader_;
 };
 } // namespace Soldank
 
@@ -206,8 +223,10 @@ WeaponType ItemTypeToWeaponType(ItemType item_type)
 }
 
 StateManager::StateManager(AnimationDataManager& animation_data_manager,
-                           std::shared_ptr<ParticleSystem> skeleton)
+                           std::shared_ptr<ParticleSystem> skeleton,
+                           std::shared_ptr<const IFileReader> file_reader)
     : state_(animation_data_manager, std::move(skeleton))
+    , file_reader_(std::move(file_reader))
 {
 }
 
@@ -537,11 +556,8 @@ glm::vec2 StateManager::SpawnSoldier(unsigned int soldier_id,
         }
 
         if (!possible_spawn_point_positions.empty()) {
-            std::uniform_int_distribution<unsigned int> spawnpoint_id_random_distribution(
-              0, possible_spawn_point_positions.size() - 1);
-
-            unsigned int random_spawnpoint_id =
-              spawnpoint_id_random_distribution(mersenne_twister_engine_);
+            unsigned int random_spawnpoint_id = state_.random.NextUInt32(
+              static_cast<std::uint32_t>(possible_spawn_point_positions.size()));
 
             initial_player_position = possible_spawn_point_positions.at(random_spawnpoint_id);
         }
@@ -691,15 +707,22 @@ void StateManager::TransformBullets(
     }
 }
 
-Item& StateManager::CreateItem(glm::vec2 position, std::uint8_t owner_id, ItemType style)
+Item& StateManager::CreateItem(glm::vec2 position,
+                               std::uint8_t owner_id,
+                               ItemType style,
+                               std::optional<std::uint8_t> force_item_id)
 {
     std::uint8_t new_id = 0;
-    for (const auto& item : state_.items) {
-        if (!item.active) {
-            break;
-        }
+    if (force_item_id.has_value()) {
+        new_id = *force_item_id;
+    } else {
+        for (const auto& item : state_.items) {
+            if (!item.active) {
+                break;
+            }
 
-        ++new_id;
+            ++new_id;
+        }
     }
 
     if (new_id >= state_.items.size()) {
@@ -793,7 +816,8 @@ Item& StateManager::CreateItem(glm::vec2 position, std::uint8_t owner_id, ItemTy
         case ItemType::AlphaFlag:
         case ItemType::BravoFlag:
         case ItemType::PointmatchFlag: {
-            new_item.skeleton = ParticleSystem::Load(ParticleSystemType::Flag, particle_scale);
+            new_item.skeleton =
+              ParticleSystem::Load(ParticleSystemType::Flag, particle_scale, *file_reader_);
             new_item.radius = FLAG_RADIUS;
             new_item.time_out = FLAG_TIMEOUT;
             new_item.collide_with_bullets = true;
@@ -815,7 +839,8 @@ Item& StateManager::CreateItem(glm::vec2 position, std::uint8_t owner_id, ItemTy
         case ItemType::Chainsaw:
         case ItemType::LAW:
         case ItemType::Bow: // TODO: bow has different condition
-            new_item.skeleton = ParticleSystem::Load(ParticleSystemType::Weapon, particle_scale);
+            new_item.skeleton = ParticleSystem::Load(
+              ParticleSystemType::Weapon, particle_scale, *file_reader_);
             // new_item.skeleton->VDamping = 0.989;
             // new_item.skeleton->GravityMultiplier = 1.07;
             new_item.radius = GUN_RADIUS;
@@ -830,7 +855,8 @@ Item& StateManager::CreateItem(glm::vec2 position, std::uint8_t owner_id, ItemTy
         case ItemType::ClusterKit:
         case ItemType::VestKit:
         case ItemType::GrenadeKit:
-            new_item.skeleton = ParticleSystem::Load(ParticleSystemType::Kit, particle_scale);
+            new_item.skeleton = ParticleSystem::Load(
+              ParticleSystemType::Kit, particle_scale, *file_reader_);
             // new_item.skeleton->VDamping = 0.989;
             // new_item.skeleton->GravityMultiplier = 1.07;
             new_item.radius = KIT_RADIUS;
@@ -839,12 +865,13 @@ Item& StateManager::CreateItem(glm::vec2 position, std::uint8_t owner_id, ItemTy
             new_item.collide_with_bullets = true; // TODO: sv_kits_collide.Value;
             break;
         case ItemType::Parachute:
-            new_item.skeleton = ParticleSystem::Load(ParticleSystemType::Parachute, particle_scale);
+            new_item.skeleton = ParticleSystem::Load(
+              ParticleSystemType::Parachute, particle_scale, *file_reader_);
             new_item.time_out = 3600;
             break;
         case ItemType::M2:
-            new_item.skeleton =
-              ParticleSystem::Load(ParticleSystemType::StationaryGun, particle_scale);
+            new_item.skeleton = ParticleSystem::Load(
+              ParticleSystemType::StationaryGun, particle_scale, *file_reader_);
             new_item.time_out = 60;
             new_item.radius = STAT_RADIUS;
             new_item.collide_with_bullets = false;
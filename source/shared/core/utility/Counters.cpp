@@ -0,0 +1,155 @@
+module;
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+export module Shared.Core.Utility.Counters;
+
+export namespace Soldank
+{
+// Monotonic counters, keep COUNTER_NAMES in sync
+enum class Counter : unsigned int
+{
+    InputsReceived = 0,
+    InputsLateApplied,
+    InputsSuperseded,
+    InputsDropped,
+    LocalCorrections,
+    TickOverruns,
+    IncomingPacketsDropped,
+};
+
+constexpr std::size_t COUNTERS_COUNT = std::to_underlying(Counter::IncomingPacketsDropped) + 1;
+
+constexpr std::array<std::string_view, COUNTERS_COUNT> COUNTER_NAMES{
+    "inputs_received",   "inputs_late_applied", "inputs_superseded",
+    "inputs_dropped",    "local_corrections",   "tick_overruns",
+    "incoming_packets_dropped",
+};
+
+// Values that are overwritten rather than accumulated, keep GAUGE_NAMES in sync
+enum class Gauge : unsigned int
+{
+    PendingPlayerInputs = 0,
+    SimulationCommandsPerTick,
+    TickDurationMicroseconds,
+    RenderCommandsPerFrame,
+    RenderStateChangesPerFrame,
+};
+
+constexpr std::size_t GAUGES_COUNT = std::to_underlying(Gauge::RenderStateChangesPerFrame) + 1;
+
+constexpr std::array<std::string_view, GAUGES_COUNT> GAUGE_NAMES{
+    "pending_player_inputs",
+    "simulation_commands_per_tick",
+    "tick_duration_microseconds",
+    "render_commands_per_frame",
+    "render_state_changes_per_frame",
+};
+
+// Bytes are counted per network event, indexed by the event's value
+constexpr std::size_t MAX_COUNTED_NETWORK_EVENTS = 32;
+
+struct CountersSnapshot
+{
+    std::array<std::uint64_t, COUNTERS_COUNT> counters{};
+    std::array<std::int64_t, GAUGES_COUNT> gauges{};
+    std::array<std::uint64_t, MAX_COUNTED_NETWORK_EVENTS> network_bytes_sent{};
+    std::array<std::uint64_t, MAX_COUNTED_NETWORK_EVENTS> network_bytes_received{};
+
+    std::uint64_t Get(Counter counter) const { return counters.at(std::to_underlying(counter)); }
+    std::int64_t Get(Gauge gauge) const { return gauges.at(std::to_underlying(gauge)); }
+};
+
+// Fixed set of counters that stay compiled into release builds. Every thread adds to its own
+// shard, so the hot paths only do an uncontended relaxed add, and the shards are only summed up
+// when a snapshot is taken.
+class CounterRegistry
+{
+public:
+    static constexpr std::size_t SHARDS_COUNT = 8;
+
+    void Add(Counter counter, std::uint64_t value = 1)
+    {
+        GetShard().counters.at(std::to_underlying(counter)).fetch_add(value,
+                                                                      std::memory_order_relaxed);
+    }
+
+    void Set(Gauge gauge, std::int64_t value)
+    {
+        gauges_.at(std::to_underlying(gauge)).store(value, std::memory_order_relaxed);
+    }
+
+    // Events out of range are not counted
+    void AddNetworkBytesSent(std::size_t network_event_index, std::uint64_t bytes)
+    {
+        if (network_event_index < MAX_COUNTED_NETWORK_EVENTS) {
+            GetShard().network_bytes_sent.at(network_event_index).fetch_add(
+              bytes, std::memory_order_relaxed);
+        }
+    }
+
+    void AddNetworkBytesReceived(std::size_t network_event_index, std::uint64_t bytes)
+    {
+        if (network_event_index < MAX_COUNTED_NETWORK_EVENTS) {
+            GetShard().network_bytes_received.at(network_event_index).fetch_add(
+              bytes, std::memory_order_relaxed);
+        }
+    }
+
+    // Counters added concurrently may or may not be included yet
+    CountersSnapshot TakeSnapshot() const
+    {
+        CountersSnapshot snapshot;
+        for (const auto& shard : shards_) {
+            for (std::size_t i = 0; i < COUNTERS_COUNT; ++i) {
+                snapshot.counters.at(i) += shard.counters.at(i).load(std::memory_order_relaxed);
+            }
+            for (std::size_t i = 0; i < MAX_COUNTED_NETWORK_EVENTS; ++i) {
+                snapshot.network_bytes_sent.at(i) +=
+                  shard.network_bytes_sent.at(i).load(std::memory_order_relaxed);
+                snapshot.network_bytes_received.at(i) +=
+                  shard.network_bytes_received.at(i).load(std::memory_order_relaxed);
+            }
+        }
+        for (std::size_t i = 0; i < GAUGES_COUNT; ++i) {
+            snapshot.gauges.at(i) = gauges_.at(i).load(std::memory_order_relaxed);
+        }
+        return snapshot;
+    }
+
+private:
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    struct alignas(CACHE_LINE_SIZE) Shard
+    {
+        std::array<std::atomic<std::uint64_t>, COUNTERS_COUNT> counters{};
+        std::array<std::atomic<std::uint64_t>, MAX_COUNTED_NETWORK_EVENTS> network_bytes_sent{};
+        std::array<std::atomic<std::uint64_t>, MAX_COUNTED_NETWORK_EVENTS>
+          network_bytes_received{};
+    };
+
+    // Threads are spread over the shards in the order they first count something
+    Shard& GetShard()
+    {
+        static std::atomic<std::size_t> next_shard_index{ 0 };
+        thread_local const std::size_t shard_index =
+          next_shard_index.fetch_add(1, std::memory_order_relaxed) % SHARDS_COUNT;
+        return shards_.at(shard_index);
+    }
+
+    std::array<Shard, SHARDS_COUNT> shards_{};
+    std::array<std::atomic<std::int64_t>, GAUGES_COUNT> gauges_{};
+};
+
+// Registry of the whole process, read by the server's admin endpoint
+CounterRegistry& GetCounterRegistry()
+{
+    static CounterRegistry counter_registry;
+    return counter_registry;
+}
+} // namespace Soldank
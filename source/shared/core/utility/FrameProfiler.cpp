@@ -0,0 +1,362 @@
+module;
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+export module Shared.Core.Utility.FrameProfiler;
+
+export namespace Soldank
+{
+enum class ProfilerTrack : std::uint8_t
+{
+    Cpu = 0,
+    Gpu,
+};
+
+struct ProfilerZone
+{
+    // Not copied, names are expected to be string literals
+    std::string_view name;
+    ProfilerTrack track;
+    // Zones begun while another zone is open are one level deeper than it
+    std::uint8_t depth;
+    // Nanoseconds since the profiler was created
+    std::int64_t start_ns;
+    std::int64_t duration_ns;
+};
+
+struct ProfiledFrame
+{
+    std::uint64_t frame_number = 0;
+    std::int64_t start_ns = 0;
+    std::int64_t duration_ns = 0;
+    std::vector<ProfilerZone> zones;
+
+    // Sum of the zones with that name, zones nested in each other are counted twice
+    std::int64_t GetZonesDuration(std::string_view name,
+                                  ProfilerTrack track = ProfilerTrack::Cpu) const
+    {
+        std::int64_t duration_ns = 0;
+        for (const auto& zone : zones) {
+            if (zone.track == track && zone.name == name) {
+                duration_ns += zone.duration_ns;
+            }
+        }
+        return duration_ns;
+    }
+};
+
+// Records how long the parts of every frame took and keeps the newest frames. Frames and zones
+// are only recorded from the thread running the frames. Without anything adding GPU zones it
+// records CPU-only traces, which is how it runs headless in tests with a fake time source.
+class FrameProfiler
+{
+public:
+    static constexpr std::size_t DEFAULT_HISTORY_FRAMES_COUNT = 300;
+
+    // Nanoseconds, only differences between the returned values matter
+    using TimeSource = std::function<std::int64_t()>;
+
+    explicit FrameProfiler(std::size_t history_frames_count = DEFAULT_HISTORY_FRAMES_COUNT,
+                           TimeSource time_source = {})
+        : frames_(std::max(history_frames_count, std::size_t{ 1 }))
+        , time_source_(std::move(time_source))
+        , epoch_(Clock::now())
+    {
+    }
+
+    // Disabling drops the frame in progress
+    void SetEnabled(bool enabled)
+    {
+        if (!enabled && frame_in_progress_) {
+            frame_in_progress_ = false;
+            open_zones_.clear();
+            --next_frame_number_;
+        }
+        enabled_ = enabled;
+    }
+
+    bool IsEnabled() const { return enabled_; }
+
+    // Ends the frame in progress first, if there is one
+    void BeginFrame()
+    {
+        if (!enabled_) {
+            return;
+        }
+        if (frame_in_progress_) {
+            EndFrame();
+        }
+
+        current_frame_.frame_number = next_frame_number_++;
+        current_frame_.start_ns = Now();
+        current_frame_.duration_ns = 0;
+        current_frame_.zones.clear();
+        frame_in_progress_ = true;
+    }
+
+    // Zones still open end with the frame
+    void EndFrame()
+    {
+        if (!frame_in_progress_) {
+            return;
+        }
+
+        std::int64_t now_ns = Now();
+        while (!open_zones_.empty()) {
+            EndZone(now_ns);
+        }
+        current_frame_.duration_ns = now_ns - current_frame_.start_ns;
+
+        // Swapping hands the zones' storage of the dropped frame over to the next frame
+        std::swap(frames_.at(current_frame_.frame_number % frames_.size()), current_frame_);
+        frames_count_ = std::min(frames_count_ + 1, frames_.size());
+        frame_in_progress_ = false;
+    }
+
+    bool IsFrameInProgress() const { return frame_in_progress_; }
+
+    // Number of the frame in progress, or of the next one when there is none
+    std::uint64_t GetCurrentFrameNumber() const
+    {
+        return frame_in_progress_ ? current_frame_.frame_number : next_frame_number_;
+    }
+
+    // Zones are only recorded during frames, returns whether the zone was begun
+    bool BeginZone(std::string_view name)
+    {
+        if (!frame_in_progress_) {
+            return false;
+        }
+
+        open_zones_.push_back(current_frame_.zones.size());
+        current_frame_.zones.push_back({
+          .name = name,
+          .track = ProfilerTrack::Cpu,
+          .depth = (std::uint8_t)std::min(open_zones_.size() - 1, std::size_t{ 255 }),
+          .start_ns = Now(),
+          .duration_ns = 0,
+        });
+        return true;
+    }
+
+    // Ends the zone begun last
+    void EndZone()
+    {
+        if (!open_zones_.empty()) {
+            EndZone(Now());
+        }
+    }
+
+    // GPU timings are known a few frames later, they are dropped when their frame isn't kept
+    // anymore. The GPU runs the passes one after another, so a GPU zone starts no earlier than
+    // the previous GPU zone of its frame ended.
+    void AddGpuZone(std::uint64_t frame_number,
+                    std::string_view name,
+                    std::int64_t start_ns,
+                    std::int64_t duration_ns)
+    {
+        ProfiledFrame* frame = FindFrame(frame_number);
+        if (frame == nullptr) {
+            return;
+        }
+
+        for (const auto& zone : frame->zones) {
+            if (zone.track == ProfilerTrack::Gpu) {
+                start_ns = std::max(start_ns, zone.start_ns + zone.duration_ns);
+            }
+        }
+        frame->zones.push_back({ .name = name,
+                                 .track = ProfilerTrack::Gpu,
+                                 .depth = 0,
+                                 .start_ns = start_ns,
+                                 .duration_ns = duration_ns });
+    }
+
+    std::int64_t Now() const
+    {
+        if (time_source_) {
+            return time_source_();
+        }
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch_)
+          .count();
+    }
+
+    // Ended frames that are kept
+    std::size_t GetFramesCount() const { return frames_count_; }
+
+    // 0 is the oldest kept frame
+    const ProfiledFrame& GetFrame(std::size_t index) const
+    {
+        std::uint64_t oldest_frame_number = GetOldestFrameNumber();
+        return frames_.at((oldest_frame_number + index) % frames_.size());
+    }
+
+    const ProfiledFrame* FindFrame(std::uint64_t frame_number) const
+    {
+        if (frame_in_progress_ && frame_number == current_frame_.frame_number) {
+            return &current_frame_;
+        }
+        if (frames_count_ == 0 || frame_number < GetOldestFrameNumber() ||
+            frame_number >= GetOldestFrameNumber() + frames_count_) {
+            return nullptr;
+        }
+        return &frames_.at(frame_number % frames_.size());
+    }
+
+    ProfiledFrame* FindFrame(std::uint64_t frame_number)
+    {
+        return const_cast<ProfiledFrame*>(std::as_const(*this).FindFrame(frame_number));
+    }
+
+    // Kept frames in the Trace Event Format read by chrome://tracing and Perfetto, CPU zones
+    // on one thread and GPU zones on another
+    std::string ExportChromeTrace() const
+    {
+        std::string trace = R"({"displayTimeUnit":"ms","traceEvents":[)";
+        trace += R"({"name":"thread_name","ph":"M","pid":1,"tid":1,"args":{"name":"CPU"}},)";
+        trace += R"({"name":"thread_name","ph":"M","pid":1,"tid":2,"args":{"name":"GPU"}})";
+        for (std::size_t i = 0; i < frames_count_; ++i) {
+            const ProfiledFrame& frame = GetFrame(i);
+            trace += ',';
+            AppendTraceEvent(trace, "Frame", "frame", 1, frame.start_ns, frame.duration_ns);
+            for (const auto& zone : frame.zones) {
+                bool is_gpu_zone = zone.track == ProfilerTrack::Gpu;
+                trace += ',';
+                AppendTraceEvent(trace,
+                                 zone.name,
+                                 is_gpu_zone ? "gpu" : "cpu",
+                                 is_gpu_zone ? 2 : 1,
+                                 zone.start_ns,
+                                 zone.duration_ns);
+            }
+        }
+        trace += "]}";
+        return trace;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void EndZone(std::int64_t now_ns)
+    {
+        auto& zone = current_frame_.zones.at(open_zones_.back());
+        zone.duration_ns = now_ns - zone.start_ns;
+        open_zones_.pop_back();
+    }
+
+    std::uint64_t GetOldestFrameNumber() const
+    {
+        std::uint64_t ended_frames_count = next_frame_number_ - (frame_in_progress_ ? 1 : 0);
+        return ended_frames_count - frames_count_;
+    }
+
+    static void AppendTraceEvent(std::string& trace,
+                                 std::string_view name,
+                                 std::string_view category,
+                                 int thread_id,
+                                 std::int64_t start_ns,
+                                 std::int64_t duration_ns)
+    {
+        trace += R"({"name":)";
+        AppendJsonString(trace, name);
+        trace += R"(,"cat":")";
+        trace += category;
+        trace += R"(","ph":"X","pid":1,"tid":)";
+        trace += std::to_string(thread_id);
+        trace += R"(,"ts":)";
+        AppendMicroseconds(trace, start_ns);
+        trace += R"(,"dur":)";
+        AppendMicroseconds(trace, duration_ns);
+        trace += '}';
+    }
+
+    static void AppendJsonString(std::string& trace, std::string_view text)
+    {
+        constexpr std::string_view HEX_DIGITS = "0123456789abcdef";
+
+        trace += '"';
+        for (char character : text) {
+            if (character == '"' || character == '\\') {
+                trace += '\\';
+                trace += character;
+            } else if ((unsigned char)character < 0x20) {
+                trace += "\\u00";
+                trace += HEX_DIGITS.at((unsigned char)character >> 4);
+                trace += HEX_DIGITS.at((unsigned char)character & 0xF);
+            } else {
+                trace += character;
+            }
+        }
+        trace += '"';
+    }
+
+    // Timestamps are in microseconds, the nanoseconds are kept as the fraction
+    static void AppendMicroseconds(std::string& trace, std::int64_t nanoseconds)
+    {
+        if (nanoseconds < 0) {
+            trace += '-';
+            nanoseconds = -nanoseconds;
+        }
+        std::string fraction = std::to_string(nanoseconds % 1000);
+        trace += std::to_string(nanoseconds / 1000);
+        trace += '.';
+        trace.append(3 - fraction.size(), '0');
+        trace += fraction;
+    }
+
+    std::vector<ProfiledFrame> frames_;
+    std::size_t frames_count_ = 0;
+    ProfiledFrame current_frame_;
+    std::vector<std::size_t> open_zones_;
+    std::uint64_t next_frame_number_ = 0;
+    bool frame_in_progress_ = false;
+    bool enabled_ = true;
+    TimeSource time_source_;
+    Clock::time_point epoch_;
+};
+
+// Ends the zone when it goes out of scope, unless its frame has ended already
+class ScopedProfilerZone
+{
+public:
+    ScopedProfilerZone(FrameProfiler& frame_profiler, std::string_view name)
+        : frame_profiler_(frame_profiler)
+        , frame_number_(frame_profiler.GetCurrentFrameNumber())
+        , began_(frame_profiler.BeginZone(name))
+    {
+    }
+
+    ~ScopedProfilerZone()
+    {
+        if (began_ && frame_profiler_.IsFrameInProgress() &&
+            frame_profiler_.GetCurrentFrameNumber() == frame_number_) {
+            frame_profiler_.EndZone();
+        }
+    }
+
+    ScopedProfilerZone(const ScopedProfilerZone&) = delete;
+    ScopedProfilerZone& operator=(const ScopedProfilerZone&) = delete;
+    ScopedProfilerZone(ScopedProfilerZone&&) = delete;
+    ScopedProfilerZone& operator=(ScopedProfilerZone&&) = delete;
+
+private:
+    FrameProfiler& frame_profiler_;
+    std::uint64_t frame_number_;
+    bool began_;
+};
+
+// Profiler of the frames run by the client's game loop
+FrameProfiler& GetFrameProfiler()
+{
+    static FrameProfiler frame_profiler;
+    return frame_profiler;
+}
+} // namespace Soldank
@@ -0,0 +1,74 @@
+module;
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+export module Shared.Core.Utility.SpscQueue;
+
+export namespace Soldank
+{
+// Bounded lock-free queue for exactly one producer thread and one consumer thread. Elements are
+// written and read in place through callbacks and the slots are reused, so elements that own
+// buffers (e.g. packet payloads) keep their capacity and stop allocating once warmed up.
+template<typename T, std::size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscQueue capacity has to be a power of two");
+
+public:
+    // Called by the producer. Returns false without calling write when the queue is full.
+    template<typename Write>
+    bool TryPush(Write&& write)
+    {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ == Capacity) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ == Capacity) {
+                return false;
+            }
+        }
+
+        write(slots_[tail & (Capacity - 1)]);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Called by the consumer. Returns false without calling read when the queue is empty.
+    template<typename Read>
+    bool TryPop(Read&& read)
+    {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                return false;
+            }
+        }
+
+        read(slots_[head & (Capacity - 1)]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate when called while the other thread is working on the queue
+    std::size_t GetSize() const
+    {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    static constexpr std::size_t GetCapacity() { return Capacity; }
+
+private:
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    // Consumer side
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head_{ 0 };
+    std::size_t cached_tail_ = 0;
+    // Producer side
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail_{ 0 };
+    std::size_t cached_head_ = 0;
+    alignas(CACHE_LINE_SIZE) std::array<T, Capacity> slots_{};
+};
+} // namespace Soldank
@@ -0,0 +1,63 @@
+module;
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+export module Shared.Core.Utility.TripleBuffer;
+
+export namespace Soldank
+{
+// Hands the latest value from exactly one producer thread to exactly one consumer thread without
+// locking and without either side ever waiting. The producer writes into its own buffer and
+// publishes it, the consumer takes the most recently published buffer, values published in
+// between are skipped. Buffers are reused, so values that own containers stop allocating once
+// warmed up.
+template<typename T>
+class TripleBuffer
+{
+public:
+    // Called by the producer, the buffer is not visible to the consumer until Publish()
+    T& GetWriteBuffer() { return buffers_[write_index_]; }
+
+    // Called by the producer
+    void Publish()
+    {
+        const std::uint8_t previous_state =
+          shared_state_.exchange(write_index_ | FRESH_FLAG, std::memory_order_acq_rel);
+        write_index_ = previous_state & INDEX_MASK;
+    }
+
+    // Called by the consumer. Returns false and keeps the current read buffer when nothing was
+    // published since the last call.
+    bool Update()
+    {
+        if ((shared_state_.load(std::memory_order_relaxed) & FRESH_FLAG) == 0) {
+            return false;
+        }
+
+        const std::uint8_t previous_state =
+          shared_state_.exchange(read_index_, std::memory_order_acq_rel);
+        read_index_ = previous_state & INDEX_MASK;
+        return true;
+    }
+
+    // Called by the consumer
+    const T& GetReadBuffer() const { return buffers_[read_index_]; }
+
+private:
+    static constexpr std::uint8_t INDEX_MASK = 0b011;
+    static constexpr std::uint8_t FRESH_FLAG = 0b100;
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    std::array<T, 3> buffers_{};
+    // Index of the buffer that is neither written nor read, with FRESH_FLAG set when the producer
+    // published it and the consumer didn't take it yet
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint8_t> shared_state_{ 2 };
+    // Producer side
+    alignas(CACHE_LINE_SIZE) std::uint8_t write_index_ = 0;
+    // Consumer side
+    alignas(CACHE_LINE_SIZE) std::uint8_t read_index_ = 1;
+};
+} // namespace Soldank
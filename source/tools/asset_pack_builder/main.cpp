@@ -0,0 +1,79 @@
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <ios>
+#include <string>
+
+import Shared.Core.Data.AssetPack;
+import Shared.Core.Data.FileReader;
+import Shared.Core.Data.IFileWriter;
+
+namespace
+{
+// Everything the simulation loads through IFileReader
+bool IsPackedAsset(const std::filesystem::path& relative_path)
+{
+    const auto directory = relative_path.has_parent_path()
+                             ? relative_path.begin()->generic_string()
+                             : std::string{};
+    const auto extension = relative_path.extension().generic_string();
+    const auto file_name = relative_path.filename().generic_string();
+
+    if (directory == "anims") {
+        return extension == ".poa";
+    }
+    if (directory == "objects") {
+        return extension == ".po";
+    }
+    if (directory == "maps") {
+        return extension == ".pms";
+    }
+    return directory.empty() && extension == ".ini" && file_name.starts_with("weapons");
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3) {
+        std::cerr << "Usage: asset_pack_builder <asset_root> <output_pack>" << std::endl;
+        return 1;
+    }
+
+    try {
+        const std::filesystem::path asset_root = argv[1];
+        const std::string output_pack = argv[2];
+
+        Soldank::AssetPackBuilder builder;
+        Soldank::FileReader file_reader;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(asset_root)) {
+            if (!entry.is_regular_file()) {
+                continue;
+            }
+
+            const auto relative_path = entry.path().lexically_relative(asset_root);
+            if (!IsPackedAsset(relative_path)) {
+                continue;
+            }
+
+            auto data = file_reader.Read(entry.path().string(), std::ios::in | std::ios::binary);
+            if (!data.has_value()) {
+                std::cerr << "Could not read " << entry.path().string() << std::endl;
+                return 1;
+            }
+            builder.AddAsset(relative_path.generic_string(), *data);
+        }
+
+        if (builder.Write(output_pack) != Soldank::FileWriterError::NoError) {
+            std::cerr << "Could not write " << output_pack << std::endl;
+            return 1;
+        }
+
+        std::cout << "Packed " << builder.GetAssetsCount() << " assets into " << output_pack
+                  << std::endl;
+    } catch (const std::exception& exception) {
+        std::cerr << exception.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,8 +1,11 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <array>
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -21,6 +24,7 @@ import Runtime.ServerRuntimeServices;
 import Sessions.PlayerSessionManager;
 
 import Shared.Core.IWorld;
+import Shared.Core.Config.Config;
 import Shared.Core.Map.Map;
 import Shared.Core.Map.PMSEnums;
 import Shared.Core.Simulation.PlayerInputApplication;
@@ -174,6 +178,20 @@ public:
         return connection != client_connection_ids_.end() ? connection_id : 0;
     }
 
+    void ForEachPlayerConnection(
+      const std::function<void(unsigned int connection_id)>& for_each_connection_function) override
+    {
+        for (const unsigned int connection_id : client_connection_ids_) {
+            for_each_connection_function(connection_id);
+        }
+    }
+
+    std::optional<ConnectionQuality> GetConnectionQuality(
+      unsigned int /*connection_id*/) override
+    {
+        return std::nullopt;
+    }
+
 private:
     std::uint32_t GetRoundTripTimeTicks() const
     {
@@ -378,9 +396,7 @@ TEST(FullClientServerReconciliationTest,
     std::size_t recurring_teleport_count = 0;
     std::size_t resynchronization_displacement_count = 0;
     std::size_t airborne_tick_count = 0;
-#ifndef NDEBUG
     std::size_t late_input_count = 0;
-#endif
 
     for (std::uint64_t step = 0; step < STEPS; step++) {
         network_bridge->SetCurrentStep(step);
@@ -391,11 +407,11 @@ TEST(FullClientServerReconciliationTest,
         network_bridge->DeliverMessagesToServer(server_dispatcher);
 
         const std::uint32_t server_tick = server_world->GetStateManager()->GetGameTick();
-        auto server_inputs = command_queues.SelectPlayerInputsForSimulation(server_tick);
-#ifndef NDEBUG
-        late_input_count += command_queues.GetInputDebugStats().late_applied_input_count;
-        command_queues.ResetInputDebugStats();
-#endif
+        std::array<PlayerInputCommand, Config::MAX_PLAYERS> server_inputs_buffer{};
+        const auto server_inputs =
+          command_queues.SelectPlayerInputsForSimulation(server_tick, server_inputs_buffer);
+        late_input_count += command_queues.GetInputStats().late_applied_input_count;
+        command_queues.ResetInputStats();
         const std::vector<SimulationCommand> server_commands;
         static_cast<void>(server_world->Tick(
           { .tick = server_tick, .player_inputs = server_inputs, .commands = server_commands }));
@@ -464,9 +480,7 @@ TEST(FullClientServerReconciliationTest,
               client_state->network.input_timeline_resync_count);
     EXPECT_LE(maximum_resynchronization_displacement, 30.0F);
     EXPECT_GT(airborne_tick_count, 100U);
-#ifndef NDEBUG
     EXPECT_EQ(late_input_count, 0U);
-#endif
 }
 
 TEST(FullClientServerReconciliationTest,
@@ -540,9 +554,7 @@ TEST(FullClientServerReconciliationTest,
     ReconciliationDisplacementMetrics second_player_metrics;
     std::size_t first_player_airborne_tick_count = 0;
     std::size_t second_player_airborne_tick_count = 0;
-#ifndef NDEBUG
     std::size_t late_input_count = 0;
-#endif
 
     for (std::uint64_t step = 0; step < STEPS; step++) {
         network_bridge->SetCurrentStep(step);
@@ -556,11 +568,11 @@ TEST(FullClientServerReconciliationTest,
         network_bridge->DeliverMessagesToServer(server_dispatcher);
 
         const std::uint32_t server_tick = server_world->GetStateManager()->GetGameTick();
-        auto server_inputs = command_queues.SelectPlayerInputsForSimulation(server_tick);
-#ifndef NDEBUG
-        late_input_count += command_queues.GetInputDebugStats().late_applied_input_count;
-        command_queues.ResetInputDebugStats();
-#endif
+        std::array<PlayerInputCommand, Config::MAX_PLAYERS> server_inputs_buffer{};
+        const auto server_inputs =
+          command_queues.SelectPlayerInputsForSimulation(server_tick, server_inputs_buffer);
+        late_input_count += command_queues.GetInputStats().late_applied_input_count;
+        command_queues.ResetInputStats();
         const std::vector<SimulationCommand> server_commands;
         static_cast<void>(server_world->Tick(
           { .tick = server_tick, .player_inputs = server_inputs, .commands = server_commands }));
@@ -652,7 +664,5 @@ TEST(FullClientServerReconciliationTest,
     EXPECT_LE(second_player_metrics.maximum_resynchronization_displacement, 30.0F);
     EXPECT_GT(first_player_airborne_tick_count, 100U);
     EXPECT_GT(second_player_airborne_tick_count, 100U);
-#ifndef NDEBUG
     EXPECT_EQ(late_input_count, 0U);
-#endif
 }
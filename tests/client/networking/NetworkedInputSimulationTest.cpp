@@ -16,6 +16,8 @@ import Networking.ReconciliationTimeline;
 import Runtime.ServerCommandQueues;
 import Sessions.PlayerSessionManager;
 
+import Shared.Core.Config.Config;
+import Shared.Core.Simulation.SimulationCommands;
 import Shared.Core.State.Control;
 import Shared.Core.Utility.SerialNumber;
 import Shared.Networking.NetworkPackets;
@@ -293,12 +295,11 @@ private:
 
     void SimulateServerTick()
     {
-        const auto selected_inputs = command_queues_.SelectPlayerInputsForSimulation(server_tick_);
-#ifndef NDEBUG
-        const auto debug_stats = command_queues_.GetInputDebugStats();
-        metrics_.superseded_inputs += debug_stats.superseded_input_count;
-        command_queues_.ResetInputDebugStats();
-#endif
+        std::array<PlayerInputCommand, Config::MAX_PLAYERS> selected_inputs_buffer{};
+        const auto selected_inputs =
+          command_queues_.SelectPlayerInputsForSimulation(server_tick_, selected_inputs_buffer);
+        metrics_.superseded_inputs += command_queues_.GetInputStats().superseded_input_count;
+        command_queues_.ResetInputStats();
         if (!selected_inputs.empty()) {
             const auto& selected_input = selected_inputs.front();
             if (IsSerialNumberOlder(selected_input.apply_server_tick, server_tick_)) {
@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+import Networking.SoldierSnapshotInterpolation;
+
+import Shared.Core.Animations;
+import Shared.Networking.NetworkPackets;
+
+using namespace Soldank;
+
+namespace
+{
+SoldierStatePacket MakeState(std::uint8_t player_id,
+                             std::uint32_t server_tick,
+                             float position_x,
+                             std::uint8_t stance = 1)
+{
+    SoldierStatePacket soldier_state{};
+    soldier_state.server_tick = server_tick;
+    soldier_state.player_id = player_id;
+    soldier_state.position_x = position_x;
+    soldier_state.position_y = -10.0F;
+    soldier_state.stance = stance;
+    return soldier_state;
+}
+} // namespace
+
+TEST(SoldierSnapshotInterpolationTest, InterpolatesBetweenReceivedStates)
+{
+    SoldierSnapshotBuffer buffer;
+    buffer.Push(MakeState(1, 100, 0.0F, 1));
+    buffer.Push(MakeState(1, 104, 40.0F, 2));
+
+    const auto sampled = buffer.Sample(101);
+    ASSERT_TRUE(sampled.has_value());
+    EXPECT_FLOAT_EQ(sampled->position_x, 10.0F);
+    EXPECT_FLOAT_EQ(sampled->position_y, -10.0F);
+    // Discrete values come from the older state
+    EXPECT_EQ(sampled->stance, 1);
+
+    EXPECT_FALSE(buffer.Sample(99).has_value());
+    EXPECT_FLOAT_EQ(buffer.Sample(104)->position_x, 40.0F);
+    // The newest state is held, not extrapolated
+    EXPECT_FLOAT_EQ(buffer.Sample(110)->position_x, 40.0F);
+}
+
+TEST(SoldierSnapshotInterpolationTest, SamplesKeepTheServerTickOfTheOlderState)
+{
+    SoldierSnapshotBuffer buffer;
+    buffer.Push(MakeState(1, 100, 0.0F));
+    buffer.Push(MakeState(1, 104, 40.0F));
+
+    EXPECT_EQ(buffer.Sample(100)->server_tick, 100);
+    EXPECT_EQ(buffer.Sample(103)->server_tick, 100);
+    EXPECT_EQ(buffer.Sample(104)->server_tick, 104);
+}
+
+TEST(SoldierSnapshotInterpolationTest, InterpolatesFramesOfAnimationsThatKeepPlaying)
+{
+    SoldierSnapshotBuffer buffer;
+    auto from = MakeState(1, 100, 0.0F);
+    from.body_animation_type = AnimationType::Run;
+    from.body_animation_frame = 4;
+    from.legs_animation_type = AnimationType::Run;
+    from.legs_animation_frame = 18;
+    auto to = MakeState(1, 104, 40.0F);
+    to.body_animation_type = AnimationType::Run;
+    to.body_animation_frame = 12;
+    to.legs_animation_type = AnimationType::Run;
+    // The animation looped in between
+    to.legs_animation_frame = 2;
+    buffer.Push(from);
+    buffer.Push(to);
+
+    const auto sampled = buffer.Sample(102);
+    ASSERT_TRUE(sampled.has_value());
+    EXPECT_EQ(sampled->body_animation_frame, 8);
+    EXPECT_EQ(sampled->legs_animation_frame, 18);
+
+    to.server_tick = 108;
+    to.body_animation_type = AnimationType::Stand;
+    buffer.Push(to);
+    EXPECT_EQ(buffer.Sample(106)->body_animation_frame, 12);
+}
+
+TEST(SoldierSnapshotInterpolationTest, IgnoresOutdatedStatesAndKeepsNewest)
+{
+    SoldierSnapshotBuffer buffer;
+    EXPECT_TRUE(buffer.Push(MakeState(1, 0xFFFFFFFE, 0.0F)));
+    EXPECT_TRUE(buffer.Push(MakeState(1, 2, 40.0F)));
+    EXPECT_FALSE(buffer.Push(MakeState(1, 1, 20.0F)));
+    EXPECT_FALSE(buffer.Push(MakeState(1, 2, 20.0F)));
+    EXPECT_FLOAT_EQ(buffer.Sample(0)->position_x, 20.0F);
+
+    for (std::uint32_t tick = 3; tick < 3 + SoldierSnapshotBuffer::CAPACITY; ++tick) {
+        buffer.Push(MakeState(1, tick, 0.0F));
+    }
+    EXPECT_EQ(buffer.GetSize(), SoldierSnapshotBuffer::CAPACITY);
+    EXPECT_FALSE(buffer.Sample(2).has_value());
+    EXPECT_EQ(buffer.GetNewestServerTick(), 2 + SoldierSnapshotBuffer::CAPACITY);
+}
+
+TEST(SoldierSnapshotInterpolationTest, DoesNotInterpolateTeleports)
+{
+    SoldierSnapshotBuffer buffer;
+    buffer.Push(MakeState(1, 100, 0.0F));
+    buffer.Push(MakeState(1, 102, 1000.0F));
+
+    EXPECT_FLOAT_EQ(buffer.Sample(101)->position_x, 0.0F);
+}
+
+TEST(SoldierSnapshotInterpolationTest, PlaybackFollowsNewestServerTickWithDelay)
+{
+    SoldierSnapshotInterpolation interpolation;
+    EXPECT_FALSE(interpolation.AdvancePlaybackTick().has_value());
+
+    interpolation.Push(MakeState(2, 100, 0.0F));
+    EXPECT_EQ(interpolation.AdvancePlaybackTick(), 97);
+    EXPECT_FALSE(interpolation.Sample(2, 97).has_value());
+
+    // The delay shrinks to the measured one by skipping a tick, bunched up states do not move the
+    // playback any further, it advances one tick at a time
+    interpolation.Push(MakeState(2, 101, 10.0F));
+    interpolation.Push(MakeState(2, 102, 20.0F));
+    interpolation.Push(MakeState(2, 103, 30.0F));
+    EXPECT_EQ(interpolation.AdvancePlaybackTick(), 99);
+    EXPECT_EQ(interpolation.GetDelayTicks(), 2);
+    EXPECT_EQ(interpolation.AdvancePlaybackTick(), 100);
+    EXPECT_EQ(interpolation.AdvancePlaybackTick(), 101);
+    EXPECT_EQ(interpolation.AdvancePlaybackTick(), 102);
+    EXPECT_FLOAT_EQ(interpolation.Sample(2, 102)->position_x, 20.0F);
+    EXPECT_EQ(interpolation.GetResynchronizationCount(), 0);
+
+    // Playback that fell far behind is resynchronized
+    interpolation.Push(MakeState(2, 200, 30.0F));
+    EXPECT_EQ(interpolation.AdvancePlaybackTick(), 200 - interpolation.GetDelayTicks());
+    EXPECT_EQ(interpolation.GetResynchronizationCount(), 1);
+}
+
+TEST(SoldierSnapshotInterpolationTest, DelayFollowsTheGapsBetweenStatesArriving)
+{
+    SoldierSnapshotInterpolation interpolation;
+    std::uint32_t server_tick = 100;
+    const auto run_ticks = [&](std::uint32_t snapshot_interval_ticks, int ticks_count) {
+        for (int i = 0; i < ticks_count; ++i) {
+            ++server_tick;
+            if (server_tick % snapshot_interval_ticks == 0) {
+                interpolation.Push(MakeState(2, server_tick, 0.0F));
+            }
+            const auto playback_tick = interpolation.AdvancePlaybackTick();
+            ASSERT_TRUE(playback_tick.has_value());
+            // The playback never runs past the newest received state
+            EXPECT_LE(*playback_tick, server_tick - server_tick % snapshot_interval_ticks);
+        }
+    };
+
+    run_ticks(1, 60);
+    EXPECT_EQ(interpolation.GetDelayTicks(), 2);
+
+    // A lower send rate lengthens the delay, which holds the playback still until it covers it
+    run_ticks(3, 60);
+    EXPECT_EQ(interpolation.GetDelayTicks(), 4);
+
+    // Once the long gaps are out of the measured window the delay shrinks back
+    run_ticks(1, 60);
+    EXPECT_EQ(interpolation.GetDelayTicks(), 2);
+    EXPECT_EQ(interpolation.GetResynchronizationCount(), 0);
+}
+
+TEST(SoldierSnapshotInterpolationTest, DelayCoversTheAnnouncedSnapshotInterval)
+{
+    SoldierSnapshotInterpolation interpolation;
+    std::uint32_t server_tick = 100;
+    for (; server_tick < 160; ++server_tick) {
+        interpolation.Push(MakeState(2, server_tick, 0.0F));
+        interpolation.AdvancePlaybackTick();
+    }
+    EXPECT_EQ(interpolation.GetDelayTicks(), 2);
+
+    // The delay starts growing with the first state sent at the lower rate, before the longer
+    // gaps between states arriving are seen
+    auto soldier_state = MakeState(2, server_tick, 0.0F);
+    soldier_state.snapshot_interval_ticks = 3;
+    interpolation.Push(soldier_state);
+    const auto playback_tick = interpolation.AdvancePlaybackTick();
+    EXPECT_EQ(interpolation.AdvancePlaybackTick(), playback_tick);
+    EXPECT_EQ(interpolation.GetDelayTicks(), 4);
+}
+
+TEST(SoldierSnapshotInterpolationTest, KeepsSoldiersSeparate)
+{
+    SoldierSnapshotInterpolation interpolation;
+    interpolation.Push(MakeState(1, 100, 5.0F));
+    interpolation.Push(MakeState(2, 100, 50.0F));
+
+    EXPECT_FLOAT_EQ(interpolation.Sample(1, 100)->position_x, 5.0F);
+    EXPECT_FLOAT_EQ(interpolation.Sample(2, 100)->position_x, 50.0F);
+
+    interpolation.Clear(1);
+    EXPECT_FALSE(interpolation.Sample(1, 100).has_value());
+    EXPECT_FALSE(interpolation.Sample(3, 100).has_value());
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
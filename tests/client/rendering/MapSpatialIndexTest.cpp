@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+
+#include <numbers>
+#include <vector>
+
+import Camera;
+import MapSpatialIndex;
+
+import Shared.Core.Map.Map;
+import Shared.Core.Map.PMSStructs;
+
+using namespace Soldank;
+
+namespace
+{
+PMSScenery MakeScenery(float x, float y, int level, int width = 100, int height = 50)
+{
+    return PMSScenery{ .active = true,
+                       .style = 1,
+                       .width = width,
+                       .height = height,
+                       .x = x,
+                       .y = y,
+                       .rotation = 0.0F,
+                       .scale_x = 1.0F,
+                       .scale_y = 1.0F,
+                       .alpha = 255,
+                       .color = {},
+                       .level = level };
+}
+
+PMSPolygon MakePolygon(float x, float y)
+{
+    PMSPolygon polygon;
+    polygon.vertices.at(0).x = x;
+    polygon.vertices.at(0).y = y;
+    polygon.vertices.at(1).x = x + 50.0F;
+    polygon.vertices.at(1).y = y;
+    polygon.vertices.at(2).x = x;
+    polygon.vertices.at(2).y = y + 50.0F;
+    return polygon;
+}
+
+// Map coordinates have y pointing down, the bounds are in render coordinates with y pointing up
+BoundingRectangle MakeViewAroundMapPosition(float x, float y, float half_size)
+{
+    return { .min = { x - half_size, -y - half_size }, .max = { x + half_size, -y + half_size } };
+}
+} // namespace
+
+TEST(MapSpatialIndexTest, CullsSceneriesOutsideOfTheViewAndSplitsThemByLevel)
+{
+    MapSpatialIndex map_spatial_index;
+    map_spatial_index.RebuildSceneries({
+      MakeScenery(0.0F, 0.0F, 2),
+      MakeScenery(5000.0F, 0.0F, 0),
+      MakeScenery(20.0F, 10.0F, 0),
+      MakeScenery(-30.0F, -20.0F, 1),
+      MakeScenery(0.0F, 5000.0F, 1),
+    });
+
+    VisibleMapObjects visible_map_objects;
+    map_spatial_index.Cull(MakeViewAroundMapPosition(0.0F, 0.0F, 200.0F), visible_map_objects);
+
+    EXPECT_EQ(visible_map_objects.scenery_ids_per_level.at(0), std::vector<unsigned int>{ 2 });
+    EXPECT_EQ(visible_map_objects.scenery_ids_per_level.at(1), std::vector<unsigned int>{ 3 });
+    EXPECT_EQ(visible_map_objects.scenery_ids_per_level.at(2), std::vector<unsigned int>{ 0 });
+    EXPECT_TRUE(visible_map_objects.polygon_ids.empty());
+
+    map_spatial_index.Cull(MakeViewAroundMapPosition(5000.0F, 0.0F, 200.0F), visible_map_objects);
+    EXPECT_EQ(visible_map_objects.scenery_ids_per_level.at(0), std::vector<unsigned int>{ 1 });
+    EXPECT_TRUE(visible_map_objects.scenery_ids_per_level.at(1).empty());
+    EXPECT_TRUE(visible_map_objects.scenery_ids_per_level.at(2).empty());
+}
+
+TEST(MapSpatialIndexTest, SceneryBoundsFollowScaleAndRotation)
+{
+    auto scenery = MakeScenery(100.0F, 200.0F, 0);
+    auto bounds = MapSpatialIndex::GetSceneryBounds(scenery);
+    EXPECT_FLOAT_EQ(bounds.min.x, 100.0F);
+    EXPECT_FLOAT_EQ(bounds.max.x, 200.0F);
+    EXPECT_FLOAT_EQ(bounds.min.y, -250.0F);
+    EXPECT_FLOAT_EQ(bounds.max.y, -200.0F);
+
+    scenery.scale_x = 2.0F;
+    scenery.rotation = std::numbers::pi_v<float> / 2.0F;
+    bounds = MapSpatialIndex::GetSceneryBounds(scenery);
+    EXPECT_NEAR(bounds.max.x - bounds.min.x, 50.0F, 0.001F);
+    EXPECT_NEAR(bounds.max.y - bounds.min.y, 200.0F, 0.001F);
+}
+
+TEST(MapSpatialIndexTest, ObjectsSpanningManyCellsAreReportedOnce)
+{
+    MapSpatialIndex map_spatial_index;
+    map_spatial_index.RebuildSceneries({
+      MakeScenery(-4000.0F, -4000.0F, 0, 8000, 8000),
+      MakeScenery(3000.0F, 3000.0F, 0),
+    });
+
+    VisibleMapObjects visible_map_objects;
+    map_spatial_index.Cull({ .min = { -5000.0F, -5000.0F }, .max = { 5000.0F, 5000.0F } },
+                           visible_map_objects);
+    EXPECT_EQ(visible_map_objects.scenery_ids_per_level.at(0),
+              (std::vector<unsigned int>{ 0, 1 }));
+}
+
+TEST(MapSpatialIndexTest, CullsPolygonsInIncreasingOrder)
+{
+    MapSpatialIndex map_spatial_index;
+    std::vector<PMSPolygon> polygons;
+    for (unsigned int i = 0; i < 100; ++i) {
+        polygons.push_back(MakePolygon(static_cast<float>(i % 10) * 1000.0F,
+                                       static_cast<float>(i / 10) * 1000.0F));
+    }
+    map_spatial_index.RebuildPolygons(polygons);
+
+    VisibleMapObjects visible_map_objects;
+    map_spatial_index.Cull({ .min = { -100.0F, -2100.0F }, .max = { 1100.0F, 100.0F } },
+                           visible_map_objects);
+    EXPECT_EQ(visible_map_objects.polygon_ids,
+              (std::vector<unsigned int>{ 0, 1, 10, 11, 20, 21 }));
+}
+
+TEST(MapSpatialIndexTest, FollowsMapEdits)
+{
+    Map map;
+    MapSpatialIndex map_spatial_index(map);
+    const auto view = MakeViewAroundMapPosition(0.0F, 0.0F, 300.0F);
+
+    VisibleMapObjects visible_map_objects;
+    map_spatial_index.Cull(view, visible_map_objects);
+    EXPECT_TRUE(visible_map_objects.polygon_ids.empty());
+    EXPECT_TRUE(visible_map_objects.scenery_ids_per_level.at(1).empty());
+
+    map.AddNewPolygon(MakePolygon(10.0F, 10.0F));
+    unsigned int scenery_id = map.AddNewScenery(MakeScenery(0.0F, 0.0F, 1), "scenery.bmp");
+    map_spatial_index.Cull(view, visible_map_objects);
+    EXPECT_EQ(visible_map_objects.polygon_ids, std::vector<unsigned int>{ 0 });
+    EXPECT_EQ(visible_map_objects.scenery_ids_per_level.at(1),
+              std::vector<unsigned int>{ scenery_id });
+
+    map.MoveSceneriesById({ { scenery_id, { 5000.0F, 5000.0F } } });
+    map_spatial_index.Cull(view, visible_map_objects);
+    EXPECT_TRUE(visible_map_objects.scenery_ids_per_level.at(1).empty());
+
+    map.RemovePolygonById(0);
+    map_spatial_index.Cull(view, visible_map_objects);
+    EXPECT_TRUE(visible_map_objects.polygon_ids.empty());
+}
+
+TEST(MapSpatialIndexTest, CameraViewBoundsAreCenteredOnTheCamera)
+{
+    Camera camera;
+    camera.Move(100.0F, -50.0F);
+    const auto bounds = GetCameraViewBounds(camera);
+    EXPECT_FLOAT_EQ(bounds.min.x, 100.0F - camera.GetWidth() / 2.0F);
+    EXPECT_FLOAT_EQ(bounds.max.x, 100.0F + camera.GetWidth() / 2.0F);
+    EXPECT_FLOAT_EQ(bounds.min.y, -50.0F - camera.GetHeight() / 2.0F);
+    EXPECT_FLOAT_EQ(bounds.max.y, -50.0F + camera.GetHeight() / 2.0F);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,155 @@
+#include "core/math/Glm.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+import PolygonMesh;
+
+import Shared.Core.Map.PMSStructs;
+
+using namespace Soldank;
+
+namespace
+{
+PMSPolygon MakePolygon(float x, float y)
+{
+    PMSPolygon polygon;
+    polygon.vertices.at(0).x = x;
+    polygon.vertices.at(0).y = y;
+    polygon.vertices.at(1).x = x + 50.0F;
+    polygon.vertices.at(1).y = y;
+    polygon.vertices.at(2).x = x;
+    polygon.vertices.at(2).y = y + 50.0F;
+    return polygon;
+}
+
+// Map coordinates have y pointing down, the mesh is in render coordinates with y pointing up
+glm::vec2 GetVertexPosition(const PolygonMesh& polygon_mesh, unsigned int vertex_id)
+{
+    const auto& vertex = polygon_mesh.vertices.at(vertex_id);
+    unsigned int chunk = 0;
+    while (chunk + 1 < polygon_mesh.chunks.size() &&
+           polygon_mesh.chunks.at(chunk + 1).first_vertex <= vertex_id) {
+        ++chunk;
+    }
+    return polygon_mesh.chunks.at(chunk).origin +
+           glm::vec2(vertex.x, vertex.y) / POLYGON_MESH_POSITION_SCALE;
+}
+} // namespace
+
+TEST(PolygonMeshTest, GroupsPolygonsIntoChunksByTheirCenters)
+{
+    std::vector<PMSPolygon> polygons{
+        MakePolygon(10.0F, 10.0F),
+        MakePolygon(5000.0F, 10.0F),
+        MakePolygon(100.0F, 100.0F),
+    };
+    auto polygon_mesh = BakePolygonMesh(polygons);
+
+    ASSERT_EQ(polygon_mesh.chunks.size(), 2U);
+    EXPECT_EQ(polygon_mesh.polygon_chunks, (std::vector<unsigned int>{ 0, 1, 0 }));
+    EXPECT_EQ(polygon_mesh.polygon_first_vertices, (std::vector<unsigned int>{ 0, 6, 3 }));
+    EXPECT_EQ(polygon_mesh.chunks.at(0).first_vertex, 0U);
+    EXPECT_EQ(polygon_mesh.chunks.at(0).vertices_count, 6U);
+    EXPECT_EQ(polygon_mesh.chunks.at(1).first_vertex, 6U);
+    EXPECT_EQ(polygon_mesh.chunks.at(1).vertices_count, 3U);
+    EXPECT_EQ(polygon_mesh.clamped_vertices_count, 0U);
+}
+
+TEST(PolygonMeshTest, VerticesAreRelativeToTheirChunk)
+{
+    std::vector<PMSPolygon> polygons{ MakePolygon(5000.25F, -3000.5F) };
+    polygons.at(0).vertices.at(1).color.red = 10;
+    polygons.at(0).vertices.at(1).color.green = 20;
+    polygons.at(0).vertices.at(1).color.blue = 30;
+    polygons.at(0).vertices.at(1).color.alpha = 40;
+    polygons.at(0).vertices.at(1).texture_s = 1.5F;
+    polygons.at(0).vertices.at(1).texture_t = -2.0F;
+    auto polygon_mesh = BakePolygonMesh(polygons);
+
+    EXPECT_EQ(GetVertexPosition(polygon_mesh, 0), glm::vec2(5000.25F, 3000.5F));
+    EXPECT_EQ(GetVertexPosition(polygon_mesh, 1), glm::vec2(5050.25F, 3000.5F));
+    EXPECT_EQ(GetVertexPosition(polygon_mesh, 2), glm::vec2(5000.25F, 2950.5F));
+
+    const auto& vertex = polygon_mesh.vertices.at(1);
+    EXPECT_EQ(vertex.color, (std::array<std::uint8_t, 4>{ 10, 20, 30, 40 }));
+    EXPECT_EQ(vertex.texture_s, 1.5F);
+    EXPECT_EQ(vertex.texture_t, -2.0F);
+}
+
+TEST(PolygonMeshTest, ClampsVerticesTooFarFromTheirChunk)
+{
+    std::vector<PMSPolygon> polygons{ MakePolygon(0.0F, 0.0F) };
+    polygons.at(0).vertices.at(1).x = 20000.0F;
+    polygons.at(0).vertices.at(2).x = -20000.0F;
+    auto polygon_mesh = BakePolygonMesh(polygons);
+
+    EXPECT_EQ(polygon_mesh.clamped_vertices_count, 2U);
+}
+
+TEST(PolygonMeshTest, PolygonsTooLargeForTheirChunkGetAChunkOfTheirOwn)
+{
+    std::vector<PMSPolygon> polygons{ MakePolygon(10.0F, 10.0F), MakePolygon(0.0F, 0.0F) };
+    polygons.at(1).vertices.at(1).x = 12000.0F;
+    polygons.at(1).vertices.at(2).y = -3000.0F;
+    auto polygon_mesh = BakePolygonMesh(polygons);
+
+    ASSERT_EQ(polygon_mesh.chunks.size(), 2U);
+    EXPECT_EQ(polygon_mesh.polygon_chunks, (std::vector<unsigned int>{ 0, 1 }));
+    EXPECT_EQ(polygon_mesh.chunks.at(1).origin, glm::vec2(4000.0F, 1000.0F));
+    EXPECT_EQ(polygon_mesh.clamped_vertices_count, 0U);
+    EXPECT_EQ(GetVertexPosition(polygon_mesh, 3), glm::vec2(0.0F, 0.0F));
+    EXPECT_EQ(GetVertexPosition(polygon_mesh, 4), glm::vec2(12000.0F, 0.0F));
+    EXPECT_EQ(GetVertexPosition(polygon_mesh, 5), glm::vec2(0.0F, 3000.0F));
+}
+
+TEST(PolygonMeshTest, ChunksOfTheirOwnAreCenteredOnThePackedPositionsGrid)
+{
+    std::vector<PMSPolygon> polygons{ MakePolygon(0.0F, 0.0F) };
+    polygons.at(0).vertices.at(1).x = 12000.3F;
+    polygons.at(0).vertices.at(2).y = -3000.0F;
+    auto polygon_mesh = BakePolygonMesh(polygons);
+
+    ASSERT_EQ(polygon_mesh.chunks.size(), 1U);
+    EXPECT_EQ(polygon_mesh.chunks.at(0).origin, glm::vec2(4000.0F, 1000.0F));
+    // Same position as the vertex would get in a chunk of a cell
+    EXPECT_EQ(GetVertexPosition(polygon_mesh, 1), glm::vec2(12000.25F, 0.0F));
+}
+
+TEST(PolygonMeshTest, DrawRangesMergePolygonsNextToEachOtherInTheMesh)
+{
+    std::vector<PMSPolygon> polygons{
+        MakePolygon(10.0F, 10.0F),   MakePolygon(20.0F, 10.0F), MakePolygon(5000.0F, 10.0F),
+        MakePolygon(100.0F, 100.0F), MakePolygon(30.0F, 10.0F),
+    };
+    auto polygon_mesh = BakePolygonMesh(polygons);
+
+    std::vector<PolygonMeshDrawRange> draw_ranges;
+    GetPolygonMeshDrawRanges(polygon_mesh, std::vector<unsigned int>{ 0, 1, 2, 3, 4 }, draw_ranges);
+    ASSERT_EQ(draw_ranges.size(), 2U);
+    EXPECT_EQ(draw_ranges.at(0).chunk, 0U);
+    EXPECT_EQ(draw_ranges.at(0).first_vertex, 0U);
+    EXPECT_EQ(draw_ranges.at(0).vertices_count, 12U);
+    EXPECT_EQ(draw_ranges.at(1).chunk, 1U);
+    EXPECT_EQ(draw_ranges.at(1).first_vertex, 12U);
+    EXPECT_EQ(draw_ranges.at(1).vertices_count, 3U);
+
+    GetPolygonMeshDrawRanges(polygon_mesh, std::vector<unsigned int>{ 4, 3, 1, 0 }, draw_ranges);
+    ASSERT_EQ(draw_ranges.size(), 1U);
+    EXPECT_EQ(draw_ranges.at(0).first_vertex, 0U);
+    EXPECT_EQ(draw_ranges.at(0).vertices_count, 12U);
+
+    GetPolygonMeshDrawRanges(polygon_mesh, std::vector<unsigned int>{ 1, 4, 10 }, draw_ranges);
+    ASSERT_EQ(draw_ranges.size(), 2U);
+    EXPECT_EQ(draw_ranges.at(0).first_vertex, 3U);
+    EXPECT_EQ(draw_ranges.at(1).first_vertex, 9U);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+import RenderQueue;
+
+using namespace Soldank;
+
+namespace
+{
+struct RecordingRenderStateBinder
+{
+    RenderStateBinder Create()
+    {
+        return { .use_shader =
+                   [this](unsigned int shader_id) {
+                       calls.push_back("shader " + std::to_string(shader_id));
+                   },
+                 .bind_texture =
+                   [this](unsigned int texture_id) {
+                       calls.push_back("texture " + std::to_string(texture_id));
+                   } };
+    }
+
+    std::vector<std::string> calls;
+};
+} // namespace
+
+TEST(RenderQueueTest, RadixSortMatchesStableSort)
+{
+    std::mt19937_64 random_engine(7);
+    std::vector<std::uint64_t> keys;
+    for (unsigned int i = 0; i < 1000; ++i) {
+        // Few distinct values so that there are many equal keys
+        keys.push_back(random_engine() % 50 << (8 * (i % 8)));
+    }
+
+    std::vector<unsigned int> order;
+    std::vector<unsigned int> scratch;
+    RadixSortRenderKeys(keys, order, scratch);
+
+    std::vector<unsigned int> expected_order(keys.size());
+    for (unsigned int i = 0; i < keys.size(); ++i) {
+        expected_order[i] = i;
+    }
+    std::ranges::stable_sort(expected_order,
+                             [&keys](unsigned int a, unsigned int b) { return keys[a] < keys[b]; });
+    EXPECT_EQ(order, expected_order);
+}
+
+TEST(RenderQueueTest, SortKeyOrdersByLayerShaderTextureThenDepth)
+{
+    EXPECT_LT(CreateRenderSortKey(RenderLayer::Background, 4000, 900000, 16000000),
+              CreateRenderSortKey(RenderLayer::BackSceneries, 0, 0, 0));
+    EXPECT_LT(CreateRenderSortKey(RenderLayer::Bullets, 1, 900000, 16000000),
+              CreateRenderSortKey(RenderLayer::Bullets, 2, 0, 0));
+    EXPECT_LT(CreateRenderSortKey(RenderLayer::Bullets, 1, 1, 16000000),
+              CreateRenderSortKey(RenderLayer::Bullets, 1, 2, 0));
+    EXPECT_LT(CreateRenderSortKey(RenderLayer::Bullets, 1, 1, 1),
+              CreateRenderSortKey(RenderLayer::Bullets, 1, 1, 2));
+}
+
+TEST(RenderQueueTest, ExecutesInSortedOrderAndSkipsRedundantStateChanges)
+{
+    RecordingRenderStateBinder binder;
+    RenderQueue render_queue;
+    render_queue.Submit(RenderLayer::Bullets, 3, 20, [&]() { binder.calls.emplace_back("A"); });
+    render_queue.Submit(RenderLayer::Bullets, 3, 10, [&]() { binder.calls.emplace_back("B"); });
+    render_queue.Submit(
+      RenderLayer::Background, 5, 10, [&]() { binder.calls.emplace_back("C"); });
+    render_queue.Submit(RenderLayer::Bullets, 3, 20, [&]() { binder.calls.emplace_back("D"); });
+    render_queue.Submit(RenderLayer::Bullets, 3, 10, [&]() { binder.calls.emplace_back("E"); });
+
+    auto stats = render_queue.Execute(binder.Create());
+
+    EXPECT_EQ(binder.calls,
+              (std::vector<std::string>{ "shader 5",
+                                         "texture 10",
+                                         "C",
+                                         "shader 3",
+                                         "B",
+                                         "E",
+                                         "texture 20",
+                                         "A",
+                                         "D" }));
+    EXPECT_EQ(stats.commands_count, 5U);
+    EXPECT_EQ(stats.shader_changes_count, 2U);
+    EXPECT_EQ(stats.texture_changes_count, 2U);
+    EXPECT_EQ(stats.GetStateChangesCount(), 4U);
+    EXPECT_EQ(render_queue.GetSize(), 0U);
+}
+
+TEST(RenderQueueTest, StateIsSetAgainAfterDrawsSettingTheirOwnState)
+{
+    RecordingRenderStateBinder binder;
+    RenderQueue render_queue;
+    render_queue.Submit(RenderLayer::Bullets, 3, 10, [&]() { binder.calls.emplace_back("A"); });
+    render_queue.Submit(RenderLayer::Soldiers, [&]() { binder.calls.emplace_back("B"); });
+    render_queue.Submit(RenderLayer::Items, 3, 10, [&]() { binder.calls.emplace_back("C"); });
+
+    auto stats = render_queue.Execute(binder.Create());
+
+    EXPECT_EQ(binder.calls,
+              (std::vector<std::string>{
+                "shader 3", "texture 10", "A", "B", "shader 3", "texture 10", "C" }));
+    EXPECT_EQ(stats.GetStateChangesCount(), 4U);
+}
+
+TEST(RenderQueueTest, LayersAreBegunAndEndedAroundTheirDraws)
+{
+    RecordingRenderStateBinder binder;
+    RenderQueue render_queue;
+    render_queue.Submit(RenderLayer::Polygons, [&]() { binder.calls.emplace_back("A"); });
+    render_queue.Submit(RenderLayer::Bullets, [&]() { binder.calls.emplace_back("B"); });
+    render_queue.Submit(RenderLayer::Bullets, [&]() { binder.calls.emplace_back("C"); });
+
+    RenderStateBinder render_state_binder = binder.Create();
+    render_state_binder.begin_layer = [&](RenderLayer layer) {
+        binder.calls.push_back("begin " + std::string(RENDER_LAYER_NAMES.at((int)layer)));
+    };
+    render_state_binder.end_layer = [&](RenderLayer layer) {
+        binder.calls.push_back("end " + std::string(RENDER_LAYER_NAMES.at((int)layer)));
+    };
+    render_queue.Execute(render_state_binder);
+
+    EXPECT_EQ(binder.calls,
+              (std::vector<std::string>{ "begin Bullets",
+                                         "B",
+                                         "C",
+                                         "end Bullets",
+                                         "begin Polygons",
+                                         "A",
+                                         "end Polygons" }));
+    EXPECT_EQ(GetRenderSortKeyLayer(CreateRenderSortKey(RenderLayer::FrontSceneries, 4095, 1, 2)),
+              RenderLayer::FrontSceneries);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,107 @@
+#include "core/math/Glm.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+import RenderSnapshot;
+
+import Shared.Core.Types.BulletType;
+
+using namespace Soldank;
+
+namespace
+{
+SoldierRenderState CreateSoldierRenderState(std::uint8_t id, glm::vec2 position)
+{
+    SoldierRenderState soldier{};
+    soldier.id = id;
+    soldier.skeleton_positions.fill(position);
+    return soldier;
+}
+
+ItemRenderState CreateItemRenderState(std::uint8_t id, glm::vec2 position)
+{
+    ItemRenderState item{};
+    item.id = id;
+    item.positions.fill(position);
+    return item;
+}
+
+BulletRenderState CreateBulletRenderState(std::uint16_t slot,
+                                          glm::vec2 initial_position,
+                                          glm::vec2 position)
+{
+    BulletRenderState bullet{};
+    bullet.id = slot;
+    bullet.style = BulletType::Bullet;
+    bullet.initial_position = initial_position;
+    bullet.position = position;
+    return bullet;
+}
+} // namespace
+
+TEST(RenderSnapshotTest, SoldiersAreDrawnBetweenTheTwoLatestSnapshots)
+{
+    RenderSnapshotHistory history;
+    history.PushNew().soldiers = { CreateSoldierRenderState(1, { 0.0F, 0.0F }),
+                                   CreateSoldierRenderState(2, { 100.0F, 0.0F }) };
+    history.PushNew().soldiers = { CreateSoldierRenderState(2, { 110.0F, 0.0F }),
+                                   CreateSoldierRenderState(3, { 50.0F, 50.0F }) };
+
+    std::vector<SoldierRenderState> soldiers;
+    history.ForEachSoldier(0.5F,
+                           [&](const SoldierRenderState& soldier) { soldiers.push_back(soldier); });
+
+    ASSERT_EQ(soldiers.size(), 2U);
+    EXPECT_EQ(soldiers.at(0).id, 2);
+    EXPECT_EQ(soldiers.at(0).skeleton_positions.at(0), glm::vec2(105.0F, 0.0F));
+    EXPECT_EQ(soldiers.at(0).skeleton_positions.at(23), glm::vec2(105.0F, 0.0F));
+    // It has only just appeared, so there is nothing to draw it from
+    EXPECT_EQ(soldiers.at(1).id, 3);
+    EXPECT_EQ(soldiers.at(1).skeleton_positions.at(0), glm::vec2(50.0F, 50.0F));
+}
+
+TEST(RenderSnapshotTest, ItemsThatWerePlacedSomewhereElseAreNotInterpolated)
+{
+    RenderSnapshotHistory history;
+    history.PushNew().items = { CreateItemRenderState(1, { 0.0F, 0.0F }),
+                                CreateItemRenderState(2, { 0.0F, 0.0F }) };
+    history.PushNew().items = { CreateItemRenderState(1, { 10.0F, 0.0F }),
+                                CreateItemRenderState(2, { 500.0F, 0.0F }) };
+
+    std::vector<ItemRenderState> items;
+    history.ForEachItem(0.5F, [&](const ItemRenderState& item) { items.push_back(item); });
+
+    ASSERT_EQ(items.size(), 2U);
+    EXPECT_EQ(items.at(0).positions.at(3), glm::vec2(5.0F, 0.0F));
+    EXPECT_EQ(items.at(1).positions.at(0), glm::vec2(500.0F, 0.0F));
+}
+
+TEST(RenderSnapshotTest, BulletsThatTookOverASlotAreNotInterpolated)
+{
+    RenderSnapshotHistory history;
+    history.PushNew().bullets = { CreateBulletRenderState(0, { 0.0F, 0.0F }, { 20.0F, 0.0F }),
+                                  CreateBulletRenderState(1, { 0.0F, 0.0F }, { 40.0F, 0.0F }) };
+    history.PushNew().bullets = { CreateBulletRenderState(0, { 0.0F, 0.0F }, { 30.0F, 0.0F }),
+                                  CreateBulletRenderState(1, { 60.0F, 0.0F }, { 60.0F, 0.0F }) };
+
+    std::vector<BulletRenderState> bullets;
+    history.ForEachBullet(0.5F,
+                          [&](const BulletRenderState& bullet) { bullets.push_back(bullet); });
+
+    ASSERT_EQ(bullets.size(), 2U);
+    EXPECT_EQ(bullets.at(0).position, glm::vec2(25.0F, 0.0F));
+    EXPECT_EQ(bullets.at(1).position, glm::vec2(60.0F, 0.0F));
+}
+
+TEST(RenderSnapshotTest, PushingReusesTheSnapshotBeforeThePreviousOne)
+{
+    RenderSnapshotHistory history;
+    history.PushNew().bullets = { CreateBulletRenderState(0, {}, {}) };
+    const BulletRenderState* bullets_data = history.GetCurrent().bullets.data();
+    history.PushNew().bullets.clear();
+
+    EXPECT_EQ(history.PushNew().bullets.data(), bullets_data);
+}
@@ -0,0 +1,171 @@
+#include "core/math/Glm.hpp"
+#include "rendering/data/sprites/SpriteTypes.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+import SoldierSkinning;
+import Texture;
+
+using namespace Soldank;
+
+namespace
+{
+const Texture::TextureRegion REGION{ .texture_min = { 0.25F, 0.5F },
+                                      .texture_max = { 0.5F, 0.75F } };
+const Texture::TextureRegion FLIPPED_REGION{ .texture_min = { 0.5F, 0.5F },
+                                              .texture_max = { 0.75F, 0.75F } };
+
+SoldierPartGeometry MakePart(glm::uvec2 point, bool flippable)
+{
+    SoldierPartGeometry part{
+        .point = point,
+        .flexibility = 5.0F,
+        .color = Sprites::SoldierSpriteColor::Skin,
+        .alpha = Sprites::SoldierSpriteAlpha::Blood,
+        .tinted = true,
+        .sprite = CreateSoldierPartSpriteGeometry({ 0.25F, 0.5F }, { 8.0F, 4.0F }, false, REGION),
+        .flipped_sprite = std::nullopt,
+    };
+    if (flippable) {
+        part.flipped_sprite =
+          CreateSoldierPartSpriteGeometry({ 0.25F, 0.5F }, { 8.0F, 4.0F }, true, FLIPPED_REGION);
+    }
+    return part;
+}
+
+SoldierSkinningRecord MakeRecord(std::int8_t direction)
+{
+    SoldierSkinningRecord record{};
+    for (unsigned int i = 0; i < SOLDIER_SKELETON_POSITIONS_COUNT; ++i) {
+        record.skeleton_positions.at(i) = { (float)i, 100.0F + (float)i };
+    }
+    record.direction = direction;
+    record.colors.at(std::to_underlying(Sprites::SoldierSpriteColor::Skin)) = { 0.1F, 0.2F, 0.3F };
+    record.alphas.at(std::to_underlying(Sprites::SoldierSpriteAlpha::Blood)) = 0.4F;
+    return record;
+}
+
+// Floats of one vertex of the vertices appended by AppendSoldierSkinningVertices
+std::vector<float> GetVertex(const std::vector<float>& vertices, unsigned int vertex_id)
+{
+    auto first = vertices.begin() + vertex_id * SOLDIER_SKINNING_FLOATS_PER_VERTEX;
+    return { first, first + SOLDIER_SKINNING_FLOATS_PER_VERTEX };
+}
+} // namespace
+
+TEST(SoldierSkinningTest, PackAtlasPlacesImagesInPaddedRows)
+{
+    std::vector<glm::ivec2> image_sizes{ { 10, 20 }, { 10, 5 }, { 10, 8 } };
+    auto atlas_layout = Texture::PackAtlas(image_sizes, 24, 1);
+
+    EXPECT_EQ(atlas_layout.positions,
+              (std::vector<glm::ivec2>{ { 1, 1 }, { 12, 1 }, { 1, 22 } }));
+    EXPECT_EQ(atlas_layout.size, glm::ivec2(24, 32));
+}
+
+TEST(SoldierSkinningTest, PackAtlasWidensForWideImages)
+{
+    std::vector<glm::ivec2> image_sizes{ { 40, 4 } };
+    auto atlas_layout = Texture::PackAtlas(image_sizes, 24, 1);
+
+    EXPECT_EQ(atlas_layout.positions, (std::vector<glm::ivec2>{ { 1, 1 } }));
+    EXPECT_EQ(atlas_layout.size, glm::ivec2(42, 8));
+}
+
+TEST(SoldierSkinningTest, SpriteGeometryIsAroundTheCenter)
+{
+    auto sprite = CreateSoldierPartSpriteGeometry({ 0.25F, 0.25F }, { 8.0F, 4.0F }, false, REGION);
+    EXPECT_EQ(sprite.corner_min, glm::vec2(-2.0F, -3.0F));
+    EXPECT_EQ(sprite.corner_max, glm::vec2(6.0F, 1.0F));
+
+    auto flipped_sprite =
+      CreateSoldierPartSpriteGeometry({ 0.25F, 0.25F }, { 8.0F, 4.0F }, true, REGION);
+    EXPECT_EQ(flipped_sprite.corner_min, glm::vec2(-2.0F, -1.0F));
+    EXPECT_EQ(flipped_sprite.corner_max, glm::vec2(6.0F, 3.0F));
+}
+
+TEST(SoldierSkinningTest, OnlyVisiblePartsAreAppended)
+{
+    std::vector<SoldierPartGeometry> parts{ MakePart({ 1, 2 }, true),
+                                            MakePart({ 3, 4 }, true),
+                                            MakePart({ 5, 6 }, true) };
+    auto record = MakeRecord(1);
+    record.visible_parts.set(0);
+    record.visible_parts.set(2);
+
+    std::vector<float> vertices;
+    AppendSoldierSkinningVertices(record, parts, vertices);
+    ASSERT_EQ(vertices.size(),
+              2 * SOLDIER_SKINNING_VERTICES_PER_PART * SOLDIER_SKINNING_FLOATS_PER_VERTEX);
+
+    // Skeleton segment of the first vertex of the second appended part
+    auto vertex = GetVertex(vertices, SOLDIER_SKINNING_VERTICES_PER_PART);
+    EXPECT_EQ((std::vector<float>(vertex.begin() + 9, vertex.begin() + 13)),
+              (std::vector<float>{ 4.0F, 104.0F, 5.0F, 105.0F }));
+
+    // Appending keeps what was there before
+    AppendSoldierSkinningVertices(record, parts, vertices);
+    EXPECT_EQ(vertices.size(),
+              4 * SOLDIER_SKINNING_VERTICES_PER_PART * SOLDIER_SKINNING_FLOATS_PER_VERTEX);
+}
+
+TEST(SoldierSkinningTest, VertexHoldsCornerColorTextureAndSkeletonSegment)
+{
+    std::vector<SoldierPartGeometry> parts{ MakePart({ 1, 2 }, true) };
+    auto record = MakeRecord(1);
+    record.visible_parts.set(0);
+
+    std::vector<float> vertices;
+    AppendSoldierSkinningVertices(record, parts, vertices);
+
+    // clang-format off
+    EXPECT_EQ(GetVertex(vertices, 0), (std::vector<float>{
+        -2.0F, -2.0F, 0.0F,
+        0.1F, 0.2F, 0.3F, 0.4F,
+        0.25F, 0.5F,
+        0.0F, 100.0F, 1.0F, 101.0F,
+        5.0F, 1.0F,
+    }));
+    // clang-format on
+    auto opposite_corner = GetVertex(vertices, 2);
+    EXPECT_EQ(opposite_corner.at(0), 6.0F);
+    EXPECT_EQ(opposite_corner.at(1), 2.0F);
+    EXPECT_EQ(opposite_corner.at(7), 0.5F);
+    EXPECT_EQ(opposite_corner.at(8), 0.75F);
+}
+
+TEST(SoldierSkinningTest, FacingLeftUsesFlippedSpritesOrMirrors)
+{
+    std::vector<SoldierPartGeometry> parts{ MakePart({ 1, 2 }, true),
+                                            MakePart({ 1, 2 }, false) };
+    parts.at(1).tinted = false;
+    auto record = MakeRecord(-1);
+    record.visible_parts.set(0);
+    record.visible_parts.set(1);
+
+    std::vector<float> vertices;
+    AppendSoldierSkinningVertices(record, parts, vertices);
+
+    auto flipped_vertex = GetVertex(vertices, 0);
+    EXPECT_EQ(flipped_vertex.at(1), -2.0F);
+    EXPECT_EQ(flipped_vertex.at(7), FLIPPED_REGION.texture_min.x);
+    EXPECT_EQ(flipped_vertex.at(14), 1.0F);
+
+    auto mirrored_vertex = GetVertex(vertices, SOLDIER_SKINNING_VERTICES_PER_PART);
+    EXPECT_EQ(mirrored_vertex.at(7), REGION.texture_min.x);
+    EXPECT_EQ(mirrored_vertex.at(14), -1.0F);
+    // Untinted parts keep the colors of their sprites
+    EXPECT_EQ((std::vector<float>(mirrored_vertex.begin() + 3, mirrored_vertex.begin() + 7)),
+              (std::vector<float>{ 1.0F, 1.0F, 1.0F, 1.0F }));
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
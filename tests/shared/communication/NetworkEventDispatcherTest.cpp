@@ -170,6 +170,30 @@ TEST_F(NetworkEventDispatcherTests, TestNetworkEventDispatcherParseErrorInvalidN
     ASSERT_EQ(std::get<ParseError>(result.second), ParseError::InvalidNetworkEvent);
 }
 
+TEST_F(NetworkEventDispatcherTests, TestNetworkEventDispatcherNetworkEventWithoutHandler)
+{
+    NetworkMessage network_message(NetworkEvent::PingCheck);
+    auto result = ProcessNetworkMessage(network_message);
+    ASSERT_EQ(result.first, NetworkEventDispatchResult::ParseError);
+    ASSERT_EQ(std::get<ParseError>(result.second), ParseError::InvalidNetworkEvent);
+}
+
+TEST(NetworkEventDispatcherTest, TestNetworkEventDispatcherUsesFirstHandlerAddedForNetworkEvent)
+{
+    auto first_handler = std::make_shared<NetworkEventHandlerForAssignPlayerIdExample>();
+    auto second_handler = std::make_shared<NetworkEventHandlerForAssignPlayerIdExample>();
+    NetworkEventDispatcher network_event_dispatcher({ first_handler });
+    network_event_dispatcher.AddNetworkEventHandler(second_handler);
+
+    ConnectionMetadata connection_metadata;
+    NetworkMessage network_message(NetworkEvent::AssignPlayerId, 7U);
+    auto result = network_event_dispatcher.ProcessNetworkMessage(connection_metadata,
+                                                                 network_message);
+    ASSERT_EQ(result.first, NetworkEventDispatchResult::Success);
+    ASSERT_EQ(first_handler->GetLastAssignedPlayerId(), 7U);
+    ASSERT_EQ(second_handler->GetLastAssignedPlayerId(), 0U);
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
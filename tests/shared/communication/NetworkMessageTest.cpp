@@ -4,8 +4,11 @@
 #include <cstdint>
 #include <array>
 #include <optional>
+#include <span>
 #include <string>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 import Shared.Networking.NetworkMessage;
 import Shared.Networking.NetworkEventDispatcher;
@@ -267,8 +270,58 @@ TEST(NetworkMessageTests, TestNetworkMessageParseDataStringHasZeroInTheMiddle)
     CheckParseError<NetworkEvent, std::string>(data, ParseError::InvalidString);
 }
 
+TEST(NetworkMessageTests, TestNetworkMessageParseDataFixedSizeStruct)
+{
+    struct ExamplePacket
+    {
+        std::uint32_t id;
+        float x;
+        float y;
+    };
+    ExamplePacket expected_packet{ .id = 3, .x = 1.5F, .y = -2.0F };
+    NetworkMessage network_message(NetworkEvent::SoldierState, expected_packet);
+
+    auto parsed = network_message.Parse<NetworkEvent, ExamplePacket>();
+    ASSERT_TRUE(parsed.has_value());
+    auto [network_event, packet] = *parsed;
+    ASSERT_EQ(network_event, NetworkEvent::SoldierState);
+    ASSERT_EQ(packet.id, expected_packet.id);
+    ASSERT_EQ(packet.x, expected_packet.x);
+    ASSERT_EQ(packet.y, expected_packet.y);
+
+    std::vector<char> data{ network_message.GetData().begin(), network_message.GetData().end() };
+    data.push_back(0);
+    ASSERT_EQ((NetworkMessage::ParseData<NetworkEvent, ExamplePacket>(data).error()),
+              ParseError::BufferTooBig);
+    data.resize(data.size() - 2);
+    ASSERT_EQ((NetworkMessage::ParseData<NetworkEvent, ExamplePacket>(data).error()),
+              ParseError::BufferTooSmall);
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
 }
+
+TEST(NetworkMessageTests, TestNetworkMessageViewParsesReceivedBytesInPlace)
+{
+    NetworkMessage network_message(
+      NetworkEvent::ChatMessage, std::string{ "Hello" }, std::uint8_t{ 7 });
+    std::vector<char> received_bytes{ network_message.GetData().begin(),
+                                      network_message.GetData().end() };
+
+    NetworkMessageView network_message_view{ received_bytes };
+    ASSERT_EQ(network_message_view.GetData().data(), received_bytes.data());
+
+    auto network_event_or_error = network_message_view.GetNetworkEvent();
+    ASSERT_TRUE(network_event_or_error.has_value());
+    ASSERT_EQ(*network_event_or_error, NetworkEvent::ChatMessage);
+
+    auto parsed = network_message_view.Parse<NetworkEvent, std::string, std::uint8_t>();
+    ASSERT_TRUE(parsed.has_value());
+    ASSERT_EQ(std::get<1>(*parsed), "Hello");
+    ASSERT_EQ(std::get<2>(*parsed), 7);
+
+    ASSERT_FALSE(NetworkMessageView{ std::span<const char>{} }.GetNetworkEvent().has_value());
+}
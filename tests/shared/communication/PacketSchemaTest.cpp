@@ -0,0 +1,227 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+import Shared.Core.Animations;
+import Shared.Core.Types.BulletType;
+import Shared.Core.Types.TeamType;
+import Shared.Core.Types.WeaponType;
+import Shared.Networking.NetworkBitStream;
+import Shared.Networking.NetworkEvent;
+import Shared.Networking.NetworkMessage;
+import Shared.Networking.NetworkPackets;
+import Shared.Networking.PacketSchema;
+
+using namespace Soldank;
+
+namespace
+{
+SoldierStatePacket MakeSoldierState()
+{
+    SoldierStatePacket soldier_state{};
+    soldier_state.server_tick = 0xFFFFFFF0;
+    soldier_state.player_id = 7;
+    soldier_state.position_x = 123.456F;
+    soldier_state.position_y = -987.654F;
+    soldier_state.old_position_x = 122.25F;
+    soldier_state.old_position_y = -988.5F;
+    soldier_state.body_animation_type = AnimationType::Throw;
+    soldier_state.body_animation_frame = 12;
+    soldier_state.body_animation_speed = 2;
+    soldier_state.body_animation_count = 1;
+    soldier_state.legs_animation_type = AnimationType::Run;
+    soldier_state.legs_animation_frame = 7;
+    soldier_state.legs_animation_speed = 1;
+    soldier_state.legs_animation_count = 0;
+    soldier_state.velocity_x = 0.1F;
+    soldier_state.velocity_y = -3.75F;
+    soldier_state.force_x = 0.0F;
+    soldier_state.force_y = 0.06F;
+    soldier_state.on_ground = true;
+    soldier_state.on_ground_for_law = false;
+    soldier_state.on_ground_last_frame = true;
+    soldier_state.on_ground_permanent = false;
+    soldier_state.old_direction = -1;
+    soldier_state.stance = 2;
+    soldier_state.mouse_map_position_x = 400.0F;
+    soldier_state.mouse_map_position_y = -120.0F;
+    soldier_state.using_jets = true;
+    soldier_state.jets_count = 190;
+    soldier_state.active_weapon = 1;
+    soldier_state.last_applied_input_id = 4321;
+    soldier_state.snapshot_interval_ticks = 3;
+    return soldier_state;
+}
+
+SoldierStatePacket RoundTrip(const SoldierStatePacket& soldier_state)
+{
+    using Schema = PacketSchemaOf<SoldierStatePacket>::Type;
+    NetworkBitWriter writer;
+    Schema::Encode(soldier_state, writer);
+    EXPECT_EQ(writer.GetData().size(), Schema::BYTES);
+
+    SoldierStatePacket decoded{};
+    NetworkBitReader reader{ writer.GetData() };
+    Schema::Decode(reader, decoded);
+    EXPECT_FALSE(reader.IsOverflowed());
+    return decoded;
+}
+} // namespace
+
+TEST(PacketSchemaTest, SoldierStateRoundTrip)
+{
+    const auto soldier_state = MakeSoldierState();
+    const auto decoded = RoundTrip(soldier_state);
+
+    EXPECT_EQ(decoded.server_tick, soldier_state.server_tick);
+    EXPECT_EQ(decoded.player_id, soldier_state.player_id);
+    // Simulation values are bit exact
+    EXPECT_EQ(decoded.position_x, soldier_state.position_x);
+    EXPECT_EQ(decoded.position_y, soldier_state.position_y);
+    EXPECT_EQ(decoded.velocity_x, soldier_state.velocity_x);
+    EXPECT_EQ(decoded.velocity_y, soldier_state.velocity_y);
+    EXPECT_EQ(decoded.force_x, soldier_state.force_x);
+    EXPECT_EQ(decoded.force_y, soldier_state.force_y);
+    EXPECT_FLOAT_EQ(decoded.old_position_x, soldier_state.old_position_x);
+    EXPECT_FLOAT_EQ(decoded.old_position_y, soldier_state.old_position_y);
+    EXPECT_EQ(decoded.body_animation_type, soldier_state.body_animation_type);
+    EXPECT_EQ(decoded.body_animation_frame, soldier_state.body_animation_frame);
+    EXPECT_EQ(decoded.body_animation_speed, soldier_state.body_animation_speed);
+    EXPECT_EQ(decoded.legs_animation_type, soldier_state.legs_animation_type);
+    EXPECT_EQ(decoded.legs_animation_frame, soldier_state.legs_animation_frame);
+    EXPECT_EQ(decoded.on_ground, soldier_state.on_ground);
+    EXPECT_EQ(decoded.on_ground_for_law, soldier_state.on_ground_for_law);
+    EXPECT_EQ(decoded.on_ground_last_frame, soldier_state.on_ground_last_frame);
+    EXPECT_EQ(decoded.old_direction, soldier_state.old_direction);
+    EXPECT_EQ(decoded.stance, soldier_state.stance);
+    EXPECT_FLOAT_EQ(decoded.mouse_map_position_x, soldier_state.mouse_map_position_x);
+    EXPECT_FLOAT_EQ(decoded.mouse_map_position_y, soldier_state.mouse_map_position_y);
+    EXPECT_EQ(decoded.using_jets, soldier_state.using_jets);
+    EXPECT_EQ(decoded.jets_count, soldier_state.jets_count);
+    EXPECT_EQ(decoded.active_weapon, soldier_state.active_weapon);
+    EXPECT_EQ(decoded.last_applied_input_id, soldier_state.last_applied_input_id);
+    EXPECT_EQ(decoded.snapshot_interval_ticks, soldier_state.snapshot_interval_ticks);
+}
+
+TEST(PacketSchemaTest, OutOfRangeValuesAreClampedAndQuantized)
+{
+    auto soldier_state = MakeSoldierState();
+    soldier_state.old_position_x = 1.0F / 200.0F;
+    soldier_state.old_position_y = std::numeric_limits<float>::quiet_NaN();
+    soldier_state.mouse_map_position_x = 1.0e9F;
+    soldier_state.mouse_map_position_y = -1.0e9F;
+    soldier_state.jets_count = -5;
+    soldier_state.body_animation_frame = 1000;
+    const auto decoded = RoundTrip(soldier_state);
+
+    EXPECT_FLOAT_EQ(decoded.old_position_x, 0.0F);
+    EXPECT_FLOAT_EQ(decoded.old_position_y, -32768.0F);
+    EXPECT_FLOAT_EQ(decoded.mouse_map_position_x, 32767.0F);
+    EXPECT_FLOAT_EQ(decoded.mouse_map_position_y, -32768.0F);
+    EXPECT_EQ(decoded.jets_count, 0);
+    EXPECT_EQ(decoded.body_animation_frame, 255);
+}
+
+TEST(PacketSchemaTest, ProjectileSpawnRoundTrip)
+{
+    using Schema = PacketSchemaOf<ProjectileSpawnPacket>::Type;
+    const ProjectileSpawnPacket projectile_spawn{ .projectile_id = 65000,
+                                                  .style = BulletType::M2Bullet,
+                                                  .weapon = WeaponType::Barrett,
+                                                  .position_x = -1500.5F,
+                                                  .position_y = 320.25F,
+                                                  .velocity_x = 12.5F,
+                                                  .velocity_y = -0.75F,
+                                                  .timeout = -1,
+                                                  .hit_multiply = 1.15F,
+                                                  .team = TeamType::Delta,
+                                                  .owner_id = 255 };
+    NetworkBitWriter writer;
+    Schema::Encode(projectile_spawn, writer);
+    ProjectileSpawnPacket decoded{};
+    NetworkBitReader reader{ writer.GetData() };
+    Schema::Decode(reader, decoded);
+
+    EXPECT_EQ(decoded.projectile_id, projectile_spawn.projectile_id);
+    EXPECT_EQ(decoded.style, projectile_spawn.style);
+    EXPECT_EQ(decoded.weapon, projectile_spawn.weapon);
+    EXPECT_FLOAT_EQ(decoded.position_x, projectile_spawn.position_x);
+    EXPECT_FLOAT_EQ(decoded.position_y, projectile_spawn.position_y);
+    EXPECT_FLOAT_EQ(decoded.velocity_x, projectile_spawn.velocity_x);
+    EXPECT_FLOAT_EQ(decoded.velocity_y, projectile_spawn.velocity_y);
+    EXPECT_EQ(decoded.timeout, projectile_spawn.timeout);
+    EXPECT_EQ(decoded.hit_multiply, projectile_spawn.hit_multiply);
+    EXPECT_EQ(decoded.team, projectile_spawn.team);
+    EXPECT_EQ(decoded.owner_id, projectile_spawn.owner_id);
+}
+
+TEST(PacketSchemaTest, NetworkMessageUsesSchema)
+{
+    const auto soldier_state = MakeSoldierState();
+    NetworkMessage message(NetworkEvent::SoldierState, soldier_state);
+    EXPECT_EQ(message.GetData().size(),
+              sizeof(NetworkEvent) + PacketSchemaOf<SoldierStatePacket>::Type::BYTES);
+
+    auto parsed = message.Parse<NetworkEvent, SoldierStatePacket>();
+    ASSERT_TRUE(parsed.has_value());
+    const auto& [network_event, decoded] = *parsed;
+    EXPECT_EQ(network_event, NetworkEvent::SoldierState);
+    EXPECT_EQ(decoded.position_x, soldier_state.position_x);
+    EXPECT_EQ(decoded.last_applied_input_id, soldier_state.last_applied_input_id);
+
+    std::vector<char> truncated_data{ message.GetData().begin(), message.GetData().end() - 1 };
+    EXPECT_EQ(NetworkMessage::ParseData<NetworkEvent, SoldierStatePacket>(truncated_data).error(),
+              ParseError::BufferTooSmall);
+}
+
+TEST(PacketSchemaTest, EncodeAndDecodeThroughput)
+{
+    using Schema = PacketSchemaOf<SoldierStatePacket>::Type;
+    constexpr std::size_t ITERATIONS_COUNT = 100000;
+    auto soldier_state = MakeSoldierState();
+
+    NetworkBitWriter writer;
+    const auto encode_start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < ITERATIONS_COUNT; ++i) {
+        soldier_state.server_tick = static_cast<std::uint32_t>(i);
+        Schema::Encode(soldier_state, writer);
+    }
+    const auto encode_end = std::chrono::steady_clock::now();
+    ASSERT_EQ(writer.GetData().size(), (Schema::BITS * ITERATIONS_COUNT + 7) / 8);
+
+    NetworkBitReader reader{ writer.GetData() };
+    SoldierStatePacket decoded{};
+    std::uint64_t server_ticks_sum = 0;
+    const auto decode_start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < ITERATIONS_COUNT; ++i) {
+        Schema::Decode(reader, decoded);
+        server_ticks_sum += decoded.server_tick;
+    }
+    const auto decode_end = std::chrono::steady_clock::now();
+    EXPECT_FALSE(reader.IsOverflowed());
+    EXPECT_EQ(server_ticks_sum, ITERATIONS_COUNT * (ITERATIONS_COUNT - 1) / 2);
+
+    const auto to_nanoseconds_per_packet = [](auto duration) {
+        return static_cast<double>(
+                 std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()) /
+               static_cast<double>(ITERATIONS_COUNT);
+    };
+    RecordProperty("encode_ns_per_packet",
+                   std::to_string(to_nanoseconds_per_packet(encode_end - encode_start)));
+    RecordProperty("decode_ns_per_packet",
+                   std::to_string(to_nanoseconds_per_packet(decode_end - decode_start)));
+    RecordProperty("encoded_bytes", std::to_string(Schema::BYTES));
+    RecordProperty("raw_bytes", std::to_string(sizeof(SoldierStatePacket)));
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
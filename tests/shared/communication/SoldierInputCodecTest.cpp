@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+import Shared.Core.State.Control;
+import Shared.Networking.NetworkEvent;
+import Shared.Networking.NetworkMessage;
+import Shared.Networking.NetworkPackets;
+import Shared.Networking.SoldierInputCodec;
+
+using namespace Soldank;
+
+namespace
+{
+std::vector<SoldierInputPacket> MakeInputs(std::uint32_t first_input_sequence_id,
+                                           std::size_t inputs_count)
+{
+    std::vector<SoldierInputPacket> inputs;
+    for (std::size_t i = 0; i < inputs_count; ++i) {
+        const auto offset = static_cast<std::uint32_t>(i);
+        SoldierInputPacket input{};
+        input.input_sequence_id = first_input_sequence_id + offset;
+        input.client_tick = 1000 + offset;
+        input.apply_server_tick = 1004 + offset;
+        input.view_server_tick = 996 + offset - static_cast<std::uint32_t>(i % 2);
+        input.position_x = 120.5F + static_cast<float>(i) * 0.75F;
+        input.position_y = -34.0F;
+        input.mouse_map_position_x = 300.25F;
+        input.mouse_map_position_y = -12.0F - static_cast<float>(i);
+        input.control.right = true;
+        input.control.jets = i % 2 == 0;
+        input.control.was_jumping = i == 1;
+        input.control.mouse_aim_x = 640 - static_cast<int>(i);
+        input.control.mouse_aim_y = 480;
+        input.control.mouse_dist = 150;
+        inputs.push_back(input);
+    }
+    return inputs;
+}
+
+void ExpectEqualInputs(const SoldierInputPacket& actual, const SoldierInputPacket& expected)
+{
+    EXPECT_EQ(actual.input_sequence_id, expected.input_sequence_id);
+    EXPECT_EQ(actual.client_tick, expected.client_tick);
+    EXPECT_EQ(actual.apply_server_tick, expected.apply_server_tick);
+    EXPECT_EQ(actual.view_server_tick, expected.view_server_tick);
+    EXPECT_EQ(actual.position_x, expected.position_x);
+    EXPECT_EQ(actual.position_y, expected.position_y);
+    EXPECT_EQ(actual.mouse_map_position_x, expected.mouse_map_position_x);
+    EXPECT_EQ(actual.mouse_map_position_y, expected.mouse_map_position_y);
+    EXPECT_EQ(PackControlFlags(actual.control), PackControlFlags(expected.control));
+    EXPECT_EQ(actual.control.mouse_aim_x, expected.control.mouse_aim_x);
+    EXPECT_EQ(actual.control.mouse_aim_y, expected.control.mouse_aim_y);
+    EXPECT_EQ(actual.control.mouse_dist, expected.control.mouse_dist);
+}
+} // namespace
+
+TEST(SoldierInputCodecTest, InputsRoundTrip)
+{
+    const auto inputs = MakeInputs(0xFFFFFFFE, MAX_SOLDIER_INPUTS_PER_MESSAGE);
+    const NetworkMessage network_message = SoldierInputCodec::Encode(inputs);
+    ASSERT_EQ(network_message.GetNetworkEvent(), NetworkEvent::SoldierInput);
+
+    const auto batch = SoldierInputCodec::Decode(network_message);
+    ASSERT_TRUE(batch.has_value());
+    ASSERT_EQ(batch->GetInputs().size(), inputs.size());
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        ExpectEqualInputs(batch->GetInputs()[i], inputs.at(i));
+    }
+}
+
+TEST(SoldierInputCodecTest, InputsAreSmallerThanFixedSizeEncoding)
+{
+    const auto inputs = MakeInputs(500, MAX_SOLDIER_INPUTS_PER_MESSAGE);
+    const NetworkMessage fixed_size_message(NetworkEvent::SoldierInput, inputs.back());
+    const std::size_t fixed_size = fixed_size_message.GetData().size();
+
+    const NetworkMessage single_input_message =
+      SoldierInputCodec::Encode(std::span{ inputs }.last(1));
+    EXPECT_LT(single_input_message.GetData().size(), fixed_size);
+
+    // The repeated inputs are delta encoded against each other, so each one costs only a
+    // fraction of the first
+    const NetworkMessage network_message = SoldierInputCodec::Encode(inputs);
+    EXPECT_LT(network_message.GetData().size(), 2 * fixed_size);
+}
+
+TEST(SoldierInputCodecTest, OnlyNewestInputsAreEncoded)
+{
+    const auto inputs = MakeInputs(10, MAX_SOLDIER_INPUTS_PER_MESSAGE + 2);
+
+    const auto batch = SoldierInputCodec::Decode(SoldierInputCodec::Encode(inputs));
+    ASSERT_TRUE(batch.has_value());
+    ASSERT_EQ(batch->GetInputs().size(), MAX_SOLDIER_INPUTS_PER_MESSAGE);
+    EXPECT_EQ(batch->GetInputs().front().input_sequence_id, 12);
+    EXPECT_EQ(batch->GetInputs().back().input_sequence_id, 15);
+}
+
+TEST(SoldierInputCodecTest, ExtremeMouseValuesWrapAround)
+{
+    auto inputs = MakeInputs(1, 2);
+    inputs.at(0).control.mouse_aim_x = std::numeric_limits<int>::max();
+    inputs.at(0).control.mouse_aim_y = std::numeric_limits<int>::min();
+    inputs.at(1).control.mouse_aim_x = std::numeric_limits<int>::min();
+    inputs.at(1).control.mouse_aim_y = std::numeric_limits<int>::max();
+    inputs.at(1).control.mouse_dist = std::numeric_limits<int>::min();
+
+    const auto batch = SoldierInputCodec::Decode(SoldierInputCodec::Encode(inputs));
+    ASSERT_TRUE(batch.has_value());
+    ASSERT_EQ(batch->GetInputs().size(), inputs.size());
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        ExpectEqualInputs(batch->GetInputs()[i], inputs.at(i));
+    }
+}
+
+TEST(SoldierInputCodecTest, InvalidMessagesAreRejected)
+{
+    const auto inputs = MakeInputs(1, 2);
+    const NetworkMessage network_message = SoldierInputCodec::Encode(inputs);
+    std::vector<char> data{ network_message.GetData().begin(), network_message.GetData().end() };
+
+    auto truncated_data = std::span<const char>{ data }.first(data.size() - 1);
+    EXPECT_EQ(SoldierInputCodec::Decode(NetworkMessageView{ truncated_data }).error(),
+              ParseError::BufferTooSmall);
+
+    data.push_back(0);
+    EXPECT_EQ(SoldierInputCodec::Decode(NetworkMessageView{ data }).error(),
+              ParseError::BufferTooBig);
+
+    const NetworkMessage other_message(NetworkEvent::PingCheck);
+    EXPECT_EQ(SoldierInputCodec::Decode(other_message).error(), ParseError::InvalidNetworkEvent);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
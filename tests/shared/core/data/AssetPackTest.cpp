@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <ios>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "core/utility/Expected.hpp"
+
+import Shared.Core.Data.AssetPack;
+import Shared.Core.Data.IFileReader;
+import Shared.Core.Data.IFileWriter;
+import Shared.Core.Data.PackFileReader;
+
+namespace
+{
+class StringFileReader final : public Soldank::IFileReader
+{
+public:
+    explicit StringFileReader(std::string data)
+        : data_(std::move(data))
+    {
+    }
+
+    std::expected<std::string, Soldank::FileReaderError> Read(
+      const std::string& /*file_path*/,
+      std::ios_base::openmode /*mode*/) const override
+    {
+        return data_;
+    }
+
+private:
+    std::string data_;
+};
+
+std::string ToString(std::span<const std::byte> data)
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return { reinterpret_cast<const char*>(data.data()), data.size() };
+}
+
+std::vector<std::byte> BuildTestPack()
+{
+    Soldank::AssetPackBuilder builder;
+    builder.AddAsset("anims/stand.poa", "stand animation");
+    builder.AddAsset("objects/gostek.po", "gostek skeleton");
+    builder.AddAsset("maps/ctf_Ash.pms", std::string_view("\0\1\2\3", 4));
+    builder.AddAsset("weapons.ini", "[Desert Eagles]");
+    return builder.Build();
+}
+} // namespace
+
+TEST(AssetPackTest, BuiltPackContainsEveryAsset)
+{
+    auto asset_pack = Soldank::AssetPack::FromBuffer(BuildTestPack(),
+                                                     Soldank::AssetPackVerification::Full);
+    ASSERT_TRUE(asset_pack.has_value());
+    EXPECT_EQ(asset_pack->GetAssetsCount(), 4);
+
+    auto stand = asset_pack->Find("anims/stand.poa");
+    ASSERT_TRUE(stand.has_value());
+    EXPECT_EQ(ToString(*stand), "stand animation");
+
+    auto map = asset_pack->Find("maps/ctf_Ash.pms");
+    ASSERT_TRUE(map.has_value());
+    EXPECT_EQ(ToString(*map), std::string("\0\1\2\3", 4));
+
+    EXPECT_TRUE(asset_pack->Contains("weapons.ini"));
+    EXPECT_FALSE(asset_pack->Contains("weapons_realistic.ini"));
+    EXPECT_EQ(asset_pack->GetAssetPaths().size(), 4);
+}
+
+TEST(AssetPackTest, AssetPathsAreNormalized)
+{
+    auto asset_pack = Soldank::AssetPack::FromBuffer(BuildTestPack());
+    ASSERT_TRUE(asset_pack.has_value());
+
+    EXPECT_TRUE(asset_pack->Contains("./objects/gostek.po"));
+    EXPECT_TRUE(asset_pack->Contains("objects\\gostek.po"));
+}
+
+TEST(AssetPackTest, AssetDataIsAligned)
+{
+    auto asset_pack = Soldank::AssetPack::FromBuffer(BuildTestPack());
+    ASSERT_TRUE(asset_pack.has_value());
+
+    const auto* pack_begin = asset_pack->GetBytes().data();
+    for (const auto asset_path : asset_pack->GetAssetPaths()) {
+        auto asset_data = asset_pack->Find(asset_path);
+        ASSERT_TRUE(asset_data.has_value());
+        EXPECT_EQ((asset_data->data() - pack_begin) % Soldank::ASSET_PACK_DATA_ALIGNMENT, 0);
+    }
+}
+
+TEST(AssetPackTest, CorruptedAssetDataFailsOnlyFullVerification)
+{
+    auto pack_data = BuildTestPack();
+    std::size_t stand_offset = 0;
+    {
+        auto asset_pack = Soldank::AssetPack::FromBuffer(pack_data);
+        ASSERT_TRUE(asset_pack.has_value());
+        auto stand = asset_pack->Find("anims/stand.poa");
+        ASSERT_TRUE(stand.has_value());
+        stand_offset = static_cast<std::size_t>(stand->data() - asset_pack->GetBytes().data());
+    }
+    pack_data.at(stand_offset) ^= std::byte{ 0xFF };
+
+    EXPECT_TRUE(Soldank::AssetPack::FromBuffer(pack_data).has_value());
+
+    auto asset_pack =
+      Soldank::AssetPack::FromBuffer(pack_data, Soldank::AssetPackVerification::Full);
+    ASSERT_FALSE(asset_pack.has_value());
+    EXPECT_EQ(asset_pack.error(), Soldank::AssetPackError::ChecksumMismatch);
+}
+
+TEST(AssetPackTest, InvalidPacksAreRejected)
+{
+    auto bad_magic = BuildTestPack();
+    bad_magic.front() = std::byte{ 'X' };
+    EXPECT_FALSE(Soldank::AssetPack::FromBuffer(bad_magic).has_value());
+
+    auto truncated = BuildTestPack();
+    truncated.resize(truncated.size() - 1);
+    EXPECT_FALSE(Soldank::AssetPack::FromBuffer(truncated).has_value());
+
+    auto corrupted_index = BuildTestPack();
+    corrupted_index.at(sizeof(Soldank::AssetPackHeader)) ^= std::byte{ 0x01 };
+    auto asset_pack = Soldank::AssetPack::FromBuffer(corrupted_index);
+    ASSERT_FALSE(asset_pack.has_value());
+    EXPECT_EQ(asset_pack.error(), Soldank::AssetPackError::ChecksumMismatch);
+
+    EXPECT_FALSE(Soldank::AssetPack::FromBuffer({}).has_value());
+}
+
+TEST(AssetPackTest, PackIsMappedFromFile)
+{
+    const auto pack_path = std::filesystem::temp_directory_path() / "soldank_asset_pack_test.sdkpack";
+
+    Soldank::AssetPackBuilder builder;
+    builder.AddAsset("objects/flag.po", "flag skeleton");
+    ASSERT_EQ(builder.Write(pack_path.string()), Soldank::FileWriterError::NoError);
+
+    {
+        auto asset_pack = Soldank::AssetPack::Open(pack_path, Soldank::AssetPackVerification::Full);
+        ASSERT_TRUE(asset_pack.has_value());
+        auto flag = asset_pack->Find("objects/flag.po");
+        ASSERT_TRUE(flag.has_value());
+        EXPECT_EQ(ToString(*flag), "flag skeleton");
+    }
+
+    std::filesystem::remove(pack_path);
+
+    auto missing_pack = Soldank::AssetPack::Open(pack_path);
+    ASSERT_FALSE(missing_pack.has_value());
+    EXPECT_EQ(missing_pack.error(), Soldank::AssetPackError::FileNotFound);
+}
+
+TEST(AssetPackTest, PackFileReaderServesPackedAssetsAndFallsBack)
+{
+    auto asset_pack = Soldank::AssetPack::FromBuffer(BuildTestPack());
+    ASSERT_TRUE(asset_pack.has_value());
+
+    Soldank::PackFileReader file_reader(std::move(*asset_pack),
+                                        std::make_shared<StringFileReader>("from disk"));
+
+    auto stand = file_reader.Read("anims/stand.poa");
+    ASSERT_TRUE(stand.has_value());
+    EXPECT_EQ(*stand, "stand animation");
+
+    auto stand_view = file_reader.ReadView("anims/stand.poa");
+    ASSERT_TRUE(stand_view.has_value());
+    EXPECT_EQ(ToString(*stand_view), "stand animation");
+
+    auto missing = file_reader.Read("anims/missing.poa");
+    ASSERT_TRUE(missing.has_value());
+    EXPECT_EQ(*missing, "from disk");
+    EXPECT_FALSE(file_reader.ReadView("anims/missing.poa").has_value());
+}
+
+TEST(AssetPackTest, PackFileReaderWithoutFallbackReportsMissingFiles)
+{
+    auto asset_pack = Soldank::AssetPack::FromBuffer(BuildTestPack());
+    ASSERT_TRUE(asset_pack.has_value());
+
+    const Soldank::PackFileReader file_reader(std::move(*asset_pack));
+    auto missing = file_reader.Read("anims/missing.poa");
+    ASSERT_FALSE(missing.has_value());
+    EXPECT_EQ(missing.error(), Soldank::FileReaderError::FileNotFound);
+}
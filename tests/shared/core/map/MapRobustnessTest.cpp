@@ -4,11 +4,13 @@
 
 #include <array>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <filesystem>
 #include <ios>
 #include <memory>
+#include <random>
 #include <set>
 #include <span>
 #include <stdexcept>
@@ -233,6 +235,16 @@ Soldank::Map CreateCollisionMap(Soldank::PMSPolygonType polygon_type)
     map.GenerateSectors();
     return map;
 }
+
+Soldank::Map CreateFuzzSourceMap()
+{
+    Soldank::Map map;
+    map.CreateEmptyMap();
+    map.AddNewPolygon(CreatePolygon(-120.0F, -20.0F));
+    map.AddNewPolygon(CreatePolygon(100.0F, 0.0F, Soldank::PMSPolygonType::Bouncy));
+    map.AddNewSpawnPoint(CreateSpawnPoint(12, -18));
+    return map;
+}
 } // namespace
 
 TEST(MapRobustnessTest, SaveLoadRoundTripPreservesMetadataAndEveryCollection)
@@ -349,6 +361,70 @@ TEST(MapRobustnessTest, OversizedSceneryCollectionIsRejected)
                  std::runtime_error);
 }
 
+TEST(MapRobustnessTest, LoadingFromBytesMatchesLoadingThroughFileReader)
+{
+    const auto data = Serialize(CreateFuzzSourceMap())->GetData();
+
+    Soldank::Map from_reader;
+    from_reader.LoadMap("from-reader.pms", StringFileReader(data));
+    Soldank::Map from_bytes;
+    from_bytes.LoadMap("from-bytes.pms", std::as_bytes(std::span{ data }));
+
+    EXPECT_EQ(Serialize(from_bytes)->GetData(), Serialize(from_reader)->GetData());
+    EXPECT_EQ(from_bytes.GetPolygons().size(), 2);
+    EXPECT_EQ(from_bytes.GetSpawnPoints().size(), 1);
+}
+
+TEST(MapRobustnessTest, EveryTruncationIsRejected)
+{
+    const auto data = Serialize(CreateFuzzSourceMap())->GetData();
+    // The two trailing zero ints are not read by the loader
+    const std::size_t loaded_size = data.size() - 2 * sizeof(int);
+
+    for (std::size_t size = 0; size < loaded_size; ++size) {
+        Soldank::Map map;
+        EXPECT_THROW(map.LoadMap("truncated.pms", std::as_bytes(std::span{ data }.first(size))),
+                     std::runtime_error)
+          << "size " << size;
+    }
+}
+
+TEST(MapRobustnessTest, FuzzedMapDataEitherLoadsOrIsRejected)
+{
+    const auto source_data = Serialize(CreateFuzzSourceMap())->GetData();
+    std::mt19937 random_generator(0x50D4);
+    std::uniform_int_distribution<std::size_t> offset_distribution(0, source_data.size() - 1);
+    std::uniform_int_distribution<int> byte_distribution(0, 255);
+    std::uniform_int_distribution<int> mutations_distribution(1, 8);
+
+    int rejected_count = 0;
+    for (int iteration = 0; iteration < 2000; ++iteration) {
+        auto data = source_data;
+        const int mutations_count = mutations_distribution(random_generator);
+        for (int i = 0; i < mutations_count; ++i) {
+            data.at(offset_distribution(random_generator)) =
+              static_cast<char>(byte_distribution(random_generator));
+        }
+        if (iteration % 4 == 0) {
+            data.resize(offset_distribution(random_generator));
+        }
+
+        Soldank::Map map;
+        map.CreateEmptyMap();
+        map.AddNewSpawnPoint(CreateSpawnPoint(10, 20));
+        try {
+            map.LoadMap("fuzzed.pms", std::as_bytes(std::span{ data }));
+        } catch (const std::runtime_error& /*error*/) {
+            ++rejected_count;
+            // A rejected map never leaves a partially loaded state behind
+            ASSERT_EQ(map.GetSpawnPoints().size(), 1) << "iteration " << iteration;
+            EXPECT_EQ(map.GetSpawnPoints().at(0).x, 10);
+        }
+    }
+
+    EXPECT_GT(rejected_count, 0);
+}
+
 TEST(MapRobustnessTest, AppendFailureThrowsBeforeFinalWrite)
 {
     Soldank::Map map;
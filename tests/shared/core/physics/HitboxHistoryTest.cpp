@@ -0,0 +1,220 @@
+#include "core/math/Glm.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+import Shared.Core.Entities.Bullet;
+import Shared.Core.Entities.Soldier;
+import Shared.Core.IWorld;
+import Shared.Core.Map.Map;
+import Shared.Core.Map.PMSEnums;
+import Shared.Core.Physics.HitboxHistory;
+import Shared.Core.Simulation.SimulationCommands;
+import Shared.Core.State.Control;
+import Shared.Core.State.StateManager;
+import Shared.Core.Types.BulletType;
+import Shared.Core.Types.TeamType;
+import Shared.Core.Types.WeaponType;
+import Shared.Core.World;
+
+import Testing.Framework.Shared.MapBuilder;
+
+using namespace Soldank;
+
+namespace
+{
+constexpr std::uint8_t SHOOTER_ID = 1;
+constexpr std::uint8_t TARGET_ID = 2;
+// Skeleton particle the test shots are aimed at
+constexpr unsigned int AIM_PARTICLE = 12;
+
+std::unique_ptr<Map> CreateFlatMap()
+{
+    return SoldankTesting::MapBuilder::Empty()
+      ->AddPolygon(
+        { -4000.0F, 0.0F }, { 4000.0F, 0.0F }, { 4000.0F, 60.0F }, PMSPolygonType::Normal)
+      ->AddPolygon(
+        { -4000.0F, 0.0F }, { 4000.0F, 60.0F }, { -4000.0F, 60.0F }, PMSPolygonType::Normal)
+      ->Build();
+}
+
+void TickWorld(IWorld& world, std::uint32_t tick)
+{
+    const std::vector<PlayerInputCommand> player_inputs;
+    const std::vector<SimulationCommand> commands;
+    static_cast<void>(
+      world.Tick({ .tick = tick, .player_inputs = player_inputs, .commands = commands }));
+    world.GetStateManager()->SetGameTick(tick + 1U);
+}
+
+// Settles the target on the ground, then teleports it away. Returns the tick of the teleport.
+std::uint32_t InitializeWorld(IWorld& world, const Map& map, glm::vec2& old_aim_position)
+{
+    world.GetStateManager()->OverrideMap(map);
+    world.CreateSoldier(TARGET_ID);
+    world.SpawnSoldier(TARGET_ID, glm::vec2{ 0.0F, -34.0F });
+
+    std::uint32_t tick = 0;
+    for (; tick < 120U; tick++) {
+        TickWorld(world, tick);
+    }
+
+    old_aim_position = world.GetSoldier(TARGET_ID).skeleton->GetPos(AIM_PARTICLE);
+    world.GetStateManager()->SetSoldierPosition(TARGET_ID, { -600.0F, -34.0F });
+    return tick;
+}
+
+int ShootAt(IWorld& world,
+            std::uint32_t tick,
+            glm::vec2 aim_position,
+            std::uint8_t lag_compensation_ticks)
+{
+    int hits_count = 0;
+    world.GetPhysicsEvents().soldier_hit_by_bullet.AddObserver(
+      [&](Soldier& /*soldier*/, float /*damage*/) { hits_count++; });
+
+    world.GetStateManager()->CreateProjectile({ .style = BulletType::Bullet,
+                                                .weapon = WeaponType::DesertEagles,
+                                                .position = aim_position - glm::vec2{ 60.0F, 0.0F },
+                                                .velocity = { 20.0F, 0.0F },
+                                                .timeout = 30,
+                                                .hit_multiply = 1.0F,
+                                                .team = TeamType::None,
+                                                .owner_id = SHOOTER_ID,
+                                                .push = 0.0F,
+                                                .lag_compensation_ticks = lag_compensation_ticks });
+    for (std::uint32_t end_tick = tick + 10U; tick < end_tick; tick++) {
+        TickWorld(world, tick);
+    }
+    return hits_count;
+}
+
+// Lag compensation ticks given to the first bullet the shooter fires with inputs simulated
+// late_ticks after their apply_server_tick, while the client was drawing its targets
+// view_delay_ticks before the apply_server_tick
+std::optional<std::uint8_t> FireLateShot(std::uint32_t late_ticks, std::int32_t view_delay_ticks)
+{
+    const auto map = CreateFlatMap();
+    World world;
+    world.SetLagCompensationEnabled(true);
+    world.GetStateManager()->OverrideMap(*map);
+    world.CreateSoldier(SHOOTER_ID);
+    world.SpawnSoldier(SHOOTER_ID, glm::vec2{ 0.0F, -34.0F });
+
+    std::optional<std::uint8_t> lag_compensation_ticks;
+    world.SetPreProjectileSpawnCallback([&](const BulletParams& bullet_params) {
+        if (!lag_compensation_ticks.has_value()) {
+            lag_compensation_ticks = bullet_params.lag_compensation_ticks;
+        }
+        return true;
+    });
+
+    Control control{};
+    control.fire = true;
+    control.mouse_dist = 100;
+    const std::vector<SimulationCommand> commands;
+    for (std::uint32_t tick = 100; tick < 160U && !lag_compensation_ticks.has_value(); tick++) {
+        const std::vector<PlayerInputCommand> player_inputs{
+            { .soldier_id = SHOOTER_ID,
+              .input_sequence_id = tick,
+              .client_tick = tick - late_ticks,
+              .apply_server_tick = tick - late_ticks,
+              .view_server_tick =
+                tick - late_ticks - static_cast<std::uint32_t>(view_delay_ticks),
+              .control = control,
+              .mouse_map_position = { 300.0F, -20.0F } },
+        };
+        static_cast<void>(
+          world.Tick({ .tick = tick, .player_inputs = player_inputs, .commands = commands }));
+        world.GetStateManager()->SetGameTick(tick + 1U);
+    }
+    return lag_compensation_ticks;
+}
+} // namespace
+
+TEST(HitboxHistoryTest, FindsRecordedTicksUntilTheyAreOverwritten)
+{
+    const auto map = CreateFlatMap();
+    World world;
+    world.GetStateManager()->OverrideMap(*map);
+    world.CreateSoldier(TARGET_ID);
+    world.SpawnSoldier(TARGET_ID, glm::vec2{ 0.0F, -34.0F });
+    const glm::vec2 first_position = world.GetSoldier(TARGET_ID).skeleton->GetPos(AIM_PARTICLE);
+
+    HitboxHistory hitbox_history;
+    hitbox_history.Record(5, *world.GetStateManager());
+    world.GetStateManager()->MoveSoldier(TARGET_ID, { 100.0F, 0.0F });
+    hitbox_history.Record(6, *world.GetStateManager());
+
+    auto first_snapshot = hitbox_history.Find(TARGET_ID, 5);
+    ASSERT_TRUE(first_snapshot.has_value());
+    EXPECT_EQ(first_snapshot->GetPos(AIM_PARTICLE), first_position);
+    auto second_snapshot = hitbox_history.Find(TARGET_ID, 6);
+    ASSERT_TRUE(second_snapshot.has_value());
+    EXPECT_EQ(second_snapshot->GetPos(AIM_PARTICLE),
+              world.GetSoldier(TARGET_ID).skeleton->GetPos(AIM_PARTICLE));
+
+    EXPECT_FALSE(hitbox_history.Find(TARGET_ID, 7).has_value());
+    EXPECT_FALSE(hitbox_history.Find(SHOOTER_ID, 5).has_value());
+
+    hitbox_history.Record(5 + HITBOX_HISTORY_LENGTH, *world.GetStateManager());
+    EXPECT_FALSE(hitbox_history.Find(TARGET_ID, 5).has_value());
+    EXPECT_TRUE(hitbox_history.Find(TARGET_ID, 5 + HITBOX_HISTORY_LENGTH).has_value());
+
+    hitbox_history.Clear();
+    EXPECT_FALSE(hitbox_history.Find(TARGET_ID, 6).has_value());
+}
+
+TEST(HitboxHistoryTest, LateShotHitsWhereTargetWas)
+{
+    const auto map = CreateFlatMap();
+    World world;
+    world.SetLagCompensationEnabled(true);
+    glm::vec2 old_aim_position;
+    const std::uint32_t tick = InitializeWorld(world, *map, old_aim_position);
+
+    EXPECT_EQ(ShootAt(world, tick, old_aim_position, 8), 1);
+}
+
+TEST(HitboxHistoryTest, ShotWithoutLagCompensationHitsCurrentPosition)
+{
+    const auto map = CreateFlatMap();
+    World world;
+    world.SetLagCompensationEnabled(true);
+    glm::vec2 old_aim_position;
+    const std::uint32_t tick = InitializeWorld(world, *map, old_aim_position);
+
+    EXPECT_EQ(ShootAt(world, tick, old_aim_position, 0), 0);
+}
+
+TEST(HitboxHistoryTest, RewindIsLimitedToRecordedHistory)
+{
+    const auto map = CreateFlatMap();
+    World world;
+    glm::vec2 old_aim_position;
+    const std::uint32_t tick = InitializeWorld(world, *map, old_aim_position);
+
+    // Nothing is recorded while lag compensation is disabled, so targets are tested where they
+    // are now
+    EXPECT_EQ(ShootAt(world, tick, old_aim_position, 8), 0);
+}
+
+TEST(HitboxHistoryTest, RewindsToTheTickTheClientWasDrawing)
+{
+    EXPECT_EQ(FireLateShot(0, 0), 0U);
+    EXPECT_EQ(FireLateShot(0, 8), 8U);
+    EXPECT_EQ(FireLateShot(2, 8), 10U);
+    // A view claimed after the apply_server_tick doesn't cancel out the lateness
+    EXPECT_EQ(FireLateShot(2, -5), 2U);
+}
+
+TEST(HitboxHistoryTest, ClaimedViewDelayIsLimited)
+{
+    EXPECT_EQ(FireLateShot(0, 1000), MAX_LAG_COMPENSATION_VIEW_DELAY_TICKS);
+    EXPECT_EQ(FireLateShot(4, 1000), MAX_LAG_COMPENSATION_VIEW_DELAY_TICKS + 4U);
+    EXPECT_EQ(FireLateShot(20, 20), MAX_LAG_COMPENSATION_TICKS);
+}
@@ -0,0 +1,500 @@
+#include "core/math/Glm.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <variant>
+#include <vector>
+
+import Shared.Core.Entities.Soldier;
+import Shared.Core.IWorld;
+import Shared.Core.Map.Map;
+import Shared.Core.Map.PMSEnums;
+import Shared.Core.Math.Random;
+import Shared.Core.Replay.ReplayFormat;
+import Shared.Core.Replay.ReplayPlayer;
+import Shared.Core.Replay.ReplayRecorder;
+import Shared.Core.Simulation.SimulationCommands;
+import Shared.Core.Simulation.WorldTick;
+import Shared.Core.State.Control;
+import Shared.Core.State.StateManager;
+import Shared.Core.Types.BulletType;
+import Shared.Core.Types.ItemType;
+import Shared.Core.Types.WeaponType;
+import Shared.Core.World;
+
+import Testing.Framework.Shared.MapBuilder;
+
+using namespace Soldank;
+
+namespace
+{
+constexpr std::uint8_t PLAYER_ID = 1;
+constexpr std::uint8_t TARGET_ID = 2;
+// Skeleton particle the shooter aims at
+constexpr unsigned int AIM_PARTICLE = 12;
+// Inputs of the shooter reach the server this many ticks after the tick they were meant for
+constexpr std::uint32_t SHOOTER_LATE_TICKS = 6;
+
+std::unique_ptr<Map> CreateFlatMap()
+{
+    return SoldankTesting::MapBuilder::Empty()
+      ->AddPolygon(
+        { -4000.0F, 0.0F }, { 4000.0F, 0.0F }, { 4000.0F, 60.0F }, PMSPolygonType::Normal)
+      ->AddPolygon(
+        { -4000.0F, 0.0F }, { 4000.0F, 60.0F }, { -4000.0F, 60.0F }, PMSPolygonType::Normal)
+      ->Build();
+}
+
+void TickWorld(IWorld& world,
+               std::uint32_t tick,
+               const std::vector<PlayerInputCommand>& player_inputs,
+               const std::vector<SimulationCommand>& commands)
+{
+    static_cast<void>(
+      world.Tick({ .tick = tick, .player_inputs = player_inputs, .commands = commands }));
+    world.GetStateManager()->SetGameTick(tick + 1U);
+}
+
+void InitializeWorld(IWorld& world, const Map& map)
+{
+    world.GetStateManager()->OverrideMap(map);
+    world.CreateSoldier(PLAYER_ID);
+    world.SpawnSoldier(PLAYER_ID, { 0.0F, -34.0F });
+    // Far enough never to be picked up, so every keyframe has an item lying on the ground
+    world.GetStateManager()->CreateItem({ -3000.0F, -20.0F }, 0, ItemType::Ak74);
+    for (std::uint32_t tick = 0; tick < 120U; tick++) {
+        TickWorld(world, tick, {}, {});
+    }
+    world.GetStateManager()->SetGameTick(0);
+}
+
+PlayerInputCommand CreatePlayerInput(std::uint32_t tick)
+{
+    // Every few ticks nothing is sent, so the recording has gaps between tick records
+    Control control{};
+    control.right = tick % 200U < 120U;
+    control.left = !control.right;
+    control.up = tick % 90U < 10U;
+    // Shoots right before most keyframes, so that they have projectiles in flight
+    control.fire = tick % 60U >= 45U;
+    // Throws the weapon away and walks over it again to pick it up
+    control.drop = tick % 150U == 100U;
+    control.mouse_aim_x = static_cast<int>(tick % 50U) - 25;
+    control.mouse_aim_y = -10;
+    control.mouse_dist = 100;
+    return { .soldier_id = PLAYER_ID,
+             .input_sequence_id = tick + 1U,
+             .client_tick = tick,
+             .apply_server_tick = tick + 2U,
+             .view_server_tick = tick - tick % 4U,
+             .control = control,
+             .mouse_map_position = { 100.0F + static_cast<float>(tick) * 0.5F, -50.0F } };
+}
+
+void InitializeShootingWorld(IWorld& world, const Map& map)
+{
+    world.GetStateManager()->OverrideMap(map);
+    world.CreateSoldier(PLAYER_ID);
+    world.SpawnSoldier(PLAYER_ID, { 0.0F, -34.0F });
+    world.CreateSoldier(TARGET_ID);
+    world.SpawnSoldier(TARGET_ID, { 150.0F, -34.0F });
+    for (std::uint32_t tick = 0; tick < 120U; tick++) {
+        TickWorld(world, tick, {}, {});
+    }
+    world.GetStateManager()->SetGameTick(0);
+}
+
+// The shooter aims at where the target is on its screen, which is where the target was when the
+// input was meant to be applied
+PlayerInputCommand CreateLateShooterInput(std::uint32_t tick, glm::vec2 seen_aim_position)
+{
+    Control control{};
+    control.fire = tick % 40U >= 30U;
+    control.mouse_dist = 100;
+    const std::uint32_t apply_server_tick =
+      tick >= SHOOTER_LATE_TICKS ? tick - SHOOTER_LATE_TICKS : 0U;
+    return { .soldier_id = PLAYER_ID,
+             .input_sequence_id = tick + 1U,
+             .client_tick = apply_server_tick,
+             .apply_server_tick = apply_server_tick,
+             .control = control,
+             .mouse_map_position = seen_aim_position };
+}
+
+// Runs back and forth and jumps while the shooter fires, so that the target is somewhere else
+// by the time the late inputs are simulated
+PlayerInputCommand CreateTargetInput(std::uint32_t tick)
+{
+    Control control{};
+    control.right = tick % 160U < 80U;
+    control.left = !control.right;
+    control.up = tick % 40U >= 25U && tick % 40U < 28U;
+    control.mouse_dist = 100;
+    return { .soldier_id = TARGET_ID,
+             .input_sequence_id = tick + 1U,
+             .client_tick = tick,
+             .apply_server_tick = tick,
+             .control = control,
+             .mouse_map_position = { 1000.0F, -50.0F } };
+}
+
+glm::vec2 GetSoldierPosition(const IWorld& world)
+{
+    return world.GetStateManager()->GetSoldier(PLAYER_ID).particle.position;
+}
+
+std::size_t GetItemsCount(const IWorld& world)
+{
+    std::size_t items_count = 0;
+    world.GetStateManager()->ForEachItem([&](const auto& /*item*/) { ++items_count; });
+    return items_count;
+}
+
+struct RecordedTickState
+{
+    glm::vec2 soldier_position;
+    std::size_t bullets_count;
+    std::size_t items_count;
+};
+
+RecordedTickState GetTickState(const IWorld& world)
+{
+    return { .soldier_position = GetSoldierPosition(world),
+             .bullets_count = world.GetStateManager()->GetBulletsCount(),
+             .items_count = GetItemsCount(world) };
+}
+
+void ExpectTickStatesEqual(const RecordedTickState& actual, const RecordedTickState& expected)
+{
+    EXPECT_EQ(actual.soldier_position.x, expected.soldier_position.x);
+    EXPECT_EQ(actual.soldier_position.y, expected.soldier_position.y);
+    EXPECT_EQ(actual.bullets_count, expected.bullets_count);
+    EXPECT_EQ(actual.items_count, expected.items_count);
+}
+
+void ExpectPlayerInputsEqual(const PlayerInputCommand& actual, const PlayerInputCommand& expected)
+{
+    EXPECT_EQ(actual.soldier_id, expected.soldier_id);
+    EXPECT_EQ(actual.input_sequence_id, expected.input_sequence_id);
+    EXPECT_EQ(actual.client_tick, expected.client_tick);
+    EXPECT_EQ(actual.apply_server_tick, expected.apply_server_tick);
+    EXPECT_EQ(actual.view_server_tick, expected.view_server_tick);
+    EXPECT_EQ(actual.control.left, expected.control.left);
+    EXPECT_EQ(actual.control.right, expected.control.right);
+    EXPECT_EQ(actual.control.up, expected.control.up);
+    EXPECT_EQ(actual.control.fire, expected.control.fire);
+    EXPECT_EQ(actual.control.mouse_aim_x, expected.control.mouse_aim_x);
+    EXPECT_EQ(actual.control.mouse_aim_y, expected.control.mouse_aim_y);
+    EXPECT_EQ(actual.control.mouse_dist, expected.control.mouse_dist);
+    EXPECT_EQ(actual.mouse_map_position.x, expected.mouse_map_position.x);
+    EXPECT_EQ(actual.mouse_map_position.y, expected.mouse_map_position.y);
+}
+} // namespace
+
+TEST(ReplayTest, TickRecordsRoundTrip)
+{
+    ReplayByteWriter writer;
+    ReplayDeltaContext write_context;
+    ReplayFormat::WriteHeader(writer, { .keyframe_interval = 60, .map_path = "ctf_Ash.pms" });
+    const SimulationRandomState random_state{ .state = 0xFEDCBA9876543210ULL, .increment = 7 };
+    ReplayFormat::WriteKeyframe(
+      writer,
+      { .tick = 10,
+        .random_state = random_state,
+        .soldiers = {},
+        .bullets = { { .slot = 17,
+                       .style = BulletType::GaugeBullet,
+                       .weapon = WeaponType::Spas12,
+                       .position = { 120.5F, -40.25F },
+                       .velocity = { 8.0F, -0.5F },
+                       .timeout = 35,
+                       .lag_compensation_ticks = 4 } },
+        .bullet_emitter = { { .style = BulletType::Bullet,
+                              .weapon = WeaponType::Ak74,
+                              .position = { -3.0F, 7.5F },
+                              .velocity = { 0.0F, 12.0F },
+                              .timeout = 60,
+                              .hit_multiply = 1.5F,
+                              .team = {},
+                              .owner_id = 2,
+                              .push = 0.25F } },
+        .items = { { .id = 3,
+                     .style = ItemType::AlphaFlag,
+                     .holding_soldier_id = 2,
+                     .time_out = 1500,
+                     .particles = { { .position = { 1.0F, 2.0F }, .old_position = { 1.5F, 2.5F } },
+                                    { .force = { 0.0F, 0.25F } } } } } },
+      write_context);
+
+    std::vector<ReplayTickRecord> tick_records;
+    tick_records.push_back({ .tick = 10,
+                             .player_inputs = { CreatePlayerInput(10) },
+                             .commands = { SpawnSoldierCommand{ .soldier_id = 3 },
+                                           SpawnSoldierCommand{ .soldier_id = 4,
+                                                                .spawn_position =
+                                                                  glm::vec2{ 12.5F, -3.0F } } } });
+    tick_records.push_back({ .tick = 14,
+                             .player_inputs = { CreatePlayerInput(14) },
+                             .commands = { KillSoldierCommand{ .soldier_id = 3 },
+                                           RemoveSoldierCommand{ .soldier_id = 4 },
+                                           SetWeaponChoiceCommand{
+                                             .soldier_id = 5,
+                                             .primary_weapon_type = WeaponType::Barrett,
+                                             .secondary_weapon_type = WeaponType::USSOCOM } } });
+    for (const auto& tick_record : tick_records) {
+        ReplayFormat::WriteTick(writer, tick_record, write_context);
+    }
+
+    const auto replay_data = writer.TakeData();
+    ReplayByteReader reader{ replay_data };
+    ReplayDeltaContext read_context;
+    auto header = ReplayFormat::ReadHeader(reader);
+    ASSERT_TRUE(header.has_value());
+    EXPECT_EQ(header->keyframe_interval, 60U);
+    EXPECT_EQ(header->map_path, "ctf_Ash.pms");
+
+    ASSERT_EQ(static_cast<ReplayRecordType>(reader.ReadByte()), ReplayRecordType::Keyframe);
+    const auto keyframe = ReplayFormat::ReadKeyframe(reader, read_context);
+    EXPECT_EQ(keyframe.tick, 10U);
+    EXPECT_EQ(keyframe.random_state.state, random_state.state);
+    EXPECT_EQ(keyframe.random_state.increment, random_state.increment);
+    ASSERT_EQ(keyframe.bullets.size(), 1U);
+    EXPECT_EQ(keyframe.bullets.front().slot, 17U);
+    EXPECT_EQ(keyframe.bullets.front().style, BulletType::GaugeBullet);
+    EXPECT_EQ(keyframe.bullets.front().position, glm::vec2(120.5F, -40.25F));
+    EXPECT_EQ(keyframe.bullets.front().timeout, 35);
+    EXPECT_EQ(keyframe.bullets.front().lag_compensation_ticks, 4U);
+    ASSERT_EQ(keyframe.bullet_emitter.size(), 1U);
+    EXPECT_EQ(keyframe.bullet_emitter.front().weapon, WeaponType::Ak74);
+    EXPECT_EQ(keyframe.bullet_emitter.front().velocity, glm::vec2(0.0F, 12.0F));
+    EXPECT_EQ(keyframe.bullet_emitter.front().owner_id, 2U);
+    EXPECT_EQ(keyframe.bullet_emitter.front().push, 0.25F);
+    ASSERT_EQ(keyframe.items.size(), 1U);
+    EXPECT_EQ(keyframe.items.front().style, ItemType::AlphaFlag);
+    EXPECT_EQ(keyframe.items.front().holding_soldier_id, 2U);
+    EXPECT_EQ(keyframe.items.front().time_out, 1500);
+    ASSERT_EQ(keyframe.items.front().particles.size(), 2U);
+    EXPECT_EQ(keyframe.items.front().particles.front().old_position, glm::vec2(1.5F, 2.5F));
+    EXPECT_EQ(keyframe.items.front().particles.back().force, glm::vec2(0.0F, 0.25F));
+
+    for (const auto& expected_record : tick_records) {
+        ASSERT_EQ(static_cast<ReplayRecordType>(reader.ReadByte()), ReplayRecordType::Tick);
+        const auto tick_record = ReplayFormat::ReadTick(reader, read_context);
+        EXPECT_EQ(tick_record.tick, expected_record.tick);
+        ASSERT_EQ(tick_record.player_inputs.size(), 1U);
+        ExpectPlayerInputsEqual(tick_record.player_inputs.front(),
+                                expected_record.player_inputs.front());
+        ASSERT_EQ(tick_record.commands.size(), expected_record.commands.size());
+        for (std::size_t i = 0; i < tick_record.commands.size(); ++i) {
+            EXPECT_EQ(tick_record.commands.at(i).index(), expected_record.commands.at(i).index());
+        }
+
+        if (tick_record.tick == 10U) {
+            const auto& spawn_command = std::get<SpawnSoldierCommand>(tick_record.commands.at(1));
+            EXPECT_EQ(spawn_command.soldier_id, 4);
+            ASSERT_TRUE(spawn_command.spawn_position.has_value());
+            EXPECT_EQ(spawn_command.spawn_position->x, 12.5F);
+            EXPECT_EQ(spawn_command.spawn_position->y, -3.0F);
+            EXPECT_FALSE(
+              std::get<SpawnSoldierCommand>(tick_record.commands.at(0)).spawn_position.has_value());
+        } else {
+            const auto& weapon_choice_command =
+              std::get<SetWeaponChoiceCommand>(tick_record.commands.at(2));
+            EXPECT_EQ(weapon_choice_command.soldier_id, 5);
+            EXPECT_EQ(weapon_choice_command.primary_weapon_type, WeaponType::Barrett);
+            EXPECT_EQ(weapon_choice_command.secondary_weapon_type, WeaponType::USSOCOM);
+        }
+    }
+    EXPECT_TRUE(reader.IsAtEnd());
+}
+
+TEST(ReplayTest, InvalidHeaderIsRejected)
+{
+    std::vector<std::byte> replay_data{ std::byte{ 'N' }, std::byte{ 'O' }, std::byte{ 'P' },
+                                        std::byte{ 'E' }, std::byte{ 1 } };
+    auto player = ReplayPlayer::FromData(replay_data);
+    ASSERT_FALSE(player.has_value());
+    EXPECT_EQ(player.error(), ReplayError::InvalidHeader);
+
+    EXPECT_EQ(ReplayPlayer::FromData({}).error(), ReplayError::InvalidHeader);
+}
+
+TEST(ReplayTest, InputsAreSmallerThanFixedSizeEncoding)
+{
+    const auto map = CreateFlatMap();
+    World world;
+    InitializeWorld(world, *map);
+
+    ReplayRecorder recorder({ .keyframe_interval = 6000, .map_path = "test.pms" });
+    for (std::uint32_t tick = 0; tick < 600U; tick++) {
+        const std::vector<PlayerInputCommand> player_inputs{ CreatePlayerInput(tick) };
+        recorder.RecordTick({ .tick = tick, .player_inputs = player_inputs, .commands = {} },
+                            *world.GetStateManager());
+    }
+
+    EXPECT_EQ(recorder.GetKeyframesCount(), 1U);
+    EXPECT_LT(recorder.GetRecordedBytesCount(), 600U * sizeof(PlayerInputCommand) / 2U);
+}
+
+TEST(ReplayTest, SeekingMatchesRecordedSimulation)
+{
+    constexpr std::uint32_t TICKS_COUNT = 500;
+    constexpr std::uint32_t KEYFRAME_INTERVAL = 60;
+
+    const auto map = CreateFlatMap();
+    World recorded_world;
+    InitializeWorld(recorded_world, *map);
+
+    ReplayRecorder recorder({ .keyframe_interval = KEYFRAME_INTERVAL, .map_path = "test.pms" });
+    // State at the end of every tick, which is the state the next tick starts from
+    std::vector<RecordedTickState> recorded_states;
+    for (std::uint32_t tick = 0; tick < TICKS_COUNT; tick++) {
+        std::vector<PlayerInputCommand> player_inputs;
+        if (tick % 7U != 0U) {
+            player_inputs.push_back(CreatePlayerInput(tick));
+        }
+        const WorldTickInput input{ .tick = tick, .player_inputs = player_inputs, .commands = {} };
+        recorder.RecordTick(input, *recorded_world.GetStateManager());
+        TickWorld(recorded_world, tick, player_inputs, {});
+        recorded_states.push_back(GetTickState(recorded_world));
+    }
+    EXPECT_EQ(recorder.GetKeyframesCount(),
+              (TICKS_COUNT + KEYFRAME_INTERVAL - 1U) / KEYFRAME_INTERVAL);
+
+    // The recording has to cover keyframes with projectiles in flight and weapons being thrown
+    // away and picked up again
+    bool has_keyframe_with_bullets = false;
+    for (std::uint32_t tick = KEYFRAME_INTERVAL; tick < TICKS_COUNT; tick += KEYFRAME_INTERVAL) {
+        has_keyframe_with_bullets |= recorded_states.at(tick - 1U).bullets_count > 0U;
+    }
+    EXPECT_TRUE(has_keyframe_with_bullets);
+    bool has_thrown_weapon = false;
+    bool has_picked_up_weapon = false;
+    for (std::size_t i = 1; i < recorded_states.size(); ++i) {
+        has_thrown_weapon |=
+          recorded_states.at(i).items_count > recorded_states.at(i - 1U).items_count;
+        has_picked_up_weapon |=
+          recorded_states.at(i).items_count < recorded_states.at(i - 1U).items_count;
+    }
+    EXPECT_TRUE(has_thrown_weapon);
+    EXPECT_TRUE(has_picked_up_weapon);
+
+    auto player = ReplayPlayer::FromData(recorder.TakeRecordedData());
+    ASSERT_TRUE(player.has_value());
+    EXPECT_FALSE(player->IsTruncated());
+    EXPECT_EQ(player->GetHeader().map_path, "test.pms");
+    EXPECT_EQ(player->GetFirstTick(), 0U);
+    EXPECT_EQ(player->GetLastTick(), TICKS_COUNT - 1U);
+
+    World replayed_world;
+    InitializeWorld(replayed_world, *map);
+
+    // Playing from the first keyframe starts from the same state the recording started from
+    ASSERT_EQ(player->SeekTo(replayed_world, 50), ReplayError::NoError);
+    EXPECT_EQ(replayed_world.GetStateManager()->GetGameTick(), 50U);
+    ExpectTickStatesEqual(GetTickState(replayed_world), recorded_states.at(49));
+
+    // Seeking backwards, into the middle of keyframe intervals and right after keyframes
+    for (std::uint32_t target_tick : { 130U, 61U, 241U, 361U, 421U, 300U }) {
+        SCOPED_TRACE(target_tick);
+        ASSERT_EQ(player->SeekTo(replayed_world, target_tick), ReplayError::NoError);
+        ExpectTickStatesEqual(GetTickState(replayed_world), recorded_states.at(target_tick - 1U));
+    }
+
+    ASSERT_EQ(player->PlayTo(replayed_world, TICKS_COUNT), ReplayError::NoError);
+    EXPECT_EQ(replayed_world.GetStateManager()->GetGameTick(), TICKS_COUNT);
+    ExpectTickStatesEqual(GetTickState(replayed_world), recorded_states.back());
+
+    EXPECT_EQ(player->SeekTo(replayed_world, TICKS_COUNT + 1U), ReplayError::TickOutOfRange);
+    EXPECT_EQ(player->PlayTo(replayed_world, 10), ReplayError::TickOutOfRange);
+}
+
+TEST(ReplayTest, TruncatedRecordingPlaysUpToLastCompleteRecord)
+{
+    const auto map = CreateFlatMap();
+    World world;
+    InitializeWorld(world, *map);
+
+    ReplayRecorder recorder({ .keyframe_interval = 60, .map_path = "test.pms" });
+    for (std::uint32_t tick = 0; tick < 100U; tick++) {
+        const std::vector<PlayerInputCommand> player_inputs{ CreatePlayerInput(tick) };
+        recorder.RecordTick({ .tick = tick, .player_inputs = player_inputs, .commands = {} },
+                            *world.GetStateManager());
+    }
+
+    auto replay_data = recorder.TakeRecordedData();
+    replay_data.resize(replay_data.size() - 3);
+    auto player = ReplayPlayer::FromData(replay_data);
+    ASSERT_TRUE(player.has_value());
+    EXPECT_TRUE(player->IsTruncated());
+    EXPECT_EQ(player->GetKeyframes().size(), 2U);
+    EXPECT_EQ(player->GetLastTick(), 98U);
+    EXPECT_EQ(player->SeekTo(world, 99), ReplayError::NoError);
+}
+
+TEST(ReplayTest, LagCompensatedHitsMatchRecordedSimulation)
+{
+    constexpr std::uint32_t TICKS_COUNT = 300;
+    constexpr std::uint32_t KEYFRAME_INTERVAL = 120;
+
+    const auto map = CreateFlatMap();
+    World recorded_world;
+    InitializeShootingWorld(recorded_world, *map);
+    recorded_world.SetLagCompensationEnabled(true);
+
+    ReplayRecorder recorder({ .keyframe_interval = KEYFRAME_INTERVAL,
+                              .map_path = "test.pms",
+                              .lag_compensation = true });
+    std::vector<glm::vec2> aim_positions;
+    // Target state at the end of every tick
+    std::vector<float> recorded_target_healths;
+    std::vector<glm::vec2> recorded_target_positions;
+    for (std::uint32_t tick = 0; tick < TICKS_COUNT; tick++) {
+        aim_positions.push_back(
+          recorded_world.GetSoldier(TARGET_ID).skeleton->GetPos(AIM_PARTICLE));
+        const std::uint32_t seen_tick = tick >= SHOOTER_LATE_TICKS ? tick - SHOOTER_LATE_TICKS : 0U;
+        const std::vector<PlayerInputCommand> player_inputs{
+            CreateLateShooterInput(tick, aim_positions.at(seen_tick)),
+            CreateTargetInput(tick),
+        };
+        const WorldTickInput input{ .tick = tick, .player_inputs = player_inputs, .commands = {} };
+        recorder.RecordTick(input, *recorded_world.GetStateManager());
+        TickWorld(recorded_world, tick, player_inputs, {});
+        recorded_target_healths.push_back(recorded_world.GetSoldier(TARGET_ID).health);
+        recorded_target_positions.push_back(
+          recorded_world.GetSoldier(TARGET_ID).particle.position);
+    }
+    EXPECT_LT(*std::ranges::min_element(recorded_target_healths), 150.0F);
+
+    auto player = ReplayPlayer::FromData(recorder.TakeRecordedData());
+    ASSERT_TRUE(player.has_value());
+    EXPECT_TRUE(player->GetHeader().lag_compensation);
+
+    // Lag compensation is left disabled, the replay has to enable it on its own
+    World replayed_world;
+    InitializeShootingWorld(replayed_world, *map);
+
+    // Seeking into the second keyframe interval restores its keyframe with bullets from before
+    // it still in flight, they need the hitboxes of the ticks before the keyframe
+    for (std::uint32_t target_tick : { 200U, 125U, 90U }) {
+        SCOPED_TRACE(target_tick);
+        ASSERT_EQ(player->SeekTo(replayed_world, target_tick), ReplayError::NoError);
+        EXPECT_EQ(replayed_world.GetSoldier(TARGET_ID).health,
+                  recorded_target_healths.at(target_tick - 1U));
+        EXPECT_EQ(replayed_world.GetSoldier(TARGET_ID).particle.position,
+                  recorded_target_positions.at(target_tick - 1U));
+    }
+
+    for (std::uint32_t tick = 91; tick <= TICKS_COUNT; tick++) {
+        SCOPED_TRACE(tick);
+        ASSERT_EQ(player->PlayTo(replayed_world, tick), ReplayError::NoError);
+        EXPECT_EQ(replayed_world.GetSoldier(TARGET_ID).health,
+                  recorded_target_healths.at(tick - 1U));
+        EXPECT_EQ(replayed_world.GetSoldier(TARGET_ID).particle.position,
+                  recorded_target_positions.at(tick - 1U));
+    }
+}
@@ -0,0 +1,195 @@
+#include "core/math/Glm.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+import Shared.Core.IWorld;
+import Shared.Core.Map.Map;
+import Shared.Core.Map.PMSEnums;
+import Shared.Core.Map.PMSStructs;
+import Shared.Core.Math.Random;
+import Shared.Core.Simulation.SimulationCommands;
+import Shared.Core.State.Control;
+import Shared.Core.State.StateManager;
+import Shared.Core.World;
+
+import Testing.Framework.Shared.MapBuilder;
+
+using namespace Soldank;
+
+namespace
+{
+constexpr std::uint8_t FIRST_SOLDIER_ID = 1;
+constexpr std::uint8_t SECOND_SOLDIER_ID = 2;
+
+std::unique_ptr<Map> CreateMapWithSpawnPoints()
+{
+    auto map = SoldankTesting::MapBuilder::Empty()
+                 ->AddPolygon({ -4000.0F, 0.0F },
+                              { 4000.0F, 0.0F },
+                              { 4000.0F, 60.0F },
+                              PMSPolygonType::Normal)
+                 ->AddPolygon({ -4000.0F, 0.0F },
+                              { 4000.0F, 60.0F },
+                              { -4000.0F, 60.0F },
+                              PMSPolygonType::Normal)
+                 ->Build();
+    for (int x = -600; x <= 600; x += 200) {
+        map->AddNewSpawnPoint(
+          { .active = 1, .x = x, .y = -34, .type = PMSSpawnPointType::General });
+    }
+    return map;
+}
+
+void InitializeWorld(IWorld& world, const Map& map, std::uint64_t seed)
+{
+    world.GetStateManager()->OverrideMap(map);
+    world.GetStateManager()->SeedRandom(seed);
+    world.CreateSoldier(FIRST_SOLDIER_ID);
+    world.CreateSoldier(SECOND_SOLDIER_ID);
+    world.GetStateManager()->SetGameTick(0);
+}
+
+std::vector<PlayerInputCommand> CreatePlayerInputs(std::uint32_t tick)
+{
+    std::vector<PlayerInputCommand> player_inputs;
+    for (std::uint8_t soldier_id : { FIRST_SOLDIER_ID, SECOND_SOLDIER_ID }) {
+        Control control{};
+        control.right = (tick / 40U + soldier_id) % 2U == 0U;
+        control.left = !control.right;
+        control.up = (tick + soldier_id * 13U) % 70U < 8U;
+        player_inputs.push_back({ .soldier_id = soldier_id,
+                                  .input_sequence_id = tick,
+                                  .client_tick = tick,
+                                  .apply_server_tick = tick,
+                                  .control = control,
+                                  .mouse_map_position = { 200.0F, -100.0F } });
+    }
+    return player_inputs;
+}
+
+// Soldiers are respawned at random spawn points every few seconds
+std::vector<SimulationCommand> CreateCommands(std::uint32_t tick)
+{
+    std::vector<SimulationCommand> commands;
+    if (tick % 150U == 0U) {
+        commands.emplace_back(SpawnSoldierCommand{ .soldier_id = FIRST_SOLDIER_ID });
+        commands.emplace_back(SpawnSoldierCommand{ .soldier_id = SECOND_SOLDIER_ID });
+    }
+    return commands;
+}
+
+void TickWorld(IWorld& world, std::uint32_t tick)
+{
+    const auto player_inputs = CreatePlayerInputs(tick);
+    const auto commands = CreateCommands(tick);
+    static_cast<void>(
+      world.Tick({ .tick = tick, .player_inputs = player_inputs, .commands = commands }));
+    world.GetStateManager()->SetGameTick(tick + 1U);
+}
+} // namespace
+
+TEST(DeterminismTest, SameSeedGivesSameSequence)
+{
+    SimulationRandom first_random{ 1234 };
+    SimulationRandom second_random{ 1234 };
+    SimulationRandom other_random{ 4321 };
+
+    bool is_other_sequence_different = false;
+    for (int i = 0; i < 1000; ++i) {
+        const std::uint32_t value = first_random.NextUInt32();
+        EXPECT_EQ(value, second_random.NextUInt32());
+        is_other_sequence_different |= value != other_random.NextUInt32();
+    }
+    EXPECT_TRUE(is_other_sequence_different);
+}
+
+TEST(DeterminismTest, MatchesPcg32ReferenceOutput)
+{
+    // First outputs of the PCG32 reference implementation seeded with pcg32_srandom_r(42, 54)
+    SimulationRandom random;
+    random.Seed(42, 54);
+    EXPECT_EQ(random.NextUInt32(), 0xA15C02B7U);
+    EXPECT_EQ(random.NextUInt32(), 0x7B47F409U);
+    EXPECT_EQ(random.NextUInt32(), 0xBA1D3330U);
+}
+
+TEST(DeterminismTest, RestoredStateContinuesSequence)
+{
+    SimulationRandom random{ 99 };
+    for (int i = 0; i < 10; ++i) {
+        static_cast<void>(random.NextUInt32());
+    }
+
+    const auto random_state = random.GetState();
+    std::vector<std::uint32_t> expected_values;
+    for (int i = 0; i < 10; ++i) {
+        expected_values.push_back(random.NextUInt32());
+    }
+
+    SimulationRandom restored_random;
+    restored_random.SetState(random_state);
+    for (std::uint32_t expected_value : expected_values) {
+        EXPECT_EQ(restored_random.NextUInt32(), expected_value);
+    }
+}
+
+TEST(DeterminismTest, BoundedValuesStayInRange)
+{
+    SimulationRandom random{ 7 };
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_LT(random.NextUInt32(7), 7U);
+        const float value = random.NextFloat();
+        EXPECT_GE(value, 0.0F);
+        EXPECT_LT(value, 1.0F);
+    }
+    EXPECT_EQ(random.NextUInt32(0), 0U);
+    EXPECT_EQ(random.NextUInt32(1), 0U);
+}
+
+TEST(DeterminismTest, WorldsWithSameSeedRunInLockstep)
+{
+    constexpr std::uint32_t TICKS_COUNT = 900;
+    constexpr std::uint64_t SEED = 0x5EED;
+
+    const auto map = CreateMapWithSpawnPoints();
+    World first_world;
+    World second_world;
+    InitializeWorld(first_world, *map, SEED);
+    InitializeWorld(second_world, *map, SEED);
+
+    for (std::uint32_t tick = 0; tick < TICKS_COUNT; tick++) {
+        TickWorld(first_world, tick);
+        TickWorld(second_world, tick);
+
+        const auto& first_state = *first_world.GetStateManager();
+        const auto& second_state = *second_world.GetStateManager();
+        ASSERT_EQ(first_state.GetRandomState().state, second_state.GetRandomState().state);
+        for (std::uint8_t soldier_id : { FIRST_SOLDIER_ID, SECOND_SOLDIER_ID }) {
+            const auto& first_soldier = first_state.GetSoldier(soldier_id);
+            const auto& second_soldier = second_state.GetSoldier(soldier_id);
+            ASSERT_EQ(first_soldier.particle.position, second_soldier.particle.position)
+              << "Soldier " << static_cast<int>(soldier_id) << " diverged at tick " << tick;
+            ASSERT_EQ(first_soldier.particle.GetVelocity(), second_soldier.particle.GetVelocity());
+        }
+    }
+}
+
+TEST(DeterminismTest, DifferentSeedsPickDifferentSpawnPoints)
+{
+    const auto map = CreateMapWithSpawnPoints();
+    World first_world;
+    World second_world;
+    InitializeWorld(first_world, *map, 1);
+    InitializeWorld(second_world, *map, 2);
+
+    bool is_spawn_position_different = false;
+    for (int i = 0; i < 20; ++i) {
+        is_spawn_position_different |= first_world.SpawnSoldier(FIRST_SOLDIER_ID) !=
+                                       second_world.SpawnSoldier(FIRST_SOLDIER_ID);
+    }
+    EXPECT_TRUE(is_spawn_position_different);
+}
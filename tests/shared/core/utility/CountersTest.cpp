@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+import Shared.Core.Utility.Counters;
+
+using namespace Soldank;
+
+TEST(CountersTest, AddsCountersAndOverwritesGauges)
+{
+    CounterRegistry counter_registry;
+    counter_registry.Add(Counter::InputsReceived);
+    counter_registry.Add(Counter::InputsReceived, 4);
+    counter_registry.Set(Gauge::PendingPlayerInputs, 7);
+    counter_registry.Set(Gauge::PendingPlayerInputs, 3);
+    counter_registry.AddNetworkBytesSent(4, 100);
+    counter_registry.AddNetworkBytesReceived(3, 20);
+    counter_registry.AddNetworkBytesReceived(MAX_COUNTED_NETWORK_EVENTS, 20);
+
+    const auto snapshot = counter_registry.TakeSnapshot();
+    EXPECT_EQ(snapshot.Get(Counter::InputsReceived), 5);
+    EXPECT_EQ(snapshot.Get(Counter::InputsDropped), 0);
+    EXPECT_EQ(snapshot.Get(Gauge::PendingPlayerInputs), 3);
+    EXPECT_EQ(snapshot.network_bytes_sent.at(4), 100);
+    EXPECT_EQ(snapshot.network_bytes_received.at(3), 20);
+}
+
+TEST(CountersTest, SumsTheShardsOfAllThreads)
+{
+    constexpr std::size_t THREADS_COUNT = CounterRegistry::SHARDS_COUNT + 3;
+    constexpr std::uint64_t ADDS_PER_THREAD = 10000;
+    CounterRegistry counter_registry;
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < THREADS_COUNT; ++i) {
+        threads.emplace_back([&counter_registry]() {
+            for (std::uint64_t j = 0; j < ADDS_PER_THREAD; ++j) {
+                counter_registry.Add(Counter::TickOverruns);
+                counter_registry.AddNetworkBytesSent(1, 2);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto snapshot = counter_registry.TakeSnapshot();
+    EXPECT_EQ(snapshot.Get(Counter::TickOverruns), THREADS_COUNT * ADDS_PER_THREAD);
+    EXPECT_EQ(snapshot.network_bytes_sent.at(1), THREADS_COUNT * ADDS_PER_THREAD * 2);
+}
+
+TEST(CountersTest, NamesCoverAllCountersAndGauges)
+{
+    for (const auto& counter_name : COUNTER_NAMES) {
+        EXPECT_FALSE(counter_name.empty());
+    }
+    for (const auto& gauge_name : GAUGE_NAMES) {
+        EXPECT_FALSE(gauge_name.empty());
+    }
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
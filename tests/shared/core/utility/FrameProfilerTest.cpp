@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+import Shared.Core.Utility.FrameProfiler;
+
+using namespace Soldank;
+
+namespace
+{
+// Headless profiler with a clock that only moves when the test moves it
+struct FakeClockProfiler
+{
+    explicit FakeClockProfiler(std::size_t history_frames_count)
+        : frame_profiler(history_frames_count, [this]() { return now_ns; })
+    {
+    }
+
+    std::int64_t now_ns = 0;
+    FrameProfiler frame_profiler;
+};
+
+void RecordFrame(FakeClockProfiler& profiler, std::int64_t duration_ns)
+{
+    profiler.frame_profiler.BeginFrame();
+    profiler.now_ns += duration_ns;
+    profiler.frame_profiler.EndFrame();
+}
+} // namespace
+
+TEST(FrameProfilerTest, RecordsNestedZones)
+{
+    FakeClockProfiler profiler(4);
+    auto& frame_profiler = profiler.frame_profiler;
+
+    profiler.now_ns = 1000;
+    frame_profiler.BeginFrame();
+    {
+        ScopedProfilerZone tick_zone(frame_profiler, "Simulation tick");
+        profiler.now_ns += 500;
+        {
+            ScopedProfilerZone network_zone(frame_profiler, "Network");
+            profiler.now_ns += 200;
+        }
+        profiler.now_ns += 300;
+    }
+    {
+        ScopedProfilerZone render_zone(frame_profiler, "Render");
+        profiler.now_ns += 2000;
+    }
+    frame_profiler.EndFrame();
+
+    ASSERT_EQ(frame_profiler.GetFramesCount(), 1U);
+    const ProfiledFrame& frame = frame_profiler.GetFrame(0);
+    EXPECT_EQ(frame.frame_number, 0U);
+    EXPECT_EQ(frame.start_ns, 1000);
+    EXPECT_EQ(frame.duration_ns, 3000);
+    ASSERT_EQ(frame.zones.size(), 3U);
+    EXPECT_EQ(frame.zones.at(0).name, "Simulation tick");
+    EXPECT_EQ(frame.zones.at(0).depth, 0U);
+    EXPECT_EQ(frame.zones.at(0).start_ns, 1000);
+    EXPECT_EQ(frame.zones.at(0).duration_ns, 1000);
+    EXPECT_EQ(frame.zones.at(1).name, "Network");
+    EXPECT_EQ(frame.zones.at(1).depth, 1U);
+    EXPECT_EQ(frame.zones.at(1).start_ns, 1500);
+    EXPECT_EQ(frame.zones.at(1).duration_ns, 200);
+    EXPECT_EQ(frame.zones.at(2).depth, 0U);
+    EXPECT_EQ(frame.GetZonesDuration("Render"), 2000);
+    EXPECT_EQ(frame.GetZonesDuration("Render", ProfilerTrack::Gpu), 0);
+}
+
+TEST(FrameProfilerTest, ZonesAreOnlyRecordedDuringFrames)
+{
+    FakeClockProfiler profiler(4);
+    auto& frame_profiler = profiler.frame_profiler;
+
+    EXPECT_FALSE(frame_profiler.BeginZone("Input"));
+    frame_profiler.EndZone();
+
+    frame_profiler.BeginFrame();
+    EXPECT_TRUE(frame_profiler.BeginZone("Render"));
+    profiler.now_ns += 100;
+    frame_profiler.EndFrame();
+
+    // Open zones end with their frame
+    ASSERT_EQ(frame_profiler.GetFramesCount(), 1U);
+    ASSERT_EQ(frame_profiler.GetFrame(0).zones.size(), 1U);
+    EXPECT_EQ(frame_profiler.GetFrame(0).zones.at(0).duration_ns, 100);
+
+    frame_profiler.SetEnabled(false);
+    RecordFrame(profiler, 100);
+    EXPECT_EQ(frame_profiler.GetFramesCount(), 1U);
+    EXPECT_EQ(frame_profiler.GetCurrentFrameNumber(), 1U);
+}
+
+TEST(FrameProfilerTest, KeepsOnlyTheNewestFrames)
+{
+    FakeClockProfiler profiler(3);
+    auto& frame_profiler = profiler.frame_profiler;
+    for (int i = 1; i <= 5; ++i) {
+        RecordFrame(profiler, i * 100);
+    }
+
+    ASSERT_EQ(frame_profiler.GetFramesCount(), 3U);
+    EXPECT_EQ(frame_profiler.GetFrame(0).frame_number, 2U);
+    EXPECT_EQ(frame_profiler.GetFrame(0).duration_ns, 300);
+    EXPECT_EQ(frame_profiler.GetFrame(2).frame_number, 4U);
+    EXPECT_EQ(frame_profiler.FindFrame(1), nullptr);
+    ASSERT_NE(frame_profiler.FindFrame(3), nullptr);
+    EXPECT_EQ(frame_profiler.FindFrame(3)->duration_ns, 400);
+    EXPECT_EQ(frame_profiler.FindFrame(5), nullptr);
+}
+
+TEST(FrameProfilerTest, GpuZonesAreAddedToTheirFrameOneAfterAnother)
+{
+    FakeClockProfiler profiler(2);
+    auto& frame_profiler = profiler.frame_profiler;
+    RecordFrame(profiler, 1000);
+    RecordFrame(profiler, 1000);
+
+    frame_profiler.AddGpuZone(1, "Polygons", 1100, 500);
+    frame_profiler.AddGpuZone(1, "ImGui", 1200, 300);
+    // Frame 0 is still kept, frame 5 hasn't happened
+    frame_profiler.AddGpuZone(0, "Polygons", 0, 100);
+    frame_profiler.AddGpuZone(5, "Polygons", 0, 100);
+    RecordFrame(profiler, 1000);
+    frame_profiler.AddGpuZone(0, "Polygons", 0, 100);
+
+    const ProfiledFrame* frame = frame_profiler.FindFrame(1);
+    ASSERT_NE(frame, nullptr);
+    ASSERT_EQ(frame->zones.size(), 2U);
+    EXPECT_EQ(frame->zones.at(0).track, ProfilerTrack::Gpu);
+    EXPECT_EQ(frame->zones.at(0).start_ns, 1100);
+    EXPECT_EQ(frame->zones.at(1).start_ns, 1600);
+    EXPECT_EQ(frame->zones.at(1).duration_ns, 300);
+    EXPECT_EQ(frame->GetZonesDuration("ImGui", ProfilerTrack::Gpu), 300);
+    EXPECT_EQ(frame_profiler.FindFrame(0), nullptr);
+}
+
+TEST(FrameProfilerTest, ExportsChromeTraceCompleteEvents)
+{
+    FakeClockProfiler profiler(4);
+    auto& frame_profiler = profiler.frame_profiler;
+
+    profiler.now_ns = 1000;
+    frame_profiler.BeginFrame();
+    frame_profiler.BeginZone("Soldiers \"all\"");
+    profiler.now_ns += 2500;
+    frame_profiler.EndFrame();
+    frame_profiler.AddGpuZone(0, "Soldiers", 1500, 1234567);
+
+    std::string trace = frame_profiler.ExportChromeTrace();
+    EXPECT_EQ(trace.find(R"({"displayTimeUnit":"ms","traceEvents":[)"), 0U);
+    EXPECT_NE(trace.find(R"({"name":"Frame","cat":"frame","ph":"X","pid":1,"tid":1,"ts":1.000,)"
+                         R"("dur":2.500})"),
+              std::string::npos);
+    EXPECT_NE(trace.find(
+                R"({"name":"Soldiers \"all\"","cat":"cpu","ph":"X","pid":1,"tid":1,"ts":1.000,)"
+                R"("dur":2.500})"),
+              std::string::npos);
+    EXPECT_NE(
+      trace.find(
+        R"({"name":"Soldiers","cat":"gpu","ph":"X","pid":1,"tid":2,"ts":1.500,"dur":1234.567})"),
+      std::string::npos);
+    EXPECT_EQ(trace.substr(trace.size() - 2), "]}");
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+import Shared.Core.Utility.SpscQueue;
+
+using namespace Soldank;
+
+TEST(SpscQueueTest, ElementsArePoppedInPushOrder)
+{
+    SpscQueue<int, 4> queue;
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(queue.TryPush([i](int& slot) { slot = i; }));
+    }
+    EXPECT_EQ(queue.GetSize(), 3);
+
+    for (int i = 0; i < 3; ++i) {
+        int value = -1;
+        ASSERT_TRUE(queue.TryPop([&](const int& slot) { value = slot; }));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.TryPop([](const int& /*slot*/) { FAIL(); }));
+}
+
+TEST(SpscQueueTest, FullQueueRejectsPush)
+{
+    SpscQueue<int, 2> queue;
+    ASSERT_TRUE(queue.TryPush([](int& slot) { slot = 1; }));
+    ASSERT_TRUE(queue.TryPush([](int& slot) { slot = 2; }));
+    EXPECT_FALSE(queue.TryPush([](int& /*slot*/) { FAIL(); }));
+
+    ASSERT_TRUE(queue.TryPop([](const int& /*slot*/) {}));
+    EXPECT_TRUE(queue.TryPush([](int& slot) { slot = 3; }));
+}
+
+TEST(SpscQueueTest, SlotBuffersAreReused)
+{
+    SpscQueue<std::vector<std::byte>, 2> queue;
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_TRUE(queue.TryPush([](std::vector<std::byte>& slot) { slot.assign(64, {}); }));
+        ASSERT_TRUE(queue.TryPop([](const std::vector<std::byte>& /*slot*/) {}));
+    }
+
+    const std::byte* reused_data = nullptr;
+    ASSERT_TRUE(queue.TryPush([&](std::vector<std::byte>& slot) {
+        slot.assign(32, {});
+        reused_data = slot.data();
+    }));
+    // The slot kept the capacity of the earlier payloads, so no new buffer was allocated
+    ASSERT_TRUE(queue.TryPop([&](const std::vector<std::byte>& slot) {
+        EXPECT_GE(slot.capacity(), 64);
+        EXPECT_EQ(slot.data(), reused_data);
+    }));
+}
+
+TEST(SpscQueueTest, ProducerAndConsumerThreadsKeepOrder)
+{
+    constexpr std::uint32_t ELEMENTS_COUNT = 200000;
+    SpscQueue<std::uint32_t, 64> queue;
+
+    std::thread producer([&]() {
+        for (std::uint32_t i = 0; i < ELEMENTS_COUNT;) {
+            if (queue.TryPush([i](std::uint32_t& slot) { slot = i; })) {
+                ++i;
+            }
+        }
+    });
+
+    std::uint32_t expected_value = 0;
+    bool is_order_kept = true;
+    while (expected_value < ELEMENTS_COUNT) {
+        queue.TryPop([&](const std::uint32_t& slot) {
+            is_order_kept = is_order_kept && slot == expected_value;
+            ++expected_value;
+        });
+    }
+    producer.join();
+
+    EXPECT_TRUE(is_order_kept);
+    EXPECT_EQ(queue.GetSize(), 0);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+import Shared.Core.Utility.TripleBuffer;
+
+using namespace Soldank;
+
+TEST(TripleBufferTest, ConsumerGetsTheLatestPublishedValue)
+{
+    TripleBuffer<int> triple_buffer;
+    EXPECT_FALSE(triple_buffer.Update());
+
+    triple_buffer.GetWriteBuffer() = 1;
+    triple_buffer.Publish();
+    triple_buffer.GetWriteBuffer() = 2;
+    triple_buffer.Publish();
+
+    ASSERT_TRUE(triple_buffer.Update());
+    EXPECT_EQ(triple_buffer.GetReadBuffer(), 2);
+    EXPECT_FALSE(triple_buffer.Update());
+    EXPECT_EQ(triple_buffer.GetReadBuffer(), 2);
+
+    triple_buffer.GetWriteBuffer() = 3;
+    EXPECT_FALSE(triple_buffer.Update());
+    triple_buffer.Publish();
+    ASSERT_TRUE(triple_buffer.Update());
+    EXPECT_EQ(triple_buffer.GetReadBuffer(), 3);
+}
+
+TEST(TripleBufferTest, BuffersAreReused)
+{
+    TripleBuffer<std::vector<int>> triple_buffer;
+    for (int i = 0; i < 6; ++i) {
+        triple_buffer.GetWriteBuffer().assign(64, i);
+        triple_buffer.Publish();
+        ASSERT_TRUE(triple_buffer.Update());
+    }
+
+    auto& write_buffer = triple_buffer.GetWriteBuffer();
+    write_buffer.clear();
+    // The buffer kept the capacity of an earlier value, so no new storage is allocated
+    EXPECT_GE(write_buffer.capacity(), 64);
+}
+
+TEST(TripleBufferTest, ConsumerNeverSeesTornOrOlderValues)
+{
+    struct Value
+    {
+        std::uint32_t first;
+        std::uint32_t second;
+    };
+    constexpr std::uint32_t VALUES_COUNT = 200000;
+    TripleBuffer<Value> triple_buffer;
+    std::atomic<bool> is_producer_done = false;
+
+    std::thread producer([&]() {
+        for (std::uint32_t i = 1; i <= VALUES_COUNT; ++i) {
+            triple_buffer.GetWriteBuffer() = { .first = i, .second = i };
+            triple_buffer.Publish();
+        }
+        is_producer_done = true;
+    });
+
+    std::uint32_t last_value = 0;
+    bool is_consistent = true;
+    while (true) {
+        const bool was_producer_done = is_producer_done;
+        if (triple_buffer.Update()) {
+            const auto& value = triple_buffer.GetReadBuffer();
+            is_consistent =
+              is_consistent && value.first == value.second && value.first > last_value;
+            last_value = value.first;
+        } else if (was_producer_done) {
+            break;
+        }
+    }
+    producer.join();
+
+    EXPECT_TRUE(is_consistent);
+    EXPECT_EQ(last_value, VALUES_COUNT);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
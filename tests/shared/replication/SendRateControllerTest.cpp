@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <limits>
+
+import Networking.Transport.TransportTypes;
+import Replication.SendRateController;
+
+using namespace Soldank;
+
+namespace
+{
+ConnectionQuality MakeHealthyLink()
+{
+    return { .round_trip_time_milliseconds = 40,
+             .packet_loss_ratio = 0.0F,
+             .pending_unreliable_bytes = 0,
+             .pending_reliable_bytes = 0,
+             .send_rate_bytes_per_second = 60000 };
+}
+
+void UpdateForTicks(SendRateController& controller,
+                    const ConnectionQuality& connection_quality,
+                    unsigned int ticks_count)
+{
+    for (unsigned int i = 0; i < ticks_count; ++i) {
+        controller.Update(connection_quality);
+    }
+}
+} // namespace
+
+TEST(SendRateControllerTest, HealthyLinkGetsEveryTick)
+{
+    SendRateController controller;
+    UpdateForTicks(controller, MakeHealthyLink(), 600);
+
+    EXPECT_EQ(controller.GetSnapshotRate(), 60);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(controller.ShouldSendSnapshot());
+    }
+    EXPECT_EQ(controller.GetSnapshotByteBudget(), 1000);
+}
+
+TEST(SendRateControllerTest, CongestedLinkDropsTo20Hz)
+{
+    SendRateController controller;
+    controller.Update(MakeHealthyLink());
+
+    auto congested_link = MakeHealthyLink();
+    congested_link.pending_unreliable_bytes = 20000;
+    UpdateForTicks(controller, congested_link, 600);
+
+    EXPECT_EQ(controller.GetSnapshotIntervalTicks(),
+              SendRateController::MAX_SNAPSHOT_INTERVAL_TICKS);
+    EXPECT_EQ(controller.GetSnapshotRate(), 20);
+    EXPECT_FALSE(controller.ShouldSendSnapshot());
+    EXPECT_FALSE(controller.ShouldSendSnapshot());
+    EXPECT_TRUE(controller.ShouldSendSnapshot());
+    // The queued bytes have to be sent first, only the client's own state still fits
+    EXPECT_EQ(controller.GetSnapshotByteBudget(), SendRateController::MIN_SNAPSHOT_BYTE_BUDGET);
+}
+
+TEST(SendRateControllerTest, LossAndLatencyIncreaseLowerTheRate)
+{
+    SendRateController lossy_controller;
+    auto lossy_link = MakeHealthyLink();
+    lossy_link.packet_loss_ratio = 0.2F;
+    lossy_controller.Update(lossy_link);
+    EXPECT_EQ(lossy_controller.GetSnapshotIntervalTicks(), 2);
+
+    SendRateController delayed_controller;
+    delayed_controller.Update(MakeHealthyLink());
+    auto delayed_link = MakeHealthyLink();
+    delayed_link.round_trip_time_milliseconds = 300;
+    delayed_controller.Update(delayed_link);
+    EXPECT_EQ(delayed_controller.GetSnapshotIntervalTicks(), 2);
+}
+
+TEST(SendRateControllerTest, RateRecoversStepByStep)
+{
+    SendRateController controller;
+    auto congested_link = MakeHealthyLink();
+    congested_link.packet_loss_ratio = 0.5F;
+    UpdateForTicks(controller, congested_link, 120);
+    ASSERT_EQ(controller.GetSnapshotIntervalTicks(), 3);
+
+    UpdateForTicks(controller, MakeHealthyLink(), 120);
+    EXPECT_EQ(controller.GetSnapshotIntervalTicks(), 2);
+    UpdateForTicks(controller, MakeHealthyLink(), 120);
+    EXPECT_EQ(controller.GetSnapshotIntervalTicks(), 1);
+}
+
+TEST(SendRateControllerTest, UnknownBandwidthIsNotLimited)
+{
+    SendRateController controller;
+    EXPECT_EQ(controller.GetSnapshotByteBudget(), std::numeric_limits<std::size_t>::max());
+
+    auto link = MakeHealthyLink();
+    link.send_rate_bytes_per_second = 0;
+    controller.Update(link);
+    EXPECT_EQ(controller.GetSnapshotByteBudget(), std::numeric_limits<std::size_t>::max());
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
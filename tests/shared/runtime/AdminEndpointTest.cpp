@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <format>
+#include <string>
+
+import Networking.AdminEndpoint;
+import Networking.Transport.TransportTypes;
+
+import Shared.Core.Utility.Counters;
+import Shared.Networking.NetworkEvent;
+import Shared.Networking.NetworkMessage;
+
+import Extern.Httplib;
+
+using namespace Soldank;
+
+TEST(AdminEndpointTest, FormatsCountersAsPrometheusText)
+{
+    CounterRegistry counter_registry;
+    counter_registry.Add(Counter::InputsLateApplied, 3);
+    counter_registry.Set(Gauge::TickDurationMicroseconds, 1250);
+    counter_registry.AddNetworkBytesSent(4, 640);
+
+    const std::string text = FormatCountersAsText(counter_registry.TakeSnapshot());
+
+    EXPECT_NE(text.find("soldank_inputs_late_applied_total 3\n"), std::string::npos);
+    EXPECT_NE(text.find("soldank_inputs_dropped_total 0\n"), std::string::npos);
+    EXPECT_NE(text.find("soldank_tick_duration_microseconds 1250\n"), std::string::npos);
+    EXPECT_NE(text.find("soldank_network_bytes_sent_total{event=\"soldier_state\"} 640\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("soldank_network_bytes_received_total{event=\"hit_soldier\"} 0\n"),
+              std::string::npos);
+}
+
+TEST(AdminEndpointTest, ListensOnAnyFreeLoopbackPort)
+{
+    AdminEndpoint admin_endpoint;
+    const auto port = admin_endpoint.Start(0);
+    ASSERT_TRUE(port.has_value());
+    EXPECT_NE(*port, 0);
+    admin_endpoint.Stop();
+}
+
+TEST(AdminEndpointTest, ServesThePacketsSentByTransports)
+{
+    const NetworkMessage network_message{ NetworkEvent::PingCheck };
+    CountSentPacket(network_message.GetData());
+    CountSentPacket(network_message.GetData());
+
+    AdminEndpoint admin_endpoint;
+    const auto port = admin_endpoint.Start(0);
+    ASSERT_TRUE(port.has_value());
+    Httplib::Client client(std::format("http://127.0.0.1:{}", *port));
+    const auto response = client.Get("/counters");
+    admin_endpoint.Stop();
+
+    ASSERT_TRUE(response);
+    EXPECT_EQ(response->status, 200);
+    const std::string bytes_sent_line =
+      std::format("soldank_network_bytes_sent_total{{event=\"ping_check\"}} {}\n",
+                  network_message.GetData().size() * 2);
+    EXPECT_NE(response->body.find(bytes_sent_line), std::string::npos);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+import Networking.LobbyClient;
+import Runtime.ServerRuntimeServices;
+
+import Extern.Httplib;
+
+using namespace Soldank;
+using namespace std::chrono_literals;
+
+namespace
+{
+// Local lobby that answers registrations with a configurable status after a configurable delay
+class StandInLobby
+{
+public:
+    StandInLobby(int response_status, std::chrono::milliseconds response_delay)
+        : response_status_(response_status)
+        , response_delay_(response_delay)
+    {
+        server_.Post("/api/servers", [this](const Httplib::ServerRequest& request) {
+            {
+                std::lock_guard lock{ mutex_ };
+                received_bodies_.push_back(request.body);
+            }
+            std::this_thread::sleep_for(response_delay_);
+            return Httplib::ServerResponse{ .status = response_status_.load(),
+                                            .body = "{}",
+                                            .content_type = "application/json",
+                                            .headers = {} };
+        });
+        port_ = server_.BindToAnyPort("127.0.0.1");
+        server_thread_ = std::thread([this]() { server_.ListenAfterBind(); });
+        server_.WaitUntilReady();
+    }
+
+    ~StandInLobby()
+    {
+        server_.Stop();
+        server_thread_.join();
+    }
+
+    StandInLobby(const StandInLobby&) = delete;
+    StandInLobby& operator=(const StandInLobby&) = delete;
+    StandInLobby(StandInLobby&&) = delete;
+    StandInLobby& operator=(StandInLobby&&) = delete;
+
+    LobbyEndpoint GetEndpoint() const
+    {
+        return { .scheme_host_port = "http://127.0.0.1:" + std::to_string(port_),
+                 .api_endpoint = "/api" };
+    }
+
+    void SetResponseStatus(int response_status) { response_status_ = response_status; }
+
+    std::vector<std::string> GetReceivedBodies() const
+    {
+        std::lock_guard lock{ mutex_ };
+        return received_bodies_;
+    }
+
+private:
+    Httplib::Server server_;
+    std::thread server_thread_;
+    int port_ = -1;
+    std::atomic<int> response_status_;
+    std::chrono::milliseconds response_delay_;
+    mutable std::mutex mutex_;
+    std::vector<std::string> received_bodies_;
+};
+
+LobbyServerInfo MakeServerInfo()
+{
+    return { .name = "Soldank \"test\" server",
+             .port = 23073,
+             .current_map = "ctf_Ash",
+             .players_count = 3,
+             .max_players = 16 };
+}
+
+LobbyClientOptions MakeShortTimeoutOptions()
+{
+    return { .connection_timeout = 200ms,
+             .read_timeout = 200ms,
+             .write_timeout = 200ms,
+             .initial_backoff = 300ms,
+             .max_backoff = 1000ms };
+}
+} // namespace
+
+TEST(LobbyClientTests, SerializesServerInfoWithEscapedStrings)
+{
+    const std::string json = LobbyServerInfoJson::Serialize(MakeServerInfo(), "Linux");
+
+    EXPECT_NE(json.find(R"("name":"Soldank \"test\" server")"), std::string::npos);
+    EXPECT_NE(json.find(R"("current_map":"ctf_Ash")"), std::string::npos);
+    EXPECT_NE(json.find(R"("num_players":3)"), std::string::npos);
+    EXPECT_NE(json.find(R"("max_players":16)"), std::string::npos);
+    EXPECT_NE(json.find(R"("port":23073)"), std::string::npos);
+    EXPECT_NE(json.find(R"("os":"Linux")"), std::string::npos);
+    EXPECT_EQ(LobbyServerInfoJson::EscapeString("a\\b\n\x01"), "a\\\\b\\n\\u0001");
+}
+
+TEST(LobbyClientTests, RegistersInLobby)
+{
+    StandInLobby lobby{ 201, 0ms };
+    LobbyClient lobby_client{ { lobby.GetEndpoint() }, MakeShortTimeoutOptions() };
+
+    lobby_client.Register(MakeServerInfo());
+    ASSERT_TRUE(lobby_client.WaitUntilIdle(5s));
+
+    const auto received_bodies = lobby.GetReceivedBodies();
+    ASSERT_EQ(received_bodies.size(), 1);
+    EXPECT_NE(received_bodies.front().find(R"("current_map":"ctf_Ash")"), std::string::npos);
+    const auto statuses = lobby_client.GetStatuses();
+    ASSERT_EQ(statuses.size(), 1);
+    EXPECT_EQ(statuses.front().state, LobbyRegistrationState::Registered);
+    EXPECT_EQ(statuses.front().last_http_status, 201);
+}
+
+TEST(LobbyClientTests, SlowLobbyDoesNotBlockRegister)
+{
+    StandInLobby lobby{ 201, 1000ms };
+    LobbyClient lobby_client{ { lobby.GetEndpoint() }, MakeShortTimeoutOptions() };
+
+    const auto register_start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 10; ++i) {
+        lobby_client.Register(MakeServerInfo());
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - register_start, 100ms);
+
+    ASSERT_TRUE(lobby_client.WaitUntilIdle(5s));
+    const auto statuses = lobby_client.GetStatuses();
+    ASSERT_EQ(statuses.size(), 1);
+    EXPECT_EQ(statuses.front().state, LobbyRegistrationState::Failed);
+    EXPECT_FALSE(statuses.front().last_error.empty());
+    // The queue is bounded, the registrations that did not fit were dropped
+    EXPECT_GT(lobby_client.GetDroppedRegistrationsCount(), 0);
+}
+
+TEST(LobbyClientTests, FailingLobbyIsRetriedAfterBackoff)
+{
+    StandInLobby lobby{ 500, 0ms };
+    LobbyClient lobby_client{ { lobby.GetEndpoint() }, MakeShortTimeoutOptions() };
+
+    lobby_client.Register(MakeServerInfo());
+    ASSERT_TRUE(lobby_client.WaitUntilIdle(5s));
+    EXPECT_EQ(lobby_client.GetStatuses().front().state, LobbyRegistrationState::Failed);
+    EXPECT_EQ(lobby_client.GetStatuses().front().last_http_status, 500);
+    EXPECT_EQ(lobby_client.GetStatuses().front().consecutive_failures_count, 1);
+
+    // Still backing off, the lobby is not contacted
+    lobby_client.Register(MakeServerInfo());
+    ASSERT_TRUE(lobby_client.WaitUntilIdle(5s));
+    EXPECT_EQ(lobby.GetReceivedBodies().size(), 1);
+
+    std::this_thread::sleep_for(400ms);
+    lobby.SetResponseStatus(201);
+    lobby_client.Register(MakeServerInfo());
+    ASSERT_TRUE(lobby_client.WaitUntilIdle(5s));
+    EXPECT_EQ(lobby.GetReceivedBodies().size(), 2);
+    EXPECT_EQ(lobby_client.GetStatuses().front().state, LobbyRegistrationState::Registered);
+    EXPECT_EQ(lobby_client.GetStatuses().front().consecutive_failures_count, 0);
+}
+
+TEST(LobbyClientTests, UnreachableLobbyFails)
+{
+    int unused_port = 0;
+    {
+        Httplib::Server server;
+        unused_port = server.BindToAnyPort("127.0.0.1");
+    }
+    LobbyClient lobby_client{ { { .scheme_host_port =
+                                    "http://127.0.0.1:" + std::to_string(unused_port),
+                                  .api_endpoint = "/api" } },
+                              MakeShortTimeoutOptions() };
+
+    lobby_client.Register(MakeServerInfo());
+    ASSERT_TRUE(lobby_client.WaitUntilIdle(5s));
+    EXPECT_EQ(lobby_client.GetStatuses().front().state, LobbyRegistrationState::Failed);
+    EXPECT_EQ(lobby_client.GetStatuses().front().last_http_status, 0);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,11 +1,15 @@
 #include <gtest/gtest.h>
 
+#include <array>
 #include <cstdint>
 #include <limits>
+#include <variant>
+#include <vector>
 
 import Runtime.ServerCommandQueues;
 import Sessions.PlayerSessionManager;
 
+import Shared.Core.Config.Config;
 import Shared.Core.Simulation.SimulationCommands;
 
 using namespace Soldank;
@@ -23,6 +27,15 @@ PlayerInputCommand MakePlayerInput(std::uint32_t input_sequence_id)
         .mouse_map_position = {},
     };
 }
+
+std::vector<PlayerInputCommand> SelectPlayerInputs(ServerCommandQueues& command_queues,
+                                                   std::uint32_t server_tick)
+{
+    std::array<PlayerInputCommand, Config::MAX_PLAYERS> player_inputs{};
+    const auto selected_inputs =
+      command_queues.SelectPlayerInputsForSimulation(server_tick, player_inputs);
+    return { selected_inputs.begin(), selected_inputs.end() };
+}
 } // namespace
 
 TEST(ServerCommandQueuesTests, NewestInputReceivedBeforeOneServerTickIsSelected)
@@ -32,11 +45,9 @@ TEST(ServerCommandQueuesTests, NewestInputReceivedBeforeOneServerTickIsSelected)
     command_queues.StorePendingPlayerInput(MakePlayerInput(11));
     command_queues.StorePendingPlayerInput(MakePlayerInput(12));
 
-#ifndef NDEBUG
-    EXPECT_EQ(command_queues.GetInputDebugStats().received_input_count, 3);
-#endif
+    EXPECT_EQ(command_queues.GetInputStats().received_input_count, 3);
 
-    const auto selected_inputs = command_queues.SelectPlayerInputsForSimulation(10);
+    const auto selected_inputs = SelectPlayerInputs(command_queues, 10);
 
     ASSERT_EQ(selected_inputs.size(), 1);
     EXPECT_EQ(selected_inputs[0].input_sequence_id, 12);
@@ -50,12 +61,12 @@ TEST(ServerCommandQueuesTests, SelectsOneNewestInputPerSoldier)
     second_soldier_input.soldier_id = 2;
     command_queues.StorePendingPlayerInput(second_soldier_input);
 
-    const auto selected_inputs = command_queues.SelectPlayerInputsForSimulation(10);
+    const auto selected_inputs = SelectPlayerInputs(command_queues, 10);
 
     ASSERT_EQ(selected_inputs.size(), 2);
     EXPECT_EQ(selected_inputs[0].input_sequence_id, 10);
     EXPECT_EQ(selected_inputs[1].input_sequence_id, 20);
-    EXPECT_TRUE(command_queues.SelectPlayerInputsForSimulation(11).empty());
+    EXPECT_TRUE(SelectPlayerInputs(command_queues, 11).empty());
 }
 
 TEST(ServerCommandQueuesTests, SelectsNewestInputOnlyWhenItsServerTickIsDue)
@@ -68,9 +79,9 @@ TEST(ServerCommandQueuesTests, SelectsNewestInputOnlyWhenItsServerTickIsDue)
     newest_input.apply_server_tick = 12;
     command_queues.StorePendingPlayerInput(newest_input);
 
-    EXPECT_TRUE(command_queues.SelectPlayerInputsForSimulation(11).empty());
+    EXPECT_TRUE(SelectPlayerInputs(command_queues, 11).empty());
 
-    const auto selected_inputs = command_queues.SelectPlayerInputsForSimulation(12);
+    const auto selected_inputs = SelectPlayerInputs(command_queues, 12);
     ASSERT_EQ(selected_inputs.size(), 1);
     EXPECT_EQ(selected_inputs[0].input_sequence_id, 11);
 }
@@ -82,12 +93,10 @@ TEST(ServerCommandQueuesTests, AppliesInputsThatMissedTheirScheduledServerTick)
     input.apply_server_tick = 9;
     command_queues.StorePendingPlayerInput(input);
 
-    const auto selected_inputs = command_queues.SelectPlayerInputsForSimulation(10);
+    const auto selected_inputs = SelectPlayerInputs(command_queues, 10);
     ASSERT_EQ(selected_inputs.size(), 1);
     EXPECT_EQ(selected_inputs[0].input_sequence_id, 10);
-#ifndef NDEBUG
-    EXPECT_EQ(command_queues.GetInputDebugStats().late_applied_input_count, 1);
-#endif
+    EXPECT_EQ(command_queues.GetInputStats().late_applied_input_count, 1);
 }
 
 TEST(ServerCommandQueuesTests, SelectsNewestInputWhenSeveralInputsAreLate)
@@ -100,14 +109,81 @@ TEST(ServerCommandQueuesTests, SelectsNewestInputWhenSeveralInputsAreLate)
     newest_input.apply_server_tick = 9;
     command_queues.StorePendingPlayerInput(newest_input);
 
-    const auto selected_inputs = command_queues.SelectPlayerInputsForSimulation(10);
+    const auto selected_inputs = SelectPlayerInputs(command_queues, 10);
+
+    ASSERT_EQ(selected_inputs.size(), 1);
+    EXPECT_EQ(selected_inputs[0].input_sequence_id, 11);
+    EXPECT_EQ(command_queues.GetInputStats().late_applied_input_count, 2);
+    EXPECT_EQ(command_queues.GetInputStats().superseded_input_count, 1);
+}
+
+TEST(ServerCommandQueuesTests, NewerInputScheduledEarlierSupersedesPendingInputs)
+{
+    ServerCommandQueues command_queues;
+    auto first_input = MakePlayerInput(10);
+    first_input.apply_server_tick = 14;
+    command_queues.StorePendingPlayerInput(first_input);
+    auto newest_input = MakePlayerInput(11);
+    newest_input.apply_server_tick = 12;
+    command_queues.StorePendingPlayerInput(newest_input);
+
+    EXPECT_EQ(command_queues.GetPendingPlayerInputCount(1), 1);
+    EXPECT_EQ(command_queues.GetInputStats().superseded_input_count, 1);
 
+    const auto selected_inputs = SelectPlayerInputs(command_queues, 12);
     ASSERT_EQ(selected_inputs.size(), 1);
     EXPECT_EQ(selected_inputs[0].input_sequence_id, 11);
-#ifndef NDEBUG
-    EXPECT_EQ(command_queues.GetInputDebugStats().late_applied_input_count, 2);
-    EXPECT_EQ(command_queues.GetInputDebugStats().superseded_input_count, 1);
-#endif
+    EXPECT_TRUE(SelectPlayerInputs(command_queues, 14).empty());
+}
+
+TEST(ServerCommandQueuesTests, PendingInputsAreBounded)
+{
+    ServerCommandQueues command_queues;
+    for (std::uint32_t i = 0; i < ServerCommandQueues::MAX_PENDING_INPUTS_PER_PLAYER; ++i) {
+        auto input = MakePlayerInput(i);
+        input.apply_server_tick = 100 + i;
+        EXPECT_TRUE(command_queues.StorePendingPlayerInput(input));
+    }
+    auto overflowing_input = MakePlayerInput(1000);
+    overflowing_input.apply_server_tick = 1000;
+    EXPECT_FALSE(command_queues.StorePendingPlayerInput(overflowing_input));
+
+    auto invalid_soldier_input = MakePlayerInput(1001);
+    invalid_soldier_input.soldier_id = Config::MAX_PLAYERS;
+    EXPECT_FALSE(command_queues.StorePendingPlayerInput(invalid_soldier_input));
+
+    EXPECT_EQ(command_queues.GetPendingPlayerInputCount(1),
+              ServerCommandQueues::MAX_PENDING_INPUTS_PER_PLAYER);
+    EXPECT_EQ(command_queues.GetInputStats().dropped_input_count, 2);
+    EXPECT_EQ(command_queues.GetInputStats().received_input_count,
+              ServerCommandQueues::MAX_PENDING_INPUTS_PER_PLAYER + 2);
+
+    // Selecting frees the due inputs
+    const auto selected_inputs = SelectPlayerInputs(command_queues, 101);
+    ASSERT_EQ(selected_inputs.size(), 1);
+    EXPECT_EQ(selected_inputs[0].input_sequence_id, 1);
+    EXPECT_EQ(command_queues.GetPendingPlayerInputCount(1),
+              ServerCommandQueues::MAX_PENDING_INPUTS_PER_PLAYER - 2);
+    EXPECT_TRUE(command_queues.StorePendingPlayerInput(overflowing_input));
+
+    command_queues.ResetInputStats();
+    EXPECT_EQ(command_queues.GetInputStats().dropped_input_count, 0);
+}
+
+TEST(ServerCommandQueuesTests, DrainsSimulationCommandsInOrder)
+{
+    ServerCommandQueues command_queues;
+    command_queues.EnqueueSimulationCommand(KillSoldierCommand{ .soldier_id = 1 });
+    command_queues.EnqueueSimulationCommand(KillSoldierCommand{ .soldier_id = 2 });
+
+    std::vector<SimulationCommand> simulation_commands;
+    command_queues.DrainSimulationCommands(simulation_commands);
+    ASSERT_EQ(simulation_commands.size(), 2);
+    EXPECT_EQ(std::get<KillSoldierCommand>(simulation_commands[0]).soldier_id, 1);
+    EXPECT_EQ(std::get<KillSoldierCommand>(simulation_commands[1]).soldier_id, 2);
+
+    command_queues.DrainSimulationCommands(simulation_commands);
+    EXPECT_TRUE(simulation_commands.empty());
 }
 
 TEST(PlayerSessionManagerTests, ReceiptDoesNotAdvanceAppliedInputId)
@@ -137,7 +213,7 @@ TEST(PlayerSessionManagerTests, AppliedInputIdCanRemainUnchangedThenJumpAfterSup
     player_session_manager.MarkInputReceived(1, 12);
     EXPECT_EQ(player_session_manager.GetLastAppliedInputId(1), 0U);
 
-    const auto selected_inputs = command_queues.SelectPlayerInputsForSimulation(10);
+    const auto selected_inputs = SelectPlayerInputs(command_queues, 10);
     ASSERT_EQ(selected_inputs.size(), 1);
     player_session_manager.MarkInputApplied(1, selected_inputs.front().input_sequence_id);
 
@@ -155,11 +231,11 @@ TEST(ServerCommandQueuesTests, SelectsDueInputsAcrossTickWraparound)
     after_wrap.apply_server_tick = 1;
     command_queues.StorePendingPlayerInput(after_wrap);
 
-    const auto selected_at_wrap = command_queues.SelectPlayerInputsForSimulation(0);
+    const auto selected_at_wrap = SelectPlayerInputs(command_queues, 0);
     ASSERT_EQ(selected_at_wrap.size(), 1);
     EXPECT_EQ(selected_at_wrap.front().input_sequence_id, 10U);
 
-    const auto selected_after_wrap = command_queues.SelectPlayerInputsForSimulation(1);
+    const auto selected_after_wrap = SelectPlayerInputs(command_queues, 1);
     ASSERT_EQ(selected_after_wrap.size(), 1);
     EXPECT_EQ(selected_after_wrap.front().input_sequence_id, 11U);
 }
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+import Runtime.ServerReplayRecording;
+
+import Shared.Core.Replay.ReplayPlayer;
+import Shared.Core.Simulation.SimulationCommands;
+import Shared.Core.Simulation.WorldTick;
+import Shared.Core.State.Control;
+import Shared.Core.World;
+
+using namespace Soldank;
+
+TEST(ServerReplayRecordingTest, WritesTheUnflushedTicksWhenDestroyed)
+{
+    const auto replay_path =
+      std::filesystem::temp_directory_path() / "soldank_server_replay_recording_test.sdkreplay";
+    World world;
+    world.CreateSoldier(1);
+
+    std::uintmax_t recorded_bytes_count = 0;
+    {
+        // Only the first tick's keyframe reaches the flush threshold on its own
+        ServerReplayRecording replay_recording(replay_path,
+                                               { .keyframe_interval = 6000, .map_path = "" });
+        for (std::uint32_t tick = 0; tick < 30U; tick++) {
+            const std::vector<PlayerInputCommand> player_inputs{
+                { .soldier_id = 1,
+                  .input_sequence_id = tick + 1U,
+                  .client_tick = tick,
+                  .apply_server_tick = tick,
+                  .control = Control{},
+                  .mouse_map_position = { 0.0F, 0.0F } }
+            };
+            replay_recording.RecordTick(
+              { .tick = tick, .player_inputs = player_inputs, .commands = {} },
+              *world.GetStateManager());
+        }
+        recorded_bytes_count = replay_recording.GetRecordedBytesCount();
+    }
+
+    EXPECT_EQ(std::filesystem::file_size(replay_path), recorded_bytes_count);
+    const auto replay_player = ReplayPlayer::Load(replay_path);
+    ASSERT_TRUE(replay_player.has_value());
+    EXPECT_FALSE(replay_player->IsTruncated());
+    EXPECT_EQ(replay_player->GetLastTick(), 29U);
+    std::filesystem::remove(replay_path);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}